@@ -63,6 +63,208 @@ struct MapEntry {
     constexpr MapEntry() requires std::is_default_constructible_v<KeyType> = default;
 };
 
+// ******************************************************************************** 文字列キーの探索方法
+/// @brief 文字列キーの探索方法。
+enum class StringKeyLookupStrategy : std::uint8_t {
+    None,          ///< 未構築（常に未検出）
+    Linear,        ///< 長さと先頭8byteによる線形探索
+    PerfectHash,   ///< 長さ・先頭8byte・末尾8byteのハッシュによる最小完全ハッシュ
+    FullKeyHash    ///< キー全体のハッシュによる最小完全ハッシュ
+};
+
+/// @brief 文字列キー専用の探索表。キー数Nとキー集合から探索方法を自動で選ぶ。
+/// @tparam N キー数。
+/// @note どうしてこの実装にしたか：std::hashはキー全体を走査するうえconstexprでなく、
+///       短いキーでは二分探索と合わせて比較より高くつく。そこで、
+///       - N <= linearMaxSize：長さと先頭8byteの比較による線形探索
+///       - それ以外：長さ・先頭8byte・末尾8byteから作るハッシュによる最小完全ハッシュ
+///         （hash and displace法。表の大きさはN、探索はハッシュ2回と比較1回）
+///       を用いる。キー集合によって完全ハッシュを作れない場合は、キー全体のハッシュ、
+///       それでも作れなければ線形探索へ切り替える。
+template <std::size_t N>
+class StringKeyLookup {
+public:
+    using Strategy = StringKeyLookupStrategy;
+
+    /// @brief 線形探索を用いる最大のキー数。
+    static constexpr std::size_t linearMaxSize = 8;
+
+    /// @brief 未構築の探索表を構築する。
+    constexpr StringKeyLookup() = default;
+
+    /// @brief キー配列から探索表を構築する。
+    /// @tparam Entries keyメンバーを持つ要素のN要素配列。
+    /// @param entries 探索対象の配列。find()にも同じ配列を渡すこと。
+    template <typename Entries>
+    constexpr void build(const Entries& entries) {
+        for (std::size_t i = 0; i < N; ++i) {
+            const std::string_view key = entries[i].key;
+            lengths_[i] = key.size();
+            prefixes_[i] = loadWord(key, 0);
+        }
+        if constexpr (N <= linearMaxSize) {
+            strategy_ = Strategy::Linear;
+        } else {
+            if (buildPerfectHash(entries, Strategy::PerfectHash) ||
+                buildPerfectHash(entries, Strategy::FullKeyHash)) {
+                return;
+            }
+            strategy_ = Strategy::Linear;
+        }
+    }
+
+    /// @brief 探索方法を返す。
+    constexpr Strategy strategy() const { return strategy_; }
+
+    /// @brief キーを探索する。
+    /// @param key 探索するキー。
+    /// @param entries build()に渡した配列。
+    /// @return 見つかった要素の位置。未検出時はN。
+    template <typename Entries>
+    constexpr std::size_t find(std::string_view key, const Entries& entries) const {
+        switch (strategy_) {
+        case Strategy::Linear: {
+            const std::uint64_t prefix = loadWord(key, 0);
+            for (std::size_t i = 0; i < N; ++i) {
+                // 8byte以下のキーは長さと先頭8byteが一致すれば等しい。
+                if (lengths_[i] == key.size() && prefixes_[i] == prefix &&
+                    (key.size() <= 8 || entries[i].key == key)) {
+                    return i;
+                }
+            }
+            return N;
+        }
+        case Strategy::PerfectHash:
+        case Strategy::FullKeyHash: {
+            if constexpr (N <= linearMaxSize) {
+                return N;  // 小さな表では完全ハッシュを構築しない。
+            } else {
+                const std::size_t bucket = hashKey(key, 0, strategy_) % bucketCount_;
+                const std::size_t slot = hashKey(key, displacements_[bucket], strategy_) % N;
+                const std::size_t index = slotToEntry_[slot];
+                return entries[index].key == key ? index : N;
+            }
+        }
+        default:
+            return N;
+        }
+    }
+
+private:
+    /// @brief キーの指定位置から最大8byteを読み込む（不足分は0）。
+    static constexpr std::uint64_t loadWord(std::string_view key, std::size_t offset) {
+        std::uint64_t word = 0;
+        const std::size_t end = std::min(key.size(), offset + 8);
+        for (std::size_t i = offset; i < end; ++i) {
+            word |= static_cast<std::uint64_t>(static_cast<unsigned char>(key[i]))
+                << (8 * (i - offset));
+        }
+        return word;
+    }
+
+    /// @brief 64bit値を混ぜ合わせる。
+    static constexpr std::uint64_t mix(std::uint64_t x) {
+        x ^= x >> 32;
+        x *= 0xD6E8FEB86659FD93ull;
+        x ^= x >> 32;
+        return x;
+    }
+
+    /// @brief 種付きでキーのハッシュ値を計算する。
+    /// @param key キー。
+    /// @param seed 種。
+    /// @param strategy PerfectHashなら長さ・先頭・末尾のみ、FullKeyHashならキー全体を使う。
+    static constexpr std::size_t hashKey(
+        std::string_view key, std::uint64_t seed, Strategy strategy) {
+        std::uint64_t h = (seed + 1) * 0x9E3779B97F4A7C15ull ^ key.size();
+        if (strategy == Strategy::FullKeyHash) {
+            for (std::size_t offset = 0; offset < key.size(); offset += 8) {
+                h = mix(h ^ loadWord(key, offset)) + 0x9E3779B97F4A7C15ull;
+            }
+        } else {
+            const std::size_t lastOffset = key.size() > 8 ? key.size() - 8 : 0;
+            h = mix(h ^ loadWord(key, 0));
+            h = mix(h ^ (loadWord(key, lastOffset) * 0xFF51AFD7ED558CCDull));
+        }
+        return static_cast<std::size_t>(h);
+    }
+
+    /// @brief 最小完全ハッシュを構築する。
+    /// @param entries 探索対象の配列。
+    /// @param strategy 使用するハッシュ。
+    /// @return 構築できた場合はtrue。
+    template <typename Entries>
+    constexpr bool buildPerfectHash(const Entries& entries, Strategy strategy) {
+        constexpr std::uint32_t maxDisplacement = 1u << 16;
+        std::array<std::size_t, N> bucketOf{};
+        std::array<std::size_t, bucketCount_> bucketSize{};
+        for (std::size_t i = 0; i < N; ++i) {
+            bucketOf[i] = hashKey(entries[i].key, 0, strategy) % bucketCount_;
+            ++bucketSize[bucketOf[i]];
+        }
+        // 要素数の多いバケットから配置する。
+        std::array<std::size_t, bucketCount_> order{};
+        for (std::size_t b = 0; b < bucketCount_; ++b) {
+            order[b] = b;
+        }
+        std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+            return bucketSize[a] > bucketSize[b];
+        });
+
+        std::array<bool, N> occupied{};
+        std::array<std::size_t, N> slots{};
+        for (const std::size_t bucket : order) {
+            if (bucketSize[bucket] == 0) {
+                break;
+            }
+            bool placed = false;
+            for (std::uint32_t d = 1; d < maxDisplacement && !placed; ++d) {
+                // バケット内の全キーが、空いていて互いに異なる位置に入るか確かめる。
+                std::size_t count = 0;
+                bool ok = true;
+                for (std::size_t i = 0; i < N && ok; ++i) {
+                    if (bucketOf[i] != bucket) {
+                        continue;
+                    }
+                    const std::size_t slot = hashKey(entries[i].key, d, strategy) % N;
+                    ok = !occupied[slot];
+                    for (std::size_t j = 0; j < count && ok; ++j) {
+                        ok = slots[j] != slot;
+                    }
+                    slots[count++] = slot;
+                }
+                if (!ok) {
+                    continue;
+                }
+                count = 0;
+                for (std::size_t i = 0; i < N; ++i) {
+                    if (bucketOf[i] == bucket) {
+                        occupied[slots[count++]] = true;
+                        slotToEntry_[hashKey(entries[i].key, d, strategy) % N] =
+                            static_cast<std::uint32_t>(i);
+                    }
+                }
+                displacements_[bucket] = d;
+                placed = true;
+            }
+            if (!placed) {
+                return false;
+            }
+        }
+        strategy_ = strategy;
+        return true;
+    }
+
+    /// @brief 完全ハッシュの1段目のバケット数。
+    static constexpr std::size_t bucketCount_ = N / 4 + 1;
+
+    Strategy strategy_ = Strategy::None;             ///< 探索方法。
+    std::array<std::size_t, N> lengths_{};           ///< 各キーの長さ。
+    std::array<std::uint64_t, N> prefixes_{};        ///< 各キーの先頭8byte。
+    std::array<std::uint32_t, bucketCount_> displacements_{}; ///< バケット毎のハッシュの種。
+    std::array<std::uint32_t, N> slotToEntry_{};     ///< ハッシュ位置から要素位置への対応。
+};
+
 template <
     typename KeyType,
     typename ValueType,
@@ -232,11 +434,32 @@ public:
         sortFields();
     }
 
+    /// @brief 文字列キー専用の探索表を使う探索キー型か。
+    /// @note 既定のTraitsを使う文字列キーのマップだけが対象（独自のハッシュ・比較を尊重する）。
+    template <typename Lookup>
+    static constexpr bool usesStringLookup =
+        std::is_same_v<KeyType, std::string_view> &&
+        std::is_same_v<Traits, SortedHashArrayMapTraits<std::string_view>> &&
+        std::is_convertible_v<const Lookup&, std::string_view>;
+
+    /// @brief 文字列キーの探索方法を返す。
+    /// @return 探索方法。文字列キーのマップでなければNone。
+    constexpr StringKeyLookupStrategy stringLookupStrategy() const {
+        return stringLookup_.strategy();
+    }
+
     /// @brief 指定キーに対応するフィールドを探索する。
     /// @param key 探索するキー名。
     /// @return 見つかった場合はフィールドの元インデックス、未検出時はstd::nullopt。
     template <typename Lookup>
     std::optional<std::size_t> findIndex(const Lookup& key) const {
+        if constexpr (usesStringLookup<Lookup>) {
+            const std::size_t pos = stringLookup_.find(std::string_view(key), sortedFields_);
+            if (pos != N) {
+                return sortedFields_[pos].originalIndex;
+            }
+            return std::nullopt;
+        }
         std::span<const FieldInfo> entries(sortedFields_.data(), N);
         auto it = Algorithms::find(entries, key);
         if (it != entries.end()) {
@@ -248,6 +471,10 @@ public:
     /// @brief 指定キーに対応する値を取得する。見つからなければ nullptr を返す。
     template <typename Lookup>
     const ValueType* findValue(const Lookup& key) const {
+        if constexpr (usesStringLookup<Lookup>) {
+            const std::size_t pos = stringLookup_.find(std::string_view(key), sortedFields_);
+            return pos != N ? &sortedFields_[pos].value : nullptr;
+        }
         std::span<const FieldInfo> entries(sortedFields_.data(), N);
         auto it = Algorithms::find(entries, key);
         if (it != entries.end()) {
@@ -313,7 +540,7 @@ private:
         }};
     }
 
-    /// @brief sortedFields_をソートする。
+    /// @brief sortedFields_をソートし、文字列キーなら探索表を構築する。
     constexpr void sortFields() {
         std::sort(sortedFields_.begin(), sortedFields_.end(),
             [](const FieldInfo& a, const FieldInfo& b) {
@@ -322,9 +549,15 @@ private:
                 }
                 return KeyCompare{}(a.key, b.key);
             });
+        if constexpr (usesStringLookup<KeyType>) {
+            stringLookup_.build(sortedFields_);
+        }
     }
 
-    Array sortedFields_; ///< ハッシュ順に整列したフィールド情報。
+    Array sortedFields_; ///< ハッシュ順に整列したフィールド情報（MapReferenceも参照する）。
+    ///! 文字列キー専用の探索表（文字列キー以外では空の表）。
+    std::conditional_t<usesStringLookup<KeyType>, StringKeyLookup<N>, StringKeyLookup<0>>
+        stringLookup_{};
 
 public:
     using iterator = const FieldInfo*;
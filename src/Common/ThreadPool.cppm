@@ -1,27 +1,491 @@
 // @file ThreadPool.cppm
-// @brief シンプルなスレッドプール実装。タスクキューを管理し、並列実行を提供する。
+// @brief タスク実行器（ワークスティーリング方式のスレッドプール・呼び出しスレッドで実行する実行器）の実装。
 
 module;
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <new>
+#include <stdexcept>
 #include <vector>
-#include <queue>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
-#include <functional>
 #include <future>
 #include <type_traits>
+#include <utility>
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 export module rai.common.thread_pool;
 
 namespace rai::common {
 
-/// @brief シンプルなスレッドプール。タスクを並列実行する。
-export class ThreadPool {
+// ******************************************************************************** タスク
+/// @brief ムーブのみ可能な、引数なしの呼び出し可能オブジェクトを保持するタスク。
+/// @note std::functionと異なりムーブのみ可能な関数オブジェクト（std::packaged_taskなど）を保持できる。
+///       inlineSize以下の関数オブジェクトは内部領域に置き、ヒープ確保しない。
+export class Task {
+public:
+    /// @brief 内部領域に置ける関数オブジェクトの最大byte数。
+    static constexpr std::size_t inlineSize = 48;
+
+    Task() = default;
+
+    /// @brief 関数オブジェクトからタスクを構築する。
+    /// @tparam F 関数オブジェクトの型。
+    /// @param function 保持する関数オブジェクト。
+    template <class F>
+        requires (!std::same_as<std::remove_cvref_t<F>, Task>) &&
+                 std::invocable<std::remove_cvref_t<F>&>
+    Task(F&& function) {  // NOLINT(google-explicit-constructor)
+        using Function = std::remove_cvref_t<F>;
+        if constexpr (fitsInline<Function>()) {
+            ::new (static_cast<void*>(storage_)) Function(std::forward<F>(function));
+            operations_ = &inlineOperations<Function>;
+        } else {
+            ::new (static_cast<void*>(storage_)) Function*(new Function(std::forward<F>(function)));
+            operations_ = &heapOperations<Function>;
+        }
+    }
+
+    Task(Task&& other) noexcept {
+        moveFrom(other);
+    }
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    ~Task() {
+        reset();
+    }
+
+    // コピー禁止（ムーブのみ可能な関数オブジェクトを保持するため）
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    /// @brief 関数オブジェクトを保持しているかを返す。
+    explicit operator bool() const {
+        return operations_ != nullptr;
+    }
+
+    /// @brief 保持している関数オブジェクトを呼び出す。
+    void operator()() {
+        operations_->invoke(storage_);
+    }
+
+private:
+    /// @brief 保持している関数オブジェクトの型毎の操作。
+    struct Operations {
+        void (*invoke)(void* storage);
+        void (*move)(void* destination, void* source);  ///< 移動元は破棄済みの状態にする。
+        void (*destroy)(void* storage);
+    };
+
+    template <class Function>
+    static constexpr bool fitsInline() {
+        return sizeof(Function) <= inlineSize && alignof(Function) <= alignof(std::max_align_t) &&
+            std::is_nothrow_move_constructible_v<Function>;
+    }
+
+    template <class Function>
+    static constexpr Operations inlineOperations{
+        [](void* storage) { (*static_cast<Function*>(storage))(); },
+        [](void* destination, void* source) {
+            ::new (destination) Function(std::move(*static_cast<Function*>(source)));
+            static_cast<Function*>(source)->~Function();
+        },
+        [](void* storage) { static_cast<Function*>(storage)->~Function(); }};
+
+    template <class Function>
+    static constexpr Operations heapOperations{
+        [](void* storage) { (**static_cast<Function**>(storage))(); },
+        [](void* destination, void* source) {
+            ::new (destination) Function*(*static_cast<Function**>(source));
+        },
+        [](void* storage) { delete *static_cast<Function**>(storage); }};
+
+    void moveFrom(Task& other) noexcept {
+        operations_ = other.operations_;
+        if (operations_ != nullptr) {
+            operations_->move(storage_, other.storage_);
+            other.operations_ = nullptr;
+        }
+    }
+
+    void reset() noexcept {
+        if (operations_ != nullptr) {
+            operations_->destroy(storage_);
+            operations_ = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char storage_[inlineSize];  ///< 関数オブジェクトの格納領域。
+    const Operations* operations_ = nullptr;  ///< 保持している関数オブジェクトの操作。
+};
+
+// ******************************************************************************** タスクノード
+/// @brief キューに積むタスクの入れ物。実行後は解放せず、ノードの貯蔵庫へ戻して使い回す。
+struct TaskNode {
+    Task task;                 ///< 実行するタスク。
+    TaskNode* next = nullptr;  ///< 貯蔵庫内の次のノード。
+};
+
+/// @brief スレッド間で受け渡す、未使用ノードの束の置き場。
+/// @note どうしてこの実装にしたか：外部のスレッドが積んでワーカーが実行する場合、ノードは実行した側に
+///       溜まり、積む側では不足する。束（batchSize個）単位で受け渡せば、ロックは束毎に1回で済む。
+class TaskNodeStash {
+public:
+    /// @brief 束の大きさ。
+    static constexpr std::size_t batchSize = 128;
+
+    /// @brief 束を預ける。
+    /// @param head batchSize個のノードを連ねた先頭。
+    void put(TaskNode* head) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        batches_.push_back(head);
+    }
+
+    /// @brief 束を1つ受け取る。
+    /// @return 束の先頭。預けられた束がなければnullptr。
+    TaskNode* take() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (batches_.empty()) {
+            return nullptr;
+        }
+        TaskNode* head = batches_.back();
+        batches_.pop_back();
+        return head;
+    }
+
+    /// @brief プロセス全体で共有する置き場を返す。
+    /// @note ワーカーの終了は静的変数の破棄より後になり得るため、破棄しない（預けたノードは到達可能なまま残る）。
+    static TaskNodeStash& instance() {
+        static TaskNodeStash* stash = new TaskNodeStash;
+        return *stash;
+    }
+
+private:
+    std::mutex mutex_;                ///< batches_を保護するミューテックス。
+    std::vector<TaskNode*> batches_;  ///< 預けられた束の先頭。
+};
+
+/// @brief スレッド毎の未使用ノードの貯蔵庫。積む時にここから取り、実行後にここへ戻す。
+class TaskNodeCache {
+public:
+    TaskNodeCache() = default;
+    TaskNodeCache(const TaskNodeCache&) = delete;
+    TaskNodeCache& operator=(const TaskNodeCache&) = delete;
+
+    ~TaskNodeCache() {
+        while (head_ != nullptr) {
+            delete std::exchange(head_, head_->next);
+        }
+    }
+
+    /// @brief タスクをノードに入れて返す。
+    /// @param task 入れるタスク。
+    TaskNode* acquire(Task&& task) {
+        if (head_ == nullptr) {
+            head_ = TaskNodeStash::instance().take();
+            count_ = head_ != nullptr ? TaskNodeStash::batchSize : 0;
+        }
+        if (head_ == nullptr) {
+            TaskNode* node = new TaskNode;
+            node->task = std::move(task);
+            return node;
+        }
+        TaskNode* node = std::exchange(head_, head_->next);
+        --count_;
+        node->task = std::move(task);
+        return node;
+    }
+
+    /// @brief 実行を終えたノードを戻す。保持するタスクはここで破棄する。
+    /// @param node 戻すノード。
+    void release(TaskNode* node) noexcept {
+        node->task = Task();
+        node->next = head_;
+        head_ = node;
+        if (++count_ >= 2 * TaskNodeStash::batchSize) {
+            // 先頭から1束分を切り出して預け、積む側のスレッドが使えるようにする。
+            TaskNode* batch = head_;
+            TaskNode* last = head_;
+            for (std::size_t i = 1; i < TaskNodeStash::batchSize; ++i) {
+                last = last->next;
+            }
+            head_ = std::exchange(last->next, nullptr);
+            count_ -= TaskNodeStash::batchSize;
+            try {
+                TaskNodeStash::instance().put(batch);
+            } catch (...) {
+                // 預けられなければ束ごと解放する。
+                while (batch != nullptr) {
+                    delete std::exchange(batch, batch->next);
+                }
+            }
+        }
+    }
+
+    /// @brief 呼び出しスレッドの貯蔵庫を返す。
+    static TaskNodeCache& current() {
+        thread_local TaskNodeCache cache;
+        return cache;
+    }
+
+private:
+    TaskNode* head_ = nullptr;  ///< 未使用ノードの先頭。
+    std::size_t count_ = 0;     ///< 未使用ノードの数。
+};
+
+// ******************************************************************************** ワークスティーリング両端キュー
+/// @brief 所有者が一方の端で積み降ろしし、他のスレッドが反対の端から盗むキュー（Chase-Lev方式）。
+/// @note push/popは所有者のワーカーだけが、stealは任意のスレッドが呼び出せる。
+///       拡張前の配列は盗む側が読んでいる可能性があるため、キューの破棄まで保持する。
+class WorkStealingDeque {
+public:
+    WorkStealingDeque() {
+        arrays_.push_back(std::make_unique<Array>(initialCapacity));
+        array_.store(arrays_.back().get(), std::memory_order_relaxed);
+    }
+
+    // コピー・ムーブ禁止（他スレッドから参照されるため）
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+    WorkStealingDeque(WorkStealingDeque&&) = delete;
+    WorkStealingDeque& operator=(WorkStealingDeque&&) = delete;
+
+    /// @brief 所有者側の端にタスクを積む（所有者のみ）。
+    /// @param task 積むタスクのノード。
+    void push(TaskNode* task) {
+        const std::int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        const std::int64_t top = top_.load(std::memory_order_acquire);
+        Array* array = array_.load(std::memory_order_relaxed);
+        if (bottom - top > static_cast<std::int64_t>(array->capacity) - 1) {
+            array = grow(array, top, bottom);
+        }
+        array->put(bottom, task);
+        // 盗む側がbottom_をacquireで読めば、積んだタスクの中身も見える。
+        bottom_.store(bottom + 1, std::memory_order_release);
+    }
+
+    /// @brief 所有者側の端からタスクを取り出す（所有者のみ）。
+    /// @return 取り出したタスク。空ならnullptr。
+    TaskNode* pop() {
+        const std::int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        Array* array = array_.load(std::memory_order_relaxed);
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t top = top_.load(std::memory_order_relaxed);
+        if (top > bottom) {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        TaskNode* task = array->get(bottom);
+        if (top == bottom) {
+            // 最後の1つは盗む側と取り合うため、topを進められた方が取得する。
+            if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                    std::memory_order_relaxed)) {
+                task = nullptr;
+            }
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    /// @brief 反対側の端からタスクを盗む（任意のスレッド）。
+    /// @return 盗んだタスク。空または取り合いに負けた場合はnullptr。
+    TaskNode* steal() {
+        std::int64_t top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t bottom = bottom_.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return nullptr;
+        }
+        Array* array = array_.load(std::memory_order_acquire);
+        TaskNode* task = array->get(top);
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return task;
+    }
+
+    /// @brief キューが空に見えるかを返す（概算）。
+    bool empty() const {
+        return top_.load(std::memory_order_relaxed) >= bottom_.load(std::memory_order_relaxed);
+    }
+
+private:
+    /// @brief 容量が2の冪の循環配列。
+    struct Array {
+        explicit Array(std::size_t size)
+            : capacity(size), mask(size - 1), slots(std::make_unique<std::atomic<TaskNode*>[]>(size)) {}
+
+        TaskNode* get(std::int64_t index) const {
+            return slots[static_cast<std::size_t>(index) & mask].load(std::memory_order_relaxed);
+        }
+
+        void put(std::int64_t index, TaskNode* task) {
+            slots[static_cast<std::size_t>(index) & mask].store(task, std::memory_order_relaxed);
+        }
+
+        std::size_t capacity;  ///< 要素数。
+        std::size_t mask;      ///< 添字の剰余用マスク。
+        std::unique_ptr<std::atomic<TaskNode*>[]> slots;  ///< 要素。
+    };
+
+    /// @brief 容量を2倍にした配列へ移す（所有者のみ）。
+    Array* grow(Array* array, std::int64_t top, std::int64_t bottom) {
+        arrays_.push_back(std::make_unique<Array>(array->capacity * 2));
+        Array* grown = arrays_.back().get();
+        for (std::int64_t i = top; i < bottom; ++i) {
+            grown->put(i, array->get(i));
+        }
+        array_.store(grown, std::memory_order_release);
+        return grown;
+    }
+
+    static constexpr std::size_t initialCapacity = 256;
+
+    alignas(64) std::atomic<std::int64_t> top_{0};     ///< 盗む側の端。
+    alignas(64) std::atomic<std::int64_t> bottom_{0};  ///< 所有者側の端。
+    std::atomic<Array*> array_{nullptr};               ///< 現在の配列。
+    std::vector<std::unique_ptr<Array>> arrays_;       ///< 確保した配列（所有者のみ変更）。
+};
+
+// ******************************************************************************** タスク実行器
+/// @brief タスクを実行する実行器のインターフェース。
+/// @note 読み込みAPIや入力ソースはこの型の参照を受け取り、スレッドプール以外の実行器も差し替えられる。
+export class Executor {
+public:
+    virtual ~Executor() = default;
+
+    /// @brief 結果を受け取らないタスクを実行する（実行器によっては呼び出し中に実行する）。
+    /// @param task 実行するタスク。例外を送出しないこと。
+    virtual void post(Task task) = 0;
+
+    /// @brief 保留中のタスクを1つ呼び出しスレッドで実行する。
+    /// @return 実行した場合はtrue、保留中のタスクがなかった場合はfalse。
+    virtual bool runPendingTask() = 0;
+
+    /// @brief タスクを並行に実行するスレッドの数を返す。
+    /// @return スレッドの数。0の場合は全てのタスクを呼び出しスレッドで実行する。
+    virtual size_t getThreadCount() const = 0;
+
+    /// @brief 呼び出しスレッドが本実行器のワーカーかを返す。
+    virtual bool isWorkerThread() const = 0;
+
+    /// @brief タスクを実行し、実行結果を受け取るfutureを返す。
+    /// @tparam F 実行するコール可能オブジェクトの型。
+    /// @param task 実行するタスク。
+    /// @return タスク完了を待機するfuture。
+    /// @note 結果を受け渡すfutureの共有状態を1回確保する。結果が不要ならpost()を使うと、
+    ///       inlineSize以下の関数オブジェクトはタスク毎に確保しない。
+    template <class F>
+    auto enqueue(F&& task) -> std::future<std::invoke_result_t<F>> {
+        using ReturnType = std::invoke_result_t<F>;
+
+        // どうしてこの実装にしたか：Taskはムーブのみ可能な関数オブジェクトを保持できるため、
+        // packaged_taskをshared_ptrで包まずにそのまま渡す。
+        std::packaged_task<ReturnType()> packagedTask(std::forward<F>(task));
+        std::future<ReturnType> future = packagedTask.get_future();
+        post(Task(std::move(packagedTask)));
+        return future;
+    }
+
+    /// @brief futureが完了するまで、保留中のタスクを実行しながら待つ。
+    /// @tparam R futureの値の型。
+    /// @param future 待機するfuture。
+    /// @note どうしてこの実装にしたか：ワーカー上のタスクが別のタスクの完了を単に待つと、
+    ///       待たれているタスクがキューに残ったまま全ワーカーが止まることがある。
+    ///       待つ間に保留中のタスクを実行すれば、入れ子のタスクも必ず進む。
+    template <class R>
+    void wait(const std::future<R>& future) {
+        while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            if (!runPendingTask()) {
+                future.wait_for(std::chrono::microseconds(50));
+            }
+        }
+    }
+};
+
+/// @brief 全てのタスクを呼び出しスレッドでその場で実行する実行器。スレッドを作らない。
+/// @note 小さなファイルを読むだけの短命なツールなど、スレッドの起動コストを避けたい場合に使う。
+///       この実行器を渡した読み込みAPIは、トークン化と解析を重ねずに逐次処理する。
+export class InlineExecutor final : public Executor {
+public:
+    void post(Task task) override {
+        task();
+    }
+
+    bool runPendingTask() override {
+        return false;
+    }
+
+    size_t getThreadCount() const override {
+        return 0;
+    }
+
+    bool isWorkerThread() const override {
+        return false;
+    }
+};
+
+/// @brief 共有のInlineExecutorインスタンスを取得する。
+/// @return InlineExecutorインスタンス（状態を持たないため共有してよい）。
+export InlineExecutor& getInlineExecutor() {
+    static InlineExecutor inlineExecutor;
+    return inlineExecutor;
+}
+
+// ******************************************************************************** スレッドプール
+/// @brief ThreadPoolの構築設定。
+export struct ThreadPoolOptions {
+    /// @brief ワーカースレッドの数。0の場合はハードウェアの並列度を使用する。
+    size_t threadCount = 0;
+
+    /// @brief ワーカーを固定するCPU番号。i番目のワーカーはcpuAffinity[i % size]に固定する。
+    /// @note 空の場合は固定しない。NUMAノードに寄せる場合は、そのノードのCPU番号を並べる。
+    ///       固定に対応するのはLinuxとWindows（CPU番号64未満）で、他の環境では無視する。
+    std::vector<unsigned> cpuAffinity;
+};
+
+/// @brief ワークスティーリング方式のスレッドプール。タスクを並列実行する。
+/// @note ワーカーから積んだタスクはそのワーカーの両端キューに、それ以外のスレッドから積んだタスクは
+///       共有キューに入る。手の空いたワーカーは自分のキュー、共有キュー、他のワーカーのキューの順に探す。
+/// @note タスクの中で他のタスクの完了を待つ場合は、wait()を使うと待つ間に保留中のタスクを実行する。
+export class ThreadPool final : public Executor {
 public:
     /// @brief コンストラクタ。指定された数のワーカースレッドを起動する。
     /// @param numThreads ワーカースレッドの数。0の場合はハードウェアの並列度を使用する。
     explicit ThreadPool(size_t numThreads = 0)
-        : stop_(false), activeTasks_(0) {
+        : ThreadPool(ThreadPoolOptions{numThreads, {}}) {}
+
+    /// @brief コンストラクタ。設定に従ってワーカースレッドを起動する。
+    /// @param options スレッド数とCPU固定の設定。
+    explicit ThreadPool(const ThreadPoolOptions& options) : cpuAffinity_(options.cpuAffinity) {
+        size_t numThreads = options.threadCount;
         // どうしてこの実装にしたか：numThreadsが0の場合、ハードウェアの並列度に基づいて適切なスレッド数を自動設定する
         if (numThreads == 0) {
             numThreads = std::thread::hardware_concurrency();
@@ -30,20 +494,24 @@ public:
             }
         }
 
-        // ワーカースレッドを起動
+        // 両端キューはワーカーの起動前に揃えておく（盗む側が全ワーカーのキューを参照するため）。
+        queues_.reserve(numThreads);
+        for (size_t i = 0; i < numThreads; ++i) {
+            queues_.push_back(std::make_unique<WorkStealingDeque>());
+        }
         workers_.reserve(numThreads);
         for (size_t i = 0; i < numThreads; ++i) {
-            workers_.emplace_back([this] { workerThread(); });
+            workers_.emplace_back([this, i] { workerThread(i); });
         }
     }
 
-    /// @brief デストラクタ。全てのタスクを完了してからスレッドを終了する。
+    /// @brief デストラクタ。積まれた全てのタスクを完了してからスレッドを終了する。
     ~ThreadPool() {
         {
-            std::unique_lock<std::mutex> lock(queueMutex_);
-            stop_ = true;
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            stop_.store(true, std::memory_order_seq_cst);
         }
-        condition_.notify_all();
+        sleepCondition_.notify_all();
 
         // どうしてこの実装にしたか：全てのワーカースレッドが確実に終了するまで待機する
         for (std::thread& worker : workers_) {
@@ -59,95 +527,261 @@ public:
     ThreadPool(ThreadPool&&) = delete;
     ThreadPool& operator=(ThreadPool&&) = delete;
 
-    /// @brief タスクをキューに追加し、実行結果を受け取るfutureを返す。
-    /// @tparam F 実行するコール可能オブジェクトの型。
-    /// @param task 実行するタスク。
-    /// @return タスク完了を待機するfuture。
-    template <class F>
-    auto enqueue(F&& task) -> std::future<std::invoke_result_t<F>> {
-        using ReturnType = std::invoke_result_t<F>;
-
-        auto packagedTask =
-            std::make_shared<std::packaged_task<ReturnType()>>(std::forward<F>(task));
-        std::future<ReturnType> future = packagedTask->get_future();
-
-        {
-            std::unique_lock<std::mutex> lock(queueMutex_);
-            if (stop_) {
-                throw std::runtime_error("ThreadPool: Cannot enqueue task after stop");
+    /// @brief 結果を受け取らないタスクをキューに追加する。
+    /// @param task 実行するタスク。例外を送出しないこと。
+    void post(Task task) override {
+        if (stop_.load(std::memory_order_relaxed)) {
+            throw std::runtime_error("ThreadPool: Cannot enqueue task after stop");
+        }
+        // どうしてこの実装にしたか：タスク毎にノードを確保・解放しないよう、スレッド毎の貯蔵庫から取る。
+        TaskNode* node = TaskNodeCache::current().acquire(std::move(task));
+        pendingTasks_.fetch_add(1, std::memory_order_relaxed);
+        const WorkerContext& context = currentWorker();
+        if (context.pool == this) {
+            queues_[context.index]->push(node);
+        } else {
+            try {
+                std::lock_guard<std::mutex> lock(injectionMutex_);
+                injected_.push_back(node);
+            } catch (...) {
+                pendingTasks_.fetch_sub(1, std::memory_order_relaxed);
+                TaskNodeCache::current().release(node);
+                throw;
             }
-            tasks_.push([packagedTask]() {
-                (*packagedTask)();
-            });
+            injectedCount_.fetch_add(1, std::memory_order_relaxed);
         }
-        condition_.notify_one();
-        return future;
+        notifyWork();
+    }
+
+    /// @brief 保留中のタスクを1つ呼び出しスレッドで実行する。
+    /// @return 実行した場合はtrue、保留中のタスクがなかった場合はfalse。
+    /// @note 他のタスクの完了を待つ間に呼ぶと、待っている間もプール全体の処理が進む。
+    bool runPendingTask() override {
+        const WorkerContext& context = currentWorker();
+        const std::size_t self = context.pool == this ? context.index : workers_.size();
+        TaskNode* task = findTask(self);
+        if (task == nullptr) {
+            return false;
+        }
+        execute(task);
+        return true;
     }
 
     /// @brief 全てのタスクが完了するまで待機する。
     void waitForCompletion() {
-        std::unique_lock<std::mutex> lock(queueMutex_);
+        std::unique_lock<std::mutex> lock(completionMutex_);
         completionCondition_.wait(lock, [this] {
-            return tasks_.empty() && activeTasks_ == 0;
+            return pendingTasks_.load(std::memory_order_acquire) == 0;
         });
     }
 
     /// @brief ワーカースレッドの数を取得する。
     /// @return ワーカースレッドの数。
-    size_t getThreadCount() const {
+    size_t getThreadCount() const override {
         return workers_.size();
     }
 
+    /// @brief 呼び出しスレッドが本プールのワーカーかを返す。
+    bool isWorkerThread() const override {
+        return currentWorker().pool == this;
+    }
+
+    /// @brief CPUへの固定に成功したワーカーの数を返す。
+    /// @return 固定に成功したワーカーの数。固定を指定しなかった場合は0。
+    size_t getPinnedThreadCount() const {
+        return pinnedWorkers_.load(std::memory_order_acquire);
+    }
+
 private:
-    /// @brief ワーカースレッドの実行関数。タスクキューからタスクを取得して実行する。
-    void workerThread() {
-        while (true) {
-            std::function<void()> task;
-
-            {
-                std::unique_lock<std::mutex> lock(queueMutex_);
-                // 停止フラグが立つか、タスクが追加されるまで待機する
-                condition_.wait(lock, [this] {
-                    return stop_ || !tasks_.empty();
-                });
-                if (stop_) {
-                    return; // 停止要求による停止。
-                }
+    /// @brief ワーカースレッドが属するプールと番号。
+    struct WorkerContext {
+        const ThreadPool* pool = nullptr;  ///< 属するプール。ワーカーでなければnullptr。
+        std::size_t index = 0;             ///< プール内のワーカー番号。
+    };
+
+    /// @brief 呼び出しスレッドのワーカー情報を返す。
+    static WorkerContext& currentWorker() {
+        thread_local WorkerContext context;
+        return context;
+    }
 
-                // waitの述語により、ここではtasks_が空でないことが保証されている
-                task = std::move(tasks_.front());
-                tasks_.pop();
-                ++activeTasks_;
+    /// @brief ワーカースレッドの実行関数。タスクを探して実行し、なければ眠る。
+    /// @param index ワーカー番号。
+    void workerThread(std::size_t index) {
+        currentWorker() = WorkerContext{this, index};
+        if (!cpuAffinity_.empty() && pinCurrentThread(cpuAffinity_[index % cpuAffinity_.size()])) {
+            pinnedWorkers_.fetch_add(1, std::memory_order_acq_rel);
+        }
+        for (;;) {
+            const std::uint64_t epoch = workEpoch_.load(std::memory_order_seq_cst);
+            if (TaskNode* task = findTask(index)) {
+                execute(task);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            if (stop_.load(std::memory_order_seq_cst)) {
+                return;  // 停止要求後に探して見つからなければ、全タスクが完了している。
             }
+            // どうしてこの実装にしたか：タスクを積む側は眠っているワーカーがいる時だけロックを取る。
+            // 眠る数を増やしてから世代を確かめるため、積まれたタスクの通知を取りこぼさない。
+            sleepers_.fetch_add(1, std::memory_order_seq_cst);
+            sleepCondition_.wait(lock, [&] {
+                return stop_.load(std::memory_order_seq_cst) ||
+                    workEpoch_.load(std::memory_order_seq_cst) != epoch;
+            });
+            sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+        }
+    }
 
-            // ロックを解放してからタスクを実行することで並列度を高める
-            task();
+    /// @brief 呼び出しスレッドを指定CPUに固定する。
+    /// @param cpu CPU番号。
+    /// @return 固定できた場合はtrue。
+    static bool pinCurrentThread(unsigned cpu) {
+#if defined(_WIN32)
+        if (cpu >= 64) {
+            return false;
+        }
+        return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{1} << cpu) != 0;
+#elif defined(__linux__)
+        if (cpu >= CPU_SETSIZE) {
+            return false;
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        (void)cpu;
+        return false;
+#endif
+    }
 
-            {
-                std::unique_lock<std::mutex> lock(queueMutex_);
-                --activeTasks_;
-                // 条件分岐の評価はnotify_all()よりも高速なため、不要な通知を避けることで効率化できる
-                if (tasks_.empty() && activeTasks_ == 0) { // // 全タスクが完了した。
-                    completionCondition_.notify_all();
-                }
+    /// @brief 実行するタスクを探す。
+    /// @param self 呼び出しスレッドのワーカー番号。ワーカーでなければworkers_.size()。
+    /// @return 見つけたタスク。なければnullptr。
+    TaskNode* findTask(std::size_t self) {
+        if (self < queues_.size()) {
+            if (TaskNode* task = queues_[self]->pop()) {
+                return task;
             }
         }
+        if (injectedCount_.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(injectionMutex_);
+            if (!injected_.empty()) {
+                TaskNode* task = injected_.front();
+                injected_.pop_front();
+                injectedCount_.fetch_sub(1, std::memory_order_relaxed);
+                return task;
+            }
+        }
+        const std::size_t count = queues_.size();
+        const std::size_t start = self < count ? self + 1 : 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::size_t victim = (start + i) % count;
+            if (victim == self) {
+                continue;
+            }
+            if (TaskNode* task = queues_[victim]->steal()) {
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    /// @brief タスクを実行してノードを貯蔵庫へ戻し、完了を記録する。
+    void execute(TaskNode* node) {
+        node->task();
+        TaskNodeCache::current().release(node);
+        if (pendingTasks_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(completionMutex_);
+            completionCondition_.notify_all();
+        }
+    }
+
+    /// @brief タスクが積まれたことを眠っているワーカーへ通知する。
+    void notifyWork() {
+        workEpoch_.fetch_add(1, std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_seq_cst) > 0) {
+            // 眠りに入る途中のワーカーが条件を確かめ終えるまで待ってから通知する。
+            { std::lock_guard<std::mutex> lock(sleepMutex_); }
+            sleepCondition_.notify_one();
+        }
     }
 
-    std::vector<std::thread> workers_;            ///< ワーカースレッドのコレクション。
-    std::queue<std::function<void()>> tasks_;     ///< タスクキュー。
-    std::mutex queueMutex_;                       ///< タスクキューへのアクセスを保護するミューテックス。
-    std::condition_variable condition_;           ///< タスクの追加や停止を通知する条件変数。
-    std::condition_variable completionCondition_; ///< タスクの完了を通知する条件変数。
-    bool stop_;                                   ///< 停止フラグ。trueの場合、新しいタスクを受け付けない。
-    size_t activeTasks_;                          ///< 現在実行中のタスクの数。queueMutex_で保護される。
+    std::vector<std::thread> workers_;  ///< ワーカースレッドのコレクション。
+    std::vector<std::unique_ptr<WorkStealingDeque>> queues_;  ///< ワーカー毎の両端キュー。
+    std::deque<TaskNode*> injected_;     ///< ワーカー以外のスレッドから積まれたタスク。
+    std::atomic<std::size_t> injectedCount_{0};  ///< injected_の要素数（ロックせずに空か判定する用）。
+    std::mutex injectionMutex_;          ///< injected_を保護するミューテックス。
+    std::atomic<std::uint64_t> workEpoch_{0};  ///< タスクが積まれる毎に進む世代。
+    std::atomic<std::size_t> sleepers_{0};     ///< 眠っているワーカーの数。
+    std::mutex sleepMutex_;                ///< 眠り・停止の判定を保護するミューテックス。
+    std::condition_variable sleepCondition_;  ///< タスクの追加や停止を通知する条件変数。
+    std::atomic<std::size_t> pendingTasks_{0};  ///< 積まれて未完了のタスクの数。
+    std::mutex completionMutex_;           ///< 完了通知用のミューテックス。
+    std::condition_variable completionCondition_;  ///< タスクの完了を通知する条件変数。
+    std::atomic<bool> stop_{false};        ///< 停止フラグ。trueの場合、新しいタスクを受け付けない。
+    std::vector<unsigned> cpuAffinity_;    ///< ワーカーを固定するCPU番号。
+    std::atomic<size_t> pinnedWorkers_{0};  ///< CPUへの固定に成功したワーカーの数。
+};
+
+// ******************************************************************************** 共有の実行器
+/// @brief 共有ThreadPoolの設定と起動状態。
+struct GlobalThreadPoolState {
+    std::mutex mutex;               ///< 設定と起動状態を保護するミューテックス。
+    ThreadPoolOptions options;      ///< 起動時に使う設定。
+    bool started = false;           ///< 起動済みフラグ。
+    std::atomic<Executor*> defaultExecutor{nullptr};  ///< 既定の実行器。nullptrは共有ThreadPool。
 };
 
-/// @brief 共有のThreadPoolインスタンスを取得する。
+GlobalThreadPoolState& globalThreadPoolState() {
+    static GlobalThreadPoolState state;
+    return state;
+}
+
+/// @brief 共有ThreadPoolの設定を変更する。共有ThreadPoolを初めて使う前に呼ぶこと。
+/// @param options スレッド数とCPU固定の設定。
+/// @throws std::runtime_error 共有ThreadPoolが既に起動している場合。
+export void configureGlobalThreadPool(ThreadPoolOptions options) {
+    GlobalThreadPoolState& state = globalThreadPoolState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (state.started) {
+        throw std::runtime_error("configureGlobalThreadPool: the global thread pool has already started");
+    }
+    state.options = std::move(options);
+}
+
+/// @brief 共有のThreadPoolインスタンスを取得する。初回の呼び出しでワーカーを起動する。
 /// @return グローバルThreadPoolインスタンス。
+/// @note スレッド数を指定しない場合、ワーカーは最低2つ確保する。
 export ThreadPool& getGlobalThreadPool() {
-    static ThreadPool globalPool;
+    static ThreadPool globalPool([] {
+        GlobalThreadPoolState& state = globalThreadPoolState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.started = true;
+        ThreadPoolOptions options = state.options;
+        if (options.threadCount == 0) {
+            options.threadCount = std::max(std::thread::hardware_concurrency(), 2u);
+        }
+        return options;
+    }());
     return globalPool;
 }
 
+/// @brief 実行器を指定しない読み込みAPIが使う実行器を設定する。
+/// @param executor 既定にする実行器。呼び出し元で寿命を保証すること。
+/// @note getInlineExecutor()を設定すると、共有ThreadPoolのスレッドは起動されない。
+export void setDefaultExecutor(Executor& executor) {
+    globalThreadPoolState().defaultExecutor.store(&executor, std::memory_order_release);
+}
+
+/// @brief 実行器を指定しない読み込みAPIが使う実行器を取得する。
+/// @return setDefaultExecutor()で設定した実行器。未設定の場合は共有ThreadPool。
+export Executor& getDefaultExecutor() {
+    if (Executor* executor = globalThreadPoolState().defaultExecutor.load(std::memory_order_acquire)) {
+        return *executor;
+    }
+    return getGlobalThreadPool();
+}
+
 }  // namespace rai::common
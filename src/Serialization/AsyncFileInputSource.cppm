@@ -0,0 +1,603 @@
+// @file AsyncFileInputSource.cppm
+// @brief 複数の読み込みを先に発行しておくファイル入力ソース（Linuxではio_uring、他はpread）。
+
+module;
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define RAI_HAS_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+export module rai.serialization.async_file_input_source;
+
+namespace rai::serialization {
+
+#if defined(RAI_HAS_IO_URING)
+/// @brief liburingを使わずにシステムコールで扱う、最小限のio_uringの投入・完了キュー。
+/// @note 1つのスレッドからだけ使う。投入キューの末尾と完了キューの先頭はこのスレッドだけが書く。
+class IoUringQueue {
+public:
+    IoUringQueue() = default;
+
+    ~IoUringQueue() {
+        close();
+    }
+
+    // コピー・ムーブ禁止（カーネルと共有する領域を保持するため）
+    IoUringQueue(const IoUringQueue&) = delete;
+    IoUringQueue& operator=(const IoUringQueue&) = delete;
+    IoUringQueue(IoUringQueue&&) = delete;
+    IoUringQueue& operator=(IoUringQueue&&) = delete;
+
+    /// @brief キューを作成する。
+    /// @param entries キューの深さ。
+    /// @return 作成できた場合はtrue。カーネルが対応していない、または禁止されている場合はfalse。
+    bool open(unsigned entries) {
+        io_uring_params params{};
+        const long fd = ::syscall(__NR_io_uring_setup, entries, &params);
+        if (fd < 0) {
+            return false;
+        }
+        ringFd_ = static_cast<int>(fd);
+        sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMap) {
+            sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+        }
+        sqRing_ = ::mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+            ringFd_, IORING_OFF_SQ_RING);
+        if (sqRing_ == MAP_FAILED) {
+            sqRing_ = nullptr;
+            close();
+            return false;
+        }
+        if (singleMap) {
+            cqRing_ = sqRing_;
+        } else {
+            cqRing_ = ::mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                ringFd_, IORING_OFF_CQ_RING);
+            if (cqRing_ == MAP_FAILED) {
+                cqRing_ = nullptr;
+                close();
+                return false;
+            }
+        }
+        sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = ::mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+            ringFd_, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            close();
+            return false;
+        }
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+        auto* sq = static_cast<std::byte*>(sqRing_);
+        auto* cq = static_cast<std::byte*>(cqRing_);
+        sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    /// @brief キューを破棄する。発行済みの読み込みは呼び出し元が全て回収しておくこと。
+    void close() {
+        if (sqes_ != nullptr) {
+            ::munmap(sqes_, sqesSize_);
+        }
+        if (cqRing_ != nullptr && cqRing_ != sqRing_) {
+            ::munmap(cqRing_, cqRingSize_);
+        }
+        if (sqRing_ != nullptr) {
+            ::munmap(sqRing_, sqRingSize_);
+        }
+        if (ringFd_ >= 0) {
+            ::close(ringFd_);
+        }
+        sqes_ = nullptr;
+        sqRing_ = cqRing_ = nullptr;
+        ringFd_ = -1;
+    }
+
+    /// @brief 読み込みを1つ発行する。
+    /// @param fd 読み込むファイル。
+    /// @param buffer 読み込み先。
+    /// @param size 読み込むbyte数。
+    /// @param offset ファイル内の読み込み位置。
+    /// @param userData 完了時に返される値。
+    /// @return 発行できた場合はtrue。
+    bool submitRead(int fd, void* buffer, unsigned size, std::uint64_t offset, std::uint64_t userData) {
+        const unsigned tail = *sqTail_;
+        const unsigned index = tail & sqMask_;
+        io_uring_sqe& sqe = sqes_[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READ;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<std::uint64_t>(buffer);
+        sqe.len = size;
+        sqe.off = offset;
+        sqe.user_data = userData;
+        sqArray_[index] = index;
+        // 投入キューの末尾は、エントリを書き終えてからカーネルへ公開する。
+        std::atomic_ref<unsigned>(*sqTail_).store(tail + 1, std::memory_order_release);
+        return enter(1, 0, 0) >= 0;
+    }
+
+    /// @brief 完了した読み込みを全て取り出す。
+    /// @param wait 完了がない場合に、1つ完了するまで待つ場合はtrue。
+    /// @param onComplete 完了毎に(userData, result)で呼ぶ関数。
+    /// @return 完了を取り出せた、または待つ必要がなかった場合はtrue。待機に失敗した場合はfalse。
+    template <typename Callback>
+    bool reap(bool wait, Callback&& onComplete) {
+        for (;;) {
+            unsigned head = *cqHead_;
+            const unsigned tail = std::atomic_ref<unsigned>(*cqTail_).load(std::memory_order_acquire);
+            if (head != tail) {
+                for (; head != tail; ++head) {
+                    const io_uring_cqe& cqe = cqes_[head & cqMask_];
+                    onComplete(cqe.user_data, cqe.res);
+                }
+                std::atomic_ref<unsigned>(*cqHead_).store(head, std::memory_order_release);
+                return true;
+            }
+            if (!wait) {
+                return true;
+            }
+            if (enter(0, 1, IORING_ENTER_GETEVENTS) < 0) {
+                return false;
+            }
+        }
+    }
+
+private:
+    /// @brief io_uring_enterを呼ぶ。割り込まれた場合はやり直す。
+    int enter(unsigned toSubmit, unsigned minComplete, unsigned flags) {
+        for (;;) {
+            const long result = ::syscall(__NR_io_uring_enter, ringFd_, toSubmit, minComplete, flags,
+                nullptr, 0);
+            if (result >= 0 || errno != EINTR) {
+                return static_cast<int>(result);
+            }
+        }
+    }
+
+    int ringFd_ = -1;                 ///< io_uringのファイル記述子。
+    void* sqRing_ = nullptr;          ///< 投入キューのリング領域。
+    void* cqRing_ = nullptr;          ///< 完了キューのリング領域。
+    std::size_t sqRingSize_ = 0;      ///< 投入キューのリング領域のbyte数。
+    std::size_t cqRingSize_ = 0;      ///< 完了キューのリング領域のbyte数。
+    io_uring_sqe* sqes_ = nullptr;    ///< 投入エントリの配列。
+    std::size_t sqesSize_ = 0;        ///< 投入エントリの配列のbyte数。
+    unsigned* sqTail_ = nullptr;      ///< 投入キューの末尾。
+    unsigned sqMask_ = 0;             ///< 投入キューの添字マスク。
+    unsigned* sqArray_ = nullptr;     ///< 投入キューの添字配列。
+    unsigned* cqHead_ = nullptr;      ///< 完了キューの先頭。
+    unsigned* cqTail_ = nullptr;      ///< 完了キューの末尾。
+    unsigned cqMask_ = 0;             ///< 完了キューの添字マスク。
+    io_uring_cqe* cqes_ = nullptr;    ///< 完了エントリの配列。
+};
+#endif
+
+}  // namespace rai::serialization
+
+export namespace rai::serialization {
+
+/// @brief AsyncFileInputSourceの読み込み方法。
+enum class AsyncFileBackend {
+    IoUring,  ///< io_uringで複数の読み込みを同時に発行する（Linux）。
+    Pread,    ///< 位置指定の同期読み込み（pread / ReadFile）。OSの先読みに任せる。
+};
+
+/// @brief AsyncFileInputSourceの設定。
+struct AsyncFileInputOptions {
+    /// @brief 1回の読み込みのbyte数。directIoの場合は4096の倍数に切り上げる。
+    std::size_t chunkSize = 64 * 1024;
+
+    /// @brief バッファの数（2以上）。消費中の1つを除いた数だけ、読み込みを先に発行しておく。
+    std::size_t queueDepth = 4;
+
+    /// @brief ページキャッシュを経由せずに読む（O_DIRECT / FILE_FLAG_NO_BUFFERING）。
+    /// @note ファイルシステムが対応していない場合は通常の読み込みに戻す。
+    bool directIo = false;
+
+    /// @brief 利用できる場合にio_uringを使う。falseの場合は常にpreadを使う。
+    bool useIoUring = true;
+};
+
+/// @brief ファイルの複数の区間への読み込みを先に発行し、完了した順に消費する入力ソース。
+/// @note 通し番号seqのバッファはファイルの[seq * chunkSize, (seq + 1) * chunkSize)を読む。
+///       各読み込みは互いに独立なので、io_uringでは消費中のバッファ以外の全てへ同時に読み込める。
+///       バッファの先頭maxReadingAhead byteには、切り替え時に直前のバッファの末尾を写す。
+/// @note 読み込みの発行と完了の回収は消費側のスレッドだけが行うため、ロックもスレッドも使わない。
+class AsyncFileInputSource {
+public:
+    /// @brief 先読みサイズ（byte）。
+    static constexpr std::size_t maxReadingAhead = 8;
+
+    /// @brief directIoの場合のバッファ・読み込み位置・サイズの境界（byte）。
+    static constexpr std::size_t directIoAlignment = 4096;
+
+    /// @brief ファイルを開いて、最初の読み込みを発行する。
+    /// @param filename 入力元のファイル名。
+    /// @param options 読み込みの設定。
+    AsyncFileInputSource(const std::string& filename, const AsyncFileInputOptions& options = {})
+        : filename_(filename), directIo_(options.directIo), queueDepth_(options.queueDepth),
+          slots_(options.queueDepth) {
+        if (queueDepth_ < 2) {
+            throw std::invalid_argument("queueDepth must be at least 2");
+        }
+        if (options.chunkSize <= maxReadingAhead) {
+            throw std::invalid_argument("chunkSize must be at least maxReadingAhead + 1");
+        }
+        openFile();
+        chunkSize_ = directIo_ ? roundUp(options.chunkSize, directIoAlignment) : options.chunkSize;
+
+        // どうしてこの実装にしたか：O_DIRECTでは読み込み先も境界に揃える必要があるため、
+        // 先頭の写し領域（maxReadingAhead byte）の直後が境界になるよう、各領域の前に余白を置く。
+        alignment_ = directIo_ ? directIoAlignment : 64;
+        lead_ = roundUp(maxReadingAhead, alignment_) - maxReadingAhead;
+        stride_ = roundUp(lead_ + maxReadingAhead + chunkSize_ + maxReadingAhead, alignment_);
+        try {
+            storage_ = static_cast<std::byte*>(
+                ::operator new(stride_ * queueDepth_, std::align_val_t{alignment_}));
+#if defined(RAI_HAS_IO_URING)
+            if (options.useIoUring && ring_.open(static_cast<unsigned>(queueDepth_))) {
+                backend_ = AsyncFileBackend::IoUring;
+            }
+#endif
+            for (std::size_t seq = 0; seq < queueDepth_; ++seq) {
+                submitRead(seq);
+            }
+            waitForRead(0);
+        } catch (...) {
+            release();
+            throw;
+        }
+        enterBuffer(0);
+        consumingPos_ = maxReadingAhead;  // 最初のバッファには写し領域の内容がない。
+    }
+
+    /// @brief デストラクタ。発行済みの読み込みの完了を待ってから、バッファを解放する。
+    ~AsyncFileInputSource() {
+        release();
+    }
+
+    // コピー・ムーブ禁止（カーネルがバッファへ書き込むため）
+    AsyncFileInputSource(const AsyncFileInputSource&) = delete;
+    AsyncFileInputSource& operator=(const AsyncFileInputSource&) = delete;
+    AsyncFileInputSource(AsyncFileInputSource&&) = delete;
+    AsyncFileInputSource& operator=(AsyncFileInputSource&&) = delete;
+
+    /// @brief 現在の絶対読み取り位置を返す。
+    /// @return 読み取り位置。
+    std::size_t position() const {
+        return position_;
+    }
+
+    /// @brief 先読みした文字を取得する。
+    /// @param offset 現在位置からのオフセット（maxReadingAhead未満）。
+    /// @return 指定位置の文字。入力の末尾以降は'\0'。
+    char peekAhead(std::size_t offset) const {
+        assert(offset < maxReadingAhead);
+        return current_[consumingPos_ + offset];
+    }
+
+    /// @brief 現在位置から、消費中のバッファで続けて読める範囲を返す。
+    /// @return 範囲。次にconsume()でバッファを切り替えるまで有効。
+    /// @note トークナイザーが文字列本体や空白の連続をこの範囲でまとめて走査するために使う。
+    std::string_view bufferedRun() const {
+        return std::string_view(current_ + consumingPos_, consumableSize_ - consumingPos_);
+    }
+
+    /// @brief 現在位置から指定された文字数だけ読み進める。
+    /// @param count 読み進める文字数。
+    /// @note 文字を取得する場合は、事前にpeekAhead()を呼び出すこと。
+    void consume(std::size_t count = 1) {
+        consumingPos_ += count;
+        position_ += count;
+        while (consumingPos_ >= consumableSize_ && !final_) {
+            consumingPos_ -= consumableSize_;
+            nextBuffer();
+        }
+        if (final_) {
+            // 末尾以降は番兵の'\0'を返し続ける。
+            consumingPos_ = std::min(consumingPos_, consumableSize_);
+        }
+    }
+
+    /// @brief 実際に使っている読み込み方法を返す。
+    /// @return io_uringを作成できた場合はIoUring、それ以外はPread。
+    AsyncFileBackend backend() const {
+        return backend_;
+    }
+
+    /// @brief ページキャッシュを経由せずに読んでいるかを返す。
+    /// @return O_DIRECTで開けた場合はtrue。
+    bool isDirectIo() const {
+        return directIo_;
+    }
+
+    /// @brief 開いた時点のファイルサイズを返す。
+    /// @return ファイルのbyte数。
+    std::size_t fileSize() const {
+        return fileSize_;
+    }
+
+private:
+    /// @brief 読み込みの状態。
+    enum class SlotState {
+        Idle,       ///< 読み込みを発行していない。
+        Submitted,  ///< io_uringへ発行済みで、完了を回収していない。
+        Queued,     ///< preadで読む予定（消費側が切り替える時に読む）。
+        Completed,  ///< 完了を回収済み。
+    };
+
+    /// @brief バッファ毎の読み込みの状態。
+    struct Slot {
+        std::size_t seq = 0;              ///< 読み込み中のバッファの通し番号。
+        SlotState state = SlotState::Idle;  ///< 読み込みの状態。
+        long long result = 0;             ///< 読み込んだbyte数、または負のエラー番号。
+    };
+
+    static std::size_t roundUp(std::size_t value, std::size_t unit) {
+        return (value + unit - 1) / unit * unit;
+    }
+
+    /// @brief バッファの先頭（写し領域の先頭）を取得する。
+    char* data(std::size_t seq) {
+        return reinterpret_cast<char*>(storage_ + (seq % queueDepth_) * stride_ + lead_);
+    }
+
+    /// @brief 通し番号seqの読み込みを発行する。ファイルの末尾より後ろは読まない。
+    void submitRead(std::size_t seq) {
+        if (seq != 0 && seq * chunkSize_ >= fileSize_) {
+            return;
+        }
+        Slot& slot = slots_[seq % queueDepth_];
+        slot.seq = seq;
+        slot.state = SlotState::Queued;
+#if defined(RAI_HAS_IO_URING)
+        if (backend_ == AsyncFileBackend::IoUring) {
+            if (ring_.submitRead(fd_, data(seq) + maxReadingAhead, static_cast<unsigned>(chunkSize_),
+                    seq * chunkSize_, seq)) {
+                slot.state = SlotState::Submitted;
+                ++inFlight_;
+            } else {
+                // 以降は発行せず、発行済みの分だけ回収する。
+                backend_ = AsyncFileBackend::Pread;
+            }
+        }
+#endif
+    }
+
+    /// @brief 通し番号seqの読み込みの完了を待ち、バッファの末尾を確定する。
+    void waitForRead(std::size_t seq) {
+        Slot& slot = slots_[seq % queueDepth_];
+        assert(slot.seq == seq && slot.state != SlotState::Idle);
+#if defined(RAI_HAS_IO_URING)
+        while (slot.state == SlotState::Submitted) {
+            if (!reapCompletions(true)) {
+                throw std::runtime_error("AsyncFileInputSource: Error waiting for file " + filename_);
+            }
+        }
+#endif
+        std::size_t bytesRead = 0;
+        if (slot.state == SlotState::Completed && slot.result >= 0) {
+            bytesRead = static_cast<std::size_t>(slot.result);
+        }
+        // どうしてこの実装にしたか：io_uringの読み込みは短く終わることや、古いカーネルでは
+        // 未対応で失敗することがあるため、足りない分はpreadで読み足す。
+        const std::size_t offset = seq * chunkSize_;
+        while (bytesRead < chunkSize_ && offset + bytesRead < fileSize_) {
+            const long long result = readAt(data(seq) + maxReadingAhead + bytesRead,
+                chunkSize_ - bytesRead, offset + bytesRead);
+            if (result < 0) {
+                throw std::runtime_error("AsyncFileInputSource: Error reading from file " + filename_);
+            }
+            if (result == 0) {
+                break;  // 読み込み中にファイルが短くなった。
+            }
+            bytesRead += static_cast<std::size_t>(result);
+        }
+        slot.state = SlotState::Completed;
+        // 開いた時点のサイズを入力の末尾とする。
+        bytesRead = std::min(bytesRead, fileSize_ > offset ? fileSize_ - offset : 0);
+        slot.result = static_cast<long long>(bytesRead);
+        if (offset + bytesRead >= fileSize_ || bytesRead < chunkSize_) {
+            std::fill_n(data(seq) + maxReadingAhead + bytesRead, maxReadingAhead, '\0');
+        }
+    }
+
+#if defined(RAI_HAS_IO_URING)
+    /// @brief 完了した読み込みを回収する。
+    /// @param wait 完了がない場合に待つ場合はtrue。
+    /// @return 待機に失敗した場合はfalse。
+    bool reapCompletions(bool wait) {
+        return ring_.reap(wait, [this](std::uint64_t seq, int result) {
+            Slot& slot = slots_[seq % queueDepth_];
+            if (slot.seq == seq && slot.state == SlotState::Submitted) {
+                slot.state = SlotState::Completed;
+                slot.result = result;
+            }
+            --inFlight_;
+        });
+    }
+#endif
+
+    /// @brief 読み込み済みの通し番号seqのバッファを消費対象にする。
+    void enterBuffer(std::size_t seq) {
+        const std::size_t bytesRead = static_cast<std::size_t>(slots_[seq % queueDepth_].result);
+        current_ = data(seq);
+        final_ = seq * chunkSize_ + bytesRead >= fileSize_ || bytesRead < chunkSize_;
+        // 末尾でなければ、最後のmaxReadingAhead byteは次のバッファの先頭で読む。
+        consumableSize_ = final_ ? maxReadingAhead + bytesRead : chunkSize_;
+    }
+
+    /// @brief 消費中のバッファを手放し、次のバッファに切り替える。
+    void nextBuffer() {
+        const std::size_t previous = consumingSeq_++;
+        waitForRead(consumingSeq_);
+        std::memcpy(data(consumingSeq_), data(previous) + chunkSize_, maxReadingAhead);
+        enterBuffer(consumingSeq_);
+        slots_[previous % queueDepth_].state = SlotState::Idle;
+        // 空いた領域には、queueDepth個先のバッファを読み込む。
+        submitRead(previous + queueDepth_);
+    }
+
+    /// @brief 位置を指定して同期的に読み込む。
+    /// @return 読み込んだbyte数。失敗した場合は負の値。
+    long long readAt(char* buffer, std::size_t size, std::size_t offset) {
+#if defined(_WIN32)
+        OVERLAPPED overlapped{};
+        overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFFu);
+        overlapped.OffsetHigh = static_cast<DWORD>(static_cast<std::uint64_t>(offset) >> 32);
+        DWORD bytesRead = 0;
+        if (!ReadFile(file_, buffer, static_cast<DWORD>(size), &bytesRead, &overlapped)) {
+            return GetLastError() == ERROR_HANDLE_EOF ? 0 : -1;
+        }
+        return static_cast<long long>(bytesRead);
+#else
+        for (;;) {
+            const ssize_t result = ::pread(fd_, buffer, size, static_cast<off_t>(offset));
+            if (result >= 0 || errno != EINTR) {
+                return static_cast<long long>(result);
+            }
+        }
+#endif
+    }
+
+    /// @brief ファイルを開き、サイズを取得して順次読みのヒントを与える。
+    void openFile() {
+#if defined(_WIN32)
+        const DWORD flags = FILE_FLAG_SEQUENTIAL_SCAN | (directIo_ ? FILE_FLAG_NO_BUFFERING : 0);
+        file_ = CreateFileA(filename_.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, flags, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE && directIo_) {
+            directIo_ = false;
+            file_ = CreateFileA(filename_.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        }
+        if (file_ == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("AsyncFileInputSource: Cannot open file " + filename_);
+        }
+        LARGE_INTEGER fileSize{};
+        if (!GetFileSizeEx(file_, &fileSize)) {
+            CloseHandle(file_);
+            file_ = INVALID_HANDLE_VALUE;
+            throw std::runtime_error("AsyncFileInputSource: Cannot get size of file " + filename_);
+        }
+        fileSize_ = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+#if defined(O_DIRECT)
+        if (directIo_) {
+            fd_ = ::open(filename_.c_str(), O_RDONLY | O_CLOEXEC | O_DIRECT);
+        }
+#endif
+        if (fd_ < 0) {
+            // O_DIRECTに対応していないファイルシステム（tmpfsなど）では通常の読み込みにする。
+            directIo_ = false;
+            fd_ = ::open(filename_.c_str(), O_RDONLY | O_CLOEXEC);
+        }
+        if (fd_ < 0) {
+            throw std::runtime_error("AsyncFileInputSource: Cannot open file " + filename_);
+        }
+        struct stat status{};
+        if (::fstat(fd_, &status) != 0) {
+            ::close(fd_);
+            fd_ = -1;
+            throw std::runtime_error("AsyncFileInputSource: Cannot get size of file " + filename_);
+        }
+        fileSize_ = static_cast<std::size_t>(status.st_size);
+#if defined(POSIX_FADV_SEQUENTIAL)
+        // 先頭から順に読むことをカーネルへ伝え、preadでも先読みを積極的にさせる。
+        ::posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+#endif
+    }
+
+    /// @brief 発行済みの読み込みを回収してから、ファイルとバッファを解放する。
+    void release() {
+#if defined(RAI_HAS_IO_URING)
+        // カーネルが書き込み中のバッファを解放しないよう、全ての完了を回収する。
+        while (inFlight_ > 0 && reapCompletions(true)) {
+        }
+        ring_.close();
+#endif
+#if defined(_WIN32)
+        if (file_ != INVALID_HANDLE_VALUE) {
+            CloseHandle(file_);
+        }
+        file_ = INVALID_HANDLE_VALUE;
+#else
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+        fd_ = -1;
+#endif
+        if (storage_ != nullptr) {
+            ::operator delete(storage_, std::align_val_t{alignment_});
+        }
+        storage_ = nullptr;
+    }
+
+    std::string filename_;          ///< エラーメッセージ用のファイル名。
+    bool directIo_;                 ///< O_DIRECTで開いたフラグ。
+    std::size_t queueDepth_;        ///< バッファの数。
+    std::size_t chunkSize_ = 0;     ///< 1回の読み込みのbyte数。
+    std::size_t fileSize_ = 0;      ///< 開いた時点のファイルサイズ。
+    std::size_t alignment_ = 0;     ///< 領域の配置境界(byte)。
+    std::size_t lead_ = 0;          ///< 各領域の先頭の余白(byte)。
+    std::size_t stride_ = 0;        ///< バッファ1つ分の領域(byte)。
+    std::byte* storage_ = nullptr;  ///< 全バッファの領域。
+    std::vector<Slot> slots_;       ///< バッファ毎の読み込みの状態。
+    AsyncFileBackend backend_ = AsyncFileBackend::Pread;  ///< 読み込み方法。
+
+    const char* current_ = nullptr;   ///< 消費中のバッファの先頭。
+    std::size_t consumingSeq_ = 0;    ///< 消費中のバッファの通し番号。
+    std::size_t consumingPos_ = 0;    ///< 消費中のバッファ内の現在位置。
+    std::size_t consumableSize_ = 0;  ///< 消費中のバッファで消費できる位置の上限。
+    bool final_ = false;              ///< 消費中のバッファが入力の末尾を含むフラグ。
+    std::size_t position_ = 0;        ///< 入力全体での読み取り位置。
+
+#if defined(_WIN32)
+    HANDLE file_ = INVALID_HANDLE_VALUE;  ///< ファイルハンドル。
+#else
+    int fd_ = -1;                   ///< ファイル記述子。
+#endif
+#if defined(RAI_HAS_IO_URING)
+    IoUringQueue ring_;             ///< 読み込みの投入・完了キュー。
+    std::size_t inFlight_ = 0;      ///< 完了を回収していない読み込みの数。
+#endif
+};
+
+}  // namespace rai::serialization
@@ -87,6 +87,12 @@ struct SingleValueFieldOmitBehavior {
         outValue = defaultValue;
     }
 
+    /// @brief 欠落を検証する（既定値を代入するため常に受け入れる）。
+    /// @param key 対象キー名
+    void validateMissing(std::string_view key) const {
+        (void)key;
+    }
+
     Value defaultValue{};  ///< 省略判定と欠落時代入に使う値
 };
 
@@ -109,6 +115,12 @@ struct NoDefaultFieldOmitBehavior {
         (void)outValue;
         (void)key;
     }
+
+    /// @brief 欠落を検証する（何も行わないため常に受け入れる）。
+    /// @param key 対象キー名
+    void validateMissing(std::string_view key) const {
+        (void)key;
+    }
 };
 
 /// @brief 読み込み時省略では例外を送出し、常時書き出しす省略時挙動。
@@ -128,6 +140,12 @@ struct RequiredFieldOmitBehavior {
     /// @param key 対象キー名
     void applyMissing(Value& outValue, std::string_view key) const {
         (void)outValue;
+        validateMissing(key);
+    }
+
+    /// @brief 欠落を検証する（例外を送出する）。
+    /// @param key 対象キー名
+    void validateMissing(std::string_view key) const {
         throw std::runtime_error(
             std::string("JsonParser: missing required key '") +
             std::string(key) + "'");
@@ -176,15 +194,36 @@ struct FieldSerializer {
         owner.*member = converter_.get().read(parser);
     }
 
+    /// @brief 値を構築せずに、JSONの値がこのフィールドに読み込めるかを検証する。
+    /// @param parser 読み取り元の FormatReader
+    void validate(FormatReader& parser) const {
+        validateWithConverter(converter_.get(), parser);
+    }
+
     /// @brief JSON項目（キーと値）を書き出す。
-    /// @param writer 書き込み先の FormatWriter
+    /// @param writer 書き込み先の書き込み型（FormatWriter、RaiBinaryWriterなど）
     /// @param owner 書き出し元の所有者
-    void write(FormatWriter& writer, const Owner& owner) const {
+    template <IsFormatWriter Writer>
+    void write(Writer& writer, const Owner& owner) const {
         const auto& value = owner.*member;
         if (omittedBehavior_.shouldSkipWrite(value)) {
             return;
         }
         writer.key(key);
+        writeWithConverter(converter_.get(), writer, value);
+    }
+
+    /// @brief JSON項目（整形済みキーと値）を書き出す。
+    /// @param writer 書き込み先の FormatWriter
+    /// @param owner 書き出し元の所有者
+    /// @param preparedKey FormatWriter::prepareKey(key)で整形したキー
+    void write(FormatWriter& writer, const Owner& owner,
+        const FormatWriter::PreparedKey& preparedKey) const {
+        const auto& value = owner.*member;
+        if (omittedBehavior_.shouldSkipWrite(value)) {
+            return;
+        }
+        writer.key(preparedKey);
         converter_.get().write(writer, value);
     }
 
@@ -194,6 +233,18 @@ struct FieldSerializer {
         omittedBehavior_.applyMissing(owner.*member, key);
     }
 
+    /// @brief 欠落が許されるかを検証する（許されない場合は例外を送出する）。
+    /// @note validateMissing()を持たない省略時挙動は、一時的な値へapplyMissing()を適用して確かめる。
+    void validateMissing() const {
+        if constexpr (requires { omittedBehavior_.validateMissing(std::string_view(key)); }) {
+            omittedBehavior_.validateMissing(key);
+        }
+        else if constexpr (std::default_initializable<Value>) {
+            Value scratch{};
+            omittedBehavior_.applyMissing(scratch, key);
+        }
+    }
+
     MemberPtr member{};                               ///< メンバポインタ
     const char* key{};                                    ///< JSONキー名
 private:
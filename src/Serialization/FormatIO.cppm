@@ -2,6 +2,11 @@
 /// @brief 既定フォーマットのReader/Writer型を束ねる。
 
 module;
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string_view>
 
 export module rai.serialization.format_io;
 
@@ -20,4 +25,117 @@ using FormatReader = JsonParser;
 /// @brief 既定フォーマットのトークン種別。
 using FormatTokenType = JsonTokenType;
 
+// ******************************************************************************** 書き込み型の条件
+
+/// @brief 変換器の書き出し先として使える書き込み型を表すconcept。
+/// @tparam Writer 判定対象の型（JsonWriter、RaiBinaryWriterなど）。
+/// @note 変換器のwrite()は書き込み型をテンプレート引数に取るため、この操作だけを使う。
+template <typename Writer>
+concept IsFormatWriter = requires(Writer& writer, std::string_view text) {
+    writer.startObject();
+    writer.endObject();
+    writer.startArray();
+    writer.endArray();
+    writer.key(text);
+    writer.null();
+    writer.writeObject(true);
+    writer.writeObject(std::int64_t{});
+    writer.writeObject(std::uint64_t{});
+    writer.writeObject(double{});
+    writer.writeObject(text);
+};
+
+// ******************************************************************************** 型消去した書き込み型
+
+/// @brief 書き込み型を型消去した基底クラス。
+/// @note serializer()がObjectSerializer&を返す型は具体的なフィールド集合の型が分からないため、
+///       FormatWriter以外へ書き出す時はこのクラスを介して仮想関数で書き出す。
+class AnyFormatWriter {
+public:
+    virtual ~AnyFormatWriter() = default;
+
+    virtual void startObject() = 0;
+    virtual void endObject() = 0;
+    virtual void startArray() = 0;
+    virtual void endArray() = 0;
+    virtual void key(std::string_view keyName) = 0;
+    virtual void null() = 0;
+    virtual void writeObject(bool value) = 0;
+    virtual void writeObject(char value) = 0;
+    virtual void writeObject(signed char value) = 0;
+    virtual void writeObject(unsigned char value) = 0;
+    virtual void writeObject(char8_t value) = 0;
+    virtual void writeObject(char16_t value) = 0;
+    virtual void writeObject(char32_t value) = 0;
+    virtual void writeObject(wchar_t value) = 0;
+    virtual void writeObject(short value) = 0;
+    virtual void writeObject(unsigned short value) = 0;
+    virtual void writeObject(int value) = 0;
+    virtual void writeObject(unsigned int value) = 0;
+    virtual void writeObject(long value) = 0;
+    virtual void writeObject(unsigned long value) = 0;
+    virtual void writeObject(long long value) = 0;
+    virtual void writeObject(unsigned long long value) = 0;
+    virtual void writeObject(float value) = 0;
+    virtual void writeObject(double value) = 0;
+    virtual void writeObject(long double value) = 0;
+    virtual void writeObject(std::string_view value) = 0;
+
+    /// @brief FormatWriterだけに対応するコンバータの出力を書き込む。
+    /// @param write 一時的なFormatWriterへ値を1つ書き出す関数。
+    /// @note 既定ではstd::runtime_errorを送出する。JsonSizeCounterのように
+    ///       JSONの出力から結果を求められる書き込み型だけが対応する。
+    virtual void writeViaJsonWriter(const std::function<void(FormatWriter&)>& write) {
+        (void)write;
+        throw std::runtime_error("AnyFormatWriter: converter does not support this writer");
+    }
+};
+
+/// @brief 書き込み型をAnyFormatWriterとして使うためのアダプター。
+/// @tparam Writer 包む書き込み型。
+template <IsFormatWriter Writer>
+class FormatWriterAdapter final : public AnyFormatWriter {
+public:
+    /// @brief 包む書き込み型を指定して構築する。
+    /// @param writer 書き込み先。本オブジェクトより長く存在すること。
+    explicit FormatWriterAdapter(Writer& writer) : writer_(writer) {}
+
+    void startObject() override { writer_.startObject(); }
+    void endObject() override { writer_.endObject(); }
+    void startArray() override { writer_.startArray(); }
+    void endArray() override { writer_.endArray(); }
+    void key(std::string_view keyName) override { writer_.key(keyName); }
+    void null() override { writer_.null(); }
+    void writeObject(bool value) override { writer_.writeObject(value); }
+    void writeObject(char value) override { writer_.writeObject(value); }
+    void writeObject(signed char value) override { writer_.writeObject(value); }
+    void writeObject(unsigned char value) override { writer_.writeObject(value); }
+    void writeObject(char8_t value) override { writer_.writeObject(value); }
+    void writeObject(char16_t value) override { writer_.writeObject(value); }
+    void writeObject(char32_t value) override { writer_.writeObject(value); }
+    void writeObject(wchar_t value) override { writer_.writeObject(value); }
+    void writeObject(short value) override { writer_.writeObject(value); }
+    void writeObject(unsigned short value) override { writer_.writeObject(value); }
+    void writeObject(int value) override { writer_.writeObject(value); }
+    void writeObject(unsigned int value) override { writer_.writeObject(value); }
+    void writeObject(long value) override { writer_.writeObject(value); }
+    void writeObject(unsigned long value) override { writer_.writeObject(value); }
+    void writeObject(long long value) override { writer_.writeObject(value); }
+    void writeObject(unsigned long long value) override { writer_.writeObject(value); }
+    void writeObject(float value) override { writer_.writeObject(value); }
+    void writeObject(double value) override { writer_.writeObject(value); }
+    void writeObject(long double value) override { writer_.writeObject(value); }
+    void writeObject(std::string_view value) override { writer_.writeObject(value); }
+    void writeViaJsonWriter(const std::function<void(FormatWriter&)>& write) override {
+        if constexpr (requires { writer_.writeViaJsonWriter(write); }) {
+            writer_.writeViaJsonWriter(write);
+        } else {
+            AnyFormatWriter::writeViaJsonWriter(write);
+        }
+    }
+
+private:
+    Writer& writer_;  ///< 書き込み先。
+};
+
 }  // namespace rai::serialization
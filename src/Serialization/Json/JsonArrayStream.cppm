@@ -0,0 +1,257 @@
+// @file JsonArrayStream.cppm
+// @brief トップレベルの配列を、要素を1つずつ読みながら処理するための読み込みストリーム。
+
+module;
+#include <cstddef>
+#include <exception>
+#include <fstream>
+#include <future>
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+export module rai.serialization.json_array_stream;
+
+import rai.serialization.object_converter;
+import rai.serialization.json_io;
+import rai.serialization.json_parser;
+import rai.serialization.json_tokenizer;
+import rai.serialization.token_manager;
+import rai.serialization.ring_buffer_token_manager;
+import rai.serialization.parallel_input_stream_source;
+import rai.common.thread_pool;
+
+export namespace rai::serialization {
+
+/// @brief トップレベルの配列の要素を、1つずつ読み込んで取り出すストリーム。
+/// @tparam T 要素の型（HasSerializerを実装したオブジェクト）。
+/// @note 配列全体を構築せず、読み込み先の要素オブジェクト1つを使い回すため、
+///       ログのような巨大な配列も一定のメモリで処理できる。
+/// @note 実行器にスレッドがある場合、ファイルの読み込みとトークン化を実行器で行い、
+///       呼び出し側のスレッドでの要素の読み込み・処理とパイプラインで進める。
+///       InlineExecutorの場合と、実行器のワーカーから構築した場合は、構築時に全体をトークン化するため、
+///       トークン列の分のメモリを使う。
+/// @note 要素オブジェクトは使い回すため、InitialOmittedのフィールドが省略された場合は
+///       前の要素の値が残る。要素毎に初期化が必要なら、次を読む前に呼び出し側で初期化すること。
+template <HasSerializer T>
+class JsonArrayStream {
+public:
+    /// @brief 要素を順に取り出す入力イテレーター。
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+
+        /// @brief 現在の要素を返す。
+        T& operator*() const { return stream_->current(); }
+        T* operator->() const { return &stream_->current(); }
+
+        /// @brief 次の要素を読み込む。
+        iterator& operator++() {
+            stream_->next();
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        /// @brief 配列の終端に達したかを判定する。
+        friend bool operator==(const iterator& it, std::default_sentinel_t) {
+            return it.isEnd();
+        }
+
+    private:
+        friend class JsonArrayStream;
+        explicit iterator(JsonArrayStream* stream) : stream_(stream) {}
+
+        /// @brief 指す要素がないかを返す。
+        bool isEnd() const { return stream_ == nullptr || !stream_->hasCurrent_; }
+
+        JsonArrayStream* stream_ = nullptr;  ///< 読み込み元のストリーム。
+    };
+
+    /// @brief ファイルを開き、配列の先頭まで読み進める。
+    /// @param filename 入力元のファイル名。
+    /// @param executor ファイルの読み込みとトークン化に使う実行器。
+    explicit JsonArrayStream(const std::string& filename,
+        rai::common::Executor& executor = rai::common::getDefaultExecutor())
+        : JsonArrayStream(openFile(filename), executor) {}
+
+    /// @brief ストリームから読み込み、配列の先頭まで読み進める。
+    /// @param stream 入力ストリーム。本オブジェクトより長く存在すること。
+    /// @param executor ストリームの読み込みとトークン化に使う実行器。
+    explicit JsonArrayStream(std::istream& stream,
+        rai::common::Executor& executor = rai::common::getDefaultExecutor())
+        : JsonArrayStream(nullptr, &stream, executor) {}
+
+    /// @brief デストラクタ。読み終える前に破棄された場合は、トークン化を中断して待つ。
+    ~JsonArrayStream() {
+        finish();
+    }
+
+    // コピー・ムーブ禁止（トークナイザーが内部のメンバーを参照するため）
+    JsonArrayStream(const JsonArrayStream&) = delete;
+    JsonArrayStream& operator=(const JsonArrayStream&) = delete;
+    JsonArrayStream(JsonArrayStream&&) = delete;
+    JsonArrayStream& operator=(JsonArrayStream&&) = delete;
+
+    // ******************************************************************************** 読み進め
+    /// @brief 次の要素をcurrent()へ読み込む。
+    /// @return 読み込めればtrue。配列の終端に達した場合はfalse。
+    /// @note 読み込みに失敗した場合は例外を送出し、以降はfalseを返す。
+    bool next() {
+        started_ = true;
+        if (finished_) {
+            return hasCurrent_ = false;
+        }
+        try {
+            if (parser_.nextIsEndArray()) {
+                parser_.endArray();
+                if (parser_.nextTokenType() != JsonTokenType::EndOfStream) {
+                    throw std::runtime_error("JsonArrayStream: unexpected content after array");
+                }
+                finish();
+                rethrowTokenizerError();
+                return hasCurrent_ = false;
+            }
+            // 未知キーは要素毎に区切る。蓄積すると、メモリ使用量が配列全体の大きさに比例してしまう。
+            parser_.clearUnknownKeys();
+            readJsonObject(parser_, current_);
+        } catch (...) {
+            hasCurrent_ = false;
+            finish();
+            throw;
+        }
+        // どうしてこの実装にしたか：ストリーム入力の文字列は全て文字列アリーナに置かれるため、
+        // 読み終えた要素の文字列を解放しないと、メモリ使用量が配列全体の大きさに比例してしまう。
+        parser_.releaseConsumedStrings();
+        unknownKeyCount_ += parser_.unknownKeys().size();
+        ++count_;
+        return hasCurrent_ = true;
+    }
+
+    /// @brief 先頭の要素を読み込んだイテレーターを返す。
+    /// @note 既にnext()で読み進めている場合は、現在の要素を指すイテレーターを返す。
+    iterator begin() {
+        if (!started_) {
+            next();
+        }
+        return iterator(this);
+    }
+
+    /// @brief 配列の終端を表す番兵を返す。
+    std::default_sentinel_t end() const { return std::default_sentinel; }
+
+    // ******************************************************************************** 状態の取得
+    /// @brief 最後に読み込んだ要素を返す。
+    T& current() { return current_; }
+
+    /// @brief これまでに読み込んだ要素の数を返す。
+    std::size_t count() const { return count_; }
+
+    /// @brief 最後に読み込んだ要素で見つかった未知キーの一覧を返す。
+    /// @note next()で次の要素を読み込むと破棄される。全要素分が必要なら呼び出し側で蓄積すること。
+    const std::vector<std::string>& unknownKeys() const { return parser_.unknownKeys(); }
+
+    /// @brief これまでに読み込んだ全要素で見つかった未知キーの数を返す。
+    std::size_t unknownKeyCount() const { return unknownKeyCount_; }
+
+private:
+    /// @brief ファイルを開く。
+    /// @param filename 入力元のファイル名。
+    /// @return 開いたファイル。
+    static std::unique_ptr<std::ifstream> openFile(const std::string& filename) {
+        auto file = std::make_unique<std::ifstream>(filename, std::ios::binary);
+        if (!file->is_open()) {
+            throw std::runtime_error("JsonArrayStream: Cannot open file " + filename);
+        }
+        return file;
+    }
+
+    /// @brief 開いたファイルを所有して構築する。
+    JsonArrayStream(std::unique_ptr<std::ifstream> file, rai::common::Executor& executor)
+        : JsonArrayStream(std::move(file), nullptr, executor) {}
+
+    /// @brief 入力を準備し、トークン化を始めて配列の先頭まで読み進める。
+    /// @param file 所有するファイル（ストリームを借りる場合はnullptr）。
+    /// @param stream 借りる入力ストリーム（ファイルを所有する場合はnullptr）。
+    /// @param executor 読み込みとトークン化に使う実行器。
+    JsonArrayStream(std::unique_ptr<std::ifstream> file, std::istream* stream,
+        rai::common::Executor& executor)
+        : file_(std::move(file)),
+          executor_(executor),
+          pipelined_(executor.getThreadCount() > 0 && !executor.isWorkerThread()),
+          input_(stream != nullptr ? *stream : *file_, getJsonFileReadPolicy().bufferOptions, executor),
+          tokenizer_(input_, ringTokens_, warningOutput_),
+          parser_(pipelined_ ? static_cast<TokenSource&>(ringTokens_) : tokens_, executor) {
+        if (pipelined_) {
+            tokenizerFuture_ = executor_.enqueue([this]() {
+                try {
+                    tokenizer_.tokenize();
+                } catch (...) {
+                    auto error = std::current_exception();
+                    ringTokens_.signalError(error);
+                    std::lock_guard<std::mutex> lock(tokenizerErrorMutex_);
+                    tokenizerError_ = std::move(error);
+                }
+            });
+        } else {
+            // 有界なリングバッファでは、同じスレッドでトークン化とパースを交互に進められない。
+            // 実行器のワーカーから構築した場合も、トークン化のタスクが自分のキューに積まれたまま
+            // 待つことになり得るため、先に全てトークン化する。
+            JsonTokenizer<ParallelInputStreamSource, TokenManager> tokenizer(
+                input_, tokens_, warningOutput_);
+            tokenizer.tokenize();
+        }
+        try {
+            parser_.startArray();
+        } catch (...) {
+            finish();
+            throw;
+        }
+    }
+
+    /// @brief トークン化を中断し、完了を待つ。
+    void finish() {
+        finished_ = true;
+        if (tokenizerFuture_.valid()) {
+            // リングバッファは有界なので、空き待ちのトークナイザーを解放してから待機する。
+            ringTokens_.close();
+            executor_.wait(tokenizerFuture_);
+        }
+    }
+
+    /// @brief トークナイザーで発生した例外があれば再送出する。
+    void rethrowTokenizerError() {
+        std::lock_guard<std::mutex> lock(tokenizerErrorMutex_);
+        if (tokenizerError_) {
+            std::rethrow_exception(tokenizerError_);
+        }
+    }
+
+    std::unique_ptr<std::ifstream> file_;  ///< 所有するファイル（ストリームを借りる場合はnullptr）。
+    rai::common::Executor& executor_;      ///< 読み込みとトークン化に使う実行器。
+    const bool pipelined_;                 ///< トークン化を実行器で並行して行うフラグ。
+    ParallelInputStreamSource input_;      ///< 先読みする入力ソース。
+    RingBufferTokenManager ringTokens_;    ///< 並行時のトークン受け渡し先。
+    TokenManager tokens_;                  ///< 一括でトークン化する場合のトークン列。
+    StdoutMessageOutput warningOutput_;    ///< トークナイザーの警告出力先。
+    JsonTokenizer<ParallelInputStreamSource, RingBufferTokenManager> tokenizer_;  ///< 並行時のトークナイザー。
+    JsonParser parser_;                    ///< 要素を読み込むパーサー。
+    std::future<void> tokenizerFuture_;    ///< トークン化タスクの完了通知。
+    std::mutex tokenizerErrorMutex_;       ///< tokenizerError_を保護するミューテックス。
+    std::exception_ptr tokenizerError_;    ///< トークナイザーで発生した例外。
+    T current_{};                          ///< 使い回す要素オブジェクト。
+    std::size_t count_ = 0;                ///< 読み込んだ要素の数。
+    std::size_t unknownKeyCount_ = 0;      ///< 読み込んだ全要素の未知キーの数。
+    bool started_ = false;                 ///< next()を呼んだことがあるフラグ。
+    bool hasCurrent_ = false;              ///< current_が有効な要素を保持しているフラグ。
+    bool finished_ = false;                ///< トークン化を終了したフラグ。
+};
+
+}  // namespace rai::serialization
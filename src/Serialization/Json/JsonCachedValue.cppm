@@ -0,0 +1,99 @@
+// @file JsonCachedValue.cppm
+// @brief 書き出したJSONを保持し、変更がなければ次の書き出しで再利用する値のラッパー。
+
+module;
+#include <concepts>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+export module rai.serialization.json_cached_value;
+
+import rai.serialization.format_io;
+import rai.serialization.object_converter;
+import rai.serialization.json_writer;
+import rai.serialization.json_parser;
+
+export namespace rai::serialization {
+
+/// @brief 書き出したJSONを保持し、変更がなければ次の書き出しで再利用する値のラッパー。
+/// @tparam T 保持する値の型（getConverter<T>()で変換できる型）。
+/// @note 大きな文書の一部だけを変更して繰り返し書き出す場合に、フィールドやコンテナの要素の型を
+///       JsonCachedValue<T>にすると、変更されていない部分は前回の出力をそのまま書き込む。
+///       入れ子にすると、変更した要素を含む経路だけを書き出し直す。
+/// @note 値はmodify()を通してだけ変更でき、呼ぶと保持している出力を破棄する。
+///       modify()の戻り値を保持しておき、書き出した後で変更しないこと。
+/// @note 出力を保持するのはJsonWriterへの書き出しのみ。他の書き込み型には毎回書き出す。
+///       書き出しで保持している出力を更新するため、同じ値を複数のスレッドから同時に書き出さないこと。
+template <typename T>
+class JsonCachedValue {
+public:
+    using value_type = T;
+
+    JsonCachedValue() = default;
+
+    /// @brief 値を指定して構築する。
+    /// @param value 保持する値。
+    explicit JsonCachedValue(T value) : value_(std::move(value)) {}
+
+    /// @brief 値を取得する。
+    const T& get() const { return value_; }
+    const T& operator*() const { return value_; }
+    const T* operator->() const { return &value_; }
+
+    /// @brief 値を変更するために取得し、保持している出力を破棄する。
+    /// @return 値への参照。
+    T& modify() {
+        cached_ = false;
+        return value_;
+    }
+
+    /// @brief 値を置き換え、保持している出力を破棄する。
+    /// @param value 新しい値。
+    JsonCachedValue& operator=(T value) {
+        value_ = std::move(value);
+        cached_ = false;
+        return *this;
+    }
+
+    /// @brief 前回の出力を保持しているかを返す。
+    /// @return 次のJsonWriterへの書き出しで前回の出力を再利用するならtrue。
+    bool cached() const { return cached_; }
+
+    /// @brief 値を書き出す。
+    /// @tparam Writer 書き込み型。
+    /// @param writer 書き込み先。
+    template <IsFormatWriter Writer>
+    void writeFormat(Writer& writer) const {
+        if constexpr (std::same_as<Writer, JsonWriter>) {
+            if (!cached_) {
+                // どうしてこの実装にしたか：出力は書き込み先の状態（カンマの有無）に依らないよう、
+                // 一時的なJsonWriterで値1つ分を書き出して保持し、writeRawElementsで繋ぐ。
+                json_.clear();
+                {
+                    JsonWriter scratch(json_);
+                    scratch.setExecutor(writer.executor());
+                    writeWithConverter(getConverter<T>(), scratch, value_);
+                }
+                cached_ = true;
+            }
+            writer.writeRawElements(json_);
+        } else {
+            writeWithConverter(getConverter<T>(), writer, value_);
+        }
+    }
+
+    /// @brief 値を読み込み、保持している出力を破棄する。
+    /// @param parser 読み取り元。
+    void readFormat(FormatReader& parser) {
+        value_ = getConverter<T>().read(parser);
+        cached_ = false;
+    }
+
+private:
+    T value_{};                   ///< 保持する値。
+    mutable std::string json_;    ///< 前回書き出したJSON。
+    mutable bool cached_ = false; ///< json_がvalue_の現在の内容を表すならtrue。
+};
+
+}  // namespace rai::serialization
@@ -0,0 +1,513 @@
+// @file JsonChunkedTokenizer.cppm
+// @brief 連続領域の入力を複数の区間に分け、並列にトークン化してから順に連結する。
+
+module;
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <future>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+export module rai.serialization.json_chunked_tokenizer;
+
+import rai.serialization.token_manager;
+import rai.serialization.json_tokenizer;
+import rai.serialization.simd_scanner;
+import rai.common.thread_pool;
+
+export namespace rai::serialization {
+
+// ******************************************************************************** 字句状態の走査
+/// @brief 入力位置が文字列・コメントの内側か外側かを表す状態。
+enum class LexicalState {
+    Outside,       ///< 文字列・コメントの外側
+    DoubleQuoted,  ///< "で始まる文字列の内側
+    SingleQuoted,  ///< 'で始まる文字列の内側
+    LineComment,   ///< 単一行コメントの内側
+    BlockComment   ///< 複数行コメントの内側
+};
+
+/// @brief 区間の先頭を文字列・コメントの外側と仮定して走査し、区間末尾での状態を返す。
+/// @param data 区間の先頭。
+/// @param size 区間のbyte数。
+/// @return 区間末尾での状態。
+/// @note どうしてこの実装にしたか：区切り位置が文字列・コメントの内側かどうかは、
+///       直前の区間を外側から走査した末尾の状態で確定する。引用符とエスケープの対応だけを
+///       追うためトークン化より軽く、各区間のトークン化と同じタスクで並列に実行できる。
+LexicalState scanLexicalState(const char* data, std::size_t size) {
+    const simd::ScannerTable& scanner = simd::activeScanner();
+    LexicalState state = LexicalState::Outside;
+    std::size_t i = 0;
+    while (i < size) {
+        switch (state) {
+        case LexicalState::Outside: {
+            const char c = data[i++];
+            if (c == '"') {
+                state = LexicalState::DoubleQuoted;
+            } else if (c == '\'') {
+                state = LexicalState::SingleQuoted;
+            } else if (c == '/' && i < size) {
+                if (data[i] == '/') {
+                    state = LexicalState::LineComment;
+                    ++i;
+                } else if (data[i] == '*') {
+                    state = LexicalState::BlockComment;
+                    ++i;
+                }
+            }
+            break;
+        }
+        case LexicalState::DoubleQuoted:
+        case LexicalState::SingleQuoted: {
+            const char quote = state == LexicalState::DoubleQuoted ? '"' : '\'';
+            i += scanner.stringRun(data + i, size - i, quote);
+            if (i >= size) {
+                break;
+            }
+            if (data[i] == quote) {
+                state = LexicalState::Outside;
+                ++i;
+            } else if (data[i] == '\\') {
+                i += 2;  // エスケープされた文字は引用符として扱わない。
+            } else {
+                ++i;  // 0xE2や制御文字は文字列の内容なので読み進める。
+            }
+            break;
+        }
+        case LexicalState::LineComment: {
+            i += scanner.lineCommentRun(data + i, size - i);
+            if (i >= size) {
+                break;
+            }
+            const unsigned char c = static_cast<unsigned char>(data[i]);
+            if (c == '\n' || c == '\r' ||
+                (c == 0xE2 && i + 2 < size && static_cast<unsigned char>(data[i + 1]) == 0x80 &&
+                 (static_cast<unsigned char>(data[i + 2]) == 0xA8 ||
+                  static_cast<unsigned char>(data[i + 2]) == 0xA9))) {
+                state = LexicalState::Outside;
+            }
+            ++i;
+            break;
+        }
+        case LexicalState::BlockComment: {
+            const void* found = std::memchr(data + i, '*', size - i);
+            if (found == nullptr) {
+                i = size;
+                break;
+            }
+            i = static_cast<const char*>(found) - data + 1;
+            if (i < size && data[i] == '/') {
+                state = LexicalState::Outside;
+                ++i;
+            }
+            break;
+        }
+        }
+    }
+    return state;
+}
+
+/// @brief 空白（' ', '\t', '\n', '\r'）かを判定する。
+constexpr bool isChunkSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/// @brief カンマが要素の区切り「}, {」「], [」の形になっているかを判定する。
+/// @param data 入力の先頭。
+/// @param size 入力のbyte数。
+/// @param comma カンマの位置。
+/// @note 文字列やコメント内のカンマがこの形になることは少ないため、区切り位置として優先する。
+bool isElementSeparator(const char* data, std::size_t size, std::size_t comma) {
+    std::size_t before = comma;
+    while (before > 0 && isChunkSpace(data[before - 1])) {
+        --before;
+    }
+    std::size_t after = comma + 1;
+    while (after < size && isChunkSpace(data[after])) {
+        ++after;
+    }
+    return before > 0 && after < size &&
+        (data[before - 1] == '}' || data[before - 1] == ']') &&
+        (data[after] == '{' || data[after] == '[');
+}
+
+/// @brief 入力を区切る位置を選ぶ。
+/// @param data 入力の先頭。
+/// @param size 入力のbyte数。
+/// @param chunkCount 区間数の上限。
+/// @return 各区間の先頭位置と、末尾のsizeを並べた配列（要素数は区間数+1）。
+/// @note 等分位置から後ろのカンマの直後を区切りとする。カンマの直後はトークンの境界になるため、
+///       区切り位置が文字列・コメントの外側であれば各区間を独立にトークン化できる。
+///       次の等分位置までに要素の区切りの形のカンマがあればそれを、なければ最初のカンマを選ぶ。
+std::vector<std::size_t> findChunkBoundaries(const char* data, std::size_t size,
+    std::size_t chunkCount) {
+    std::vector<std::size_t> boundaries{0};
+    const std::size_t step = size / chunkCount;
+    for (std::size_t k = 1; k < chunkCount; ++k) {
+        const std::size_t target = std::max(step * k, boundaries.back());
+        const std::size_t limit = std::min(target + step, size);
+        std::size_t firstComma = size;
+        std::size_t chosen = size;
+        for (std::size_t pos = target; pos < limit; ++pos) {
+            const void* found = std::memchr(data + pos, ',', limit - pos);
+            if (found == nullptr) {
+                break;
+            }
+            pos = static_cast<const char*>(found) - data;
+            firstComma = std::min(firstComma, pos);
+            if (isElementSeparator(data, size, pos)) {
+                chosen = pos;
+                break;
+            }
+        }
+        if (chosen == size) {
+            chosen = firstComma;
+        }
+        if (chosen + 1 >= size) {
+            break;
+        }
+        if (chosen + 1 > boundaries.back()) {
+            boundaries.push_back(chosen + 1);
+        }
+    }
+    boundaries.push_back(size);
+    return boundaries;
+}
+
+// ******************************************************************************** 区間の入力元
+/// @brief 入力全体のうち1区間だけを読む入力元。
+/// @note 位置は入力全体の先頭からの絶対位置で、区間末尾以降は'\0'として読める。
+///       data()は入力全体の先頭を返すため、文字列トークンは入力全体へのスライスになる。
+class ChunkInputSource {
+public:
+    /// @brief 区間を指定して構築する。
+    /// @param data 入力全体の先頭。
+    /// @param begin 区間の先頭位置。
+    /// @param end 区間の末尾位置（この位置は含まない）。
+    /// @param aheadSize 先読みbyte数。
+    ChunkInputSource(const char* data, std::size_t begin, std::size_t end, std::size_t aheadSize)
+        : data_(data), end_(end), position_(begin) {
+        // どうしてこの実装にしたか：先読みで区間外を読まないよう、MmapInputSourceと同じく
+        // 区間末尾aheadSize byteと番兵だけを別バッファに持ち、そこへ切り替える。
+        tailStart_ = end_ - begin > aheadSize ? end_ - aheadSize : begin;
+        tail_.assign(end_ - tailStart_ + aheadSize, '\0');
+        std::memcpy(tail_.data(), data_ + tailStart_, end_ - tailStart_);
+        inTail_ = position_ >= tailStart_;
+        cursor_ = inTail_ ? tail_.data() + (position_ - tailStart_) : data_ + position_;
+    }
+
+    // コピー・ムーブ禁止（cursor_が自身のバッファを指すため）
+    ChunkInputSource(const ChunkInputSource&) = delete;
+    ChunkInputSource& operator=(const ChunkInputSource&) = delete;
+    ChunkInputSource(ChunkInputSource&&) = delete;
+    ChunkInputSource& operator=(ChunkInputSource&&) = delete;
+
+    /// @brief 現在の絶対読み取り位置を返す。
+    /// @return 読み取り位置。
+    std::size_t position() const { return position_; }
+
+    /// @brief 入力全体の先頭を返す。
+    /// @return 位置0の文字へのポインタ。
+    const char* data() const { return data_; }
+
+    /// @brief 区間の末尾位置を返す。
+    /// @return 区間の末尾位置。data()からこの位置までを連続領域として読める。
+    std::size_t size() const { return end_; }
+
+    /// @brief 先読みした文字を取得する。
+    /// @param offset 現在位置からのオフセット。aheadSize未満であること。
+    /// @return 指定位置の文字。区間外の場合は'\0'。
+    char peekAhead(std::size_t offset) const { return cursor_[offset]; }
+
+    /// @brief 現在位置から指定された文字数だけ読み進める。
+    /// @param count 読み進める文字数。
+    void consume(std::size_t count = 1) {
+        assert(position_ + count <= end_);
+        position_ += count;
+        cursor_ += count;
+        if (position_ >= tailStart_ && !inTail_) {
+            cursor_ = tail_.data() + (position_ - tailStart_);
+            inTail_ = true;
+        }
+    }
+
+private:
+    const char* data_;              ///< 入力全体の先頭。
+    std::size_t end_;               ///< 区間の末尾位置。
+    std::size_t position_;          ///< 現在の絶対読み取り位置。
+    std::size_t tailStart_ = 0;     ///< 末尾コピーに切り替える位置。
+    std::vector<char> tail_;        ///< 区間末尾aheadSize byteと番兵'\0'のコピー。
+    const char* cursor_ = nullptr;  ///< 現在位置の文字へのポインタ。
+    bool inTail_ = false;           ///< 末尾コピーを読んでいるか。
+};
+
+// ******************************************************************************** 区間のトークン列
+/// @brief 1区間分のトークン列と、その区間の文字列アリーナ。
+/// @note 区間毎にトークナイザーを並列に動かすため、ロックせずに配列へ追加する。
+class ChunkTokenBuffer {
+public:
+    ChunkTokenBuffer() = default;
+
+    // コピー・ムーブ禁止（文字列アリーナを保持するため）
+    ChunkTokenBuffer(const ChunkTokenBuffer&) = delete;
+    ChunkTokenBuffer& operator=(const ChunkTokenBuffer&) = delete;
+    ChunkTokenBuffer(ChunkTokenBuffer&&) = delete;
+    ChunkTokenBuffer& operator=(ChunkTokenBuffer&&) = delete;
+
+    /// @brief トークンを追加する。
+    /// @param token 追加するトークン。
+    void pushToken(JsonToken&& token) {
+        if (token.flags & JsonToken::arenaStringFlag) {
+            // 連結時に共有の文字列アリーナへ写すため、位置を控えておく。
+            arenaTokenIndices_.push_back(tokens_.size());
+        }
+        tokens_.push_back(token);
+        indexer_.onPush(tokens_.back(), [&](std::uint64_t index) { return &tokens_[index]; });
+    }
+
+    /// @brief 文字列アリーナを取得する（トークナイザー用）。
+    JsonStringArena& arena() { return arena_; }
+
+    /// @brief 入力バッファの先頭を設定する（トークナイザー用）。
+    /// @note 連結先のChunkedTokenSourceが入力全体の先頭を持つため、ここでは保持しない。
+    void setInputData(const char*) {}
+
+    /// @brief トークン列を破棄する。
+    void clear() {
+        tokens_.clear();
+        arenaTokenIndices_.clear();
+        indexer_.clear();
+    }
+
+private:
+    friend class ChunkedTokenSource;
+
+    std::vector<JsonToken> tokens_;               ///< トークン列（末尾はEndOfStream）。
+    std::vector<std::size_t> arenaTokenIndices_;  ///< 文字列アリーナを参照するトークンの位置。
+    JsonStringArena arena_;                       ///< この区間の文字列アリーナ。
+    JsonSubtreeIndexer indexer_;                  ///< 区間内で閉じる開始トークンへsubtreeSizeを書き込む索引。
+};
+
+/// @brief 警告メッセージを溜めておき、後でまとめて出力する。
+/// @note 並列にトークン化した区間の警告を、入力順に出力するために使う。
+class BufferedMessageOutput : public MessageOutput {
+public:
+    /// @brief 警告メッセージを溜める。
+    /// @param msg 警告メッセージ。
+    void warning(const std::string& msg) override {
+        messages_.push_back(msg);
+    }
+
+    /// @brief 溜めた警告メッセージを出力先へ渡す。
+    /// @param output 出力先。
+    void replay(MessageOutput& output) const {
+        for (const auto& message : messages_) {
+            output.warning(message);
+        }
+    }
+
+private:
+    std::vector<std::string> messages_;  ///< 溜めた警告メッセージ。
+};
+
+// ******************************************************************************** 連結したトークン列
+/// @brief 区間毎のトークン列を入力順に連結して読み出すトークン読み出し元。
+/// @note トークン列は写し直さず、区間の境目で次の区間へ読み出し位置を移す。
+class ChunkedTokenSource final : public TokenSource {
+public:
+    /// @brief 区間を実行する実行器を指定して構築する。
+    /// @param executor 区間毎のトークン化を実行する実行器。
+    explicit ChunkedTokenSource(rai::common::Executor& executor = rai::common::getDefaultExecutor())
+        : executor_(executor) {}
+
+    // コピー・ムーブ禁止（TokenSourceが文字列アリーナを保持するため）
+    ChunkedTokenSource(const ChunkedTokenSource&) = delete;
+    ChunkedTokenSource& operator=(const ChunkedTokenSource&) = delete;
+    ChunkedTokenSource(ChunkedTokenSource&&) = delete;
+    ChunkedTokenSource& operator=(ChunkedTokenSource&&) = delete;
+
+    /// @brief 入力をトークン化する。
+    /// @param input 入力全体。トークン列を読み終えるまで有効であること。
+    /// @param warningOutput 警告メッセージの出力先。
+    /// @param chunkCount 区間数。0の場合は入力サイズとスレッド数から決める。
+    /// @return 並列にトークン化した場合はtrue、逐次処理に切り替えた場合はfalse。
+    /// @note 区切り位置が文字列・コメントの内側だった場合や、いずれかの区間でエラーが
+    ///       起きた場合は、入力全体を逐次にトークン化し直す（エラーは逐次版と同じ内容で送出する）。
+    bool tokenize(std::string_view input, MessageOutput& warningOutput,
+        std::size_t chunkCount = 0) {
+        setInputData(input.data());
+        if (chunkCount == 0) {
+            chunkCount = std::min(std::max<std::size_t>(executor_.getThreadCount(), 1),
+                std::max<std::size_t>(input.size() / minChunkSize, 1));
+        }
+        const std::vector<std::size_t> boundaries =
+            findChunkBoundaries(input.data(), input.size(), chunkCount);
+        const std::size_t count = boundaries.size() - 1;
+        if (count >= 2 && tokenizeParallel(input, boundaries, warningOutput)) {
+            return true;
+        }
+        tokenizeSequential(input, warningOutput);
+        return false;
+    }
+
+    /// @brief 区間の窓を読み終えたとき、次の区間へ移ってトークンを取得する。
+    /// @return 取得したトークン。終端トークンは読み進めず、以降も終端を返し続ける。
+    JsonToken takeNext() override {
+        if (chunkIndex_ + 1 < chunks_.size()) {
+            moveToNextChunk();
+            return take();
+        }
+        return *windowCursor();
+    }
+
+    /// @brief 区間の窓を読み終えたとき、次の空でない区間の先頭のトークンを取得する（消費しない）。
+    /// @return 次のトークンへの参照。
+    const JsonToken& peekNext() const override {
+        for (std::size_t i = chunkIndex_ + 1; i < chunks_.size(); ++i) {
+            if (!chunks_[i]->tokens_.empty()) {
+                return chunks_[i]->tokens_.front();
+            }
+        }
+        return *windowCursor();
+    }
+
+    /// @brief 区間数を返す。
+    /// @return トークン化に使った区間数。逐次処理の場合は1。
+    std::size_t chunkCount() const {
+        return chunks_.size();
+    }
+
+    /// @brief 並列化する場合の1区間あたりの最小byte数。
+    static constexpr std::size_t minChunkSize = 1024 * 1024;
+
+private:
+    /// @brief 区間毎に並列でトークン化する。
+    /// @param input 入力全体。
+    /// @param boundaries 区間の境界位置。
+    /// @param warningOutput 警告メッセージの出力先。
+    /// @return 全区間が外側の位置で始まり、エラーなくトークン化できた場合はtrue。
+    bool tokenizeParallel(std::string_view input, const std::vector<std::size_t>& boundaries,
+        MessageOutput& warningOutput) {
+        const std::size_t count = boundaries.size() - 1;
+        resetChunks(count);
+        std::vector<BufferedMessageOutput> warnings(count);
+        std::vector<LexicalState> endStates(count, LexicalState::Outside);
+        std::vector<std::exception_ptr> errors(count);
+
+        auto& threadPool = executor_;
+        std::vector<std::future<void>> futures;
+        futures.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            futures.push_back(threadPool.enqueue([&, i]() {
+                const std::size_t begin = boundaries[i];
+                const std::size_t end = boundaries[i + 1];
+                try {
+                    endStates[i] = scanLexicalState(input.data() + begin, end - begin);
+                    ChunkInputSource source(input.data(), begin, end, aheadSize);
+                    JsonTokenizer<ChunkInputSource, ChunkTokenBuffer> tokenizer(
+                        source, *chunks_[i], warnings[i]);
+                    tokenizer.tokenize();
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            }));
+        }
+        for (auto& future : futures) {
+            threadPool.wait(future);
+        }
+
+        // 直前の区間の末尾が外側であれば、次の区間の先頭を外側と仮定したことが正しい。
+        for (std::size_t i = 0; i < count; ++i) {
+            if (errors[i] || (i + 1 < count && endStates[i] != LexicalState::Outside)) {
+                return false;
+            }
+        }
+        for (const auto& chunkWarnings : warnings) {
+            chunkWarnings.replay(warningOutput);
+        }
+        stitch();
+        return true;
+    }
+
+    /// @brief 入力全体を1区間として呼び出しスレッドでトークン化する。
+    /// @param input 入力全体。
+    /// @param warningOutput 警告メッセージの出力先。
+    void tokenizeSequential(std::string_view input, MessageOutput& warningOutput) {
+        resetChunks(1);
+        ChunkInputSource source(input.data(), 0, input.size(), aheadSize);
+        JsonTokenizer<ChunkInputSource, ChunkTokenBuffer> tokenizer(
+            source, *chunks_[0], warningOutput);
+        tokenizer.tokenize();
+        stitch();
+    }
+
+    /// @brief 区間のトークン列を指定数だけ用意する。
+    /// @param count 区間数。
+    void resetChunks(std::size_t count) {
+        chunks_.clear();
+        for (std::size_t i = 0; i < count; ++i) {
+            chunks_.push_back(std::make_unique<ChunkTokenBuffer>());
+        }
+    }
+
+    /// @brief 区間毎のトークン列を連結して読み出せるようにする。
+    /// @note 区間の文字列アリーナにある文字列は、共有の文字列アリーナへ写してスライスを付け替える。
+    ///       最後以外の区間の終端トークンは読み飛ばす。
+    void stitch() {
+        for (std::size_t i = 0; i < chunks_.size(); ++i) {
+            ChunkTokenBuffer& chunk = *chunks_[i];
+            for (std::size_t index : chunk.arenaTokenIndices_) {
+                JsonToken& token = chunk.tokens_[index];
+                const std::string_view content = chunk.arena_.view(token.slice);
+                JsonStringArena& shared = arena();
+                shared.begin();
+                shared.append(content.data(), content.size());
+                token.slice = shared.finish();
+            }
+            if (i + 1 < chunks_.size()) {
+                assert(!chunk.tokens_.empty() &&
+                    chunk.tokens_.back().type == JsonTokenType::EndOfStream);
+                chunk.tokens_.pop_back();
+            }
+        }
+        chunkIndex_ = 0;
+        if (chunks_[0]->tokens_.empty()) {
+            moveToNextChunk();
+        } else {
+            openChunkWindow();
+        }
+    }
+
+    /// @brief 次の空でない区間に読み出し位置を移す。
+    /// @note 最後の区間は終端トークンを持つため、必ず空でない区間が見つかる。
+    void moveToNextChunk() {
+        do {
+            ++chunkIndex_;
+        } while (chunks_[chunkIndex_]->tokens_.empty());
+        openChunkWindow();
+    }
+
+    /// @brief 読み出し中の区間のトークン列を窓に設定する。最後の区間は終端トークンを窓の外に置く。
+    /// @note subtreeSizeは区間内で閉じる範囲にだけ書き込まれるため、skipTokens()は窓の中で読み進める。
+    void openChunkWindow() {
+        const auto& tokens = chunks_[chunkIndex_]->tokens_;
+        const JsonToken* end = tokens.data() + tokens.size();
+        if (chunkIndex_ + 1 == chunks_.size()) {
+            --end;
+        }
+        setWindow(tokens.data(), end);
+    }
+
+    static constexpr std::size_t aheadSize = 8;  ///< 先読みbyte数。
+
+    rai::common::Executor& executor_;  ///< 区間毎のトークン化を実行する実行器。
+    std::vector<std::unique_ptr<ChunkTokenBuffer>> chunks_;  ///< 区間毎のトークン列。
+    std::size_t chunkIndex_ = 0;                ///< 読み出し中の区間。
+};
+
+}  // namespace rai::serialization
@@ -2,12 +2,20 @@
 // @brief JSON入出力の統合インターフェース。ObjectSerializerと連携してJSON変換を提供する。
 
 module;
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <memory_resource>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <fstream>
+#include <exception>
 #include <filesystem>
-#include <sstream>
 #include <stdexcept>
 #include <mutex>
 #include <future>
@@ -20,27 +28,117 @@ import rai.serialization.format_io;
 import rai.serialization.json_writer;
 import rai.serialization.json_parser;
 import rai.serialization.json_tokenizer;
+import rai.serialization.json_chunked_tokenizer;
 import rai.serialization.token_manager;
+import rai.serialization.ring_buffer_token_manager;
 import rai.serialization.reading_ahead_buffer;
+import rai.serialization.reading_ahead_buffer_ring;
 import rai.serialization.parallel_input_stream_source;
+import rai.serialization.mmap_input_source;
+import rai.serialization.async_file_input_source;
+import rai.serialization.parallel_file_output_sink;
+import rai.serialization.pipeline_instrumentation;
 import rai.common.thread_pool;
 
 namespace rai::serialization {
 
-static constexpr std::size_t smallFileThreshold = 10 * 1024; //< 小ファイルとみなす閾値（byte）
 static constexpr std::size_t aheadSize = 8;        //< 先読み8byte
 
+/// @brief readJsonFileが読み込み方法を選ぶ基準と、並列版の入力バッファの設定。
+export struct JsonFileReadPolicy {
+    std::size_t smallFileThreshold = 10 * 1024;          ///< これ以下のファイルは逐次版で読む（byte）。
+    std::size_t mappedFileThreshold = 64 * 1024 * 1024;  ///< これを超えるファイルはメモリマップ版で読む（byte）。
+    InputBufferOptions bufferOptions;                    ///< 並列版の入力バッファの容量・数・配置。
+};
+
+/// @brief 実行時に変更できる読み込み方針の保持先。
+struct JsonFileReadPolicyState {
+    std::mutex mutex;           ///< policyを保護するミューテックス。
+    JsonFileReadPolicy policy;  ///< 現在の読み込み方針。
+};
+
+JsonFileReadPolicyState& jsonFileReadPolicyState() {
+    static JsonFileReadPolicyState state;
+    return state;
+}
+
+/// @brief 現在の読み込み方針を取得する。
+/// @return 読み込み方針の写し。
+export JsonFileReadPolicy getJsonFileReadPolicy() {
+    JsonFileReadPolicyState& state = jsonFileReadPolicyState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    return state.policy;
+}
+
+/// @brief 読み込み方針を変更する。以降に始まる読み込みから使われる。
+/// @param policy 新しい読み込み方針。
+export void setJsonFileReadPolicy(const JsonFileReadPolicy& policy) {
+    JsonFileReadPolicyState& state = jsonFileReadPolicyState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.policy = policy;
+}
+
+/// @brief オブジェクトをJSON形式でJsonWriterに書き出す。
+/// @tparam T 変換対象の型。
+/// @param obj 変換するオブジェクト。
+/// @param writer 書き込み先のJsonWriter。
+template <HasSerializer T>
+void writeJsonObject(const T& obj, JsonWriter& writer) {
+    writer.startObject();
+    writeSerializerFields(writer, obj.serializer(), obj);
+    writer.endObject();
+}
+
 /// @brief オブジェクトをJSON形式でストリームに書き出す。
 /// @tparam T 変換対象の型。
 /// @param obj 変換するオブジェクト。
 /// @param os 出力先のストリーム。
 export template <HasSerializer T>
 void writeJsonToBuffer(const T& obj, std::ostream& os) {
-    JsonWriter writer(os);
-    auto& fields = obj.serializer();
-    writer.startObject();
-    fields.writeFields(writer, &obj);
-    writer.endObject();
+    // 書き込み毎のos.write()を避けるため、出力先コールバックで溜めてからまとめて書く。
+    JsonWriter writer([&os](std::span<const char> data) {
+        os.write(data.data(), static_cast<std::streamsize>(data.size()));
+    });
+    writeJsonObject(obj, writer);
+    writer.flush();
+}
+
+/// @brief オブジェクトをJSON形式で文字列の末尾に書き出す。
+/// @tparam T 変換対象の型。
+/// @param obj 変換するオブジェクト。
+/// @param out 出力先の文字列。既存の内容の後ろに追記する。
+export template <HasSerializer T>
+void writeJsonToBuffer(const T& obj, std::string& out) {
+    JsonWriter writer(out);
+    writeJsonObject(obj, writer);
+}
+
+/// @brief オブジェクトをJSON形式で出力先コールバックに書き出す。
+/// @tparam T 変換対象の型。
+/// @param obj 変換するオブジェクト。
+/// @param sink 出力先コールバック。書き込み済みの連続領域を順に受け取る。
+/// @param bufferSize 出力先コールバックへ渡す前に溜めるbyte数の目安。
+export template <HasSerializer T>
+void writeJsonToSink(const T& obj, const JsonWriteSink& sink,
+    std::size_t bufferSize = defaultJsonWriteBufferSize) {
+    JsonWriter writer(sink, bufferSize);
+    writeJsonObject(obj, writer);
+    writer.flush();
+}
+
+/// @brief オブジェクトをJSON形式で書き出した時のbyte数を求める。
+/// @tparam T 変換対象の型。
+/// @param obj 計測するオブジェクト。
+/// @return getJsonContent(obj)の長さと同じbyte数。
+/// @note 書き出しと同じ走査をJsonSizeCounterに対して行うため、文字列の確保は行わない。
+///       出力先の事前確保や、ストリーム・並列書き出しへ切り替えるかの判断に使う。
+export template <HasSerializer T>
+std::size_t estimateJsonSize(const T& obj) {
+    JsonSizeCounter counter;
+    counter.startObject();
+    writeSerializerFields(counter, obj.serializer(), obj);
+    counter.endObject();
+    return counter.size();
 }
 
 /// @brief 任意の型のオブジェクトをJSON形式で文字列化して返す。
@@ -49,9 +147,12 @@ void writeJsonToBuffer(const T& obj, std::ostream& os) {
 /// @return JSON形式の文字列。
 export template <HasSerializer T>
 std::string getJsonContent(const T& obj) {
-    std::ostringstream oss;
-    writeJsonToBuffer(obj, oss);
-    return oss.str();
+    // どうしてこの実装にしたか：ostringstreamを経由せず、戻り値の文字列へ直接書き込む。
+    // 計測の走査は数値の書式化を含み書き出しの7割ほどかかるため、ここでは再確保に任せる。
+    // 再確保による余分な容量を避けたい場合はestimateJsonSize()で確保してからwriteJsonToBufferを使う。
+    std::string result;
+    writeJsonToBuffer(obj, result);
+    return result;
 }
 
 /// @brief オブジェクトをJSONファイルに書き出す。
@@ -60,19 +161,45 @@ std::string getJsonContent(const T& obj) {
 /// @param filename 出力先のファイル名。
 export template <HasSerializer T>
 void writeJsonFile(const T& obj, const std::string& filename) {
-    std::ofstream ofs(filename, std::ios::out | std::ios::trunc);
-    if (!ofs.is_open()) {
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> file(
+        std::fopen(filename.c_str(), "wb"), &std::fclose);
+    if (!file) {
         throw std::runtime_error("writeJsonToFile: Cannot open file " + filename);
     }
 
-    writeJsonToBuffer(obj, ofs);
+    // iostreamを経由せず、内部バッファが溜まる毎にまとめてfwriteする。
+    writeJsonToSink(obj, [&file, &filename](std::span<const char> data) {
+        if (std::fwrite(data.data(), 1, data.size(), file.get()) != data.size()) {
+            throw std::runtime_error("writeJsonToFile: Error writing to file " + filename);
+        }
+    });
 
-    ofs.close();
-    if (ofs.bad()) {
+    if (std::fclose(file.release()) != 0) {
         throw std::runtime_error("writeJsonToFile: Error writing to file " + filename);
     }
 }
 
+/// @brief オブジェクトをJSONファイルに書き出す（バックグラウンド書き込み版）。
+/// @tparam T 変換対象の型。
+/// @param obj 変換するオブジェクト。
+/// @param filename 出力先のファイル名。
+/// @param options バッファの容量・数と、fsync・一時ファイルからの置き換えの設定。
+/// @param executor 書き込みタスクと、ParallelContainerConverterの並列書き出しを実行する実行器。
+/// @note 1つのバッファへシリアライズする間に、書き込み済みのバッファを実行器のタスクがファイルへ書き出す。
+///       書き込み待ちのバッファがoptions.bufferCount - 1個に達すると、シリアライズ側は空きを待つ。
+export template <HasSerializer T>
+void writeJsonFile(const T& obj, const std::string& filename, const FileWriteOptions& options,
+    rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
+    ParallelFileOutputSink sink(filename, options, executor);
+    {
+        JsonWriter writer(sink, sink.bufferSize());
+        writer.setExecutor(executor);
+        writeJsonObject(obj, writer);
+        writer.flush();
+    }
+    sink.close();
+}
+
 /// @brief オブジェクトをJSONから読み込む（startObject/endObject含む）。
 /// @tparam T HasSerializerを実装している型。
 /// @param parser 読み取り元のJsonParser互換オブジェクト。
@@ -92,55 +219,233 @@ void readJsonObject(JsonParser& parser, T& obj) {
 /// @param buffer 入力バッファ（ReadingAheadBuffer用の先読み領域を含む容量が必要）。
 /// @param out 読み込み先のオブジェクト。
 /// @param unknownKeysOut 未知キーの収集先。
-template <HasSerializer T>
+/// @param executor 並列処理に使う実行器。
+/// @param instrumentation 計測フック。
+template <HasSerializer T, PipelineInstrumentation Instrumentation = NoPipelineInstrumentation>
 void readJsonFromBuffer(std::string&& buffer, T& out,
-    std::vector<std::string>& unknownKeysOut) {
+    std::vector<std::string>& unknownKeysOut, rai::common::Executor& executor,
+    Instrumentation instrumentation = {}) {
     ReadingAheadBuffer inputSource(std::move(buffer), aheadSize);
-    TokenManager tokenManager;
+    // どうしてこの実装にしたか：全てトークン化してから同じスレッドで読むため、ロックを取らない
+    // TokenBufferへ溜め、パーサーがトークン列を窓としてインラインで読み出せるようにする。
+    TokenBuffer tokenManager;
     StdoutMessageOutput warningOutput;
-    JsonTokenizer<ReadingAheadBuffer, TokenManager> tokenizer(
-        inputSource, tokenManager, warningOutput);
+    JsonTokenizer<ReadingAheadBuffer, TokenBuffer, Instrumentation> tokenizer(
+        inputSource, tokenManager, warningOutput, instrumentation);
     tokenizer.tokenize();
 
-    JsonParser parser(tokenManager);
+    JsonParser parser(tokenManager, executor);
+    const std::uint64_t parseStart = pipelineTimestamp<Instrumentation>();
     readJsonObject(parser, out);
+    instrumentation.addParse(pipelineTimestamp<Instrumentation>() - parseStart);
     unknownKeysOut = std::move(parser.getUnknownKeys());
 }
 
-template <HasSerializer T>
-void readJsonImpl(std::istream& inputStream, T& out,
-    std::vector<std::string>& unknownKeysOut) {
-    // ストリームから文字列に読み込み
-    std::ostringstream oss;
-    oss << inputStream.rdbuf();
+// 未知キーの収集先を受け取るオーバーロード（先に定義）
+export template <HasSerializer T>
+void readJsonString(const std::string& jsonText, T& out,
+    std::vector<std::string>& unknownKeysOut,
+    rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
+    // どうしてこの実装にしたか：文字列ストリームを経由すると入力を3回写すため、先読み領域を含めて1回だけ写す。
+    std::string buffer;
+    buffer.reserve(jsonText.size() + aheadSize);
+    buffer.assign(jsonText);
+    readJsonFromBuffer(std::move(buffer), out, unknownKeysOut, executor);
+}
+
+/// @brief JSON文字列からオブジェクトを読み込む。
+/// @tparam T 読み込み対象の型。
+/// @param json JSON形式の文字列。
+/// @param out 読み込み先のオブジェクト。
+/// @param executor 並列処理に使う実行器。
+export template <HasSerializer T>
+void readJsonString(const std::string& jsonText, T& out,
+    rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
+    std::vector<std::string> unknownKeysOut;
+    readJsonString(jsonText, out, unknownKeysOut, executor);
+}
+
+// ******************************************************************************** 再利用できる読み込み文脈
+
+/// @brief validateJsonの結果。
+export struct JsonValidationResult {
+    bool valid = true;         ///< 文書がJSON5として正しく、型の定義どおりに読み込めるならtrue。
+    std::size_t position = 0;  ///< 最初のエラーの入力内の位置（byte）。validの場合は0。
+    std::string message;       ///< 最初のエラーの内容。validの場合は空。
 
-    // 読み込み失敗をチェック
-    if (inputStream.fail() && !inputStream.eof()) {
-        throw std::runtime_error("readJsonImpl: Failed to read from input stream");
+    /// @brief 検証に成功したかを返す。
+    explicit operator bool() const { return valid; }
+};
+
+/// @brief 小さな文書を繰り返し読み込むため、トークン列などの確保済み領域を使い回す読み込み文脈。
+/// @note 入力を写さずにトークン化し、トークン列・文字列アリーナ・入れ子の追跡用の配列を次の読み込みでも使う。
+///       同じ文脈を複数のスレッドから同時に使わないこと（スレッド毎に持つ）。
+export class JsonReadContext {
+public:
+    JsonReadContext() = default;
+
+    // コピー・ムーブ禁止（トークン列が文字列アリーナを保持するため）
+    JsonReadContext(const JsonReadContext&) = delete;
+    JsonReadContext& operator=(const JsonReadContext&) = delete;
+    JsonReadContext(JsonReadContext&&) = delete;
+    JsonReadContext& operator=(JsonReadContext&&) = delete;
+
+    /// @brief JSON文字列からオブジェクトを読み込む。
+    /// @tparam T 読み込み対象の型。
+    /// @param jsonText JSON形式の文字列。読み込みが終わるまで有効であること（写さずに参照する）。
+    /// @param out 読み込み先のオブジェクト。
+    /// @param executor 並列処理に使う実行器。
+    /// @note 未知キーはunknownKeys()で取得できる（次の読み込みまで有効）。
+    template <HasSerializer T>
+    void read(std::string_view jsonText, T& out,
+        rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
+        inUse_ = true;
+        tokens_.clear();
+        unknownKeys_.clear();
+        try {
+            ChunkInputSource inputSource(jsonText.data(), 0, jsonText.size(), aheadSize);
+            JsonTokenizer<ChunkInputSource, TokenBuffer> tokenizer(
+                inputSource, tokens_, warningOutput_);
+            tokenizer.tokenize();
+            JsonParser parser(tokens_, executor);
+            readJsonObject(parser, out);
+            unknownKeys_ = std::move(parser.getUnknownKeys());
+        } catch (...) {
+            inUse_ = false;
+            throw;
+        }
+        inUse_ = false;
     }
 
-    std::string buffer = oss.str();
-    buffer.reserve(buffer.size() + aheadSize);
+    /// @brief JSON文字列が型Tとして読み込めるかを、Tを構築せずに検証する。
+    /// @tparam T 検証に使う型。既定構築できること。
+    /// @param jsonText JSON形式の文字列。検証が終わるまで有効であること（写さずに参照する）。
+    /// @return 検証の結果。未知キーはunknownKeys()で取得できる（次の読み込みまで有効）。
+    template <HasSerializer T>
+    JsonValidationResult validate(std::string_view jsonText) {
+        inUse_ = true;
+        tokens_.clear();
+        unknownKeys_.clear();
+        JsonValidationResult result;
+        try {
+            result = validateTokens<T>(jsonText);
+        } catch (...) {
+            inUse_ = false;
+            throw;
+        }
+        inUse_ = false;
+        return result;
+    }
+
+    /// @brief 直前の読み込みで見つかった未知キーを返す。
+    const std::vector<std::string>& unknownKeys() const { return unknownKeys_; }
+
+    /// @brief 読み込み中かを返す。
+    /// @return read()の実行中ならtrue。
+    bool inUse() const { return inUse_; }
+
+private:
+    /// @brief トークン化してからフィールド集合で検証する（validate()の本体）。
+    template <HasSerializer T>
+    JsonValidationResult validateTokens(std::string_view jsonText) {
+        ChunkInputSource inputSource(jsonText.data(), 0, jsonText.size(), aheadSize);
+        JsonTokenizer<ChunkInputSource, TokenBuffer> tokenizer(inputSource, tokens_, warningOutput_);
+        try {
+            tokenizer.tokenize();
+        } catch (const std::exception& e) {
+            return JsonValidationResult{false, inputSource.position(), e.what()};
+        }
+
+        JsonParser parser(tokens_);
+        try {
+            parser.startObject();
+            prototypeSerializer<T>().validateFields(parser);
+            parser.endObject();
+        } catch (const std::exception& e) {
+            return JsonValidationResult{false, parser.lastPosition(), e.what()};
+        }
+        unknownKeys_ = std::move(parser.getUnknownKeys());
+        return JsonValidationResult{};
+    }
 
-    readJsonFromBuffer(std::move(buffer), out, unknownKeysOut);
+    TokenBuffer tokens_;                    ///< 再利用するトークン列と文字列アリーナ。
+    StdoutMessageOutput warningOutput_;     ///< 警告メッセージの出力先。
+    std::vector<std::string> unknownKeys_;  ///< 直前の読み込みの未知キー。
+    bool inUse_ = false;                    ///< read()の実行中ならtrue。
+};
+
+/// @brief 現在のスレッドのreadJsonが使う読み込み文脈を返す。
+inline JsonReadContext& threadJsonReadContext() {
+    thread_local JsonReadContext context;
+    return context;
 }
 
 // 未知キーの収集先を受け取るオーバーロード（先に定義）
 export template <HasSerializer T>
-void readJsonString(const std::string& jsonText, T& out,
-    std::vector<std::string>& unknownKeysOut) {
-    std::istringstream stream(jsonText);
-    readJsonImpl(stream, out, unknownKeysOut);
+void readJson(std::string_view jsonText, T& out, std::vector<std::string>& unknownKeysOut,
+    rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
+    JsonReadContext& threadContext = threadJsonReadContext();
+    if (threadContext.inUse()) {
+        // 読み込み中の変換処理から呼ばれた場合は、読み込み中の文脈を壊さないよう別の文脈を使う。
+        JsonReadContext context;
+        context.read(jsonText, out, executor);
+        unknownKeysOut = context.unknownKeys();
+        return;
+    }
+    threadContext.read(jsonText, out, executor);
+    unknownKeysOut = threadContext.unknownKeys();
 }
 
-/// @brief JSON文字列からオブジェクトを読み込む。
+/// @brief JSON文字列を写さずに、スレッド毎に使い回す読み込み文脈でオブジェクトを読み込む。
 /// @tparam T 読み込み対象の型。
-/// @param json JSON形式の文字列。
+/// @param jsonText JSON形式の文字列。
 /// @param out 読み込み先のオブジェクト。
+/// @param executor 並列処理に使う実行器。
+/// @note 小さな文書を繰り返し読み込む場合、2回目以降はトークン列などの確保が起きない。
 export template <HasSerializer T>
-void readJsonString(const std::string& jsonText, T& out) {
+void readJson(std::string_view jsonText, T& out,
+    rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
+    JsonReadContext& threadContext = threadJsonReadContext();
+    if (threadContext.inUse()) {
+        JsonReadContext context;
+        context.read(jsonText, out, executor);
+        return;
+    }
+    threadContext.read(jsonText, out, executor);
+}
+
+// ******************************************************************************** 検証
+
+// 未知キーの収集先を受け取るオーバーロード（先に定義）
+export template <HasSerializer T>
+JsonValidationResult validateJson(std::string_view jsonText,
+    std::vector<std::string>& unknownKeysOut) {
+    // どうしてこの実装にしたか：readJsonと同じく、呼び出し側の文字列をその場でトークン化し、
+    // ロックを取らないTokenBufferへ溜める。入力の複写とトークン毎のロックを避け、
+    // スレッド毎の文脈を使い回してトークン列の確保も繰り返さない。
+    JsonReadContext& threadContext = threadJsonReadContext();
+    if (threadContext.inUse()) {
+        JsonReadContext context;
+        const JsonValidationResult result = context.validate<T>(jsonText);
+        unknownKeysOut = context.unknownKeys();
+        return result;
+    }
+    const JsonValidationResult result = threadContext.validate<T>(jsonText);
+    unknownKeysOut = threadContext.unknownKeys();
+    return result;
+}
+
+/// @brief JSON文字列が型Tとして読み込めるかを、Tを構築せずに検証する。
+/// @tparam T 検証に使う型。既定構築できること。
+/// @param jsonText JSON形式の文字列。
+/// @return 検証の結果。失敗した場合は最初のエラーの位置と内容を持つ。
+/// @note readJsonStringと同じ規則（必須フィールド・値の型・キーの重複）で判定する。
+///       値は読み込まず、文字列は入力を参照するビューで確かめ、コンテナの確保も行わない。
+///       フィールド集合はTの既定値（型毎に1つだけ構築する）のserializer()から得る。
+export template <HasSerializer T>
+JsonValidationResult validateJson(std::string_view jsonText) {
     std::vector<std::string> unknownKeysOut;
-    readJsonString(jsonText, out, unknownKeysOut);
+    return validateJson<T>(jsonText, unknownKeysOut);
 }
 
 /// @brief JSONファイルからオブジェクトを読み込む（逐次処理版、内部実装）。
@@ -150,23 +455,29 @@ void readJsonString(const std::string& jsonText, T& out) {
 /// @param out 読み込み先のオブジェクト。
 /// @param fileSize ファイルサイズ。
 /// @param unknownKeysOut 未知キーの収集先。
-template <HasSerializer T>
+/// @param executor 並列処理に使う実行器。
+/// @param instrumentation 計測フック。
+template <HasSerializer T, PipelineInstrumentation Instrumentation = NoPipelineInstrumentation>
 void readJsonFileSequentialImpl(std::ifstream& ifs, const std::string& filename, T& out,
-    std::streamsize fileSize, std::vector<std::string>& unknownKeysOut) {
+    std::streamsize fileSize, std::vector<std::string>& unknownKeysOut,
+    rai::common::Executor& executor, Instrumentation instrumentation = {}) {
     // どうしてこの実装にしたか：ファイルを一括読み込みしてからトークン化する方が、
     // 小〜中規模ファイルではスレッド同期オーバーヘッドを回避できるため高速
     std::string buffer;
     buffer.reserve(fileSize + aheadSize);
     buffer.resize(fileSize);
+    const std::uint64_t readStart = pipelineTimestamp<Instrumentation>();
     ifs.read(buffer.data(), buffer.capacity());
     auto bytesRead = ifs.gcount();
+    instrumentation.addRead(static_cast<std::uint64_t>(bytesRead),
+        pipelineTimestamp<Instrumentation>() - readStart);
     assert(bytesRead <= static_cast<std::streamsize>(buffer.size()));
     if (ifs.bad()) {
         throw std::runtime_error("readJsonFileSequential: Error reading from file " + filename);
     }
     buffer.resize(bytesRead);
 
-    readJsonFromBuffer(std::move(buffer), out, unknownKeysOut);
+    readJsonFromBuffer(std::move(buffer), out, unknownKeysOut, executor, instrumentation);
 }
 
 /// @brief JSONファイルからオブジェクトを読み込む（逐次処理版）。
@@ -175,14 +486,16 @@ void readJsonFileSequentialImpl(std::ifstream& ifs, const std::string& filename,
 /// @param out 読み込み先のオブジェクト。
 /// @param fileSize ファイルサイズ。
 /// @param unknownKeysOut 未知キーの収集先。
+/// @param executor 並列処理に使う実行器。
 export template <HasSerializer T>
 void readJsonFileSequentialCore(const std::string& filename, T& out, std::streamsize fileSize,
-    std::vector<std::string>& unknownKeysOut) {
+    std::vector<std::string>& unknownKeysOut,
+    rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
     std::ifstream ifs(filename, std::ios::binary);
     if (!ifs.is_open()) {
         throw std::runtime_error("readJsonFile: Cannot open file " + filename);
     }
-    readJsonFileSequentialImpl(ifs, filename, out, fileSize, unknownKeysOut);
+    readJsonFileSequentialImpl(ifs, filename, out, fileSize, unknownKeysOut, executor);
     ifs.close();
 }
 
@@ -196,42 +509,85 @@ void readJsonFileSequentialCore(const std::string& filename, T& out, std::stream
 /// @param filename 入力元のファイル名。
 /// @param out 読み込み先のオブジェクト。
 /// @param unknownKeysOut 未知キーの収集先。
+/// @param executor 並列処理に使う実行器。
 export template <HasSerializer T>
 void readJsonFileSequential(const std::string& filename, T& out,
-    std::vector<std::string>& unknownKeysOut) {
+    std::vector<std::string>& unknownKeysOut,
+    rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
     readJsonFileSequentialCore(filename, out,
-        std::filesystem::file_size(filename), unknownKeysOut);
+        std::filesystem::file_size(filename), unknownKeysOut, executor);
 }
 
 /// @brief JSONファイルからオブジェクトを読み込む（逐次処理版、簡易インターフェース）。
 /// @tparam T 読み込み対象の型。
 /// @param filename 入力元のファイル名。
 /// @param out 読み込み先のオブジェクト。
+/// @param executor 並列処理に使う実行器。
 export template <HasSerializer T>
-void readJsonFileSequential(const std::string& filename, T& out) {
+void readJsonFileSequential(const std::string& filename, T& out,
+    rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
     std::vector<std::string> unknownKeysOut;
-    readJsonFileSequential(filename, out, unknownKeysOut);
+    readJsonFileSequential(filename, out, unknownKeysOut, executor);
 }
 
-/// @brief JSONファイルからオブジェクトを読み込む（並列処理版、内部実装）。
+/// @brief 呼び出しスレッドで入力を全てトークン化してから、オブジェクトを読み込む。
+/// @tparam Input 入力ソースの型。
 /// @tparam T 読み込み対象の型。
-/// @param ifs 入力元のファイルストリーム（既にオープン済み）。
-/// @param filename エラーメッセージ用のファイル名。
+/// @param inputSource 入力元。
 /// @param out 読み込み先のオブジェクト。
 /// @param unknownKeysOut 未知キーの収集先。
-template <HasSerializer T>
-void readJsonFileParallelImpl(std::ifstream& ifs, const std::string& filename, T& out,
-    std::vector<std::string>& unknownKeysOut) {
-    ParallelInputStreamSource inputSource(ifs);
-    TokenManager tokenManager;
+/// @param executor ParallelContainerConverterなどが要素の読み込みに使う実行器。
+/// @param instrumentation 計測フック。
+/// @note 実行器のタスクを待たないため、実行器のタスクの中からも呼べる。
+template <InputSource Input, HasSerializer T,
+    PipelineInstrumentation Instrumentation = NoPipelineInstrumentation>
+void readJsonTokenizedFirst(Input& inputSource, T& out, std::vector<std::string>& unknownKeysOut,
+    rai::common::Executor& executor, Instrumentation instrumentation = {}) {
+    TokenManagerBase<Instrumentation> tokenManager(instrumentation);
     StdoutMessageOutput warningOutput;
-    JsonTokenizer<ParallelInputStreamSource, TokenManager> tokenizer(
-        inputSource, tokenManager, warningOutput);
+    JsonTokenizer<Input, TokenManagerBase<Instrumentation>, Instrumentation> tokenizer(
+        inputSource, tokenManager, warningOutput, instrumentation);
+    tokenizer.tokenize();
+    JsonParser parser(tokenManager, executor);
+    const std::uint64_t parseStart = pipelineTimestamp<Instrumentation>();
+    readJsonObject(parser, out);
+    instrumentation.addParse(pipelineTimestamp<Instrumentation>() - parseStart);
+    unknownKeysOut = std::move(parser.getUnknownKeys());
+}
+
+/// @brief トークナイザーをスレッドプールで動かしながら、呼び出しスレッドでパースする。
+/// @tparam Input 入力ソースの型。
+/// @tparam T 読み込み対象の型。
+/// @param inputSource 入力元。
+/// @param out 読み込み先のオブジェクト。
+/// @param unknownKeysOut 未知キーの収集先。
+/// @param executor トークナイザーを動かす実行器。スレッドを持たない場合と、そのワーカーから呼ばれた場合は、
+///        先に全てトークン化してからパースする。
+/// @param instrumentation 計測フック。パースの経過時間は、並行時はトークン待ちを含む。
+template <InputSource Input, HasSerializer T,
+    PipelineInstrumentation Instrumentation = NoPipelineInstrumentation>
+void readJsonPipelined(Input& inputSource, T& out, std::vector<std::string>& unknownKeysOut,
+    rai::common::Executor& executor, Instrumentation instrumentation = {}) {
+    if (executor.getThreadCount() == 0 || executor.isWorkerThread()) {
+        // 有界なリングバッファでは、同じスレッドでトークン化とパースを交互に進められない。
+        // どうしてこの実装にしたか：実行器のワーカーから呼ばれた場合、トークナイザーは自分の両端キューに
+        // 積まれ、パース側はトークン待ちで眠る。全てのワーカーがこの状態になると誰もトークン化しないため、
+        // ワーカーの中では先に全てトークン化する。
+        readJsonTokenizedFirst(inputSource, out, unknownKeysOut, executor, instrumentation);
+        return;
+    }
+
+    // どうしてこの実装にしたか：トークナイザーとパーサーが別スレッドで動くため、
+    // トークン毎にロックするTokenManagerではなくロックフリーのリングバッファを使う。
+    RingBufferTokenManagerBase<Instrumentation> tokenManager(instrumentation);
+    StdoutMessageOutput warningOutput;
+    JsonTokenizer<Input, RingBufferTokenManagerBase<Instrumentation>, Instrumentation> tokenizer(
+        inputSource, tokenManager, warningOutput, instrumentation);
 
     std::mutex tokenizerExceptionMutex;
     std::exception_ptr tokenizerException;
 
-    auto& threadPool = rai::common::getGlobalThreadPool();
+    auto& threadPool = executor;
     std::future<void> tokenizerFuture = threadPool.enqueue([&]() {
         try {
             tokenizer.tokenize();
@@ -243,17 +599,23 @@ void readJsonFileParallelImpl(std::ifstream& ifs, const std::string& filename, T
         }
     });
 
-    JsonParser parser(tokenManager);
+    JsonParser parser(tokenManager, executor);
 
     try {
+        const std::uint64_t parseStart = pipelineTimestamp<Instrumentation>();
         readJsonObject(parser, out);
+        instrumentation.addParse(pipelineTimestamp<Instrumentation>() - parseStart);
         unknownKeysOut = std::move(parser.getUnknownKeys());
     } catch (...) {
-        tokenizerFuture.wait();
+        // リングバッファは有界なので、空き待ちのトークナイザーを解放してから待機する。
+        tokenManager.close();
+        threadPool.wait(tokenizerFuture);
         throw;
     }
 
-    tokenizerFuture.wait();
+    // ルートオブジェクト以降のトークンは読まないため、空き待ちにならないよう中断を通知する。
+    tokenManager.close();
+    threadPool.wait(tokenizerFuture);
     {
         std::lock_guard<std::mutex> lock(tokenizerExceptionMutex);
         if (tokenizerException) {
@@ -262,41 +624,212 @@ void readJsonFileParallelImpl(std::ifstream& ifs, const std::string& filename, T
     }
 }
 
+/// @brief JSONファイルからオブジェクトを読み込む（並列処理版、内部実装）。
+/// @tparam T 読み込み対象の型。
+/// @param ifs 入力元のファイルストリーム（既にオープン済み）。
+/// @param filename エラーメッセージ用のファイル名。
+/// @param out 読み込み先のオブジェクト。
+/// @param unknownKeysOut 未知キーの収集先。
+/// @param executor 並列処理に使う実行器。
+/// @param instrumentation 計測フック。
+template <HasSerializer T, PipelineInstrumentation Instrumentation = NoPipelineInstrumentation>
+void readJsonFileParallelImpl(std::ifstream& ifs, const std::string& filename, T& out,
+    std::vector<std::string>& unknownKeysOut, rai::common::Executor& executor,
+    Instrumentation instrumentation = {}) {
+    ParallelInputStreamSourceBase<Instrumentation> inputSource(
+        ifs, getJsonFileReadPolicy().bufferOptions, executor, instrumentation);
+    readJsonPipelined(inputSource, out, unknownKeysOut, executor, instrumentation);
+}
+
 /// @brief JSONファイルからオブジェクトを読み込む（並列処理版）。
 /// @tparam T 読み込み対象の型。
 /// @param filename 入力元のファイル名。
 /// @param out 読み込み先のオブジェクト。
 /// @param unknownKeysOut 未知キーの収集先。
+/// @param executor 並列処理に使う実行器。
 /// @note この関数は常に並列処理を行います。小ファイルでも並列化のオーバーヘッドが発生します。
 export template <HasSerializer T>
 void readJsonFileParallel(const std::string& filename, T& out,
-    std::vector<std::string>& unknownKeysOut) {
+    std::vector<std::string>& unknownKeysOut,
+    rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
     std::ifstream ifs(filename, std::ios::binary);
     if (!ifs.is_open()) {
         throw std::runtime_error("readJsonFile: Cannot open file " + filename);
     }
-    readJsonFileParallelImpl(ifs, filename, out, unknownKeysOut);
+    readJsonFileParallelImpl(ifs, filename, out, unknownKeysOut, executor);
 }
 
 /// @brief JSONファイルからオブジェクトを読み込む（並列処理版、簡易インターフェース）。
 /// @tparam T 読み込み対象の型。
 /// @param filename 入力元のファイル名。
 /// @param out 読み込み先のオブジェクト。
+/// @param executor 並列処理に使う実行器。
 export template <HasSerializer T>
-void readJsonFileParallel(const std::string& filename, T& out) {
+void readJsonFileParallel(const std::string& filename, T& out,
+    rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
     std::vector<std::string> unknownKeysOut;
-    readJsonFileParallel(filename, out, unknownKeysOut);
+    readJsonFileParallel(filename, out, unknownKeysOut, executor);
 }
 
-/// @brief JSONファイルからオブジェクトを読み込む。ファイルサイズに応じて最適な方法を選択。
+/// @brief JSONファイルからオブジェクトを読み込む（メモリマップ版、内部実装）。
+/// @tparam T 読み込み対象の型。
+/// @param filename 入力元のファイル名。
+/// @param out 読み込み先のオブジェクト。
+/// @param unknownKeysOut 未知キーの収集先。
+/// @param executor 並列処理に使う実行器。
+/// @param instrumentation 計測フック。読み込み時間にはマップに掛かった時間を記録する
+///        （ページの読み込みはトークン化の時間に含まれる）。
+template <HasSerializer T, PipelineInstrumentation Instrumentation = NoPipelineInstrumentation>
+void readJsonFileMappedImpl(const std::string& filename, T& out,
+    std::vector<std::string>& unknownKeysOut, rai::common::Executor& executor,
+    Instrumentation instrumentation = {}) {
+    const std::uint64_t mapStart = pipelineTimestamp<Instrumentation>();
+    MmapInputSource inputSource(filename, aheadSize);
+    instrumentation.addRead(inputSource.size(), pipelineTimestamp<Instrumentation>() - mapStart);
+    readJsonPipelined(inputSource, out, unknownKeysOut, executor, instrumentation);
+}
+
+/// @brief JSONファイルからオブジェクトを読み込む（メモリマップ版）。
 /// @tparam T 読み込み対象の型。
 /// @param filename 入力元のファイル名。
 /// @param out 読み込み先のオブジェクト。
 /// @param unknownKeysOut 未知キーの収集先。
-/// @note 小ファイル（10KB未満）では逐次処理、大ファイルでは並列処理を自動選択します。
+/// @param executor 並列処理に使う実行器。
+/// @note ファイル内容をコピーせずにマップして読む。エスケープを含まない文字列は
+///       マップ領域を直接参照するため、巨大ファイルでもメモリ使用量が増えにくい。
 export template <HasSerializer T>
-void readJsonFile(const std::string& filename, T& out,
-    std::vector<std::string>& unknownKeysOut) {
+void readJsonFileMapped(const std::string& filename, T& out,
+    std::vector<std::string>& unknownKeysOut,
+    rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
+    readJsonFileMappedImpl(filename, out, unknownKeysOut, executor);
+}
+
+/// @brief JSONファイルからオブジェクトを読み込む（メモリマップ版、簡易インターフェース）。
+/// @tparam T 読み込み対象の型。
+/// @param filename 入力元のファイル名。
+/// @param out 読み込み先のオブジェクト。
+/// @param executor 並列処理に使う実行器。
+export template <HasSerializer T>
+void readJsonFileMapped(const std::string& filename, T& out,
+    rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
+    std::vector<std::string> unknownKeysOut;
+    readJsonFileMapped(filename, out, unknownKeysOut, executor);
+}
+
+/// @brief JSONファイルからオブジェクトを読み込む（非同期読み込み版）。
+/// @tparam T 読み込み対象の型。
+/// @param filename 入力元のファイル名。
+/// @param out 読み込み先のオブジェクト。
+/// @param unknownKeysOut 未知キーの収集先。
+/// @param options 読み込みの設定（バッファの容量・数、O_DIRECT、io_uringの利用）。
+/// @param executor 並列処理に使う実行器。
+/// @note ファイルの複数の区間への読み込みを先に発行しておき（Linuxではio_uring）、完了した順にトークン化する。
+export template <HasSerializer T>
+void readJsonFileAsync(const std::string& filename, T& out,
+    std::vector<std::string>& unknownKeysOut, const AsyncFileInputOptions& options = {},
+    rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
+    AsyncFileInputSource inputSource(filename, options);
+    readJsonPipelined(inputSource, out, unknownKeysOut, executor);
+}
+
+/// @brief JSONファイルからオブジェクトを読み込む（非同期読み込み版、簡易インターフェース）。
+/// @tparam T 読み込み対象の型。
+/// @param filename 入力元のファイル名。
+/// @param out 読み込み先のオブジェクト。
+/// @param options 読み込みの設定。
+/// @param executor 並列処理に使う実行器。
+export template <HasSerializer T>
+void readJsonFileAsync(const std::string& filename, T& out,
+    const AsyncFileInputOptions& options = {},
+    rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
+    std::vector<std::string> unknownKeysOut;
+    readJsonFileAsync(filename, out, unknownKeysOut, options, executor);
+}
+
+/// @brief 入力を区間毎に並列にトークン化してから、オブジェクトを読み込む。
+/// @tparam T 読み込み対象の型。
+/// @param input 入力全体。読み込みが終わるまで有効であること。
+/// @param out 読み込み先のオブジェクト。
+/// @param unknownKeysOut 未知キーの収集先。
+/// @param executor 並列処理に使う実行器。
+template <HasSerializer T>
+void readJsonChunkedImpl(std::string_view input, T& out,
+    std::vector<std::string>& unknownKeysOut, rai::common::Executor& executor) {
+    ChunkedTokenSource tokenSource(executor);
+    StdoutMessageOutput warningOutput;
+    tokenSource.tokenize(input, warningOutput);
+
+    JsonParser parser(tokenSource, executor);
+    readJsonObject(parser, out);
+    unknownKeysOut = std::move(parser.getUnknownKeys());
+}
+
+/// @brief JSON文字列からオブジェクトを読み込む（区間並列トークン化版）。
+/// @tparam T 読み込み対象の型。
+/// @param jsonText JSON形式の文字列。
+/// @param out 読み込み先のオブジェクト。
+/// @param unknownKeysOut 未知キーの収集先。
+/// @param executor 並列処理に使う実行器。
+/// @note 区切り位置が文字列・コメントの内側になった場合は逐次にトークン化する。
+export template <HasSerializer T>
+void readJsonStringChunked(const std::string& jsonText, T& out,
+    std::vector<std::string>& unknownKeysOut,
+    rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
+    readJsonChunkedImpl(jsonText, out, unknownKeysOut, executor);
+}
+
+/// @brief JSON文字列からオブジェクトを読み込む（区間並列トークン化版、簡易インターフェース）。
+/// @tparam T 読み込み対象の型。
+/// @param jsonText JSON形式の文字列。
+/// @param out 読み込み先のオブジェクト。
+/// @param executor 並列処理に使う実行器。
+export template <HasSerializer T>
+void readJsonStringChunked(const std::string& jsonText, T& out,
+    rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
+    std::vector<std::string> unknownKeysOut;
+    readJsonStringChunked(jsonText, out, unknownKeysOut, executor);
+}
+
+/// @brief JSONファイルからオブジェクトを読み込む（区間並列トークン化版）。
+/// @tparam T 読み込み対象の型。
+/// @param filename 入力元のファイル名。
+/// @param out 読み込み先のオブジェクト。
+/// @param unknownKeysOut 未知キーの収集先。
+/// @param executor 並列処理に使う実行器。
+/// @note ファイルをマップし、カンマの直後で区切った区間をスレッドプールで並列にトークン化する。
+///       巨大な配列を持つファイルで、トークン化が1スレッドに律速されるのを避ける。
+export template <HasSerializer T>
+void readJsonFileChunked(const std::string& filename, T& out,
+    std::vector<std::string>& unknownKeysOut,
+    rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
+    MmapInputSource inputSource(filename, aheadSize);
+    readJsonChunkedImpl(std::string_view(inputSource.data(), inputSource.size()), out,
+        unknownKeysOut, executor);
+}
+
+/// @brief JSONファイルからオブジェクトを読み込む（区間並列トークン化版、簡易インターフェース）。
+/// @tparam T 読み込み対象の型。
+/// @param filename 入力元のファイル名。
+/// @param out 読み込み先のオブジェクト。
+/// @param executor 並列処理に使う実行器。
+export template <HasSerializer T>
+void readJsonFileChunked(const std::string& filename, T& out,
+    rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
+    std::vector<std::string> unknownKeysOut;
+    readJsonFileChunked(filename, out, unknownKeysOut, executor);
+}
+
+/// @brief JSONファイルからオブジェクトを読み込む（自動選択版、内部実装）。
+/// @tparam T 読み込み対象の型。
+/// @param filename 入力元のファイル名。
+/// @param out 読み込み先のオブジェクト。
+/// @param unknownKeysOut 未知キーの収集先。
+/// @param executor 並列処理に使う実行器。
+/// @param instrumentation 計測フック。
+template <HasSerializer T, PipelineInstrumentation Instrumentation = NoPipelineInstrumentation>
+void readJsonFileImpl(const std::string& filename, T& out,
+    std::vector<std::string>& unknownKeysOut, rai::common::Executor& executor,
+    Instrumentation instrumentation = {}) {
     std::ifstream ifs(filename, std::ios::binary);
     if (!ifs.is_open()) {
         throw std::runtime_error("readJsonFile: Cannot open file " + filename);
@@ -307,25 +840,194 @@ void readJsonFile(const std::string& filename, T& out,
     // すでにファイルを開いているので、std::filesystem::file_sizeよりseekg+tellgの方が速い。
     ifs.seekg(0, std::ios::end);
     std::streamsize fileSize = ifs.tellg();
+    if (fileSize < 0) {
+        throw std::runtime_error("readJsonFile: Cannot determine the size of file " + filename);
+    }
     ifs.seekg(0, std::ios::beg);
 
-    if (fileSize <= smallFileThreshold) {
-        // 小ファイルは逐次版を使用
-        readJsonFileSequentialImpl(ifs, filename, out, fileSize, unknownKeysOut);
+    const JsonFileReadPolicy policy = getJsonFileReadPolicy();
+    if (static_cast<std::size_t>(fileSize) > policy.mappedFileThreshold) {
+        // 巨大ファイルはコピーを避けてマップする
+        ifs.close();
+        instrumentation.beginRead(JsonReadMethod::Mapped, static_cast<std::uint64_t>(fileSize));
+        readJsonFileMappedImpl(filename, out, unknownKeysOut, executor, instrumentation);
+    } else if (static_cast<std::size_t>(fileSize) <= policy.smallFileThreshold ||
+        executor.getThreadCount() == 0) {
+        // 小ファイル、またはスレッドを使わない実行器では逐次版を使用
+        instrumentation.beginRead(JsonReadMethod::Sequential, static_cast<std::uint64_t>(fileSize));
+        readJsonFileSequentialImpl(ifs, filename, out, fileSize, unknownKeysOut, executor,
+            instrumentation);
     } else {
         // 大ファイルは並列版を使用
-        readJsonFileParallelImpl(ifs, filename, out, unknownKeysOut);
+        instrumentation.beginRead(JsonReadMethod::Parallel, static_cast<std::uint64_t>(fileSize));
+        readJsonFileParallelImpl(ifs, filename, out, unknownKeysOut, executor, instrumentation);
     }
 }
 
+/// @brief JSONファイルからオブジェクトを読み込む。ファイルサイズに応じて最適な方法を選択。
+/// @tparam T 読み込み対象の型。
+/// @param filename 入力元のファイル名。
+/// @param out 読み込み先のオブジェクト。
+/// @param unknownKeysOut 未知キーの収集先。
+/// @param executor 並列処理に使う実行器。
+/// @note 小ファイル（既定では10KB以下）では逐次処理、大ファイルでは並列処理、
+///       巨大ファイル（既定では64MB超）ではメモリマップ版を自動選択します。閾値はsetJsonFileReadPolicy()で変更できます。
+///       スレッドを持たない実行器（InlineExecutor）では、大ファイルも逐次処理します。
+export template <HasSerializer T>
+void readJsonFile(const std::string& filename, T& out,
+    std::vector<std::string>& unknownKeysOut,
+    rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
+    readJsonFileImpl(filename, out, unknownKeysOut, executor);
+}
+
+/// @brief JSONファイルからオブジェクトを読み込み、パイプラインの各段の計測値を集計する。
+/// @tparam T 読み込み対象の型。
+/// @param filename 入力元のファイル名。
+/// @param out 読み込み先のオブジェクト。
+/// @param unknownKeysOut 未知キーの収集先。
+/// @param counters 計測値の集計先。読み込み前に初期化する。
+/// @param executor 並列処理に使う実行器。
+/// @note 読み込み方法の選択と処理はreadJsonFileと同じ。選んだ方法はcounters.methodに記録する。
+///       計測フックはテンプレート引数で差し込むため、計測しない読み込み関数は時刻を読まない。
+export template <HasSerializer T>
+void readJsonFile(const std::string& filename, T& out,
+    std::vector<std::string>& unknownKeysOut, JsonPipelineCounters& counters,
+    rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
+    using Instrumentation = CountingPipelineInstrumentation;
+    counters = JsonPipelineCounters{};
+    const std::uint64_t start = pipelineTimestamp<Instrumentation>();
+    readJsonFileImpl(filename, out, unknownKeysOut, executor, Instrumentation(counters));
+    counters.totalNanoseconds = pipelineTimestamp<Instrumentation>() - start;
+}
+
 /// @brief JSONファイルからオブジェクトを読み込む（自動選択版、簡易インターフェース）。
 /// @tparam T 読み込み対象の型。
 /// @param filename 入力元のファイル名。
 /// @param out 読み込み先のオブジェクト。
+/// @param executor 並列処理に使う実行器。
 export template <HasSerializer T>
-void readJsonFile(const std::string& filename, T& out) {
+void readJsonFile(const std::string& filename, T& out,
+    rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
     std::vector<std::string> unknownKeysOut;
-    readJsonFile(filename, out, unknownKeysOut);
+    readJsonFile(filename, out, unknownKeysOut, executor);
+}
+
+/// @brief 一括読み込みで、読み込みを先に発行しておくファイル数の下限。
+inline constexpr std::size_t minBatchReadAhead = 8;
+
+/// @brief 複数のJSONファイルを並行して読み込む（読み込みの設定を指定）。
+/// @tparam T 読み込み対象の型。
+/// @param filenames 入力元のファイル名の列。
+/// @param outputs 読み込み先のオブジェクトの列。filenamesと同じ長さであること。
+/// @param unknownKeysOut ファイル毎の未知キーの収集先。filenamesと同じ長さに揃える。
+/// @param options ファイル毎のAsyncFileInputSourceの設定。
+/// @param executor ファイル毎のトークン化と読み込みを実行する実行器。
+/// @note 呼び出しスレッドが先頭から順にAsyncFileInputSourceを開き、各ファイルの最初のqueueDepth個の
+///       読み込みを発行しておく。開いておくファイルは、実行器のスレッド数の2倍（最低minBatchReadAhead）まで。
+///       各ファイルは実行器のタスクの中で、届いた区間から全てトークン化してからパースする。
+/// @note 呼び出しスレッドのJsonProjectionScopeとMemoryResourceScopeの指定は、各ファイルの読み込みにも適用する。
+///       MemoryResourceScopeを指定した場合は、ファイルを呼び出しスレッドで順に読み込む。
+/// @note 失敗したファイルがあっても全ての読み込みの完了を待ってから、最初（ファイルの順）の例外を再送出する。
+export template <HasSerializer T>
+void readJsonFiles(std::span<const std::filesystem::path> filenames, std::span<T> outputs,
+    std::vector<std::vector<std::string>>& unknownKeysOut, const AsyncFileInputOptions& options,
+    rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
+    if (filenames.size() != outputs.size()) {
+        throw std::invalid_argument("readJsonFiles: filenames and outputs must have the same size");
+    }
+    const std::size_t count = filenames.size();
+    unknownKeysOut.assign(count, {});
+    std::vector<std::unique_ptr<AsyncFileInputSource>> sources(count);
+    std::vector<std::future<void>> tasks(count);
+    std::vector<std::exception_ptr> errors(count);
+    // 射影と確保先はスレッド毎の指定なので、呼び出しスレッドで取得してタスクの中で指定し直す。
+    const JsonProjection* const projection = scopedProjection();
+    std::pmr::memory_resource* const resource = scopedMemoryResource();
+    // memory_resource（monotonic_buffer_resourceなど）はスレッド安全とは限らないため、
+    // 確保先が指定されている場合はファイルを呼び出しスレッドで1つずつ読み込む（読み込みは先に発行する）。
+    rai::common::Executor& taskExecutor =
+        resource != nullptr ? rai::common::getInlineExecutor() : executor;
+
+    // どうしてこの実装にしたか：ファイル毎にスレッドを塞いで読むのではなく、開いた時点で全ての区間の
+    // 読み込みをカーネルへ発行しておき、タスクは届いたデータをトークン化する。開いたままのファイルは
+    // バッファとファイル記述子を持つため、先に開く数は窓の大きさで抑える。
+    // タスクの中ではトークナイザーを同じ実行器に積めないため、リングバッファは使わない。
+    auto start = [&](std::size_t i) {
+        try {
+            sources[i] = std::make_unique<AsyncFileInputSource>(filenames[i].string(), options);
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+    auto launch = [&](std::size_t i) {
+        if (!sources[i]) {
+            return;
+        }
+        try {
+            tasks[i] = taskExecutor.enqueue([&, i]() {
+                JsonProjectionScope projectionScope(projection);
+                MemoryResourceScope resourceScope(resource);
+                readJsonTokenizedFirst(*sources[i], outputs[i], unknownKeysOut[i], executor);
+            });
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+    const std::size_t window =
+        std::min(count, std::max(taskExecutor.getThreadCount() * 2, minBatchReadAhead));
+    for (std::size_t i = 0; i < window; ++i) {
+        start(i);
+    }
+    for (std::size_t i = 0; i < window; ++i) {
+        launch(i);
+    }
+    // どうしてこの実装にしたか：タスクが出力先を参照しているため、例外があっても全て待ってから送出する。
+    for (std::size_t i = 0; i < count; ++i) {
+        if (tasks[i].valid()) {
+            taskExecutor.wait(tasks[i]);
+            try {
+                tasks[i].get();
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        }
+        sources[i].reset();
+        if (i + window < count) {
+            start(i + window);
+            launch(i + window);
+        }
+    }
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+/// @brief 複数のJSONファイルを並行して読み込む。
+/// @tparam T 読み込み対象の型。
+/// @param filenames 入力元のファイル名の列。
+/// @param outputs 読み込み先のオブジェクトの列。filenamesと同じ長さであること。
+/// @param unknownKeysOut ファイル毎の未知キーの収集先。filenamesと同じ長さに揃える。
+/// @param executor ファイル毎のトークン化と読み込みを実行する実行器。
+/// @note AsyncFileInputSourceの既定の設定で読む。
+export template <HasSerializer T>
+void readJsonFiles(std::span<const std::filesystem::path> filenames, std::span<T> outputs,
+    std::vector<std::vector<std::string>>& unknownKeysOut,
+    rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
+    readJsonFiles(filenames, outputs, unknownKeysOut, AsyncFileInputOptions{}, executor);
+}
+
+/// @brief 複数のJSONファイルを並行して読み込む（簡易インターフェース）。
+/// @tparam T 読み込み対象の型。
+/// @param filenames 入力元のファイル名の列。
+/// @param outputs 読み込み先のオブジェクトの列。filenamesと同じ長さであること。
+/// @param executor ファイル毎のトークン化と読み込みを実行する実行器。
+export template <HasSerializer T>
+void readJsonFiles(std::span<const std::filesystem::path> filenames, std::span<T> outputs,
+    rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
+    std::vector<std::vector<std::string>> unknownKeysOut;
+    readJsonFiles(filenames, outputs, unknownKeysOut, executor);
 }
 
 // writeFormat/readFormatメソッドを持つ型専用のオーバーロード
@@ -336,10 +1038,10 @@ void readJsonFile(const std::string& filename, T& out) {
 /// @return JSON形式の文字列。
 export template <HasWriteFormat T>
 std::string getJsonContent(const T& obj) {
-    std::ostringstream oss;
-    JsonWriter writer(oss);
+    std::string result;
+    JsonWriter writer(result);
     obj.writeFormat(writer);
-    return oss.str();
+    return result;
 }
 
 /// @brief readFormatメソッドを持つ型をJSON文字列から読み込む。
@@ -376,6 +1078,9 @@ void readJsonFile(const std::string& filename, T& out) {
     // ファイルサイズを取得
     ifs.seekg(0, std::ios::end);
     std::streamsize fileSize = ifs.tellg();
+    if (fileSize < 0) {
+        throw std::runtime_error("readJsonFile: Cannot determine the size of file " + filename);
+    }
     ifs.seekg(0, std::ios::beg);
 
     // バッファに読み込み
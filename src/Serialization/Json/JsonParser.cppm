@@ -2,18 +2,183 @@
 // @brief JSON5パーサーの定義。トークン列からオブジェクトを構築する。
 
 module;
+#include <initializer_list>
+#include <memory>
+#include <memory_resource>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <type_traits>
-#include <variant>
 #include <vector>
 
 export module rai.serialization.json_parser;
 
 import rai.serialization.token_manager;
+import rai.common.thread_pool;
 
 export namespace rai::serialization {
 
+// ******************************************************************************** 読み込み先のmemory_resource
+/// @brief 現在のスレッドで構築するJsonParserが使うmemory_resourceを返す。
+/// @return 指定中のmemory_resourceへの参照（nullptrは未指定）。
+/// @note MemoryResourceScopeで設定する。
+inline std::pmr::memory_resource*& scopedMemoryResource() {
+    thread_local std::pmr::memory_resource* resource = nullptr;
+    return resource;
+}
+
+/// @brief 読み込んだ値の確保先として使うmemory_resourceを返す。
+/// @return 指定中のmemory_resource。未指定の場合はstd::pmr::get_default_resource()。
+/// @note ポリモーフィック型のファクトリ関数から、makePmrUnique()の確保先として使う。
+inline std::pmr::memory_resource& currentMemoryResource() {
+    std::pmr::memory_resource* resource = scopedMemoryResource();
+    return resource != nullptr ? *resource : *std::pmr::get_default_resource();
+}
+
+/// @brief 有効な間、現在のスレッドで構築するJsonParserに読み込み先のmemory_resourceを指定する。
+/// @note std::pmrのコンテナ・文字列や、アロケーターを受け取る型の値をそこへ確保して読み込む。
+///       std::pmr::monotonic_buffer_resourceを指定すると、読み込んだ文書を1つの領域にまとめて置ける。
+class MemoryResourceScope {
+public:
+    /// @brief memory_resourceを指定する。
+    /// @param resource 読み込み先のmemory_resource。nullptrは未指定に戻す。
+    explicit MemoryResourceScope(std::pmr::memory_resource* resource)
+        : previous_(scopedMemoryResource()) {
+        scopedMemoryResource() = resource;
+    }
+
+    /// @brief デストラクタ。以前の指定に戻す。
+    ~MemoryResourceScope() { scopedMemoryResource() = previous_; }
+
+    // コピー・ムーブ禁止（スコープで指定を戻すため）
+    MemoryResourceScope(const MemoryResourceScope&) = delete;
+    MemoryResourceScope& operator=(const MemoryResourceScope&) = delete;
+    MemoryResourceScope(MemoryResourceScope&&) = delete;
+    MemoryResourceScope& operator=(MemoryResourceScope&&) = delete;
+
+private:
+    std::pmr::memory_resource* previous_;  ///< 以前の指定。
+};
+
+// ******************************************************************************** 読み込むフィールドの射影
+/// @brief 読み込むフィールドをパスで指定する射影（パスの木の1節点）。
+/// @note パスはキーを'.'で区切って"header.version"のように指定する。配列は要素に同じ射影を適用するため、
+///       "items[*].id"の"[*]"は省略して"items.id"と書いてもよい。パスの末尾のフィールドは中身を全て読み込む。
+/// @note 射影に含まれないキーは値ごと読み飛ばし、未知キーとしても記録しない。
+///       必須フィールドの判定も射影に含まれるフィールドだけに行い、含まれないフィールドは変更しない。
+class JsonProjection {
+public:
+    JsonProjection() = default;
+
+    /// @brief パスの一覧から構築する。
+    /// @param paths 読み込むフィールドのパス。
+    JsonProjection(std::initializer_list<std::string_view> paths) {
+        for (const std::string_view path : paths) {
+            add(path);
+        }
+    }
+
+    /// @brief 読み込むフィールドのパスを追加する。
+    /// @param path '.'区切りのパス。各キーの末尾の"[*]"は無視する。
+    void add(std::string_view path) {
+        JsonProjection* node = this;
+        while (!node->selectsAll_) {
+            const std::size_t dot = path.find('.');
+            std::string_view key = path.substr(0, dot);
+            while (key.ends_with("[*]")) {
+                key.remove_suffix(3);
+            }
+            if (key.empty()) {
+                throw std::runtime_error("JsonProjection: empty key in path");
+            }
+            node = &node->child(key);
+            if (dot == std::string_view::npos) {
+                node->selectsAll_ = true;
+                node->children_.clear();
+                return;
+            }
+            path.remove_prefix(dot + 1);
+        }
+    }
+
+    /// @brief キーに対応する子の節点を返す。
+    /// @param key オブジェクトのキー。
+    /// @return 射影に含まれるキーなら子の節点、含まれないならnullptr。
+    const JsonProjection* find(std::string_view key) const {
+        // どうしてこの実装にしたか：射影するフィールドは数個のため、探索表を作らず順に比較する。
+        for (const auto& entry : children_) {
+            if (entry.key == key) {
+                return entry.node.get();
+            }
+        }
+        return nullptr;
+    }
+
+    /// @brief この節点より下を全て読み込むかを返す。
+    /// @return パスの末尾の節点ならtrue。
+    bool selectsAll() const { return selectsAll_; }
+
+private:
+    /// @brief 子の節点を返す（なければ追加する）。
+    JsonProjection& child(std::string_view key) {
+        for (auto& entry : children_) {
+            if (entry.key == key) {
+                return *entry.node;
+            }
+        }
+        children_.push_back(Child{std::string(key), std::make_unique<JsonProjection>()});
+        return *children_.back().node;
+    }
+
+    /// @brief 子の節点とそのキー。
+    struct Child {
+        std::string key;                        ///< オブジェクトのキー。
+        std::unique_ptr<JsonProjection> node;   ///< 子の節点。
+    };
+
+    std::vector<Child> children_;  ///< 射影に含まれるキーの子の節点。
+    bool selectsAll_ = false;      ///< この節点より下を全て読み込むならtrue。
+};
+
+/// @brief 現在のスレッドで構築するJsonParserが使う射影を返す。
+/// @return 指定中の射影への参照（nullptrは全て読み込む）。
+/// @note JsonProjectionScopeで設定する。
+inline const JsonProjection*& scopedProjection() {
+    thread_local const JsonProjection* projection = nullptr;
+    return projection;
+}
+
+/// @brief 有効な間、現在のスレッドで構築するJsonParserに読み込むフィールドの射影を指定する。
+/// @note readJsonString・readJsonFileなどの読み込み関数はそのまま射影したフィールドだけを読み込む。
+class JsonProjectionScope {
+public:
+    /// @brief 射影を指定する。
+    /// @param projection 読み込むフィールドの射影。本オブジェクトより長く存在すること。
+    explicit JsonProjectionScope(const JsonProjection& projection)
+        : previous_(scopedProjection()) {
+        scopedProjection() = &projection;
+    }
+
+    /// @brief 別のスレッドで取得した指定を引き継ぐ。
+    /// @param projection scopedProjection()で取得した射影。nullptrは全て読み込む。
+    explicit JsonProjectionScope(const JsonProjection* projection)
+        : previous_(scopedProjection()) {
+        scopedProjection() = projection;
+    }
+
+    /// @brief デストラクタ。以前の指定に戻す。
+    ~JsonProjectionScope() { scopedProjection() = previous_; }
+
+    // コピー・ムーブ禁止（スコープで指定を戻すため）
+    JsonProjectionScope(const JsonProjectionScope&) = delete;
+    JsonProjectionScope& operator=(const JsonProjectionScope&) = delete;
+    JsonProjectionScope(JsonProjectionScope&&) = delete;
+    JsonProjectionScope& operator=(JsonProjectionScope&&) = delete;
+
+private:
+    const JsonProjection* previous_;  ///< 以前の指定。
+};
+
 // @brief トークン管理型が満たすべきインターフェース
 
 // ******************************************************************************** JsonParser
@@ -23,7 +188,11 @@ class JsonParser {
 private:
     // 次のトークンを取得して消費
     // @note generateAllTokens()で必ずEndOfStreamTagが追加されるため、トークンは常に存在する
-    JsonToken take() { return tokenManager_.take(); }
+    JsonToken take() {
+        const JsonToken token = tokenManager_.take();
+        lastPosition_ = token.position;
+        return token;
+    }
 
     // 次のトークンを取得（消費しない）
     // @note generateAllTokens()で必ずEndOfStreamTagが追加されるため、トークンは常に存在する
@@ -31,9 +200,15 @@ private:
 
     // ******************************************************************************** 構築
 public:
-    // @brief コンストラクタ（トークン管理オブジェクトを指定）
-    // @param tokenManager トークン管理オブジェクトの参照
-    explicit JsonParser(TokenManager& tokenManager) : tokenManager_(tokenManager) {}
+    // @brief コンストラクタ（トークン読み出し元を指定）
+    // @param tokenManager トークン読み出し元の参照（TokenManager、RingBufferTokenManagerなど）
+    explicit JsonParser(TokenSource& tokenManager) : tokenManager_(tokenManager) {}
+
+    // @brief コンストラクタ（トークン読み出し元と、並列読み込みに使う実行器を指定）
+    // @param tokenManager トークン読み出し元の参照
+    // @param executor ParallelContainerConverterなどが要素の読み込みに使う実行器
+    JsonParser(TokenSource& tokenManager, rai::common::Executor& executor)
+        : tokenManager_(tokenManager), executor_(&executor) {}
 
     // ******************************************************************************** トークン読み取り
 public:
@@ -43,17 +218,23 @@ public:
         return peekToken().position;
     }
 
+    // @brief 直前に消費したトークンの開始位置を返す。
+    // @return 入力ストリーム内での開始位置（まだ消費していない場合は0）
+    // @note 読み込みが例外で止まった時、原因のトークンの位置を示すのに使う。
+    std::size_t lastPosition() const {
+        return lastPosition_;
+    }
+
     // @brief 次のトークンの種類を返す。
     // @return 次のトークンの種類を示すJsonTokenType値
     JsonTokenType nextTokenType() const {
-        // JsonTokenValueとJsonTokenTypeの列挙値の順序が一致していることを前提とする
-        return static_cast<JsonTokenType>(peekToken().value.index());
+        return peekToken().type;
     }
 
     // 構造トークン
     std::size_t startObject() {
         auto t = take();
-        if (!std::holds_alternative<json_token_detail::StartObjectTag>(t.value)) {
+        if (t.type != JsonTokenType::StartObject) {
             typeError("object start '{'");
         }
         return t.position;
@@ -61,7 +242,7 @@ public:
 
     std::size_t endObject() {
         auto t = take();
-        if (!std::holds_alternative<json_token_detail::EndObjectTag>(t.value)) {
+        if (t.type != JsonTokenType::EndObject) {
             typeError("object end '}'");
         }
         return t.position;
@@ -69,7 +250,7 @@ public:
 
     std::size_t startArray() {
         auto t = take();
-        if (!std::holds_alternative<json_token_detail::StartArrayTag>(t.value)) {
+        if (t.type != JsonTokenType::StartArray) {
             typeError("array start '['");
         }
         return t.position;
@@ -77,7 +258,7 @@ public:
 
     std::size_t endArray() {
         auto t = take();
-        if (!std::holds_alternative<json_token_detail::EndArrayTag>(t.value)) {
+        if (t.type != JsonTokenType::EndArray) {
             typeError("array end ']'");
         }
         return t.position;
@@ -86,45 +267,57 @@ public:
     // 次が EndArray / EndObject か確認（消費しない）
     // @note peekToken()は常に成功する（EndOfStreamTagが保証されている）
     bool nextIsEndArray() {
-        return std::holds_alternative<json_token_detail::EndArrayTag>(peekToken().value);
+        return peekToken().type == JsonTokenType::EndArray;
     }
 
     bool nextIsEndObject() {
-        return std::holds_alternative<json_token_detail::EndObjectTag>(peekToken().value);
+        return peekToken().type == JsonTokenType::EndObject;
     }
 
     // 次がnullならtrueを返す。それ以外のトークンならfalseを返す。
     // @note peekToken()は常に成功する（EndOfStreamTagが保証されている）
     bool nextIsNull() {
-        return std::holds_alternative<json_token_detail::NullTag>(peekToken().value);
+        return peekToken().type == JsonTokenType::Null;
     }
 
     // キー
     std::string nextKey() {
         auto t = take();
-        if (!std::holds_alternative<json_token_detail::KeyVal>(t.value)) {
+        if (t.type != JsonTokenType::Key) {
             typeError("object key");
         }
-        return std::get<json_token_detail::KeyVal>(t.value).v;
+        return std::string(tokenManager_.text(t));
+    }
+
+    // @brief キーを読み取り、トークンの格納先を参照するビューで返す（コピーしない）。
+    // @return キー名。次にreleaseConsumedStrings()を呼ぶまで有効。
+    //         コンテナの要素やフィールドの読み込みを越えて使う場合はコピーする。
+    std::string_view nextKeyView() {
+        auto t = take();
+        if (t.type != JsonTokenType::Key) {
+            typeError("object key");
+        }
+        return tokenManager_.text(t);
     }
 
     void expectKey(const char* expected) {
         auto t = take();
-        if (!std::holds_alternative<json_token_detail::KeyVal>(t.value)) {
+        if (t.type != JsonTokenType::Key) {
             typeError("object key");
         }
-        if (std::get<json_token_detail::KeyVal>(t.value).v != expected) {
+        const std::string_view key = tokenManager_.text(t);
+        if (key != expected) {
             throw std::runtime_error(
                 std::string("JsonParser: unexpected key '") +
-                std::get<json_token_detail::KeyVal>(t.value).v + "', expected '" + std::string(expected) + "'");
+                std::string(key) + "', expected '" + std::string(expected) + "'");
         }
     }
 
     // 値読み取り
     void readTo(bool& out) {
         auto t = take();
-        if (std::holds_alternative<json_token_detail::BoolVal>(t.value)) {
-            out = static_cast<bool>(std::get<json_token_detail::BoolVal>(t.value).v);
+        if (t.type == JsonTokenType::Bool) {
+            out = t.boolean;
         } else {
             typeError("bool");
         }
@@ -134,8 +327,8 @@ public:
         requires std::is_integral_v<T> && (!std::is_same_v<T, bool>)
     void readTo(T& out) {
         auto t = take();
-        if (std::holds_alternative<json_token_detail::IntVal>(t.value)) {
-            out = static_cast<T>(std::get<json_token_detail::IntVal>(t.value).v);
+        if (t.type == JsonTokenType::Integer) {
+            out = static_cast<T>(t.integer);
         } else {
             typeError("integer");
         }
@@ -145,12 +338,12 @@ public:
         requires std::is_floating_point_v<T>
     void readTo(T& out) {
         auto t = take();
-        if (std::holds_alternative<json_token_detail::NumVal>(t.value)) {
-            out = static_cast<T>(std::get<json_token_detail::NumVal>(t.value).v);
+        if (t.type == JsonTokenType::Number) {
+            out = static_cast<T>(t.number);
             return;
         }
-        if (std::holds_alternative<json_token_detail::IntVal>(t.value)) {
-            out = static_cast<T>(std::get<json_token_detail::IntVal>(t.value).v);
+        if (t.type == JsonTokenType::Integer) {
+            out = static_cast<T>(t.integer);
             return;
         }
         typeError("number");
@@ -158,8 +351,29 @@ public:
 
     void readTo(std::string& out) {
         auto t = take();
-        if (std::holds_alternative<json_token_detail::StrVal>(t.value)) {
-            out = std::get<std::string>(t.value);
+        if (t.type == JsonTokenType::String) {
+            out.assign(tokenManager_.text(t));
+            return;
+        }
+        typeError("string");
+    }
+
+    void readTo(std::pmr::string& out) {
+        auto t = take();
+        if (t.type == JsonTokenType::String) {
+            out.assign(tokenManager_.text(t));
+            return;
+        }
+        typeError("string");
+    }
+
+    // @brief 文字列を読み取り、トークンの格納先を参照するビューで返す（コピーしない）。
+    // @param out 読み取り先。次にreleaseConsumedStrings()を呼ぶまで有効。
+    //           コンテナの要素やフィールドの読み込みを越えて使う場合はコピーする。
+    void readTo(std::string_view& out) {
+        auto t = take();
+        if (t.type == JsonTokenType::String) {
+            out = tokenManager_.text(t);
             return;
         }
         typeError("string");
@@ -168,8 +382,8 @@ public:
     // @brief 文字列から1文字を読み込む
     void readTo(char& out) {
         auto t = take();
-        if (std::holds_alternative<json_token_detail::StrVal>(t.value)) {
-            const auto& str = std::get<json_token_detail::StrVal>(t.value);
+        if (t.type == JsonTokenType::String) {
+            const std::string_view str = tokenManager_.text(t);
             if (str.size() == 1) {
                 out = str[0];
                 return;
@@ -196,8 +410,8 @@ public:
     // @brief 文字列から1バイトを読み込む（UTF-8コードユニット）
     void readTo(char8_t& out) {
         auto t = take();
-        if (std::holds_alternative<json_token_detail::StrVal>(t.value)) {
-            const auto& str = std::get<json_token_detail::StrVal>(t.value);
+        if (t.type == JsonTokenType::String) {
+            const std::string_view str = tokenManager_.text(t);
             if (str.size() == 1) {
                 out = static_cast<char8_t>(static_cast<unsigned char>(str[0]));
                 return;
@@ -210,8 +424,8 @@ public:
     // @brief 文字列から1コードポイントを読み込む（UTF-16）
     void readTo(char16_t& out) {
         auto t = take();
-        if (std::holds_alternative<json_token_detail::StrVal>(t.value)) {
-            const auto& str = std::get<json_token_detail::StrVal>(t.value);
+        if (t.type == JsonTokenType::String) {
+            const std::string_view str = tokenManager_.text(t);
             char32_t codePoint;
             size_t byteCount;
             if (!decodeUtf8FirstCodePoint(str, codePoint, byteCount)) {
@@ -235,8 +449,8 @@ public:
     // @brief 文字列から1コードポイントを読み込む（UTF-32）
     void readTo(char32_t& out) {
         auto t = take();
-        if (std::holds_alternative<json_token_detail::StrVal>(t.value)) {
-            const auto& str = std::get<json_token_detail::StrVal>(t.value);
+        if (t.type == JsonTokenType::String) {
+            const std::string_view str = tokenManager_.text(t);
             char32_t codePoint;
             size_t byteCount;
 
@@ -352,40 +566,139 @@ public:
     // 値全体をスキップ（未知キーなどで使用）。プリミティブ/配列/オブジェクトを丸ごと消費する。
     void skipValue() {
         auto t = take();
+        switch (t.type) {
         // プリミティブ/Null/文字列/数値/真偽は1トークンで完結
-        if (std::holds_alternative<json_token_detail::NullTag>(t.value) ||
-            std::holds_alternative<json_token_detail::BoolVal>(t.value) ||
-            std::holds_alternative<json_token_detail::IntVal>(t.value) ||
-            std::holds_alternative<json_token_detail::NumVal>(t.value) ||
-            std::holds_alternative<json_token_detail::StrVal>(t.value)) {
+        case JsonTokenType::Null:
+        case JsonTokenType::Bool:
+        case JsonTokenType::Integer:
+        case JsonTokenType::Number:
+        case JsonTokenType::String:
             return;
-        }
         // オブジェクト: { key: value, ... }
-        if (std::holds_alternative<json_token_detail::StartObjectTag>(t.value)) {
+        case JsonTokenType::StartObject:
+            // どうしてこの実装にしたか：トークン管理側が対応する終了トークンまでの数を記録済みなら、
+            // 中身は文法検証済みのため1トークンずつ辿らず一括で読み進める。
+            if (t.subtreeSize != 0) {
+                skipSubtree(t);
+                return;
+            }
             while (!nextIsEndObject()) {
-                (void)nextKey();  // キーを消費
-                skipValue();      // 対応する値をスキップ
+                skipKey();     // キーを消費
+                skipValue();   // 対応する値をスキップ
             }
             endObject();
             return;
-        }
         // 配列: [ v1, v2, ... ]
-        if (std::holds_alternative<json_token_detail::StartArrayTag>(t.value)) {
+        case JsonTokenType::StartArray:
+            if (t.subtreeSize != 0) {
+                skipSubtree(t);
+                return;
+            }
             while (!nextIsEndArray()) {
                 skipValue();
             }
             endArray();
             return;
-        }
         // 想定外（Endマーカー/Keyなど値位置では不正）
-        if (std::holds_alternative<json_token_detail::EndOfStreamTag>(t.value)) {
+        case JsonTokenType::EndOfStream:
             typeError("value (got end-of-stream)");
-        }
-        if (std::holds_alternative<json_token_detail::KeyVal>(t.value)) {
+        case JsonTokenType::Key:
             typeError("value (got key)");
+        default:
+            return;
+        }
+    }
+
+    // @brief 配列の残りの要素のトークンを集める。配列終了']'まで消費する。
+    // @param tokens 集めたトークンの追加先（配列終了']'は含まない）。
+    // @param elementStarts 各要素の先頭トークンのtokens内の位置の追加先。
+    // @note startArray()の後に呼ぶ。入れ子の深さを追って要素の境界を求めるだけで、
+    //       要素の中身の検証は集めたトークンを読み込むときに行う。
+    void collectArrayElements(std::vector<JsonToken>& tokens,
+        std::vector<std::size_t>& elementStarts) {
+        std::size_t depth = 0;
+        for (;;) {
+            const JsonToken t = take();
+            switch (t.type) {
+            case JsonTokenType::StartObject:
+            case JsonTokenType::StartArray:
+                if (depth == 0) {
+                    elementStarts.push_back(tokens.size());
+                }
+                ++depth;
+                break;
+            case JsonTokenType::EndObject:
+            case JsonTokenType::EndArray:
+                if (depth == 0) {
+                    if (t.type == JsonTokenType::EndArray) {
+                        return;
+                    }
+                    typeError("array end ']'");
+                }
+                --depth;
+                break;
+            case JsonTokenType::EndOfStream:
+                typeError("array end ']' (got end-of-stream)");
+            case JsonTokenType::Key:
+                if (depth == 0) {
+                    typeError("value (got key)");
+                }
+                break;
+            default:
+                if (depth == 0) {
+                    elementStarts.push_back(tokens.size());
+                }
+                break;
+            }
+            tokens.push_back(t);
         }
     }
 
+    // @brief トークン読み出し元を返す（文字列内容の解決に使う）。
+    const TokenSource& tokenSource() const { return tokenManager_; }
+
+    // @brief 読み終えた値の文字列が使う、文字列アリーナのチャンクを解放する。
+    // @note コンテナの要素1つ、またはフィールド1つを読み終えた位置で呼ぶ。
+    //       アリーナ内の文字列を指すnextKeyView()／readTo(std::string_view&)のビューは無効になる。
+    void releaseConsumedStrings() { tokenManager_.releaseConsumedStrings(); }
+
+    // @brief 並列読み込みに使う実行器を返す（未指定の場合は既定の実行器）。
+    rai::common::Executor& executor() const {
+        return executor_ != nullptr ? *executor_ : rai::common::getDefaultExecutor();
+    }
+
+    // @brief 読み込んだ値の確保先を返す（nullptrは未指定）。
+    // @note 構築時に、そのスレッドでMemoryResourceScopeが指定しているものを引き継ぐ。
+    std::pmr::memory_resource* memoryResource() const { return memoryResource_; }
+
+    // @brief 読み込んだ値の確保先を設定する。
+    // @param resource 確保先のmemory_resource（nullptrは未指定）。
+    void setMemoryResource(std::pmr::memory_resource* resource) { memoryResource_ = resource; }
+
+    // @brief 現在読み込み中のオブジェクトに適用する射影を返す。
+    // @return 射影の節点（nullptrは全て読み込む）。
+    // @note 構築時に、そのスレッドでJsonProjectionScopeが指定しているものを引き継ぐ。
+    //       フィールドを読み込む間は、そのフィールドに対応する子の節点に切り替わる。
+    const JsonProjection* projection() const { return projection_; }
+
+    // @brief 現在読み込み中のオブジェクトに適用する射影を設定する。
+    // @param projection 射影の節点（nullptrは全て読み込む）。
+    void setProjection(const JsonProjection* projection) { projection_ = projection; }
+
+private:
+    // @brief キーを内容を取り出さずに消費する（skipValue用）
+    void skipKey() {
+        if (take().type != JsonTokenType::Key) {
+            typeError("object key");
+        }
+    }
+
+    // @brief 取得済みの開始トークンに続く、対応する終了トークンまでを一括で消費する（skipValue用）
+    // @param start subtreeSizeが記録済みのStartObject/StartArrayトークン
+    void skipSubtree(const JsonToken& start) {
+        tokenManager_.skipTokens(start.subtreeSize);
+    }
+
 private:
     [[noreturn]] static void typeError(const char* expected) {
         throw std::runtime_error(std::string("JsonParser: expected ") + expected);
@@ -393,8 +706,12 @@ private:
 
     // ******************************************************************************** メンバー変数
 private:
-    TokenManager& tokenManager_;       ///< トークン管理オブジェクトの参照
+    TokenSource& tokenManager_;       ///< トークン読み出し元の参照
+    rai::common::Executor* executor_ = nullptr;  ///< 並列読み込みに使う実行器（nullptrは既定の実行器）
+    std::pmr::memory_resource* memoryResource_ = scopedMemoryResource();  ///< 読み込んだ値の確保先（nullptrは未指定）
     std::vector<std::string> unknownKeys_{};  ///< 未知キー記録（診断用）
+    std::size_t lastPosition_ = 0;  ///< 直前に消費したトークンの開始位置
+    const JsonProjection* projection_ = scopedProjection();  ///< 読み込むフィールドの射影（nullptrは全て）
 
 public:
     // @brief 未知キーの一覧を取得して所有権を移動
@@ -402,10 +719,13 @@ public:
 
     // @brief 未知キーを記録する（後で診断に利用）
     // @param key 未知のキー名
-    void noteUnknownKey(std::string key) { unknownKeys_.push_back(std::move(key)); }
+    void noteUnknownKey(std::string_view key) { unknownKeys_.emplace_back(key); }
 
     // @brief 未知キーの一覧を取得（const参照）
     const std::vector<std::string>& unknownKeys() const { return unknownKeys_; }
+
+    // @brief 記録した未知キーを破棄する（容量は再利用する）
+    void clearUnknownKeys() { unknownKeys_.clear(); }
 };
 
 }  // namespace rai::serialization
@@ -2,12 +2,16 @@
 // @brief JSON5トークナイザーの定義。入力文字列からトークン列を生成する。
 
 module;
+#include <bit>
+#include <charconv>
 #include <cstdint>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 #include <limits>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <utility>
 
 // マクロ定義（識別子文字の列挙）
@@ -29,6 +33,8 @@ module;
 export module rai.serialization.json_tokenizer;
 
 import rai.serialization.token_manager;
+import rai.serialization.simd_scanner;
+import rai.serialization.pipeline_instrumentation;
 
 export namespace rai::serialization {
 
@@ -40,12 +46,31 @@ concept InputSource = requires(T& t, const T& ct, std::size_t offset, std::size_
     { ct.position() } -> std::same_as<std::size_t>;
 };
 
+// 入力全体を連続領域として保持し、トークン化中に移動しない入力文字列取得元のconcept
+// @note 満たす場合、エスケープを含まない文字列は入力バッファをそのまま参照する。
+//       また、文字列本体や空白の連続はSIMD走査でまとめて読み進める。
+template <typename T>
+concept ContiguousInputSource = InputSource<T> && requires(const T& ct) {
+    { ct.data() } -> std::same_as<const char*>;
+    { ct.size() } -> std::same_as<std::size_t>;
+};
+
+// 入力を連続したバッファ毎に保持する入力文字列取得元のconcept
+// @note bufferedRun()は現在位置から消費中のバッファの末尾までを返す。文字列本体や空白の連続は
+//       その範囲でSIMD走査し、バッファの境目では切り替えてから走査を続ける。
+template <typename T>
+concept BufferedInputSource = InputSource<T> && requires(const T& ct) {
+    { ct.bufferedRun() } -> std::same_as<std::string_view>;
+};
+
 // @brief トークン管理型が満たすべきインターフェース
 template <typename T>
-concept IsTokenManager = requires(T& t, JsonToken&& token) {
+concept IsTokenManager = requires(T& t, JsonToken&& token, const char* data) {
     // トークンを追加。tokenはrvalue referenceだが、
     // 名前付き変数なのでstd::move()でrvalueに変換する必要がある
     { t.pushToken(std::move(token)) } -> std::same_as<void>;
+    { t.arena() } -> std::same_as<JsonStringArena&>;
+    { t.setInputData(data) } -> std::same_as<void>;
 };
 
 // @brief 警告メッセージ出力用のconcept
@@ -75,7 +100,9 @@ public:
 
 // ******************************************************************************** JsonTokenizer
 // @brief JSON5トークナイザー（入力文字列からトークン列を生成）
-template <InputSource Input, IsTokenManager TokMgr>
+// @tparam Instrumentation 計測フックの型。トークン種別毎の数、文字列アリーナの確保、トークン化の時間を記録する。
+template <InputSource Input, IsTokenManager TokMgr,
+    PipelineInstrumentation Instrumentation = NoPipelineInstrumentation>
 class JsonTokenizer {
     // ******************************************************************************** 空白文字とコメントのスキップ
 private:
@@ -91,6 +118,8 @@ private:
                 case '\t':  // U+0009 Horizontal tab
                 case '\n':  // U+000A Line feed
                 case '\r':  // U+000D Carriage return
+                    consumeWhitespaceRun();
+                    continue;
                 case '\v':  // U+000B Vertical tab
                 case '\f':  // U+000C Form feed
                     consume();
@@ -149,15 +178,14 @@ private:
                     case '/':       // 単一行コメント //
                         consume(2);  // "//"
                         // 改行か終端まで読み飛ばし（JSON5仕様7 Comments準拠）
-                        while (!isLineTerminator()) {
-                            consume();
-                        }
+                        skipLineCommentBody();
                         // 改行コードは次の反復で読み飛ばす。
                         continue;
                     case '*':       // 複数行コメント /* */
                         consume(2);  // "/*"
                         // */ まで読み飛ばし
                         for (;;) {
+                            skipToAsterisk();
                             char ch = peek();
                             if (ch == '\0') {
                                 break;  // 入力終端（閉じていないコメント）
@@ -179,13 +207,174 @@ private:
         }
     }
 
+    // ******************************************************************************** 連続した文字の一括読み進め
+private:
+    // @brief 現在位置から続くASCII空白（' ', '\t', '\n', '\r'）をまとめて読み進める
+    // @note 現在位置が上記の空白であること。連続領域でない入力元では1文字だけ読み進める。
+    void consumeWhitespaceRun() {
+        if constexpr (scannable_) {
+            const std::string_view run = scannableRun();
+            consume(scanner_.whitespaceRun(run.data(), run.size()));
+        } else {
+            consume();
+        }
+    }
+
+    // @brief 単一行コメントの本体を、改行か終端の直前まで読み飛ばす
+    void skipLineCommentBody() {
+        for (;;) {
+            if constexpr (scannable_) {
+                // どうしてこの実装にしたか：改行候補のbyteまでをSIMDで飛ばし、
+                // 0xE2がU+2028/U+2029かどうかの判定だけを1文字ずつ行う。
+                const std::string_view run = scannableRun();
+                consume(scanner_.lineCommentRun(run.data(), run.size()));
+            }
+            if (isLineTerminator()) {
+                return;
+            }
+            consume();
+        }
+    }
+
+    // @brief 複数行コメント内で、次の'*'か終端の位置まで読み飛ばす
+    // @note 走査できない入力元では何もしない（呼び出し元が1文字ずつ読み進める）。
+    //       バッファ毎の入力元では消費中のバッファの末尾で止まり、呼び出し元の次の反復で続ける。
+    void skipToAsterisk() {
+        if constexpr (scannable_) {
+            const std::string_view run = scannableRun();
+            const void* found = std::memchr(run.data(), '*', run.size());
+            consume(found != nullptr ? static_cast<const char*>(found) - run.data() : run.size());
+        }
+    }
+
+    // @brief 文字列本体の通常文字の連続を、そのまま内容として読み進める
+    // @param quote 終了引用符
+    // @note 現在位置が通常文字（引用符・'\\'・0xE2以外）であること。
+    void takeStringRun(char quote) {
+        if constexpr (scannable_) {
+            const std::string_view rest = scannableRun();
+            const std::size_t run = scanner_.stringRun(rest.data(), rest.size(), quote);
+            // 制御文字はSIMD走査で止まるが内容としては通常文字なので、最低1文字は進める。
+            // バッファの境目で止まった場合も、残りは次の呼び出しで切り替えたバッファから続ける。
+            const std::size_t count = run != 0 ? run : 1;
+            if (textInArena_) {
+                tokenManager_.arena().append(rest.data(), count);
+            }
+            consume(count);
+        } else {
+            takeRaw();
+        }
+    }
+
+    /// @brief SIMD走査で一括して読み進められる入力元かどうか。
+    static constexpr bool scannable_ = ContiguousInputSource<Input> || BufferedInputSource<Input>;
+
+    // @brief 現在位置から連続して読める入力の範囲を返す
+    // @note 連続領域の入力元では入力の末尾まで、バッファ毎の入力元では消費中のバッファの末尾まで。
+    std::string_view scannableRun() const {
+        if constexpr (ContiguousInputSource<Input>) {
+            const std::size_t pos = inputSource_.position();
+            return std::string_view(inputSource_.data() + pos, inputSource_.size() - pos);
+        } else {
+            return inputSource_.bufferedRun();
+        }
+    }
+
+    // ******************************************************************************** 文字列内容の組み立て
+private:
+    /// @brief 解析した文字列・識別子の内容の位置。
+    struct ParsedText {
+        JsonStringSlice slice;  ///< 内容の位置。
+        bool inArena;           ///< 文字列アリーナ内ならtrue、入力バッファ内ならfalse。
+    };
+
+    /// @brief 文字列内容の組み立てを開始する。
+    /// @param start 内容の先頭の入力位置。
+    /// @note どうしてこの実装にしたか：入力が連続領域なら、エスケープが現れるまでは
+    ///       入力バッファを参照するだけにして、文字列毎のヒープ確保とコピーを避ける。
+    void beginText(std::size_t start) {
+        textStart_ = start;
+        textInArena_ = !ContiguousInputSource<Input>;
+        if (textInArena_) {
+            tokenManager_.arena().begin();
+        }
+    }
+
+    /// @brief 現在位置からcount文字を、そのまま内容として読み進める。
+    /// @param count 読み進める文字数。
+    void takeRaw(std::size_t count = 1) {
+        if (textInArena_) {
+            auto& arena = tokenManager_.arena();
+            for (std::size_t i = 0; i < count; ++i) {
+                arena.push(peekAhead(i));
+            }
+        }
+        consume(count);
+    }
+
+    /// @brief 入力と異なる内容（エスケープの復号結果など）を書き込めるよう、文字列アリーナへ移す。
+    /// @note 現在位置より前の内容は入力バッファからコピーする。エスケープ開始前に呼ぶこと。
+    void moveTextToArena() {
+        if constexpr (ContiguousInputSource<Input>) {
+            if (!textInArena_) {
+                auto& arena = tokenManager_.arena();
+                arena.begin();
+                arena.append(inputSource_.data() + textStart_,
+                    inputSource_.position() - textStart_);
+                textInArena_ = true;
+            }
+        }
+    }
+
+    /// @brief 復号した1文字を内容に追加する。
+    /// @param c 追加する文字。
+    /// @note 事前にmoveTextToArena()を呼び出すこと。
+    void pushDecoded(char c) {
+        tokenManager_.arena().push(c);
+    }
+
+    /// @brief 文字列内容の組み立てを終了する。
+    /// @return 内容の位置。
+    ParsedText finishText() {
+        if constexpr (ContiguousInputSource<Input>) {
+            if (!textInArena_) {
+                const std::size_t end = inputSource_.position();
+                if (end <= JsonToken::maxPosition) {
+                    return ParsedText{JsonStringSlice{static_cast<std::uint32_t>(textStart_),
+                        static_cast<std::uint32_t>(end - textStart_)}, false};
+                }
+                // スライスで表せない位置の文字列は、文字列アリーナへ写す。
+                moveTextToArena();
+            }
+        }
+        return ParsedText{tokenManager_.arena().finish(), true};
+    }
+
+    /// @brief 消費済みの予約語をキーとして使う場合の内容を返す。
+    /// @param word 予約語の文字列。
+    /// @param length 予約語の長さ。
+    /// @param start 予約語の入力位置。
+    /// @return 内容の位置。
+    ParsedText reservedWordText(const char* word, std::size_t length, std::size_t start) {
+        if constexpr (ContiguousInputSource<Input>) {
+            if (start + length <= JsonToken::maxPosition) {
+                return ParsedText{JsonStringSlice{static_cast<std::uint32_t>(start),
+                    static_cast<std::uint32_t>(length)}, false};
+            }
+        }
+        auto& arena = tokenManager_.arena();
+        arena.begin();
+        arena.append(word, length);
+        return ParsedText{arena.finish(), true};
+    }
+
     // ******************************************************************************** 文字列・識別子の解析
 private:
     // @brief 文字列をパース
     // @param quote 開始引用符（'または"）
-    std::string parseString(char quote) {
-        std::string result;
+    ParsedText parseString(char quote) {
         consume(); // 開始引用符を消費
+        beginText(inputSource_.position());
 
         for (;;) {
             unsigned char c = static_cast<unsigned char>(peek());
@@ -199,28 +388,29 @@ private:
             case '\'':
                 // 終了引用符かチェック
                 if (static_cast<char>(c) == quote) {
+                    ParsedText text = finishText();
                     consume(); // 終了引用符を消費
-                    return result;
+                    return text;
                 }
                 // 異なる引用符の場合は通常の文字として処理
-                result += peek();
-                consume();
+                takeRaw();
                 break;
             case '\\': {
                 // エスケープシーケンス処理
+                moveTextToArena();
                 consume();  // '\'を消費
                 unsigned char next = static_cast<unsigned char>(peek());
                 consume();
                 switch (next) {
-                    case '"':  result += '"'; break;
-                    case '\'': result += '\''; break;
-                    case '\\': result += '\\'; break;
-                    case 'b':  result += '\b'; break;
-                    case 'f':  result += '\f'; break;
-                    case 'n':  result += '\n'; break;
-                    case 'r':  result += '\r'; break;
-                    case 't':  result += '\t'; break;
-                    case 'v':  result += '\v'; break;
+                    case '"':  pushDecoded('"'); break;
+                    case '\'': pushDecoded('\''); break;
+                    case '\\': pushDecoded('\\'); break;
+                    case 'b':  pushDecoded('\b'); break;
+                    case 'f':  pushDecoded('\f'); break;
+                    case 'n':  pushDecoded('\n'); break;
+                    case 'r':  pushDecoded('\r'); break;
+                    case 't':  pushDecoded('\t'); break;
+                    case 'v':  pushDecoded('\v'); break;
                     case '0': {
                         // JSON5仕様5.1: \0の後に数字(1-9)が続いてはいけない
                         auto nn = peek();
@@ -228,7 +418,7 @@ private:
                             throw std::runtime_error(
                                 "JSON5: decimal digit must not follow \\0 escape sequence");
                         }
-                        result += '\0';
+                        pushDecoded('\0');
                         break;
                     }
                     case '\n': // 行継続（エスケープされた改行は無視）
@@ -250,25 +440,25 @@ private:
                             }
                         }
                         // それ以外は通常のエスケープとして処理
-                        result += static_cast<char>(0xE2);
-                        result += static_cast<char>(next);
+                        pushDecoded(static_cast<char>(0xE2));
+                        pushDecoded(static_cast<char>(next));
                         break;
                     }
                     case 'x': {
                         // Latin-1 Supplement エスケープ \xXX (2桁の16進数)
                         int codePoint = parseHexEscape(2, "\\x");
-                        result += static_cast<char>(codePoint);
+                        pushDecoded(static_cast<char>(codePoint));
                         break;
                     }
                     case 'u': {
                         // Unicode エスケープ \uXXXX (4桁の16進数)
                         int codePoint = parseHexEscape(4, "\\u");
-                        appendUtf8(result, codePoint);
+                        appendUtf8(codePoint);
                         break;
                     }
                     default:
                         // その他のエスケープは文字そのまま
-                        result += static_cast<char>(next);
+                        pushDecoded(static_cast<char>(next));
                         break;
                 }
                 break;
@@ -281,35 +471,26 @@ private:
                     case 0xA8:  // U+2028 (Line separator)
                         warningOutput_.warning("Unescaped U+2028 (Line separator) in string at position " +
                                              std::to_string(inputSource_.position()));
-                        result += peek();
-                        result += peekAhead(1);
-                        result += peekAhead(2);
-                        consume(3);
+                        takeRaw(3);
                         break;
                     case 0xA9:  // U+2029 (Paragraph separator)
                         warningOutput_.warning("Unescaped U+2029 (Paragraph separator) in string at position " +
                                              std::to_string(inputSource_.position()));
-                        result += peek();
-                        result += peekAhead(1);
-                        result += peekAhead(2);
-                        consume(3);
+                        takeRaw(3);
                         break;
                     default:
                         // U+2028/U+2029以外のE2始まり文字
-                        result += peek();
-                        consume();
+                        takeRaw();
                         break;
                     }
                 } else {
                     // 0xE2だが0x80が続かない場合
-                    result += peek();
-                    consume();
+                    takeRaw();
                 }
                 break;
             default:
                 // 通常の文字
-                result += peek();
-                consume();
+                takeStringRun(quote);
                 break;
             }
         }
@@ -317,8 +498,8 @@ private:
 
     // @brief 識別子をパース（JSON5のキー名用）
     // @note ECMAScript 5.1のIdentifierNameに準拠（Unicode文字対応）
-    std::string parseIdentifier() {
-        std::string result;
+    ParsedText parseIdentifier() {
+        beginText(inputSource_.position());
         char c = peek();
 
         // 最初の文字は英字、$、_、またはUnicode文字
@@ -326,23 +507,23 @@ private:
             case '$': case '_':
             CASE_ALPHA_LOWER:
             CASE_ALPHA_UPPER:
-                result += peek();
-                consume();
+                takeRaw();
                 break;
                 // ※識別子では\xXX形式のエスケープ文字には対応しない。
             case '\\': // Unicodeエスケープ \uXXXX（識別子内）
+                moveTextToArena();
                 consume();  // '\'
                 if (peek() == 'u') {
                     consume();  // 'u'
                     int codePoint = parseHexEscape(4, "\\u");
-                    appendUtf8(result, codePoint);
+                    appendUtf8(codePoint);
                 } else {
                     throw std::runtime_error("JSON5: invalid escape in identifier");
                 }
                 break;
             default:
                 // Unicode文字をチェック（consumeUnicodeCharがfalseを返す場合はASCII文字で不正）
-                if (!consumeUnicodeChar(result)) {
+                if (!consumeUnicodeChar()) {
                     throw std::runtime_error("JSON5: expected identifier or object key");
                 }
                 break;
@@ -356,31 +537,29 @@ private:
                 CASE_PART_DIGITS:
                 CASE_ALPHA_LOWER:
                 CASE_ALPHA_UPPER:
-                    result += peek();
-                    consume();
+                    takeRaw();
                     break;
                 case '\\':
                     // Unicodeエスケープ \uXXXX（識別子内）
+                    moveTextToArena();
                     consume();  // '\'
                     if (peek() == 'u') {
                         consume();  // 'u'
                         int codePoint = parseHexEscape(4, "\\u");
-                        appendUtf8(result, codePoint);
+                        appendUtf8(codePoint);
                     } else {
                         throw std::runtime_error("JSON5: invalid escape in identifier");
                     }
                     break;
                 default:
                     // Unicode文字をチェック（consumeUnicodeCharがfalseを返す場合は識別子終端）
-                    if (!consumeUnicodeChar(result)) {
+                    if (!consumeUnicodeChar()) {
                         // 識別子にできる文字以外、または終端(\0)
-                        return result;
+                        return finishText();
                     }
                     break;
             }
         }
-
-        return result;
     }
 
     // @brief 16進数エスケープシーケンスをパース（\xXX または \uXXXX）
@@ -403,39 +582,37 @@ private:
         return codePoint;
     }
 
-    // @brief Unicode コードポイントをUTF-8にエンコードして文字列に追加
-    // @param result 追加先の文字列
+    // @brief Unicode コードポイントをUTF-8にエンコードして内容に追加
     // @param codePoint Unicodeコードポイント
-    static void appendUtf8(std::string& result, int codePoint) {
+    void appendUtf8(int codePoint) {
         if (codePoint < 0) {
             throw std::runtime_error("JSON5: invalid code point");
         } else if (codePoint <= 0x7F) {
             // 1バイト (ASCII)
-            result += static_cast<char>(codePoint);
+            pushDecoded(static_cast<char>(codePoint));
         } else if (codePoint <= 0x7FF) {
             // 2バイト
-            result += static_cast<char>(0xC0 | ((codePoint >> 6) & 0x1F));
-            result += static_cast<char>(0x80 | (codePoint & 0x3F));
+            pushDecoded(static_cast<char>(0xC0 | ((codePoint >> 6) & 0x1F)));
+            pushDecoded(static_cast<char>(0x80 | (codePoint & 0x3F)));
         } else if (codePoint <= 0xFFFF) {
             // 3バイト
-            result += static_cast<char>(0xE0 | ((codePoint >> 12) & 0x0F));
-            result += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
-            result += static_cast<char>(0x80 | (codePoint & 0x3F));
+            pushDecoded(static_cast<char>(0xE0 | ((codePoint >> 12) & 0x0F)));
+            pushDecoded(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+            pushDecoded(static_cast<char>(0x80 | (codePoint & 0x3F)));
         } else if (codePoint <= 0x10FFFF) {
             // 4バイト
-            result += static_cast<char>(0xF0 | ((codePoint >> 18) & 0x07));
-            result += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
-            result += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
-            result += static_cast<char>(0x80 | (codePoint & 0x3F));
+            pushDecoded(static_cast<char>(0xF0 | ((codePoint >> 18) & 0x07)));
+            pushDecoded(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+            pushDecoded(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+            pushDecoded(static_cast<char>(0x80 | (codePoint & 0x3F)));
         } else {
             throw std::runtime_error("JSON5: code point out of Unicode range");
         }
     }
 
-    // @brief Unicode文字（マルチバイトUTF-8）を1文字消費して追加
-    // @param result 追加先の文字列
+    // @brief Unicode文字（マルチバイトUTF-8）を1文字消費して内容に追加
     // @return Unicode文字として有効ならtrue、そうでなければfalse
-    bool consumeUnicodeChar(std::string& result) {
+    bool consumeUnicodeChar() {
         unsigned char first = static_cast<unsigned char>(peek());
 
         if (first < 0x80) {
@@ -443,24 +620,15 @@ private:
             return false;
         } else if ((first & 0xE0) == 0xC0) {
             // 2バイト
-            result += peek();
-            result += peekAhead(1);
-            consume(2);
+            takeRaw(2);
             return true;
         } else if ((first & 0xF0) == 0xE0) {
             // 3バイト
-            result += peek();
-            result += peekAhead(1);
-            result += peekAhead(2);
-            consume(3);
+            takeRaw(3);
             return true;
         } else if ((first & 0xF8) == 0xF0) {
             // 4バイト
-            result += peek();
-            result += peekAhead(1);
-            result += peekAhead(2);
-            result += peekAhead(3);
-            consume(4);
+            takeRaw(4);
             return true;
         } else {
             // 不正なUTF-8
@@ -504,7 +672,7 @@ private:
             if (isNegative) {
                 value = -value;
             }
-            emitToken(json_token_detail::IntVal{value}, tokenPos);
+            emitToken(JsonToken::makeInteger(value, tokenPos));
             validateAfterValue();
             return;
         }
@@ -547,12 +715,161 @@ private:
         }
     }
 
+    /// @brief 10進数の仮数部の読み取り状態。
+    /// @note 値は mantissa * 10^exponent で表す。有効桁は最大19桁まで保持する。
+    struct DecimalDigits {
+        std::uint64_t mantissa = 0;  ///< 有効桁（先頭の0を除く、最大19桁）
+        int significant = 0;         ///< mantissaに取り込んだ桁数
+        int exponent = 0;            ///< 10進指数の補正値
+        bool truncated = false;      ///< 0以外の桁を切り捨てたか
+    };
+
+    /// @brief 10進数1桁を仮数部に追加する。
+    /// @param digits 仮数部の読み取り状態
+    /// @param digit 桁の値（0～9）
+    /// @param isFraction 小数部の桁ならtrue
+    static constexpr void appendDigit(DecimalDigits& digits, int digit, bool isFraction) {
+        constexpr int maxSignificant = 19;  // uint64_tで桁あふれしない最大桁数
+        if (digits.significant < maxSignificant) {
+            if (digits.mantissa != 0 || digit != 0) {
+                digits.mantissa = digits.mantissa * 10 + static_cast<std::uint64_t>(digit);
+                ++digits.significant;
+            }
+            if (isFraction) {
+                --digits.exponent;
+            }
+        } else {
+            digits.truncated = digits.truncated || digit != 0;
+            if (!isFraction) {
+                ++digits.exponent;
+            }
+        }
+    }
+
+    /// @brief 8byteが全て10進数の桁かを判定する（SWAR）。
+    /// @param chunk リトルエンディアンで読み込んだ8byte
+    static constexpr bool isEightDigits(std::uint64_t chunk) {
+        return ((chunk & 0xF0F0F0F0F0F0F0F0ull) |
+                (((chunk + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) ==
+               0x3333333333333333ull;
+    }
+
+    /// @brief 10進数8桁を数値に変換する（SWAR）。
+    /// @param chunk リトルエンディアンで読み込んだ8byte。isEightDigits()を満たすこと。
+    static constexpr std::uint32_t parseEightDigits(std::uint64_t chunk) {
+        constexpr std::uint64_t mask = 0x000000FF000000FFull;
+        constexpr std::uint64_t mul1 = 0x000F424000000064ull;  // 100 + (1000000 << 32)
+        constexpr std::uint64_t mul2 = 0x0000271000000001ull;  // 1 + (10000 << 32)
+        chunk -= 0x3030303030303030ull;
+        chunk = (chunk * 10) + (chunk >> 8);
+        chunk = (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32;
+        return static_cast<std::uint32_t>(chunk);
+    }
+
+    /// @brief 連続する10進数の桁を読み取り、仮数部に追加する
+    /// @param digits 仮数部の読み取り状態
+    /// @param isFraction 小数部の桁ならtrue
+    /// @return 1桁以上読み取った場合はtrue
+    bool readDigits(DecimalDigits& digits, bool isFraction) {
+        bool hasDigits = false;
+        if constexpr (ContiguousInputSource<Input> && std::endian::native == std::endian::little) {
+            // どうしてこの実装にしたか：長い数字列は8桁ずつまとめて変換し、桁毎の分岐を減らす。
+            // 19桁を超える分は1桁ずつ処理して、切り捨ての判定をappendDigit()に任せる。
+            for (;;) {
+                const std::size_t pos = inputSource_.position();
+                if (pos + 8 > inputSource_.size() || digits.significant + 8 > 19) {
+                    break;
+                }
+                const char* p = inputSource_.data() + pos;
+                if (digits.mantissa == 0 && *p == '0') {
+                    break;  // 先頭の0は有効桁に数えないため1桁ずつ処理する。
+                }
+                std::uint64_t chunk = 0;
+                std::memcpy(&chunk, p, sizeof(chunk));
+                if (!isEightDigits(chunk)) {
+                    break;
+                }
+                digits.mantissa = digits.mantissa * 100000000ull + parseEightDigits(chunk);
+                digits.significant += 8;
+                if (isFraction) {
+                    digits.exponent -= 8;
+                }
+                consume(8);
+                hasDigits = true;
+            }
+        }
+        while (isDecimalDigit(peek())) {
+            appendDigit(digits, peek() - '0', isFraction);
+            consumeNumberChar();
+            hasDigits = true;
+        }
+        return hasDigits;
+    }
+
+    /// @brief 数値の1文字を読み進める
+    /// @note 連続領域でない入力元では、std::from_charsへ渡すため文字を保持する。
+    void consumeNumberChar() {
+        if constexpr (!ContiguousInputSource<Input>) {
+            numberText_.push_back(peek());
+        }
+        consume();
+    }
+
+    /// @brief 解析中の数値の文字列（符号を除く）を返す
+    /// @param start 数値の先頭の入力位置（符号を除く）
+    std::string_view numberText(std::size_t start) const {
+        if constexpr (ContiguousInputSource<Input>) {
+            return std::string_view(inputSource_.data() + start,
+                inputSource_.position() - start);
+        } else {
+            return numberText_;
+        }
+    }
+
+    /// @brief 整数として表せない10進数を倍精度浮動小数点数に変換する
+    /// @param text 数値の文字列（符号を除く）
+    /// @param digits 仮数部の読み取り状態（範囲外時の判定に使う）
+    /// @param exponent 指数部の値
+    /// @note どうしてこの実装にしたか：仮数が2^53以下かつ10の指数が±22以内なら、
+    ///       どちらも倍精度で正確に表せるため乗除算1回で正しく丸められる（Clingerの高速経路）。
+    ///       それ以外は正確な丸めを行うstd::from_chars（Eisel-Lemire法による実装）に任せる。
+    static double toDouble(std::string_view text, const DecimalDigits& digits, int exponent) {
+        static constexpr double exactPowersOfTen[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+        constexpr std::uint64_t maxExactMantissa = std::uint64_t{1} << 53;
+        const int totalExponent = digits.exponent + exponent;
+        if (digits.mantissa == 0) {
+            return 0.0;
+        }
+        if (!digits.truncated && digits.mantissa <= maxExactMantissa &&
+            totalExponent >= -22 && totalExponent <= 22) {
+            const double mantissa = static_cast<double>(digits.mantissa);
+            return totalExponent < 0 ? mantissa / exactPowersOfTen[-totalExponent]
+                                     : mantissa * exactPowersOfTen[totalExponent];
+        }
+        double value = 0.0;
+        const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (ec == std::errc::result_out_of_range) {
+            // 桁あふれは無限大、桁落ちは0とする。
+            return totalExponent + digits.significant > 0
+                ? std::numeric_limits<double>::infinity() : 0.0;
+        }
+        if (ec != std::errc{} || end != text.data() + text.size()) {
+            throw std::runtime_error("JSON5: invalid number format");
+        }
+        return value;
+    }
+
     // @brief 10進数をパース（整数部・小数部・指数部）
     // @param c 先頭文字
     // @param isNegative 符号が負かどうか
     void parseDecimalNumber(char c, bool isNegative, std::size_t tokenPos) {
-        std::int64_t integerPart = 0;
-        double fractionalPart = 0.0;
+        const std::size_t start = inputSource_.position();
+        if constexpr (!ContiguousInputSource<Input>) {
+            numberText_.clear();
+        }
+        DecimalDigits digits;
         bool hasDot = false;
         bool hasIntegerDigits = false;
         bool hasFractionalDigits = false;
@@ -560,33 +877,21 @@ private:
         // 先頭が'.'の場合
         if (c == '.') {
             hasDot = true;
-            consume();
+            consumeNumberChar();
         } else {
             // 整数部を読み取り
-            while (isDecimalDigit(peek())) {
-                hasIntegerDigits = true;
-                char digit = peek();
-                consume();
-                integerPart = integerPart * 10 + (digit - '0');
-            }
+            hasIntegerDigits = readDigits(digits, false);
 
             // 小数点
             if (peek() == '.') {
                 hasDot = true;
-                consume();
+                consumeNumberChar();
             }
         }
 
         // 小数点の後の数字を読み取り
         if (hasDot) {
-            double divisor = 10.0;
-            while (isDecimalDigit(peek())) {
-                hasFractionalDigits = true;
-                char digit = peek();
-                consume();
-                fractionalPart += (digit - '0') / divisor;
-                divisor *= 10.0;
-            }
+            hasFractionalDigits = readDigits(digits, true);
         }
 
         // 最低1桁の数字が必要
@@ -599,18 +904,21 @@ private:
         bool hasExp = false;
         if (peek() == 'e' || peek() == 'E') {
             hasExp = true;
-            consume();
+            consumeNumberChar();
             bool expNegative = false;
             if (peek() == '+' || peek() == '-') {
                 expNegative = (peek() == '-');
-                consume();
+                consumeNumberChar();
             }
             bool hasExpDigits = false;
             while (isDecimalDigit(peek())) {
                 hasExpDigits = true;
                 char digit = peek();
-                consume();
-                exponent = exponent * 10 + (digit - '0');
+                consumeNumberChar();
+                // 十分大きな値で止め、int の桁あふれを防ぐ（結果は無限大か0になる）。
+                if (exponent < 100000) {
+                    exponent = exponent * 10 + (digit - '0');
+                }
             }
             if (!hasExpDigits) {
                 throw std::runtime_error("JSON5: invalid exponent");
@@ -621,24 +929,24 @@ private:
         }
 
         // 値を計算
-        if (hasDot || hasExp) {
-            // 浮動小数点数
-            double value = static_cast<double>(integerPart) + fractionalPart;
-            if (hasExp) {
-                value *= std::pow(10.0, exponent);
+        if (!hasDot && !hasExp && digits.exponent == 0) {
+            // 整数。int64_tの範囲（負数は-2^63まで）に収まる場合のみ整数トークンにする。
+            constexpr std::uint64_t maxPositive =
+                static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max());
+            if (digits.mantissa <= maxPositive) {
+                const auto value = static_cast<std::int64_t>(digits.mantissa);
+                emitToken(JsonToken::makeInteger(isNegative ? -value : value, tokenPos));
+                return;
             }
-            if (isNegative) {
-                value = -value;
-            }
-            emitToken(json_token_detail::NumVal{value}, tokenPos);
-        } else {
-            // 整数
-            std::int64_t value = integerPart;
-            if (isNegative) {
-                value = -value;
+            if (isNegative && digits.mantissa == maxPositive + 1) {
+                emitToken(JsonToken::makeInteger(
+                    std::numeric_limits<std::int64_t>::min(), tokenPos));
+                return;
             }
-            emitToken(json_token_detail::IntVal{value}, tokenPos);
         }
+        // 浮動小数点数（int64_tに収まらない整数を含む）
+        const double value = toDouble(numberText(start), digits, exponent);
+        emitToken(JsonToken::makeNumber(isNegative ? -value : value, tokenPos));
     }
 
     // ********************************************************************************
@@ -695,7 +1003,7 @@ private:
         while (generateNextToken())
             ;
         // ストリーム終端マーカーを追加
-        emitToken(json_token_detail::EndOfStreamTag{}, inputSource_.position());
+        emitToken(JsonToken::make(JsonTokenType::EndOfStream, inputSource_.position()));
     }
 
     // @brief 次のトークンを1つ生成してtokenManager_に追加
@@ -713,19 +1021,19 @@ private:
                 return false;
             case '{':
                 consume();
-                emitToken(json_token_detail::StartObjectTag{}, tokenPos);
+                emitToken(JsonToken::make(JsonTokenType::StartObject, tokenPos));
                 break;
             case '}':
                 consume();
-                emitToken(json_token_detail::EndObjectTag{}, tokenPos);
+                emitToken(JsonToken::make(JsonTokenType::EndObject, tokenPos));
                 break;
             case '[':
                 consume();
-                emitToken(json_token_detail::StartArrayTag{}, tokenPos);
+                emitToken(JsonToken::make(JsonTokenType::StartArray, tokenPos));
                 break;
             case ']':
                 consume();
-                emitToken(json_token_detail::EndArrayTag{}, tokenPos);
+                emitToken(JsonToken::make(JsonTokenType::EndArray, tokenPos));
                 break;
             case ':': // コロンはスキップ（トークンとして生成しない）
                 consume();
@@ -742,21 +1050,21 @@ private:
                 parseNumber(c, tokenPos);
                 break;
             case 'n': // 予約語: null または識別子
-                addReservedWordOrIdentifier("null", json_token_detail::NullTag{}, tokenPos);
+                addReservedWordOrIdentifier("null", JsonToken::make(JsonTokenType::Null, tokenPos), tokenPos);
                 break;
             case 't': // 予約語: true または識別子
-                addReservedWordOrIdentifier("true", json_token_detail::BoolVal{true}, tokenPos);
+                addReservedWordOrIdentifier("true", JsonToken::makeBool(true, tokenPos), tokenPos);
                 break;
             case 'f': // 予約語: false または識別子
-                addReservedWordOrIdentifier("false", json_token_detail::BoolVal{false}, tokenPos);
+                addReservedWordOrIdentifier("false", JsonToken::makeBool(false, tokenPos), tokenPos);
                 break;
             case 'I': // 予約語: Infinity または識別子
                 addReservedWordOrIdentifier("Infinity",
-                    json_token_detail::NumVal{std::numeric_limits<double>::infinity()}, tokenPos);
+                    JsonToken::makeNumber(std::numeric_limits<double>::infinity(), tokenPos), tokenPos);
                 break;
             case 'N': // 予約語: NaN または識別子
                 addReservedWordOrIdentifier("NaN",
-                    json_token_detail::NumVal{std::numeric_limits<double>::quiet_NaN()}, tokenPos);
+                    JsonToken::makeNumber(std::numeric_limits<double>::quiet_NaN(), tokenPos), tokenPos);
                 break;
             default:
                 // その他の文字：識別子として処理（英字、$、_で始まる）
@@ -771,11 +1079,11 @@ private:
     // @tparam N 予約語の長さ
     // @param reservedWord 予約語文字列
     // @param valueToken 予約語が値の場合のトークン
-    template <std::size_t N, typename TokenT>
-    void addReservedWordOrIdentifier(const char (&reservedWord)[N], TokenT valueToken,
+    template <std::size_t N>
+    void addReservedWordOrIdentifier(const char (&reservedWord)[N], const JsonToken& valueToken,
                                      std::size_t tokenPos) {
         if (matchReservedWord(reservedWord)) {
-            addReservedWordOrKey(reservedWord, std::move(valueToken), tokenPos);
+            addReservedWordOrKey(reservedWord, N - 1, valueToken, tokenPos);
         } else {
             addStringOrKey(parseIdentifier(), tokenPos);
         }
@@ -806,27 +1114,30 @@ private:
 
     // @brief 予約語をキーか値として追加
     // @param word 予約語の文字列
+    // @param length 予約語の長さ
     // @param valueToken 値としてのトークン
-    template <typename TokenT>
-    void addReservedWordOrKey(const char* word, TokenT valueToken, std::size_t tokenPos) {
+    void addReservedWordOrKey(const char* word, std::size_t length, const JsonToken& valueToken,
+                              std::size_t tokenPos) {
         skipWhitespaceAndComments();
         if (peek() == ':') {
-            emitToken(json_token_detail::KeyVal{word}, tokenPos);
+            ParsedText key = reservedWordText(word, length, tokenPos);
+            emitToken(JsonToken::makeText(JsonTokenType::Key, key.slice, key.inArena, tokenPos));
         } else {
-            emitToken(std::move(valueToken), tokenPos);
+            emitToken(valueToken);
             validateAfterValue();
         }
     }
 
     // @brief 識別子または文字列をキーか値として追加
     // @note 処理速度低下を避けるためaddReservedWordOrKeyとの共通化しない。
-    // @param text 識別子または文字列
-    void addStringOrKey(std::string text, std::size_t tokenPos) {
+    // @param text 識別子または文字列の内容の位置
+    void addStringOrKey(ParsedText text, std::size_t tokenPos) {
         skipWhitespaceAndComments();
         if (peek() == ':') {
-            emitToken(json_token_detail::KeyVal{std::move(text)}, tokenPos);
+            emitToken(JsonToken::makeText(JsonTokenType::Key, text.slice, text.inArena, tokenPos));
         } else {
-            emitToken(json_token_detail::StrVal{std::move(text)}, tokenPos);
+            emitToken(
+                JsonToken::makeText(JsonTokenType::String, text.slice, text.inArena, tokenPos));
             validateAfterValue();
         }
     }
@@ -842,9 +1153,11 @@ private:
         }
     }
 
-    template <typename TokenT>
-    void emitToken(TokenT&& tokenValue, std::size_t position) {
-        tokenManager_.pushToken(JsonToken{std::forward<TokenT>(tokenValue), position});
+    // @brief トークンをトークン管理オブジェクトに追加する
+    // @param token 追加するトークン
+    void emitToken(JsonToken token) {
+        instrumentation_.countToken(static_cast<std::size_t>(token.type));
+        tokenManager_.pushToken(std::move(token));
     }
 
     // ******************************************************************************** 構築
@@ -862,15 +1175,35 @@ public:
     JsonTokenizer(Input& inputSource, TokMgr& tokenManager, MessageOutput& warnOut)
         : inputSource_(inputSource), tokenManager_(tokenManager), warningOutput_(warnOut) {}
 
+    // @brief コンストラクタ（入力文字列取得元、トークン管理、警告出力オブジェクト、計測フックを指定）
+    // @param inputSource 入力文字列取得元の参照
+    // @param tokenManager トークン管理オブジェクトの参照
+    // @param warnOut 警告メッセージの出力先
+    // @param instrumentation 計測フック
+    JsonTokenizer(Input& inputSource, TokMgr& tokenManager, MessageOutput& warnOut,
+        Instrumentation instrumentation)
+        : inputSource_(inputSource), tokenManager_(tokenManager), warningOutput_(warnOut),
+          instrumentation_(instrumentation) {}
+
     // @brief トークン生成を実行
     // @note 入力全体をパースしてトークン列を生成する
     void tokenize() {
+        if constexpr (ContiguousInputSource<Input>) {
+            // 文字列トークンが入力バッファを参照できるよう、最初のトークン追加前に設定する。
+            tokenManager_.setInputData(inputSource_.data());
+        }
+        const std::uint64_t start = pipelineTimestamp<Instrumentation>();
+        const std::size_t chunks = tokenManager_.arena().allocatedChunks();
+        const std::size_t bytes = tokenManager_.arena().allocatedBytes();
         try {
             generateAllTokens();
         } catch (const std::exception& e) {
             throw std::runtime_error(std::string("JSON5 parse error at position ") +
                                      std::to_string(inputSource_.position()) + ": " + e.what());
         }
+        instrumentation_.addArenaAllocations(tokenManager_.arena().allocatedChunks() - chunks,
+            tokenManager_.arena().allocatedBytes() - bytes);
+        instrumentation_.addTokenize(pipelineTimestamp<Instrumentation>() - start);
     }
 
     // ******************************************************************************** メンバー変数
@@ -878,6 +1211,11 @@ private:
     Input& inputSource_;         ///< 入力文字列取得元の参照
     TokMgr& tokenManager_;       ///< トークン管理オブジェクトの参照
     MessageOutput& warningOutput_;      ///< 警告メッセージ出力先
+    std::size_t textStart_ = 0;         ///< 組み立て中の文字列内容の先頭の入力位置
+    bool textInArena_ = false;          ///< 組み立て中の文字列内容を文字列アリーナに書いているか
+    const simd::ScannerTable& scanner_ = simd::activeScanner();  ///< SIMD走査関数の組
+    std::string numberText_;            ///< 解析中の数値の文字列（連続領域でない入力元のみ使用）
+    [[no_unique_address]] Instrumentation instrumentation_;  ///< 計測フック
 };
 
 }  // namespace rai::serialization
@@ -4,13 +4,135 @@
 module;
 #include <cassert>
 #include <cctype>
+#include <charconv>
+#include <array>
 #include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <functional>
 #include <ostream>
+#include <span>
+#include <string>
 #include <string_view>
 #include <type_traits>
 
 export module rai.serialization.json_writer;
 
+import rai.common.thread_pool;
+
+export namespace rai::serialization {
+
+/// @brief JsonWriterの出力先コールバック。書き込み済みの連続領域を受け取る。
+/// @note 受け取った領域はコールバックから戻った後に再利用されるため、保持しないこと。
+using JsonWriteSink = std::function<void(std::span<const char>)>;
+
+/// @brief 書き込み済みのバッファを丸ごと受け取る出力先。
+/// @note JsonWriterはバッファをコピーせずに渡し、代わりに空のバッファを受け取って書き込みを続ける。
+///       受け取ったバッファの書き出しを別スレッドで進めることで、シリアライズと出力を重ねられる。
+class JsonBufferSink {
+public:
+    virtual ~JsonBufferSink() = default;
+
+    /// @brief 書き込み済みのバッファを受け取り、空のバッファと交換する。
+    /// @param buffer 書き込み済みのバッファ。戻る時には空（容量は確保済み）のバッファになっている。
+    virtual void exchange(std::string& buffer) = 0;
+};
+
+/// @brief 出力先コールバックへ渡す前に内部バッファへ溜める既定のbyte数。
+inline constexpr std::size_t defaultJsonWriteBufferSize = 64 * 1024;
+
+/// @brief 書き出し用に整形済みのキー。
+/// @note 先頭のカンマ・キー本体（必要なら引用符付き）・末尾のコロンを連続して保持し、
+///       書き出し時は1回のコピーで済ませる。JsonWriterBase::prepareKey()で生成する。
+class JsonPreparedKey {
+public:
+    /// @brief 空のキーを構築する（後から代入する配列要素用）。
+    JsonPreparedKey() = default;
+
+    /// @brief 整形済みのバイト列から構築する。
+    /// @param bytes 先頭のカンマと末尾のコロンを含むバイト列。
+    explicit JsonPreparedKey(std::string bytes) : bytes_(std::move(bytes)) {}
+
+    /// @brief 先頭のカンマを含むバイト列を返す。
+    std::string_view withComma() const { return bytes_; }
+
+    /// @brief 先頭のカンマを含まないバイト列を返す。
+    std::string_view withoutComma() const { return std::string_view(bytes_).substr(1); }
+
+private:
+    std::string bytes_;  ///< ",key:"形式のバイト列
+};
+
+}  // namespace rai::serialization
+
+namespace rai::serialization {
+
+/// @brief 16進数の桁文字（小文字）。
+inline constexpr char hexDigits[] = "0123456789abcdef";
+
+/// @brief 文字列出力時の各byteのエスケープ方法の表。
+/// @note 0はエスケープ不要、'u'は\u00XX形式、それ以外は'\\'に続けて出力する文字。
+inline constexpr std::array<char, 256> escapeKinds = [] {
+    std::array<char, 256> kinds{};
+    for (int c = 0; c < 0x20; ++c) {
+        kinds[c] = 'u';
+    }
+    // 引用符が"なので'のエスケープは要らない。
+    kinds['"'] = '"';
+    kinds['\\'] = '\\';
+    kinds['\b'] = 'b';
+    kinds['\f'] = 'f';
+    kinds['\n'] = 'n';
+    kinds['\r'] = 'r';
+    kinds['\t'] = 't';
+    kinds['\v'] = 'v';
+    kinds['\0'] = '0';
+    return kinds;
+}();
+
+/// @brief キーが識別子として有効かチェックする。
+/// @param keyName チェックするキー名
+/// @return 識別子として有効な場合true
+inline bool isValidIdentifier(std::string_view keyName) {
+    // 空文字列は識別子として無効
+    if (keyName.empty()) {
+        return false;
+    }
+
+    // 最初の文字は英字、$、_のいずれか
+    char first = keyName[0];
+    if (!std::isalpha(static_cast<unsigned char>(first)) && first != '$' && first != '_') {
+        return false;
+    }
+
+    // 2文字目以降は英数字、$、_のいずれか
+    for (size_t i = 1; i < keyName.size(); ++i) {
+        char c = keyName[i];
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '$' && c != '_') {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/// @brief JsonWriterBaseが文字列をエスケープし引用符で囲んだ時のbyte数を求める。
+/// @param str エスケープする文字列
+/// @return 引用符を含むbyte数
+inline std::size_t escapedSize(std::string_view str) {
+    std::size_t size = str.size() + 2;
+    for (const char c : str) {
+        const char kind = escapeKinds[static_cast<unsigned char>(c)];
+        if (kind != 0) {
+            // \u00XXは1byteが6byteに、それ以外は2byteになる。
+            size += kind == 'u' ? 5 : 1;
+        }
+    }
+    return size;
+}
+
+}  // namespace rai::serialization
+
 export namespace rai::serialization {
 
 // @brief JSON5出力用の簡易Writer。
@@ -20,76 +142,76 @@ export namespace rai::serialization {
 // - AllowNonIdentifierKeys=true: 識別子として無効なキーも許容し、その場合は引用符で囲んで出力
 template <bool AllowNonIdentifierKeys = false>
 class JsonWriterBase {
-    std::ostream& stream_;
+    std::string* output_;     // 書き込み先の連続バッファ（利用者の文字列か、buffer_）
+    std::string buffer_;      // 出力先へ渡す前の内部バッファ（出力先コールバック使用時）
+    JsonWriteSink sink_;      // 出力先コールバック（文字列へ直接書く場合は空）
+    JsonBufferSink* bufferSink_ = nullptr;  // バッファを交換する出力先（使わない場合はnullptr）
+    std::size_t flushThreshold_ = defaultJsonWriteBufferSize;  // 出力先へ渡すbyte数の目安
     bool needsComma_;  // 次の要素の前にカンマが必要かどうか
+    rai::common::Executor* executor_ = nullptr;  // 並列書き出しに使う実行器（nullptrは既定の実行器）
+
+    // @brief 1文字を出力
+    void put(char c) {
+        output_->push_back(c);
+        flushIfFull();
+    }
+
+    // @brief 文字列をそのまま出力
+    void append(std::string_view text) {
+        output_->append(text);
+        flushIfFull();
+    }
+
+    // @brief 内部バッファが閾値を超えていれば出力先へ渡す
+    void flushIfFull() {
+        // 出力先へ渡すのは内部バッファへ書いている場合だけ。
+        if (output_->size() >= flushThreshold_ && output_ == &buffer_) {
+            flush();
+        }
+    }
 
     // @brief 文字列をエスケープして出力
     // @param str エスケープする文字列
     void escapeString(std::string_view str) {
+        appendEscaped(*output_, str);
+        flushIfFull();
+    }
+
+    // @brief 文字列をエスケープし、引用符で囲んで追記
+    // @param out 追記先
+    // @param str エスケープする文字列
+    static void appendEscaped(std::string& out, std::string_view str) {
         // JSON5では単一引用符も使えるが、ここでは二重引用符を使用
-        stream_ << '"';
-        // 各文字をエスケープ処理
-        for (char c : str) {
-            // エスケープが必要な文字を処理
-            switch (c) {
-                // 引用符が"なので'のエスケープは要らない。
-                case '"':  stream_ << "\\\""; break;
-                case '\\': stream_ << "\\\\"; break;
-                case '\b': stream_ << "\\b"; break;
-                case '\f': stream_ << "\\f"; break;
-                case '\n': stream_ << "\\n"; break;
-                case '\r': stream_ << "\\r"; break;
-                case '\t': stream_ << "\\t"; break;
-                case '\v': stream_ << "\\v"; break;
-                case '\0': stream_ << "\\0"; break;
-                default:
-                    // 制御文字の場合は\uXXXX形式でエスケープ
-                    if (static_cast<unsigned char>(c) < 0x20) {
-                        stream_ << "\\u";
-                        char buf[5];
-                        snprintf(buf, sizeof(buf), "%04x", static_cast<unsigned char>(c));
-                        stream_ << buf;
-                    } else {
-                        stream_ << c;
-                    }
-                    break;
+        out.push_back('"');
+        // どうしてこの実装にしたか：エスケープ不要な文字の連続はまとめてコピーし、
+        // 1文字毎の分岐は表引き1回だけにする。
+        std::size_t runStart = 0;
+        for (std::size_t i = 0; i < str.size(); ++i) {
+            const char kind = escapeKinds[static_cast<unsigned char>(str[i])];
+            if (kind == 0) {
+                continue;
+            }
+            out.append(str.data() + runStart, i - runStart);
+            runStart = i + 1;
+            if (kind == 'u') {
+                // その他の制御文字は\u00XX形式でエスケープ
+                const unsigned char c = static_cast<unsigned char>(str[i]);
+                const char escaped[] = {'\\', 'u', '0', '0', hexDigits[c >> 4], hexDigits[c & 0xF]};
+                out.append(escaped, sizeof(escaped));
+            } else {
+                const char escaped[] = {'\\', kind};
+                out.append(escaped, sizeof(escaped));
             }
         }
-        stream_ << '"';
+        out.append(str.data() + runStart, str.size() - runStart);
+        out.push_back('"');
     }
 
     // @brief 1つのUTF-16コードユニットを \uXXXX で出力
     void writeUnicodeEscape16(unsigned u) {
-        stream_ << "\\u";
-        char buf[5];
-        snprintf(buf, sizeof(buf), "%04x", (u & 0xFFFFu));
-        stream_ << buf;
-    }
-
-    // @brief キーが識別子として有効かチェック
-    // @param keyName チェックするキー名
-    // @return 識別子として有効な場合true
-    bool isValidIdentifier(std::string_view keyName) const {
-        // 空文字列は識別子として無効
-        if (keyName.empty()) {
-            return false;
-        }
-
-        // 最初の文字は英字、$、_のいずれか
-        char first = keyName[0];
-        if (!std::isalpha(static_cast<unsigned char>(first)) && first != '$' && first != '_') {
-            return false;
-        }
-
-        // 2文字目以降は英数字、$、_のいずれか
-        for (size_t i = 1; i < keyName.size(); ++i) {
-            char c = keyName[i];
-            if (!std::isalnum(static_cast<unsigned char>(c)) && c != '$' && c != '_') {
-                return false;
-            }
-        }
-
-        return true;
+        const char escaped[] = {'\\', 'u', hexDigits[(u >> 12) & 0xF], hexDigits[(u >> 8) & 0xF],
+                                hexDigits[(u >> 4) & 0xF], hexDigits[u & 0xF]};
+        append(std::string_view(escaped, sizeof(escaped)));
     }
 
     // @brief カンマ出力の前処理
@@ -97,40 +219,109 @@ class JsonWriterBase {
     void writeCommaIfNeeded() {
         // カンマが必要な場合は出力
         if (needsComma_) {
-            stream_ << ',';
+            output_->push_back(',');
         }
         needsComma_ = true;
     }
 
+    // @brief 数値をstd::to_charsで書式化して出力
+    // @param value 出力する値（整数、または有限の浮動小数点数）
+    template<typename T>
+    void writeNumber(T value) {
+        // long doubleの最短表記でも収まる大きさ
+        char buffer[64];
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        assert(result.ec == std::errc{});
+        append(std::string_view(buffer, static_cast<std::size_t>(result.ptr - buffer)));
+    }
+
 public:
-    // @brief コンストラクタ
+    // @brief コンストラクタ（ストリームへ出力）
     // @param os 出力先ストリーム
-    JsonWriterBase(std::ostream& os) : stream_(os), needsComma_(false)
-    {}
+    // @note 書き込み関数を呼ぶ毎にos.write()する（内部バッファに溜めない）。
+    // @note どうしてこの実装にしたか：このコンストラクタを使う既存のコードは、書き込み直後に
+    //       ストリームの内容を読むことがある。flush()なしでも出力が揃う振る舞いを保ち、
+    //       まとめて書きたい場合は文字列・出力先コールバックのコンストラクタを使う。
+    JsonWriterBase(std::ostream& os)
+        : JsonWriterBase([&os](std::span<const char> data) {
+              os.write(data.data(), static_cast<std::streamsize>(data.size()));
+          }, 0) {}
+
+    // @brief コンストラクタ（文字列の末尾へ直接出力）
+    // @param out 出力先の文字列。既存の内容の後ろに追記する。
+    explicit JsonWriterBase(std::string& out) : output_(&out), needsComma_(false) {}
+
+    // @brief コンストラクタ（出力先コールバックへ出力）
+    // @param sink 出力先コールバック。内部バッファが溜まった時とflush()時に呼ばれる。
+    // @param bufferSize 出力先コールバックへ渡す前に溜めるbyte数の目安。
+    explicit JsonWriterBase(JsonWriteSink sink,
+        std::size_t bufferSize = defaultJsonWriteBufferSize)
+        : output_(&buffer_), sink_(std::move(sink)), flushThreshold_(bufferSize),
+          needsComma_(false) {
+        buffer_.reserve(bufferSize + bufferSize / 4);
+    }
+
+    // @brief コンストラクタ（バッファを交換する出力先へ出力）
+    // @param sink 出力先。内部バッファが溜まった時とflush()時に、バッファを丸ごと交換する。
+    // @param bufferSize 出力先へ渡す前に溜めるbyte数の目安。
+    explicit JsonWriterBase(JsonBufferSink& sink,
+        std::size_t bufferSize = defaultJsonWriteBufferSize)
+        : output_(&buffer_), bufferSink_(&sink), flushThreshold_(bufferSize), needsComma_(false) {
+        buffer_.reserve(bufferSize + bufferSize / 4);
+    }
+
+    // @brief デストラクタ。未出力の内容があれば出力先へ渡す。
+    // @note デストラクタでは例外を送出しない。出力失敗を検出するにはflush()を呼ぶこと。
+    ~JsonWriterBase() {
+        try {
+            flush();
+        } catch (...) {
+        }
+    }
+
+    // コピー・ムーブ禁止（output_が内部バッファを指すため）
+    JsonWriterBase(const JsonWriterBase&) = delete;
+    JsonWriterBase& operator=(const JsonWriterBase&) = delete;
+    JsonWriterBase(JsonWriterBase&&) = delete;
+    JsonWriterBase& operator=(JsonWriterBase&&) = delete;
+
+    // @brief 内部バッファの内容を出力先コールバックへ渡す
+    // @note 文字列へ直接出力している場合は何もしない。
+    void flush() {
+        if (buffer_.empty()) {
+            return;
+        }
+        if (bufferSink_ != nullptr) {
+            bufferSink_->exchange(buffer_);
+        } else if (sink_) {
+            sink_(std::span<const char>(buffer_.data(), buffer_.size()));
+            buffer_.clear();
+        }
+    }
 
     // @brief オブジェクトの開始
     void startObject() {
         writeCommaIfNeeded();
-        stream_ << '{';
+        put('{');
         needsComma_ = false;
     }
 
     // @brief オブジェクトの終了
     void endObject() {
-        stream_ << '}';
+        put('}');
         needsComma_ = true;
     }
 
     // @brief 配列の開始
     void startArray() {
         writeCommaIfNeeded();
-        stream_ << '[';
+        put('[');
         needsComma_ = false;
     }
 
     // @brief 配列の終了
     void endArray() {
-        stream_ << ']';
+        put(']');
         needsComma_ = true;
     }
 
@@ -143,7 +334,7 @@ public:
             // 識別子として無効なキーも許容する場合
             // JSON5では識別子として有効なキーは引用符なしで出力
             if (isValidIdentifier(keyName)) {
-                stream_ << keyName;
+                append(keyName);
             } else {
                 // 識別子として無効な場合は引用符で囲む
                 escapeString(keyName);
@@ -152,16 +343,68 @@ public:
             // 識別子として無効なキーは許容しない場合
             // キーが識別子として有効であることをアサート
             assert(isValidIdentifier(keyName) && "Key must be a valid identifier");
-            stream_ << keyName;
+            append(keyName);
         }
-        stream_ << ':';
+        put(':');
+        needsComma_ = false;
+    }
+
+    /// @brief 整形済みキーの型。
+    using PreparedKey = JsonPreparedKey;
+
+    // @brief キーを書き出し用に整形する
+    // @param keyName キー名
+    // @return 整形済みのキー。key(const PreparedKey&)で書き出す。
+    // @note 識別子の判定とエスケープを事前に一度だけ行う。
+    static PreparedKey prepareKey(std::string_view keyName) {
+        std::string bytes(1, ',');
+        if constexpr (AllowNonIdentifierKeys) {
+            if (isValidIdentifier(keyName)) {
+                bytes.append(keyName);
+            } else {
+                appendEscaped(bytes, keyName);
+            }
+        } else {
+            assert(isValidIdentifier(keyName) && "Key must be a valid identifier");
+            bytes.append(keyName);
+        }
+        bytes.push_back(':');
+        return PreparedKey(std::move(bytes));
+    }
+
+    // @brief 整形済みキーの書き込み
+    // @param preparedKey prepareKey()で整形したキー
+    void key(const PreparedKey& preparedKey) {
+        append(needsComma_ ? preparedKey.withComma() : preparedKey.withoutComma());
         needsComma_ = false;
     }
 
     // @brief null値の書き込み
     void null() {
         writeCommaIfNeeded();
-        stream_ << "null";
+        append("null");
+    }
+
+    // @brief 別のJsonWriterで書き出した、カンマ区切りの1つ以上の要素をそのまま書き込み
+    // @param elements 要素の列（"1,2,3"や"{...},{...}"の形）。空の場合は何も書かない。
+    // @note 直前の要素との間のカンマだけを補う。ParallelContainerConverterが区間毎の結果を繋ぐのに使う。
+    void writeRawElements(std::string_view elements) {
+        if (elements.empty()) {
+            return;
+        }
+        writeCommaIfNeeded();
+        append(elements);
+    }
+
+    // @brief 並列書き出しに使う実行器を設定する
+    // @param executor ParallelContainerConverterなどが要素の書き出しに使う実行器
+    void setExecutor(rai::common::Executor& executor) {
+        executor_ = &executor;
+    }
+
+    // @brief 並列書き出しに使う実行器を返す（未指定の場合は既定の実行器）
+    rai::common::Executor& executor() const {
+        return executor_ != nullptr ? *executor_ : rai::common::getDefaultExecutor();
     }
 
     // プロパティ名なしでの書き出し（ルート要素やArray要素用）
@@ -170,7 +413,7 @@ public:
     // @param value 書き込む値
     void writeObject(bool value) {
         writeCommaIfNeeded();
-        stream_ << (value ? "true" : "false");
+        append(value ? "true" : "false");
     }
 
     // @brief 1文字を文字列として書き込み（エスケープ対応）
@@ -201,19 +444,19 @@ public:
             char c = static_cast<char>(byte);
             escapeString(std::string_view(&c, 1));
         } else {
-            stream_ << '"';
+            put('"');
             // 非ASCIIの単一バイトは \u00XX で表現
             writeUnicodeEscape16(0x00u | byte);
-            stream_ << '"';
+            put('"');
         }
     }
 
     // @brief UTF-16コードユニットを1文字の文字列として出力（サロゲートもそのままコードユニットとして出力）
     void writeObject(char16_t value) {
         writeCommaIfNeeded();
-        stream_ << '"';
+        put('"');
         writeUnicodeEscape16(static_cast<unsigned>(value));
-        stream_ << '"';
+        put('"');
     }
 
     // @brief ワイド文字を1文字の文字列として出力
@@ -234,7 +477,7 @@ public:
             escapeString(std::string_view(&c, 1));
             return;
         }
-        stream_ << '"';
+        put('"');
         if (cp <= 0xFFFFu) {
             writeUnicodeEscape16(cp);
         } else if (cp <= 0x10FFFFu) {
@@ -247,7 +490,7 @@ public:
             // 範囲外はU+FFFDにフォールバック
             writeUnicodeEscape16(0xFFFDu);
         }
-        stream_ << '"';
+        put('"');
     }
 
     // @brief 整数値の書き込み
@@ -256,7 +499,7 @@ public:
         requires std::is_integral_v<T> && (!std::is_same_v<T, bool>)
     void writeObject(T value) {
         writeCommaIfNeeded();
-        stream_ << value;
+        writeNumber(value);
     }
 
     // @brief 浮動小数点数値の書き込み
@@ -268,16 +511,18 @@ public:
 
         // 特殊な値のチェック
         if (std::isnan(value)) {
-            stream_ << "NaN";
+            append("NaN");
         } else if (std::isinf(value)) {
             // JSON5では正負の無限大をサポート
             if (value > 0) {
-                stream_ << "Infinity";
+                append("Infinity");
             } else {
-                stream_ << "-Infinity";
+                append("-Infinity");
             }
         } else {
-            stream_ << value;
+            // どうしてこの実装にしたか：std::to_charsは読み戻すと同じ値になる最短の表記を返すため、
+            // ストリームの既定精度（6桁）で値が丸められることがない。
+            writeNumber(value);
         }
     }
 
@@ -292,4 +537,199 @@ public:
 // @brief JsonWriterの既定型エイリアス（識別子のみ許可）
 using JsonWriter = JsonWriterBase<false>;
 
+// ******************************************************************************** 出力サイズの計測
+
+// @brief JsonWriterBaseと同じ呼び出しを受け取り、出力されるbyte数だけを数えるWriter。
+// @tparam AllowNonIdentifierKeys 計測対象のJsonWriterBaseと同じ値を指定する。
+// @note 変換器のwrite()に渡すと、書き出しと同じ走査で出力サイズを求められる。
+//       数値の桁数はstd::to_charsで求めるため、JsonWriterBaseと必ず一致する。
+template <bool AllowNonIdentifierKeys = false>
+class JsonSizeCounterBase {
+    std::size_t size_ = 0;     // 数えたbyte数
+    bool needsComma_ = false;  // 次の要素の前にカンマが必要かどうか
+
+    // @brief カンマの分を数える
+    void countCommaIfNeeded() {
+        size_ += needsComma_ ? 1 : 0;
+        needsComma_ = true;
+    }
+
+    // @brief 数値をstd::to_charsで書式化した時の桁数を数える
+    template<typename T>
+    void countNumber(T value) {
+        char buffer[64];
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        assert(result.ec == std::errc{});
+        size_ += static_cast<std::size_t>(result.ptr - buffer);
+    }
+
+    // @brief 1文字の文字列の分を数える
+    // @param cp 文字のコードポイント（0x80未満はエスケープ表に従い、それ以上は\uXXXX）
+    void countCodePoint(unsigned cp) {
+        if (cp < 0x80u) {
+            const char c = static_cast<char>(cp);
+            size_ += escapedSize(std::string_view(&c, 1));
+        } else {
+            // 引用符2つと\uXXXX（U+10000以上はサロゲートペアで2つ）
+            size_ += 2 + (cp > 0xFFFFu && cp <= 0x10FFFFu ? 12 : 6);
+        }
+    }
+
+public:
+    /// @brief 整形済みキーの型。
+    using PreparedKey = JsonPreparedKey;
+
+    // @brief 数えたbyte数を返す
+    std::size_t size() const { return size_; }
+
+    // @brief オブジェクトの開始
+    void startObject() {
+        countCommaIfNeeded();
+        ++size_;
+        needsComma_ = false;
+    }
+
+    // @brief オブジェクトの終了
+    void endObject() {
+        ++size_;
+        needsComma_ = true;
+    }
+
+    // @brief 配列の開始
+    void startArray() {
+        countCommaIfNeeded();
+        ++size_;
+        needsComma_ = false;
+    }
+
+    // @brief 配列の終了
+    void endArray() {
+        ++size_;
+        needsComma_ = true;
+    }
+
+    // @brief キーの計測
+    // @param keyName キー名
+    void key(std::string_view keyName) {
+        countCommaIfNeeded();
+        if constexpr (AllowNonIdentifierKeys) {
+            size_ += isValidIdentifier(keyName) ? keyName.size() : escapedSize(keyName);
+        } else {
+            assert(isValidIdentifier(keyName) && "Key must be a valid identifier");
+            size_ += keyName.size();
+        }
+        ++size_;
+        needsComma_ = false;
+    }
+
+    // @brief 整形済みキーの計測
+    // @param preparedKey JsonWriterBase::prepareKey()で整形したキー
+    void key(const PreparedKey& preparedKey) {
+        size_ += (needsComma_ ? preparedKey.withComma() : preparedKey.withoutComma()).size();
+        needsComma_ = false;
+    }
+
+    // @brief null値の計測
+    void null() {
+        countCommaIfNeeded();
+        size_ += 4;
+    }
+
+    // @brief bool値の計測
+    void writeObject(bool value) {
+        countCommaIfNeeded();
+        size_ += value ? 4 : 5;
+    }
+
+    // @brief 1文字の文字列の計測
+    void writeObject(char value) {
+        countCommaIfNeeded();
+        size_ += escapedSize(std::string_view(&value, 1));
+    }
+
+    // @brief 1バイト文字（符号付き）の計測
+    void writeObject(signed char value) {
+        writeObject(static_cast<char>(value));
+    }
+
+    // @brief 1バイト文字（符号なし）の計測
+    void writeObject(unsigned char value) {
+        writeObject(static_cast<char>(value));
+    }
+
+    // @brief UTF-8コードユニットの計測
+    void writeObject(char8_t value) {
+        countCommaIfNeeded();
+        countCodePoint(static_cast<unsigned>(value));
+    }
+
+    // @brief UTF-16コードユニットの計測（常に\uXXXXで出力される）
+    void writeObject(char16_t value) {
+        countCommaIfNeeded();
+        size_ += 8;
+    }
+
+    // @brief ワイド文字の計測
+    void writeObject(wchar_t value) {
+        if constexpr (sizeof(wchar_t) == 2) {
+            writeObject(static_cast<char16_t>(value));
+        } else {
+            writeObject(static_cast<char32_t>(value));
+        }
+    }
+
+    // @brief Unicodeスカラー値の計測
+    void writeObject(char32_t value) {
+        countCommaIfNeeded();
+        countCodePoint(static_cast<unsigned>(value));
+    }
+
+    // @brief 整数値の計測
+    template<typename T>
+        requires std::is_integral_v<T> && (!std::is_same_v<T, bool>)
+    void writeObject(T value) {
+        countCommaIfNeeded();
+        countNumber(value);
+    }
+
+    // @brief 浮動小数点数値の計測
+    template<typename T>
+        requires std::is_floating_point_v<T>
+    void writeObject(T value) {
+        countCommaIfNeeded();
+        if (std::isnan(value)) {
+            size_ += 3;
+        } else if (std::isinf(value)) {
+            size_ += value > 0 ? 8 : 9;
+        } else {
+            countNumber(value);
+        }
+    }
+
+    // @brief 文字列値の計測
+    void writeObject(std::string_view value) {
+        countCommaIfNeeded();
+        size_ += escapedSize(value);
+    }
+
+    // @brief JsonWriterだけに対応するコンバータの出力を計測する
+    // @param write 一時的なJsonWriterBaseへ値を1つ書き出す関数
+    // @note 一時的な文字列へ書き出してその長さを数えるため、この値の分だけ計測が遅くなる。
+    // @note キーの規則を計測対象と揃えるため、一時的な書き込み先はJsonWriterBase<AllowNonIdentifierKeys>とする。
+    template <typename Write>
+        requires std::invocable<Write&, JsonWriterBase<AllowNonIdentifierKeys>&>
+    void writeViaJsonWriter(Write&& write) {
+        countCommaIfNeeded();
+        std::string scratch;
+        {
+            JsonWriterBase<AllowNonIdentifierKeys> writer(scratch);
+            write(writer);
+        }
+        size_ += scratch.size();
+    }
+};
+
+// @brief JsonSizeCounterの既定型エイリアス（JsonWriterと対応）
+using JsonSizeCounter = JsonSizeCounterBase<false>;
+
 }  // namespace rai::serialization
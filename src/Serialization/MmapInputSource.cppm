@@ -0,0 +1,191 @@
+// @file MmapInputSource.cppm
+// @brief ファイルをメモリマップして読み取る入力ソース。
+
+module;
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+export module rai.serialization.mmap_input_source;
+
+export namespace rai::serialization {
+
+/// @brief ファイル全体をメモリマップして読み取る入力ソース。
+/// @note ファイル内容をコピーせずに参照するため、巨大ファイルでもメモリ使用量が増えない。
+/// @note 末尾の先読み用番兵は、ファイル末尾aheadSize byteだけを'\0'詰めの小バッファへ
+///       コピーして提供する（tail-copy）。マップ領域の外は読まない。
+class MmapInputSource {
+public:
+    /// @brief ファイルをマップして入力ソースを構築する。
+    /// @param filename 入力元のファイル名。
+    /// @param aheadSize 先読みbyte数。
+    MmapInputSource(const std::string& filename, std::size_t aheadSize)
+        : aheadSize_(aheadSize) {
+        mapFile(filename);
+        // どうしてこの実装にしたか：末尾の先読みで範囲外を読まないよう、
+        // 末尾aheadSize byteとその後の番兵だけを別バッファに持ち、そこへ切り替える。
+        tailStart_ = size_ > aheadSize_ ? size_ - aheadSize_ : 0;
+        tail_.assign(size_ - tailStart_ + aheadSize_, '\0');
+        if (size_ > tailStart_) {
+            std::memcpy(tail_.data(), mapped_ + tailStart_, size_ - tailStart_);
+        }
+        inTail_ = tailStart_ == 0;
+        cursor_ = inTail_ ? tail_.data() : mapped_;
+    }
+
+    /// @brief デストラクタ。マップを解除する。
+    ~MmapInputSource() {
+        unmapFile();
+    }
+
+    // コピー・ムーブ禁止（マップ領域を参照するため）
+    MmapInputSource(const MmapInputSource&) = delete;
+    MmapInputSource& operator=(const MmapInputSource&) = delete;
+    MmapInputSource(MmapInputSource&&) = delete;
+    MmapInputSource& operator=(MmapInputSource&&) = delete;
+
+    /// @brief 現在の絶対読み取り位置を返す。
+    /// @return 読み取り位置。
+    std::size_t position() const { return position_; }
+
+    /// @brief 入力全体の先頭を返す。
+    /// @return 位置0の文字へのポインタ。本オブジェクトが存在する間有効。
+    /// @note ファイル内容の範囲（size()まで）のみ参照すること。
+    const char* data() const { return mapped_ != nullptr ? mapped_ : tail_.data(); }
+
+    /// @brief ファイルサイズを返す。
+    /// @return ファイルのbyte数。
+    std::size_t size() const { return size_; }
+
+    /// @brief 先読みした文字を取得する。
+    /// @param offset 現在位置からのオフセット。aheadSize未満であること。
+    /// @return 指定位置の文字。範囲外の場合は'\0'。
+    char peekAhead(std::size_t offset) const {
+        assert(offset < aheadSize_);
+        return cursor_[offset];
+    }
+
+    /// @brief 現在位置から指定された文字数だけ読み進める。
+    /// @param count 読み進める文字数。
+    /// @note 文字を取得する場合は、事前にpeekAhead()を呼び出すこと。
+    void consume(std::size_t count = 1) {
+        assert(position_ + count <= size_);
+        position_ += count;
+        cursor_ += count;
+        if (position_ >= tailStart_ && !inTail_) {
+            // 末尾aheadSize byteに入ったので、番兵付きのコピーへ切り替える。
+            cursor_ = tail_.data() + (position_ - tailStart_);
+            inTail_ = true;
+        }
+    }
+
+private:
+    /// @brief ファイルを読み取り専用でマップする。
+    /// @param filename 入力元のファイル名。
+    void mapFile(const std::string& filename) {
+#if defined(_WIN32)
+        file_ = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("MmapInputSource: Cannot open file " + filename);
+        }
+        LARGE_INTEGER fileSize{};
+        if (!GetFileSizeEx(file_, &fileSize)) {
+            unmapFile();
+            throw std::runtime_error("MmapInputSource: Cannot get size of file " + filename);
+        }
+        size_ = static_cast<std::size_t>(fileSize.QuadPart);
+        if (size_ == 0) {
+            return;  // 空ファイルはマップできないため、番兵のみで扱う。
+        }
+        mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping_ == nullptr) {
+            unmapFile();
+            throw std::runtime_error("MmapInputSource: Cannot map file " + filename);
+        }
+        mapped_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+        if (mapped_ == nullptr) {
+            unmapFile();
+            throw std::runtime_error("MmapInputSource: Cannot map file " + filename);
+        }
+#else
+        const int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("MmapInputSource: Cannot open file " + filename);
+        }
+        struct stat status{};
+        if (::fstat(fd, &status) != 0) {
+            ::close(fd);
+            throw std::runtime_error("MmapInputSource: Cannot get size of file " + filename);
+        }
+        size_ = static_cast<std::size_t>(status.st_size);
+        if (size_ == 0) {
+            ::close(fd);
+            return;  // 空ファイルはマップできないため、番兵のみで扱う。
+        }
+        void* address = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        // マップ後はファイル記述子が不要なため閉じる（マップは維持される）。
+        ::close(fd);
+        if (address == MAP_FAILED) {
+            throw std::runtime_error("MmapInputSource: Cannot map file " + filename);
+        }
+        // 先頭から順に読むことをカーネルへ伝え、先読みを積極的にさせる。
+        ::madvise(address, size_, MADV_SEQUENTIAL);
+        mapped_ = static_cast<const char*>(address);
+#endif
+    }
+
+    /// @brief マップを解除する。
+    void unmapFile() {
+#if defined(_WIN32)
+        if (mapped_ != nullptr) {
+            UnmapViewOfFile(mapped_);
+        }
+        if (mapping_ != nullptr) {
+            CloseHandle(mapping_);
+        }
+        if (file_ != INVALID_HANDLE_VALUE) {
+            CloseHandle(file_);
+        }
+        mapping_ = nullptr;
+        file_ = INVALID_HANDLE_VALUE;
+#else
+        if (mapped_ != nullptr) {
+            ::munmap(const_cast<char*>(mapped_), size_);
+        }
+#endif
+        mapped_ = nullptr;
+    }
+
+    const char* mapped_ = nullptr;  ///< マップ領域の先頭（空ファイルではnullptr）。
+    std::size_t size_ = 0;          ///< ファイルサイズ。
+    std::size_t aheadSize_;         ///< 先読みbyte数。
+    std::size_t tailStart_ = 0;     ///< 末尾コピーに切り替える位置。
+    std::vector<char> tail_;        ///< 末尾aheadSize byteと番兵'\0'のコピー。
+    const char* cursor_ = nullptr;  ///< 現在位置の文字へのポインタ。
+    std::size_t position_ = 0;      ///< 現在の絶対読み取り位置。
+    bool inTail_ = false;           ///< 末尾コピーを読んでいるか。
+#if defined(_WIN32)
+    HANDLE file_ = INVALID_HANDLE_VALUE;  ///< ファイルハンドル。
+    HANDLE mapping_ = nullptr;            ///< ファイルマッピングハンドル。
+#endif
+};
+
+}  // namespace rai::serialization
@@ -3,6 +3,7 @@
 
 module;
 #include <memory>
+#include <memory_resource>
 #include <concepts>
 #include <type_traits>
 #include <utility>
@@ -15,6 +16,10 @@ module;
 #include <functional>
 #include <ranges>
 #include <span>
+#include <vector>
+#include <future>
+#include <exception>
+#include <algorithm>
 
 export module rai.serialization.object_converter;
 
@@ -24,6 +29,7 @@ import rai.serialization.json_parser;
 import rai.serialization.token_manager;
 
 import rai.collection.sorted_hash_array_map;
+import rai.common.thread_pool;
 
 export namespace rai::serialization {
 
@@ -43,6 +49,52 @@ concept IsObjectConverter = std::is_class_v<Converter>
         { converter.read(parser) } -> std::same_as<Value>;
     };
 
+/// @brief コンバータで値を書き出す。
+/// @tparam Converter コンバータ型。
+/// @tparam Writer 書き込み型。
+/// @tparam Value 書き出す値の型。
+/// @param converter 使用するコンバータ。
+/// @param writer 書き込み先。
+/// @param value 書き出す値。
+/// @note どうしてこの実装にしたか：利用者定義のコンバータはwrite(FormatWriter&, ...)だけを
+///       持つことがある。その場合は書き込み型のwriteViaJsonWriter()（JsonSizeCounterなど）で
+///       書き込み型が選んだ一時的なJsonWriterBaseへ書き出す。型消去したAnyFormatWriter経由の書き出しは全フィールド分が
+///       実体化されるため、対応しない場合はコンパイルエラーではなく実行時エラーにする。
+template <typename Converter, IsFormatWriter Writer, typename Value>
+void writeWithConverter(const Converter& converter, Writer& writer, const Value& value) {
+    if constexpr (requires { converter.write(writer, value); }) {
+        converter.write(writer, value);
+    }
+    else if constexpr (requires {
+                           writer.writeViaJsonWriter([&](auto& jsonWriter)
+                               -> decltype(converter.write(jsonWriter, value)) {});
+                       }) {
+        writer.writeViaJsonWriter([&](auto& jsonWriter)
+            -> decltype(converter.write(jsonWriter, value)) { converter.write(jsonWriter, value); });
+    }
+    else if constexpr (std::derived_from<Writer, AnyFormatWriter>) {
+        throw std::runtime_error("writeWithConverter: converter does not support this writer");
+    }
+    else {
+        static_assert(false, "writeWithConverter: converter does not support this writer");
+    }
+}
+
+/// @brief 値を構築せずに、コンバータで読み込めるかを検証する。
+/// @tparam Converter コンバータ型。
+/// @param converter 使用するコンバータ。
+/// @param parser 読み取り元。検証した値の分だけ消費する。
+/// @note validate()を持たないコンバータは、read()で読み込んだ値を捨てて検証する。
+template <typename Converter>
+void validateWithConverter(const Converter& converter, FormatReader& parser) {
+    if constexpr (requires { converter.validate(parser); }) {
+        converter.validate(parser);
+    }
+    else {
+        (void)converter.read(parser);
+    }
+}
+
 /// @brief readFormatメソッドを持つ型を表すconcept。
 /// @tparam T 型。
 template <typename T>
@@ -57,6 +109,28 @@ concept HasWriteFormatCore = requires(const T& obj, FormatWriter& writer) {
     { obj.writeFormat(writer) } -> std::same_as<void>;
 };
 
+// ******************************************************************************** 読み込み先の値の構築
+
+/// @brief 型がstd::pmrのアロケーターを受け取って構築できるかを判定するconcept。
+/// @tparam T 判定対象の型（std::pmrのコンテナ・文字列や、allocator_typeを持つ型）。
+template <typename T>
+concept IsPmrAllocatorAware = std::uses_allocator_v<T, std::pmr::polymorphic_allocator<>>;
+
+/// @brief 読み込み先の値を構築する。
+/// @tparam T 構築する型。
+/// @param parser 読み取り元のJsonParser。
+/// @return 構築した値。パーサーにmemory_resourceが指定されていて、型がアロケーターを受け取れる場合は、
+///         そのmemory_resourceを使う値。
+template <typename T>
+T makeReadValue(const JsonParser& parser) {
+    if constexpr (IsPmrAllocatorAware<T>) {
+        if (std::pmr::memory_resource* resource = parser.memoryResource()) {
+            return std::make_obj_using_allocator<T>(std::pmr::polymorphic_allocator<>(resource));
+        }
+    }
+    return T{};
+}
+
 // ******************************************************************************** 基本型用変換方法
 
 /// @brief プリミティブ型（int, double, bool など）かどうかを判定するconcept。
@@ -67,15 +141,27 @@ concept IsFundamentalValue = std::is_fundamental_v<T>;
 /// @brief プリミティブ型、文字列型の変換方法。
 template <typename T>
 struct FundamentalConverter {
-    static_assert(IsFundamentalValue<T> || std::same_as<T, std::string>,
+    static_assert(IsFundamentalValue<T> || std::same_as<T, std::string> ||
+        std::same_as<T, std::pmr::string>,
         "FundamentalConverter requires T to be a fundamental JSON value or std::string");
     using Value = T;
-    void write(JsonWriter& writer, const T& value) const { writer.writeObject(value); }
+    template <IsFormatWriter Writer>
+    void write(Writer& writer, const T& value) const { writer.writeObject(value); }
     T read(JsonParser& parser) const {
-        T out{};
+        T out = makeReadValue<T>(parser);
         parser.readTo(out);
         return out;
     }
+    void validate(JsonParser& parser) const {
+        // 文字列はビューで受け取り、確保とコピーを行わない。
+        if constexpr (IsFundamentalValue<T>) {
+            T out{};
+            parser.readTo(out);
+        } else {
+            std::string_view out;
+            parser.readTo(out);
+        }
+    }
 };
 
 /// @brief serializer()メンバー関数を持つかどうかを判定するconcept。
@@ -83,26 +169,60 @@ struct FundamentalConverter {
 template <typename T>
 concept HasSerializer = requires(const T& t) { t.serializer(); };
 
+/// @brief serializer()が返すフィールド集合を使い、オブジェクトのフィールドを書き出す（startObject/endObjectなし）。
+/// @tparam Writer 書き込み型。
+/// @param writer 書き込み先。
+/// @param fields オブジェクトのserializer()が返したフィールド集合。
+/// @param obj 対象オブジェクト。
+/// @note serializer()が具体的なフィールド集合の型（const auto&）を返す場合は、仮想関数を介さずに書き出す。
+///       ObjectSerializer&を返す場合は仮想関数で書き出し、FormatWriter以外へはAnyFormatWriterを介する。
+template <IsFormatWriter Writer, typename Fields, typename T>
+void writeSerializerFields(Writer& writer, const Fields& fields, const T& obj) {
+    if constexpr (requires { fields.writeFieldsTo(writer, obj); }) {
+        fields.writeFieldsTo(writer, obj);
+    } else if constexpr (std::same_as<Writer, FormatWriter> || std::derived_from<Writer, AnyFormatWriter>) {
+        fields.writeFields(writer, static_cast<const void*>(&obj));
+    } else {
+        FormatWriterAdapter<Writer> adapter(writer);
+        fields.writeFields(adapter, static_cast<const void*>(&obj));
+    }
+}
+
+/// @brief 型のフィールド集合を、インスタンスを都度構築せずに返す。
+/// @tparam T serializer()を持ち、既定構築できる型。
+/// @return 型毎に1つだけ構築した既定値のserializer()が返すフィールド集合。
+/// @note 検証ではオブジェクトを構築しないため、フィールド集合はインスタンスによらないものとする。
+template <typename T>
+const auto& prototypeSerializer() {
+    static const T prototype{};
+    return prototype.serializer();
+}
+
 /// @brief serializer を持つ型のコンバータ
 template <typename T>
 struct JsonFieldsConverter {
     static_assert(HasSerializer<T> && std::default_initializable<T>,
         "JsonFieldsConverter requires T to have serializer() and be default-initializable");
     using Value = T;
-    void write(FormatWriter& writer, const T& obj) const {
-        auto& fields = obj.serializer();
+    template <IsFormatWriter Writer>
+    void write(Writer& writer, const T& obj) const {
         writer.startObject();
-        fields.writeFields(writer, static_cast<const void*>(&obj));
+        writeSerializerFields(writer, obj.serializer(), obj);
         writer.endObject();
     }
     T read(FormatReader& parser) const {
-        T obj{};
+        T obj = makeReadValue<T>(parser);
         auto& fields = obj.serializer();
         parser.startObject();
         fields.readFields(parser, &obj);
         parser.endObject();
         return obj;
     }
+    void validate(FormatReader& parser) const {
+        parser.startObject();
+        prototypeSerializer<T>().validateFields(parser);
+        parser.endObject();
+    }
 };
 
 /// @brief readFormatメソッドを持つ型を表すconcept。
@@ -121,11 +241,27 @@ struct ReadWriteFormatConverter {
     static_assert(HasReadFormat<T> && HasWriteFormat<T> && std::default_initializable<T>,
         "ReadWriteFormatConverter requires T to have readFormat/writeFormat and be default-initializable");
     using Value = T;
-    void write(FormatWriter& writer, const T& obj) const {
-        obj.writeFormat(writer);
+    template <IsFormatWriter Writer>
+    void write(Writer& writer, const T& obj) const {
+        if constexpr (requires { obj.writeFormat(writer); }) {
+            obj.writeFormat(writer);
+        }
+        else if constexpr (requires {
+                               writer.writeViaJsonWriter([&](auto& jsonWriter)
+                                   -> decltype(obj.writeFormat(jsonWriter)) {});
+                           }) {
+            writer.writeViaJsonWriter([&](auto& jsonWriter)
+                -> decltype(obj.writeFormat(jsonWriter)) { obj.writeFormat(jsonWriter); });
+        }
+        else if constexpr (std::derived_from<Writer, AnyFormatWriter>) {
+            throw std::runtime_error("ReadWriteFormatConverter: writeFormat does not support this writer");
+        }
+        else {
+            static_assert(false, "ReadWriteFormatConverter: writeFormat must accept this writer type (make it a template)");
+        }
     }
     T read(FormatReader& parser) const {
-        T out{};
+        T out = makeReadValue<T>(parser);
         out.readFormat(parser);
         return out;
     }
@@ -137,6 +273,7 @@ template <typename T>
 concept IsDefaultConverterSupported
     = IsFundamentalValue<T>
     || std::same_as<T, std::string>
+    || std::same_as<T, std::pmr::string>
     || HasSerializer<T>
     || (HasReadFormat<T> && HasWriteFormat<T>);
 
@@ -144,7 +281,8 @@ concept IsDefaultConverterSupported
 /// @note 基本型、`HasSerializer`、`HasReadFormat`/`HasWriteFormat` を持つ型を自動的に扱い、その他の複雑な型は明確な static_assert で除外します。
 template <typename T>
 constexpr auto& getConverter() {
-    if constexpr (IsFundamentalValue<T> || std::same_as<T, std::string>) {
+    if constexpr (IsFundamentalValue<T> || std::same_as<T, std::string> ||
+                  std::same_as<T, std::pmr::string>) {
         static const FundamentalConverter<T> inst{};
         return inst;
     }
@@ -240,7 +378,8 @@ struct EnumConverter {
     constexpr explicit EnumConverter(const MapType& map)
         : map_(map) {}
 
-    void write(JsonWriter& writer, const Enum& value) const {
+    template <IsFormatWriter Writer>
+    void write(Writer& writer, const Enum& value) const {
         if (auto name = map_.toName(value)) {
             writer.writeObject(*name);
             return;
@@ -249,12 +388,13 @@ struct EnumConverter {
     }
 
     Enum read(JsonParser& parser) const {
-        std::string jsonValue;
+        std::string_view jsonValue;
         parser.readTo(jsonValue);
         if (auto v = map_.fromName(jsonValue)) {
             return *v;
         }
-        throw std::runtime_error(std::string("Failed to convert string to enum: ") + jsonValue);
+        throw std::runtime_error(
+            std::string("Failed to convert string to enum: ") + std::string(jsonValue));
     }
 private:
     MapType map_;
@@ -286,7 +426,8 @@ constexpr auto getEnumConverter(std::span<const EnumEntry<Enum>, N> entries) {
 /// @brief 文字列系型かどうかを判定するconcept。
 /// @tparam T 判定対象の型。
 template <typename T>
-concept LikesString = std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>;
+concept LikesString = std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view> ||
+    std::is_same_v<T, std::pmr::string>;
 
 /// @brief string 系を除くレンジ（配列/コンテナ）を表す concept。
 /// @details std::ranges::range を満たし、かつ `LikesString` を除外することで
@@ -311,16 +452,17 @@ struct ContainerConverter {
     constexpr explicit ContainerConverter(const ElementConverter& elemConv)
         : elementConverter_(std::cref(elemConv)) {}
 
-    void write(JsonWriter& writer, const Container& range) const {
+    template <IsFormatWriter Writer>
+    void write(Writer& writer, const Container& range) const {
         writer.startArray();
         for (const auto& e : range) {
-            elementConverter_.get().write(writer, e);
+            writeWithConverter(elementConverter_.get(), writer, e);
         }
         writer.endArray();
     }
 
     Container read(JsonParser& parser) const {
-        Container out{};
+        Container out = makeReadValue<Container>(parser);
         parser.startArray();
         while (!parser.nextIsEndArray()) {
             auto elem = elementConverter_.get().read(parser);
@@ -338,11 +480,23 @@ struct ContainerConverter {
                 static_assert(false,
                     "ContainerConverter: container must support push_back or insert");
             }
+            // どうしてこの実装にしたか：読み込んだ要素は文字列を写し終えているため、
+            // 要素毎にアリーナを解放し、長い配列でもトークナイザー側の使用量を一定に保つ。
+            parser.releaseConsumedStrings();
         }
         parser.endArray();
         return out;
     }
 
+    void validate(JsonParser& parser) const {
+        parser.startArray();
+        while (!parser.nextIsEndArray()) {
+            validateWithConverter(elementConverter_.get(), parser);
+            parser.releaseConsumedStrings();
+        }
+        parser.endArray();
+    }
+
 private:
     std::reference_wrapper<const ElementConverterT> elementConverter_{};
 };
@@ -366,6 +520,246 @@ constexpr auto getContainerConverter(const ElementConverter& elemConv) {
     return ContainerConverter<Container, ElementConverter>(elemConv);
 }
 
+// ******************************************************************************** 要素を並列に読み書きするコンテナ用変換方法
+
+/// @brief 並列読み込み・書き出しを始める要素数の既定値。
+inline constexpr std::size_t defaultMinParallelElements = 1024;
+
+/// @brief 現在のスレッドが並列読み込みの区間を処理中かを返す。
+/// @return 処理中のフラグへの参照。
+/// @note 区間の処理中に入れ子の並列読み込みを行うと、スレッドプールのワーカーが
+///       互いの完了を待って止まるおそれがあるため、入れ子では逐次に読み込む。
+inline bool& insideParallelRead() {
+    thread_local bool inside = false;
+    return inside;
+}
+
+/// @brief 現在のスレッドが並列書き出しの区間を処理中かを返す。
+/// @return 処理中のフラグへの参照。
+/// @note 入れ子のコンテナは、外側の区間の中で逐次に書き出す。
+inline bool& insideParallelWrite() {
+    thread_local bool inside = false;
+    return inside;
+}
+
+/// @brief 要素を並列に読み書きするコンテナの変換方法。
+/// @note 読み込みでは配列のトークンを集めて要素の境界を求め、
+///       要素数分の領域を確保してから、要素の区間毎にスレッドプールで並列に読み込む。
+///       未知キーは区間の順に、例外は最初の区間のものを送出するため、結果は逐次版と同じになる。
+/// @note 書き出しでは先頭の区間を呼び出し元のJsonWriterへ、残りの区間を区間毎の文字列へ並列に書き、
+///       区間の順にカンマで繋ぐ。出力は逐次版と同じになる。
+/// @tparam Container コンテナ型（resize()と添字アクセスが可能なこと）
+/// @tparam ElementConverter 要素コンバータ型
+template <typename Container, typename ElementConverter>
+struct ParallelContainerConverter {
+    using Value = Container;
+    using Element = std::remove_cvref_t<std::ranges::range_value_t<Container>>;
+    static_assert(requires(Container& c, std::size_t n) { c.resize(n); c[n] = std::declval<Element>(); },
+        "ParallelContainerConverter requires a resizable random-access container");
+    static_assert(IsObjectConverter<ElementConverter, Element>,
+        "ElementConverter must satisfy IsObjectConverter for container element type");
+    using ElementConverterT = std::remove_cvref_t<ElementConverter>;
+
+    /// @brief 要素コンバータと並列化の閾値を指定して構築する。
+    /// @param elemConv 要素コンバータ。
+    /// @param minParallelElements 並列に読み書きする最小の要素数。これ未満は逐次に読み書きする。
+    constexpr explicit ParallelContainerConverter(const ElementConverter& elemConv,
+        std::size_t minParallelElements = defaultMinParallelElements)
+        : elementConverter_(std::cref(elemConv)), minParallelElements_(minParallelElements) {}
+
+    template <IsFormatWriter Writer>
+    void write(Writer& writer, const Container& range) const {
+        if constexpr (!std::same_as<Writer, JsonWriter>) {
+            // 区間毎の結果を繋ぐ操作（writeRawElements）はJSONの書き込み型にしかないため、逐次に書き出す。
+            writer.startArray();
+            for (const auto& e : range) {
+                writeWithConverter(elementConverter_.get(), writer, e);
+            }
+            writer.endArray();
+        } else {
+            writeJson(writer, range);
+        }
+    }
+
+    Container read(JsonParser& parser) const {
+        parser.startArray();
+        std::vector<JsonToken> tokens;
+        std::vector<std::size_t> elementStarts;
+        parser.collectArrayElements(tokens, elementStarts);
+        const std::size_t count = elementStarts.size();
+        elementStarts.push_back(tokens.size());
+
+        Container out = makeReadValue<Container>(parser);
+        out.resize(count);
+        auto& threadPool = parser.executor();
+        std::size_t chunkCount = 1;
+        // memory_resource（monotonic_buffer_resourceなど）はスレッド安全とは限らないため、
+        // 確保先が指定されている場合は区間に分けずに読み込む。
+        if (count >= std::max<std::size_t>(minParallelElements_, 2) && !insideParallelRead() &&
+            parser.memoryResource() == nullptr) {
+            chunkCount = std::clamp<std::size_t>(threadPool.getThreadCount(), 1, count);
+        }
+
+        // 区間毎の読み込み結果。未知キーと例外は区間の順にまとめる。
+        std::vector<std::vector<std::string>> unknownKeys(chunkCount);
+        std::vector<std::exception_ptr> errors(chunkCount);
+        auto readChunk = [&](std::size_t chunk) {
+            const std::size_t first = count * chunk / chunkCount;
+            const std::size_t last = count * (chunk + 1) / chunkCount;
+            const bool wasInside = insideParallelRead();
+            insideParallelRead() = chunkCount > 1;
+            try {
+                const std::span<const JsonToken> range(tokens.data() + elementStarts[first],
+                    elementStarts[last] - elementStarts[first]);
+                TokenRangeSource source(range, parser.tokenSource());
+                JsonParser chunkParser(source, threadPool);
+                chunkParser.setMemoryResource(parser.memoryResource());
+                chunkParser.setProjection(parser.projection());
+                for (std::size_t i = first; i < last; ++i) {
+                    out[i] = elementConverter_.get().read(chunkParser);
+                }
+                if (!source.atEnd()) {
+                    throw std::runtime_error("JsonParser: expected array end ']'");
+                }
+                unknownKeys[chunk] = std::move(chunkParser.getUnknownKeys());
+            } catch (...) {
+                errors[chunk] = std::current_exception();
+            }
+            insideParallelRead() = wasInside;
+        };
+
+        if (chunkCount == 1) {
+            readChunk(0);
+        } else {
+            std::vector<std::future<void>> futures;
+            futures.reserve(chunkCount - 1);
+            for (std::size_t chunk = 1; chunk < chunkCount; ++chunk) {
+                futures.push_back(threadPool.enqueue([&readChunk, chunk]() { readChunk(chunk); }));
+            }
+            // どうしてこの実装にしたか：呼び出しスレッドも待つだけにせず先頭の区間を読む。
+            readChunk(0);
+            for (auto& future : futures) {
+                threadPool.wait(future);
+            }
+        }
+        // 区間の読み込みは全て終わり、集めたトークンの文字列はもう参照しない。
+        parser.releaseConsumedStrings();
+
+        for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            if (errors[chunk]) {
+                std::rethrow_exception(errors[chunk]);
+            }
+            for (const auto& key : unknownKeys[chunk]) {
+                parser.noteUnknownKey(key);
+            }
+        }
+        return out;
+    }
+
+    /// @brief 要素を構築せずに検証する。
+    /// @note 検証は値を作らず確保もしないため、トークンを集めて区間に分けるより逐次の方が速い。
+    void validate(JsonParser& parser) const {
+        parser.startArray();
+        while (!parser.nextIsEndArray()) {
+            validateWithConverter(elementConverter_.get(), parser);
+            parser.releaseConsumedStrings();
+        }
+        parser.endArray();
+    }
+
+private:
+    /// @brief JSONへ書き出す。要素数が閾値以上なら区間毎に並列に書き出す。
+    void writeJson(JsonWriter& writer, const Container& range) const {
+        const std::size_t count = std::ranges::size(range);
+        auto& threadPool = writer.executor();
+        std::size_t chunkCount = 1;
+        if (count >= std::max<std::size_t>(minParallelElements_, 2) && !insideParallelWrite()) {
+            chunkCount = std::clamp<std::size_t>(threadPool.getThreadCount(), 1, count);
+        }
+
+        writer.startArray();
+        if (chunkCount == 1) {
+            for (const auto& e : range) {
+                writeWithConverter(elementConverter_.get(), writer, e);
+            }
+            writer.endArray();
+            return;
+        }
+
+        // どうしてこの実装にしたか：カンマの要否はJsonWriterの状態に依存するため、区間毎に
+        // 別のJsonWriterで書き、繋ぐ時に区間の間のカンマだけを補う。
+        std::vector<std::string> outputs(chunkCount);
+        std::vector<std::exception_ptr> errors(chunkCount);
+        auto writeChunk = [&](std::size_t chunk, JsonWriter& chunkWriter) {
+            const std::size_t first = count * chunk / chunkCount;
+            const std::size_t last = count * (chunk + 1) / chunkCount;
+            const bool wasInside = insideParallelWrite();
+            insideParallelWrite() = true;
+            try {
+                for (std::size_t i = first; i < last; ++i) {
+                    elementConverter_.get().write(chunkWriter, range[i]);
+                }
+            } catch (...) {
+                errors[chunk] = std::current_exception();
+            }
+            insideParallelWrite() = wasInside;
+        };
+
+        std::vector<std::future<void>> futures;
+        futures.reserve(chunkCount - 1);
+        for (std::size_t chunk = 1; chunk < chunkCount; ++chunk) {
+            futures.push_back(threadPool.enqueue([&writeChunk, &outputs, &threadPool, chunk]() {
+                JsonWriter chunkWriter(outputs[chunk]);
+                chunkWriter.setExecutor(threadPool);
+                writeChunk(chunk, chunkWriter);
+            }));
+        }
+        // 呼び出しスレッドは先頭の区間を、コピーせずに出力先へ直接書く。
+        writeChunk(0, writer);
+        for (auto& future : futures) {
+            threadPool.wait(future);
+        }
+
+        for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            if (errors[chunk]) {
+                std::rethrow_exception(errors[chunk]);
+            }
+        }
+        for (std::size_t chunk = 1; chunk < chunkCount; ++chunk) {
+            writer.writeRawElements(outputs[chunk]);
+        }
+        writer.endArray();
+    }
+
+    std::reference_wrapper<const ElementConverterT> elementConverter_;
+    std::size_t minParallelElements_;  ///< 並列に読み書きする最小の要素数
+};
+
+/// @brief コンテナ型に対応する既定の `ParallelContainerConverter` を作成する。
+/// @tparam Container コンテナ型
+/// @param minParallelElements 並列に読み書きする最小の要素数
+template <typename Container>
+constexpr auto getParallelContainerConverter(
+    std::size_t minParallelElements = defaultMinParallelElements) {
+    using Elem = std::remove_cvref_t<std::ranges::range_value_t<Container>>;
+    const auto& elementConverter = getConverter<Elem>();
+    using ElemConv = std::remove_cvref_t<decltype(elementConverter)>;
+    return ParallelContainerConverter<Container, ElemConv>(elementConverter, minParallelElements);
+}
+
+/// @brief 明示的な要素コンバータから `ParallelContainerConverter` を作成する。
+/// @tparam Container コンテナ型
+/// @tparam ElementConverter 要素コンバータ型
+/// @param elemConv 要素コンバータ
+/// @param minParallelElements 並列に読み書きする最小の要素数
+template <typename Container, typename ElementConverter>
+    requires IsObjectConverter<ElementConverter,
+        std::remove_cvref_t<std::ranges::range_value_t<Container>>>
+constexpr auto getParallelContainerConverter(const ElementConverter& elemConv,
+    std::size_t minParallelElements = defaultMinParallelElements) {
+    return ParallelContainerConverter<Container, ElementConverter>(elemConv, minParallelElements);
+}
+
 // ******************************************************************************** unique_ptr用変換方法
 
 /// @brief std::unique_ptr を判定する concept（element_type / deleter_type を確認し正確に判定）。
@@ -376,7 +770,64 @@ concept IsUniquePtr = requires {
     typename T::deleter_type;
 } && std::is_same_v<T, std::unique_ptr<typename T::element_type, typename T::deleter_type>>;
 
+/// @brief memory_resourceから確保したオブジェクトを破棄する削除子。
+/// @tparam T 破棄するオブジェクトの型。
+/// @note 確保した型の大きさを保持するため、派生クラスのポインタから基底クラスのポインタへ変換できる。
+///       基底クラスとして破棄する場合は、仮想デストラクタが必要（std::default_deleteと同じ）。
+template <typename T>
+struct PmrDeleter {
+    std::pmr::memory_resource* resource = nullptr;  ///< 確保元のmemory_resource。
+    std::size_t size = 0;                           ///< 確保した大きさ（byte）。
+    std::size_t alignment = alignof(std::max_align_t);  ///< 確保した境界。
+
+    PmrDeleter() = default;
+
+    /// @brief 確保元と確保した大きさを指定して構築する。
+    PmrDeleter(std::pmr::memory_resource* resource, std::size_t size, std::size_t alignment)
+        : resource(resource), size(size), alignment(alignment) {}
+
+    /// @brief 派生クラス用の削除子から変換する。
+    template <typename U>
+        requires std::convertible_to<U*, T*>
+    PmrDeleter(const PmrDeleter<U>& other)
+        : resource(other.resource), size(other.size), alignment(other.alignment) {}
+
+    void operator()(T* ptr) const {
+        // 多重継承で基底クラスの位置がずれていても、確保した先頭を返せるようにする。
+        void* block = ptr;
+        if constexpr (std::is_polymorphic_v<T>) {
+            block = dynamic_cast<void*>(ptr);
+        }
+        std::destroy_at(ptr);
+        resource->deallocate(block, size, alignment);
+    }
+};
+
+/// @brief memory_resourceに置かれたオブジェクトを所有するunique_ptr。
+template <typename T>
+using PmrUniquePtr = std::unique_ptr<T, PmrDeleter<T>>;
+
+/// @brief memory_resourceにオブジェクトを構築し、PmrUniquePtrで返す。
+/// @tparam T 構築する型。アロケーターを受け取れる型なら、メンバーも同じmemory_resourceに置く。
+/// @param resource 確保先のmemory_resource。
+/// @param args コンストラクタ引数。
+/// @return 構築したオブジェクト。
+/// @note ポリモーフィック型のファクトリ関数では、currentMemoryResource()を確保先に渡す。
+template <typename T, typename... Args>
+PmrUniquePtr<T> makePmrUnique(std::pmr::memory_resource& resource, Args&&... args) {
+    void* block = resource.allocate(sizeof(T), alignof(T));
+    try {
+        T* ptr = std::uninitialized_construct_using_allocator(static_cast<T*>(block),
+            std::pmr::polymorphic_allocator<>(&resource), std::forward<Args>(args)...);
+        return PmrUniquePtr<T>(ptr, PmrDeleter<T>(&resource, sizeof(T), alignof(T)));
+    } catch (...) {
+        resource.deallocate(block, sizeof(T), alignof(T));
+        throw;
+    }
+}
+
 /// @brief unique_ptr 等のコンバータ
+/// @note PmrUniquePtrの場合は、パーサーに指定されたmemory_resource（未指定なら既定のもの）へ構築する。
 template <typename T, typename TargetConverter>
 struct UniquePtrConverter {
     using Value = T;
@@ -400,12 +851,13 @@ struct UniquePtrConverter {
     constexpr explicit UniquePtrConverter(const ElemConvT& conv)
         : targetConverter_(std::cref(conv)) {}
 
-    void write(JsonWriter& writer, const T& ptr) const {
+    template <IsFormatWriter Writer>
+    void write(Writer& writer, const T& ptr) const {
         if (!ptr) {
             writer.null();
             return;
         }
-        targetConverter_.get().write(writer, *ptr);
+        writeWithConverter(targetConverter_.get(), writer, *ptr);
     }
 
     T read(JsonParser& parser) const {
@@ -414,7 +866,21 @@ struct UniquePtrConverter {
             return nullptr;
         }
         auto elem = targetConverter_.get().read(parser);
-        return std::make_unique<Element>(std::move(elem));
+        if constexpr (std::same_as<typename T::deleter_type, PmrDeleter<Element>>) {
+            std::pmr::memory_resource* resource = parser.memoryResource();
+            return makePmrUnique<Element>(
+                resource != nullptr ? *resource : *std::pmr::get_default_resource(), std::move(elem));
+        } else {
+            return std::make_unique<Element>(std::move(elem));
+        }
+    }
+
+    void validate(JsonParser& parser) const {
+        if (parser.nextIsNull()) {
+            parser.skipValue();
+            return;
+        }
+        validateWithConverter(targetConverter_.get(), parser);
     }
 
 private:
@@ -470,7 +936,13 @@ struct TokenConverter {
     }
 
     Value readString(JsonParser& parser) const {
-        return this->template read<std::string>(parser, "String is not supported for TokenConverter");
+        // どうしてこの実装にしたか：ビューから直接構築できる型では、一時的なstd::stringを作らない。
+        if constexpr (std::is_constructible_v<Value, std::string_view>) {
+            return this->template read<std::string_view>(parser, "");
+        }
+        else {
+            return this->template read<std::string>(parser, "String is not supported for TokenConverter");
+        }
     }
 
     Value readStartObject(JsonParser& parser) const {
@@ -499,7 +971,8 @@ private:
         }
     }
 
-    void write(JsonWriter& writer, const Value& value) const {
+    template <IsFormatWriter Writer>
+    void write(Writer& writer, const Value& value) const {
         if constexpr (IsDefaultConverterSupported<Value>) {
             getConverter<Value>().write(writer, value);
         }
@@ -536,8 +1009,9 @@ struct TokenDispatchConverter {
     }
 
     /// @brief 値を JSON に書き出すための関数を呼び出す。
-    void write(JsonWriter& writer, const ValueType& value) const {
-        tokenConverter_.write(writer, value);
+    template <IsFormatWriter Writer>
+    void write(Writer& writer, const ValueType& value) const {
+        writeWithConverter(tokenConverter_, writer, value);
     }
 
 private:
@@ -654,14 +1128,15 @@ struct VariantElementConverter : TokenConverter<Variant> {
     /// @brief Variant 値を JSON に書き出す。
     /// @param writer 書き込み先の JsonWriter
     /// @param value 書き込む値
-    void write(JsonWriter& writer, const Variant& value) const {
+    template <IsFormatWriter Writer>
+    void write(Writer& writer, const Variant& value) const {
         std::visit([&](const auto& inner) {
             this->write(writer, inner);
         }, value);
     }
 
-    template<typename T>
-    void write(JsonWriter& writer, const T& value) const {
+    template <IsFormatWriter Writer, typename T>
+    void write(Writer& writer, const T& value) const {
         static const auto& conv = getConverter<std::remove_cvref_t<T>>();
         conv.write(writer, value);
     }
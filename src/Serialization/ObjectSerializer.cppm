@@ -23,6 +23,7 @@ module;
 
 import rai.collection.sorted_hash_array_map;
 import rai.serialization.format_io;
+import rai.serialization.json_parser;
 import rai.serialization.token_manager;
 export module rai.serialization.object_serializer;
 
@@ -42,11 +43,23 @@ public:
     /// @note ポリモーフィック型の書き出し時に使用する。
     virtual void writeFields(FormatWriter& writer, const void* obj) const = 0;
 
+    /// @brief オブジェクトのフィールドのみを型消去した書き込み型へ書き出す（startObject/endObjectなし）。
+    /// @param writer 書き込み先（FormatWriterAdapterなど）。
+    /// @param obj 対象オブジェクトのvoidポインタ。
+    /// @note FormatWriter以外のフォーマットへ、具体的なフィールド集合の型が分からないまま書き出す時に使用する。
+    virtual void writeFields(AnyFormatWriter& writer, const void* obj) const = 0;
+
     /// @brief オブジェクトのフィールドを読み込む。
     /// @param parser 読み取り元の FormatReader
     /// @param obj 対象オブジェクトの void* ポインタ
     /// @note startObject/endObject は呼び出し側で処理してください。
     virtual void readFields(FormatReader& parser, void* obj) const = 0;
+
+    /// @brief オブジェクトを構築せずに、フィールドが読み込めるかを検証する。
+    /// @param parser 読み取り元の FormatReader
+    /// @note startObject/endObject は呼び出し側で処理してください。
+    ///       検証に失敗した場合は、readFieldsと同じ例外を送出する。
+    virtual void validateFields(FormatReader& parser) const = 0;
 };
 
 // ******************************************************************************** フィールド集合による永続化
@@ -88,6 +101,15 @@ public:
 
         auto arr = buildArr(std::make_index_sequence<N_>{});
         fieldMap_ = collection::SortedHashArrayMap<std::string_view, bool, N_>(arr);
+        for (std::size_t i = 0; i < N_; ++i) {
+            keys_[i] = arr[i].first;
+        }
+
+        // どうしてこの実装にしたか：キーは定数なので、識別子判定やエスケープを伴う整形を
+        // 構築時に一度だけ行い、書き出し時はカンマ・キー・コロンをまとめてコピーする。
+        forEachField([&](std::size_t index, const auto& field) {
+            preparedKeys_[index] = FormatWriter::prepareKey(field.key);
+        });
     }
 
     /// @brief フィールド数を返す。
@@ -96,16 +118,48 @@ public:
         return N_;
     }
 
+    /// @brief 宣言順のキーを先に比較する探索（ordered probe）の有効・無効を設定する。
+    /// @param enabled 有効にする場合はtrue（既定値）。
+    /// @note 無効にすると、常にキーの探索表で探索する。
+    constexpr void setOrderedProbe(bool enabled) {
+        orderedProbe_ = enabled;
+    }
+
+    /// @brief 宣言順のキーを先に比較する探索が有効かを返す。
+    /// @return 有効ならtrue。
+    constexpr bool orderedProbe() const {
+        return orderedProbe_;
+    }
+
+    /// @brief オブジェクトのフィールドのみを書き出す（startObject/endObjectなし）。
+    /// @tparam Writer 書き込み型（JsonWriter、RaiBinaryWriterなど）。
+    /// @param writer 書き込み先。
+    /// @param owner 対象オブジェクト。
+    /// @note 仮想関数を介さないため、各フィールドの書き出しは書き込み型毎にインライン展開できる。
+    template <IsFormatWriter Writer>
+    void writeFieldsTo(Writer& writer, const Owner& owner) const {
+        forEachField([&](std::size_t index, const auto& field) {
+            if constexpr (requires { field.write(writer, owner, preparedKeys_[index]); }) {
+                field.write(writer, owner, preparedKeys_[index]);
+            } else {
+                field.write(writer, owner);
+            }
+        });
+    }
+
     /// @brief オブジェクトのフィールドのみを書き出す（startObject/endObjectなし）。
     /// @param writer 書き込み先のFormatWriter。
     /// @param obj 対象オブジェクトのvoidポインタ。
     /// @note ポリモーフィック型の書き出し時に使用する。
     void writeFields(FormatWriter& writer, const void* obj) const override {
-        const Owner* owner = static_cast<const Owner*>(obj);
-        forEachField([&](std::size_t, const auto& field) {
-            // デフォルトの toJson に委譲（明示的な分岐不要）
-            field.write(writer, *owner);
-        });
+        writeFieldsTo(writer, *static_cast<const Owner*>(obj));
+    }
+
+    /// @brief オブジェクトのフィールドのみを型消去した書き込み型へ書き出す（startObject/endObjectなし）。
+    /// @param writer 書き込み先。
+    /// @param obj 対象オブジェクトのvoidポインタ。
+    void writeFields(AnyFormatWriter& writer, const void* obj) const override {
+        writeFieldsTo(writer, *static_cast<const Owner*>(obj));
     }
 
     /// @brief オブジェクトのフィールドをJSONから読み込む（startObject/endObjectなし）。
@@ -114,38 +168,86 @@ public:
     /// @note FieldsObjectSerializer内でフィールド探索と読み込みを行う。
     void readFields(FormatReader& parser, void* obj) const override {
         auto& owner = *static_cast<Owner*>(obj);
+        // テンプレート展開により各フィールドの型に応じた処理が静的に解決される
+        walkFields(parser,
+            [&](const auto& field) { field.read(parser, owner); },
+            [&](const auto& field) { field.applyMissing(owner); });
+    }
+
+    /// @brief オブジェクトを構築せずに、フィールドが読み込めるかを検証する（startObject/endObjectなし）。
+    /// @param parser 読み取り元のFormatReader互換オブジェクト。
+    /// @note キーの探索・重複・必須フィールドの判定はreadFieldsと同じ処理を使う。
+    void validateFields(FormatReader& parser) const override {
+        walkFields(parser,
+            [&](const auto& field) { field.validate(parser); },
+            [&](const auto& field) { field.validateMissing(); });
+    }
+
+    // ************************************************************************** JSONフィールド操作
+
+private:
+    /// @brief オブジェクトのキーを順に読み、対応するフィールドを処理する。
+    /// @param parser 読み取り元のFormatReader互換オブジェクト。
+    /// @param onField 見つかったフィールドを受け取り、値を消費するファンクタ。
+    /// @param onMissing 現れなかったフィールドを受け取るファンクタ。
+    template <typename OnField, typename OnMissing>
+    void walkFields(FormatReader& parser, OnField&& onField, OnMissing&& onMissing) const {
         std::bitset<N_> seen{};
+        std::size_t expectedIndex = 0;
+        const JsonProjection* const projection = parser.projection();
         while (!parser.nextIsEndObject()) {
-            std::string k = parser.nextKey();
-            auto foundIndex = fieldMap_.findIndex(k);
-            if (!foundIndex) {
-                parser.noteUnknownKey(k);
-                parser.skipValue();
-                continue;
+            // 前のフィールドの値は読み終え、キーのビューも使い終えている。
+            parser.releaseConsumedStrings();
+            // どうしてこの実装にしたか：キーは探索にしか使わないため、コピーせずビューで受け取る。
+            const std::string_view k = parser.nextKeyView();
+            const JsonProjection* selected = nullptr;
+            if (projection != nullptr) {
+                // 射影に含まれないキーは、フィールドを探さずに値ごと読み飛ばす。
+                selected = projection->find(k);
+                if (selected == nullptr) {
+                    parser.skipValue();
+                    continue;
+                }
             }
-            const std::size_t fieldIndex = *foundIndex;
+            std::size_t fieldIndex = 0;
+            // どうしてこの実装にしたか：同じフィールド集合で書き出したJSONはキーが宣言順に並ぶため、
+            // 次に来るはずのキーと先に比較し、外れた場合だけ探索表を引く。
+            if (orderedProbe_ && expectedIndex < N_ && keys_[expectedIndex] == k) {
+                fieldIndex = expectedIndex;
+            } else {
+                auto foundIndex = fieldMap_.findIndex(k);
+                if (!foundIndex) {
+                    parser.noteUnknownKey(k);
+                    parser.skipValue();
+                    continue;
+                }
+                fieldIndex = *foundIndex;
+            }
+            // 省略されたフィールドの後も、見つかった位置の次から宣言順の比較を再開する。
+            expectedIndex = fieldIndex + 1;
             if (seen[fieldIndex]) {
-                throw std::runtime_error(std::string("JsonParser: duplicate key '") + k + "'");
+                throw std::runtime_error(
+                    std::string("JsonParser: duplicate key '") + std::string(k) + "'");
             }
             seen[fieldIndex] = true;
-
-            // テンプレート展開により各フィールドの型に応じた処理が静的に解決される
-            visitField(fieldIndex, [&](const auto& field) {
-                field.read(parser, owner);
-            });
+            if (projection != nullptr) {
+                // フィールドの値の中では、そのフィールドに対応する子の節点を適用する。
+                parser.setProjection(selected->selectsAll() ? nullptr : selected);
+                visitField(fieldIndex, onField);
+                parser.setProjection(projection);
+            } else {
+                visitField(fieldIndex, onField);
+            }
         }
 
-        // 必須フィールドのチェックと既定値の反映
+        // 必須フィールドのチェックと既定値の反映（射影する場合は射影に含まれるフィールドのみ）
         forEachField([&](std::size_t index, const auto& field) {
-            if (!seen[index]) {
-                field.applyMissing(owner);
+            if (!seen[index] && (projection == nullptr || projection->find(keys_[index]) != nullptr)) {
+                onMissing(field);
             }
         });
     }
 
-    // ************************************************************************** JSONフィールド操作
-
-private:
     /// @brief 指定インデックスのフィールドにアクセスする。
     /// @param index 対象フィールドの元インデックス。
     /// @param visitor フィールドを受け取るファンクタ。引数にFieldSerializer&を取る必要がある。
@@ -185,6 +287,9 @@ private:
 
     ///! jsonキーに対応するフィールド検索用。
     collection::SortedHashArrayMap<std::string_view, bool, N_> fieldMap_{};
+    std::array<FormatWriter::PreparedKey, N_> preparedKeys_{}; ///< 書き出し用に整形済みのキー。
+    std::array<std::string_view, N_> keys_{}; ///< 宣言順のキー（ordered probe用）。
+    bool orderedProbe_ = true; ///< 宣言順のキーを先に比較するか。
     std::tuple<std::remove_cvref_t<Fields>...> fields_{}; ///< フィールド定義群。
 };
 
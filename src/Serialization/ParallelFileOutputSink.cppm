@@ -0,0 +1,308 @@
+// @file ParallelFileOutputSink.cppm
+// @brief シリアライズ中に、書き込み済みのバッファをバックグラウンドでファイルへ書き出す出力先。
+
+module;
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+export module rai.serialization.parallel_file_output_sink;
+import rai.serialization.json_writer;
+import rai.common.thread_pool;
+
+export namespace rai::serialization {
+
+/// @brief ParallelFileOutputSinkの設定。
+struct FileWriteOptions {
+    /// @brief 1つのバッファに溜めるbyte数の目安。1回の書き込みの単位になる。
+    std::size_t bufferSize = 1024 * 1024;
+
+    /// @brief バッファの数（2以上）。シリアライズ中の1つを除いた数だけ、書き込みを溜められる。
+    /// @note 全て書き込み待ちになると、シリアライズ側は空きができるまで待つ（またはその場で書く）。
+    std::size_t bufferCount = 3;
+
+    /// @brief close()でファイルを閉じる前にfsyncする。atomicRenameと併用するとディレクトリもfsyncする。
+    bool syncOnClose = false;
+
+    /// @brief 一時ファイル（ファイル名 + ".tmp"）へ書き、close()で成功した場合だけ本来の名前へ置き換える。
+    bool atomicRename = false;
+};
+
+/// @brief 書き込み済みのバッファをスレッドプールでファイルへ書き出す出力先。
+/// @note ParallelInputStreamSourceの書き込み側。JsonWriterが1つのバッファへ書く間に、
+///       バックグラウンドのタスクが受け取り済みのバッファを順に書き出す。
+/// @note 要求した書き込みがまだ始まっていない時に空きがなくなった場合は、書き込み側のスレッドで書く。
+/// @note 全て書き終えるにはclose()を呼ぶこと。書き込みの失敗はexchange()かclose()で送出する。
+class ParallelFileOutputSink final : public JsonBufferSink {
+public:
+    /// @brief 出力先のファイルを開く。
+    /// @param filename 出力先のファイル名。
+    /// @param options バッファの構成とfsync・置き換えの設定。
+    /// @param executor 書き込みタスクを実行する実行器。InlineExecutorの場合は受け取った時にその場で書く。
+    explicit ParallelFileOutputSink(const std::string& filename, const FileWriteOptions& options = {},
+        rai::common::Executor& executor = rai::common::getDefaultExecutor())
+        : filename_(filename),
+          writePath_(options.atomicRename ? filename + ".tmp" : filename),
+          options_(options),
+          executor_(executor) {
+        if (options_.bufferCount < 2) {
+            throw std::invalid_argument("bufferCount must be at least 2");
+        }
+        file_ = std::fopen(writePath_.c_str(), "wb");
+        if (file_ == nullptr) {
+            throw std::runtime_error("ParallelFileOutputSink: Cannot open file " + writePath_);
+        }
+        // どうしてこの実装にしたか：書き込みは常にバッファ単位なので、stdioのバッファでのコピーを省く。
+        std::setvbuf(file_, nullptr, _IONBF, 0);
+        // 書き込み側が持つ1つを除いた数を、空きとして用意しておく。
+        freeBuffers_.resize(options_.bufferCount - 1);
+        for (auto& buffer : freeBuffers_) {
+            buffer.reserve(options_.bufferSize + options_.bufferSize / 4);
+        }
+    }
+
+    /// @brief デストラクタ。受け取ったバッファを書き終えてからファイルを閉じる。
+    /// @note close()を呼ばずに破棄した場合、atomicRenameでは一時ファイルを削除し、置き換えない。
+    ~ParallelFileOutputSink() override {
+        if (closed_) {
+            return;
+        }
+        try {
+            finishWrites();
+        } catch (...) {
+        }
+        closed_ = true;
+        std::fclose(file_);
+        if (options_.atomicRename) {
+            std::error_code ec;
+            std::filesystem::remove(writePath_, ec);
+        }
+    }
+
+    // コピー・ムーブ禁止（スレッド管理のため）
+    ParallelFileOutputSink(const ParallelFileOutputSink&) = delete;
+    ParallelFileOutputSink& operator=(const ParallelFileOutputSink&) = delete;
+    ParallelFileOutputSink(ParallelFileOutputSink&&) = delete;
+    ParallelFileOutputSink& operator=(ParallelFileOutputSink&&) = delete;
+
+    /// @brief 1つのバッファに溜めるbyte数の目安を返す。JsonWriterの構築に使う。
+    std::size_t bufferSize() const {
+        return options_.bufferSize;
+    }
+
+    /// @brief 書き込み済みのバッファを受け取り、空のバッファと交換する。
+    /// @param buffer 書き込み済みのバッファ。戻る時には空のバッファになっている。
+    /// @note 全てのバッファが書き込み待ちの場合は、空きができるまで待つ。
+    void exchange(std::string& buffer) override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        throwIfFailed();
+        filledBuffers_.push_back(std::move(buffer));
+        while (freeBuffers_.empty()) {
+            // どうしてこの実装にしたか：スレッドプールが他のタスクで埋まっていると、
+            // 書き込みタスクが始まるまで待つことになる。未着手ならこのスレッドで書き、互いに待たないようにする。
+            if (writePending_ || !writingInProgress_) {
+                writePending_ = false;
+                writingInProgress_ = true;
+                writeNextBuffer(lock);
+                writingInProgress_ = false;
+                condition_.notify_all();
+            } else {
+                condition_.wait(lock, [this]() {
+                    return !freeBuffers_.empty() || !writingInProgress_;
+                });
+            }
+        }
+        buffer = std::move(freeBuffers_.back());
+        freeBuffers_.pop_back();
+        requestWriteIfNeeded(lock);
+        throwIfFailed();
+    }
+
+    /// @brief 受け取ったバッファを全て書き出してファイルを閉じる。
+    /// @note syncOnCloseならfsyncし、atomicRenameなら一時ファイルを本来の名前へ置き換える。
+    ///       書き込みに失敗していた場合は例外を送出し、atomicRenameでは一時ファイルを削除する。
+    void close() {
+        if (closed_) {
+            return;
+        }
+        finishWrites();
+        closed_ = true;
+
+        bool failed = static_cast<bool>(error_);
+        if (!failed && options_.syncOnClose) {
+            failed = !syncFile();
+        }
+        failed = std::fclose(file_) != 0 || failed;
+        if (failed) {
+            if (options_.atomicRename) {
+                std::error_code ec;
+                std::filesystem::remove(writePath_, ec);
+            }
+            throwIfFailed();
+            throw std::runtime_error("ParallelFileOutputSink: Error writing to file " + writePath_);
+        }
+        if (options_.atomicRename) {
+            std::error_code ec;
+            std::filesystem::rename(writePath_, filename_, ec);
+            if (ec) {
+                std::filesystem::remove(writePath_, ec);
+                throw std::runtime_error("ParallelFileOutputSink: Cannot rename to file " + filename_);
+            }
+            if (options_.syncOnClose) {
+                syncDirectory();
+            }
+        }
+    }
+
+private:
+    /// @brief 書き込みに失敗していれば、その例外を送出する。
+    void throwIfFailed() const {
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+    /// @brief 受け取ったバッファを書き終え、書き込みタスクの終了を待つ。
+    void finishWrites() {
+        std::vector<std::future<void>> tasks;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (!filledBuffers_.empty() || writingInProgress_) {
+                if (writePending_ || !writingInProgress_) {
+                    writePending_ = false;
+                    writingInProgress_ = true;
+                    while (!filledBuffers_.empty()) {
+                        writeNextBuffer(lock);
+                    }
+                    writingInProgress_ = false;
+                    condition_.notify_all();
+                } else {
+                    condition_.wait(lock, [this]() { return !writingInProgress_; });
+                }
+            }
+            // 未着手のタスクは、書くものがないので何もせずに終わる。
+            writePending_ = false;
+            tasks = std::move(pendingWriteTasks_);
+        }
+        // 待つ間も他のタスクを進める（呼び出し元がプールのワーカーでも止まらないようにする）。
+        for (auto& task : tasks) {
+            executor_.wait(task);
+        }
+    }
+
+    /// @brief 書き込み待ちのバッファがあれば、スレッドプールへ非同期書き込みを要求する。
+    /// @param lock 呼び出し元で取得済みのロック。
+    void requestWriteIfNeeded(std::unique_lock<std::mutex>& lock) {
+        if (filledBuffers_.empty() || writePending_ || writingInProgress_) {
+            return;
+        }
+        writePending_ = true;
+        std::erase_if(pendingWriteTasks_, [](const std::future<void>& task) {
+            return task.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        });
+        lock.unlock();
+        std::future<void> taskFuture = executor_.enqueue([this]() {
+            writeTask();
+        });
+        lock.lock();
+        pendingWriteTasks_.push_back(std::move(taskFuture));
+    }
+
+    /// @brief スレッドプール上で、書き込み待ちのバッファがなくなるまで書き出す。
+    /// @note 書き込み側が先に書き始めていた場合は何もしない。
+    void writeTask() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!writePending_) {
+            return;
+        }
+        writePending_ = false;
+        writingInProgress_ = true;
+        while (!filledBuffers_.empty()) {
+            writeNextBuffer(lock);
+        }
+        writingInProgress_ = false;
+        condition_.notify_all();
+    }
+
+    /// @brief 書き込み待ちの先頭のバッファを書き出し、空きに戻す。
+    /// @param lock 取得済みのロック。書き込み中は解放し、戻る時には再び取得している。
+    /// @note writingInProgress_をtrueにした1つのスレッドだけが呼び出す。
+    void writeNextBuffer(std::unique_lock<std::mutex>& lock) {
+        std::string buffer = std::move(filledBuffers_.front());
+        filledBuffers_.pop_front();
+        const bool skip = static_cast<bool>(error_);
+        lock.unlock();
+
+        // 一度失敗したら以降は書かない（ファイルの途中が欠けた内容にしない）。
+        const bool written = skip ||
+            std::fwrite(buffer.data(), 1, buffer.size(), file_) == buffer.size();
+        buffer.clear();
+
+        lock.lock();
+        if (!written && !error_) {
+            error_ = std::make_exception_ptr(
+                std::runtime_error("ParallelFileOutputSink: Error writing to file " + writePath_));
+        }
+        freeBuffers_.push_back(std::move(buffer));
+        condition_.notify_all();
+    }
+
+    /// @brief ファイルの内容を記憶装置へ書き出す。
+    /// @return 成功した場合はtrue。
+    bool syncFile() {
+#if defined(_WIN32)
+        return _commit(_fileno(file_)) == 0;
+#else
+        return ::fsync(::fileno(file_)) == 0;
+#endif
+    }
+
+    /// @brief 置き換え後の名前を記録したディレクトリを記憶装置へ書き出す（POSIXのみ）。
+    void syncDirectory() {
+#if !defined(_WIN32)
+        std::filesystem::path directory = std::filesystem::path(filename_).parent_path();
+        if (directory.empty()) {
+            directory = ".";
+        }
+        const int fd = ::open(directory.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            ::fsync(fd);
+            ::close(fd);
+        }
+#endif
+    }
+
+    std::string filename_;         ///< 出力先のファイル名。
+    std::string writePath_;        ///< 書き込み中のファイル名（atomicRenameでは一時ファイル）。
+    FileWriteOptions options_;     ///< バッファの構成とfsync・置き換えの設定。
+    std::FILE* file_ = nullptr;    ///< 書き込み中のファイル。
+    bool closed_ = false;          ///< close()済みフラグ（書き込み側だけが扱う）。
+
+    // スレッド制御用メンバー（mutex_で保護）
+    std::deque<std::string> filledBuffers_;  ///< 書き込み待ちのバッファ（受け取った順）。
+    std::vector<std::string> freeBuffers_;   ///< 空きのバッファ。
+    bool writePending_ = false;       ///< 書き込みを要求済みで、まだ誰も始めていないフラグ。
+    bool writingInProgress_ = false;  ///< 書き込み実行中フラグ。
+    std::exception_ptr error_;        ///< 最初の書き込み失敗。
+    std::mutex mutex_;                ///< 並列アクセス保護用ミューテックス。
+    std::condition_variable condition_;  ///< スレッド間同期用条件変数。
+    rai::common::Executor& executor_;    ///< 書き込みタスクを実行する実行器。
+    std::vector<std::future<void>> pendingWriteTasks_;  ///< 完了を確認していない書き込みタスク。
+};
+
+}  // namespace rai::serialization
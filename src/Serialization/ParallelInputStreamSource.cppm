@@ -1,52 +1,86 @@
 // @file ParallelInputStreamSource.cppm
-// @brief ファイル入力を二重バッファで扱う入力ソース。
+// @brief ファイル入力をK個のバッファで先読みする入力ソース。
 
 module;
 #include <algorithm>
-#include <array>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <istream>
 #include <mutex>
+#include <string_view>
 #include <future>
 #include <vector>
 #include <cassert>
 
 export module rai.serialization.parallel_input_stream_source;
-import rai.serialization.reading_ahead_double_buffer;
-import rai.serialization.reading_ahead_buffer;
+import rai.serialization.reading_ahead_buffer_ring;
+import rai.serialization.pipeline_instrumentation;
 import rai.common.thread_pool;
 
 export namespace rai::serialization {
 
 /// @brief ファイルストリームから並列安全にデータを読み取る入力ソース。
-/// @note 二重バッファを用いて効率的にファイル読み込みを行う。
-/// @note バックグラウンドスレッドでファイル読み込みを並列実行する。
-class ParallelInputStreamSource {
+/// @note K個のバッファを環状に使い、消費中のバッファ以外の全てへ先に読み込んでおく。
+/// @note バックグラウンドのタスクが、空いたバッファがなくなるか入力の末尾に達するまで続けて読み込む。
+/// @note 要求した読み込みがまだ始まっていない時に消費側が追いついた場合は、消費側のスレッドで読み込む。
+/// @tparam Instrumentation 計測フックの型。読み込んだbyte数・時間と、swapBuffersで待った時間を記録する。
+template <PipelineInstrumentation Instrumentation = NoPipelineInstrumentation>
+class ParallelInputStreamSourceBase {
 public:
+    /// @brief 先読みサイズ（要素数）。
+    static constexpr std::size_t maxReadingAhead = 8;
+
     /// @brief 入力ソースを構築する。
     /// @param stream 入力ストリーム。
-    explicit ParallelInputStreamSource(std::istream& stream)
-        : stream_(stream),
-          eof_(false),
-          readingInProgress_(false),
-          threadPool_(rai::common::getGlobalThreadPool()) {
-        // 消費バッファを事前確保し、初回読み込みを同期的に実行して処理を開始可能にする。
-        stream_.read(buffer_.consumingData(),
-            static_cast<std::streamsize>(buffer_.consumingCapacity()));
-        std::size_t bytesRead = static_cast<std::size_t>(stream_.gcount());
-        eof_ = isEof(bytesRead);
-
-        buffer_.initializeFromFirstRead(bytesRead);
-        if (!eof_) {
-            std::unique_lock<std::mutex> lock(mutex_);
-            requestReadIfNeeded(lock);
-        }
+    /// @param executor 先読みタスクを実行する実行器。InlineExecutorの場合は要求時にその場で読み込む。
+    explicit ParallelInputStreamSourceBase(std::istream& stream,
+        rai::common::Executor& executor = rai::common::getDefaultExecutor())
+        : ParallelInputStreamSourceBase(stream, InputBufferOptions{}, executor) {}
+
+    /// @brief バッファの構成を指定して入力ソースを構築する。
+    /// @param stream 入力ストリーム。
+    /// @param options バッファの容量・数・配置の設定。
+    /// @param executor 先読みタスクを実行する実行器。
+    ParallelInputStreamSourceBase(std::istream& stream, const InputBufferOptions& options,
+        rai::common::Executor& executor = rai::common::getDefaultExecutor())
+        : ParallelInputStreamSourceBase(stream, options, executor, Instrumentation{}) {}
+
+    /// @brief バッファの構成と計測フックを指定して入力ソースを構築する。
+    /// @param stream 入力ストリーム。
+    /// @param options バッファの容量・数・配置の設定。
+    /// @param executor 先読みタスクを実行する実行器。
+    /// @param instrumentation 計測フック。
+    ParallelInputStreamSourceBase(std::istream& stream, const InputBufferOptions& options,
+        rai::common::Executor& executor, Instrumentation instrumentation)
+        : buffers_(maxReadingAhead, options),
+          stream_(stream),
+          executor_(executor),
+          instrumentation_(instrumentation) {
+        // 初回読み込みを同期的に実行して処理を開始可能にする。
+        std::unique_lock<std::mutex> lock(mutex_);
+        readingInProgress_ = true;
+        readNextChunk(lock);
+        readingInProgress_ = false;
+        enterBuffer();
+        requestReadIfNeeded(lock);
     }
 
-    /// @brief デストラクタ。バックグラウンドスレッドを終了する。
-    ~ParallelInputStreamSource() {
+    /// @brief デストラクタ。バックグラウンドの読み込みを終了する。
+    ~ParallelInputStreamSourceBase() {
+        std::vector<std::future<void>> tasks;
+        {
+            // 未着手の読み込みは不要なので、タスクが何もせずに終わるようにする。
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+            readPending_ = false;
+            tasks = std::move(pendingReadTasks_);
+        }
         condition_.notify_all();
-        waitForPendingTask();
+        // 待つ間も他のタスクを進める（呼び出し元がプールのワーカーでも止まらないようにする）。
+        for (auto& task : tasks) {
+            executor_.wait(task);
+        }
         {
             std::unique_lock<std::mutex> lock(mutex_);
             // predicate版でスプリアスウェイクアップを扱い、条件の評価をまとめる
@@ -55,137 +89,187 @@ public:
     }
 
     // コピー・ムーブ禁止（スレッド管理のため）
-    ParallelInputStreamSource(const ParallelInputStreamSource&) = delete;
-    ParallelInputStreamSource& operator=(const ParallelInputStreamSource&) = delete;
-    ParallelInputStreamSource(ParallelInputStreamSource&&) = delete;
-    ParallelInputStreamSource& operator=(ParallelInputStreamSource&&) = delete;
+    ParallelInputStreamSourceBase(const ParallelInputStreamSourceBase&) = delete;
+    ParallelInputStreamSourceBase& operator=(const ParallelInputStreamSourceBase&) = delete;
+    ParallelInputStreamSourceBase(ParallelInputStreamSourceBase&&) = delete;
+    ParallelInputStreamSourceBase& operator=(ParallelInputStreamSourceBase&&) = delete;
 
     /// @brief 現在の絶対読み取り位置を返す。
     /// @return 読み取り位置。
     std::size_t position() const {
-        return buffer_.position();
+        return position_;
     }
 
     /// @brief 先読みした文字を取得する。
-    /// @param offset 現在位置からのオフセット。
-    /// @return 指定位置の文字。範囲外の場合は'\0'。
+    /// @param offset 現在位置からのオフセット（maxReadingAhead未満）。
+    /// @return 指定位置の文字。入力の末尾以降は'\0'。
     char peekAhead(std::size_t offset) const {
-        return buffer_.peekAhead(offset);
+        assert(offset < maxReadingAhead);
+        // 消費中のバッファは読み込み側が書き換えないためロック不要。
+        return current_[consumingPos_ + offset];
+    }
+
+    /// @brief 現在位置から、消費中のバッファで続けて読める範囲を返す。
+    /// @return 範囲。次にconsume()でバッファを切り替えるまで有効。
+    /// @note トークナイザーが文字列本体や空白の連続をこの範囲でまとめて走査するために使う。
+    std::string_view bufferedRun() const {
+        return std::string_view(current_ + consumingPos_, consumableSize_ - consumingPos_);
     }
 
     /// @brief 現在位置から指定された文字数だけ読み進める。
     /// @param count 読み進める文字数。
     /// @note 文字を取得する場合は、事前にpeekAhead()を呼び出すこと。
     void consume(std::size_t count = 1) {
-        assert(buffer_.consumingPos() <= buffer_.consumingValidSize());
-        if (buffer_.consumingPos() + count <= buffer_.consumingValidSize()) {
-            // 進めた後もバッファ内。
-            buffer_.advance(count);
-            return;
-        }
-
-        // 消費バッファ有効末尾まで進める。
-        auto d = buffer_.consumingValidSize() - buffer_.consumingPos();
-        count -= d;
-        buffer_.moveToValidEnd();
-
-        if (swapBuffers()) {
-            // バッファ入れ替えした。
-            if (count <= buffer_.consumingValidSize()) {
-                // バッファ入れ替え後にバッファ内。
-                buffer_.advance(count);
-            } else {  // ファイル末尾で残った分。
-                buffer_.moveToValidEnd();
-            }
+        consumingPos_ += count;
+        position_ += count;
+        while (consumingPos_ >= consumableSize_ && !final_) {
+            consumingPos_ -= consumableSize_;
+            swapBuffers();
         }
-        else {
-            // EOF到達。
-            buffer_.prepareEofBuffer(count);
+        if (final_) {
+            // 末尾以降は番兵の'\0'を返し続ける。
+            consumingPos_ = std::min(consumingPos_, consumableSize_);
         }
     }
 
-    /// @brief 消費バッファと読み込みバッファを入れ替える。
-    /// @return 入れ替えればtrue。
-    bool swapBuffers() {
+    /// @brief 消費中のバッファを手放し、次のバッファに切り替える。
+    /// @note 次のバッファが読み込み中の場合は完了を待つ。未着手ならこのスレッドで読み込む。
+    /// @note 待った時間（このスレッドでの読み込みを含む）を計測フックへ記録する。
+    void swapBuffers() {
         std::unique_lock<std::mutex> lock(mutex_);
-
-        // 読み込みバッファが空でかつEOF未到達のときのみ待機し、
-        // スレッドプールで非同期読み込みが完了するのを待つ
-        condition_.wait(lock, [this]() {
-            return !(((buffer_.readingValidSize() == 0) && !eof_) || readingInProgress_);
-        });
-        if (buffer_.readingValidSize() == 0) {
-            return false; // なにも読み込めなかった。EOF到達後。
+        ++consumingSeq_;
+        if constexpr (Instrumentation::enabled) {
+            if (readSeq_ <= consumingSeq_) {
+                const std::uint64_t start = pipelineTimestamp<Instrumentation>();
+                waitForNextBuffer(lock);
+                instrumentation_.addReadStall(pipelineTimestamp<Instrumentation>() - start);
+            }
+        } else {
+            waitForNextBuffer(lock);
         }
+        enterBuffer();
+        requestReadIfNeeded(lock);
+    }
 
-        buffer_.swapAndReset();
-        if (!eof_) {
-            requestReadIfNeeded(lock);
+private:
+    /// @brief 次のバッファの読み込みが終わるまで待つ（ロック取得済みで呼ぶ）。
+    /// @param lock 取得済みのロック。
+    void waitForNextBuffer(std::unique_lock<std::mutex>& lock) {
+        while (readSeq_ <= consumingSeq_) {
+            // どうしてこの実装にしたか：スレッドプールが他のタスク（トークナイザーなど）で埋まっていると、
+            // 読み込みタスクが始まるまで待つことになる。未着手ならこのスレッドで読み込み、互いに待たないようにする。
+            if (readPending_ || !readingInProgress_) {
+                readPending_ = false;
+                readingInProgress_ = true;
+                readNextChunk(lock);
+                readingInProgress_ = false;
+                condition_.notify_all();
+            } else {
+                condition_.wait(lock, [this]() {
+                    return readSeq_ > consumingSeq_ || !readingInProgress_;
+                });
+            }
         }
-        return true;
     }
 
-    /// @brief スレッドプールへ非同期読み込みを要求する。
+    /// @brief 空いたバッファへの読み込みを続けられるかを返す（ロック取得済みで呼ぶ）。
+    bool canReadAhead() const {
+        return !eof_ && !stopping_ && readSeq_ - consumingSeq_ < buffers_.bufferCount();
+    }
+
+    /// @brief 読み込み済みの次のバッファを消費対象にする（ロック取得済みで呼ぶ）。
+    void enterBuffer() {
+        current_ = buffers_.data(consumingSeq_);
+        consumableSize_ = buffers_.consumableSize(consumingSeq_);
+        final_ = buffers_.isFinal(consumingSeq_);
+    }
+
+    /// @brief 空いたバッファがあれば、スレッドプールへ非同期読み込みを要求する。
     /// @param lock 呼び出し元で取得済みのロック。
     void requestReadIfNeeded(std::unique_lock<std::mutex>& lock) {
-        assert(buffer_.readingValidSize() == 0);
+        if (!canReadAhead() || readPending_ || readingInProgress_) {
+            return;
+        }
+        readPending_ = true;
+        std::erase_if(pendingReadTasks_, [](const std::future<void>& task) {
+            return task.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        });
         lock.unlock();
-        std::future<void> taskFuture = threadPool_.enqueue([this]() {
-            readNextChunkTask();
+        std::future<void> taskFuture = executor_.enqueue([this]() {
+            readAheadTask();
         });
         lock.lock();
-        pendingReadTask_ = std::move(taskFuture);
+        pendingReadTasks_.push_back(std::move(taskFuture));
     }
 
-    /// @brief スレッドプール上で1回分の読み込み処理を行う。
-    void readNextChunkTask() {
+    /// @brief スレッドプール上で、空いたバッファがなくなるまで読み込む。
+    /// @note 消費側が先に読み込みを始めていた場合は何もしない。
+    void readAheadTask() {
         std::unique_lock<std::mutex> lock(mutex_);
+        if (!readPending_) {
+            return;
+        }
+        readPending_ = false;
         readingInProgress_ = true;
-        lock.unlock();
-
-        // 読み込みバッファの先頭は前の消費バッファの末尾の先読み分。
-        stream_.read(buffer_.readingData() + buffer_.maxReadingAhead(),
-            static_cast<std::streamsize>(buffer_.maxConsumeSize()));
-        std::size_t bytesRead = static_cast<std::size_t>(stream_.gcount());
-        bool eof = isEof(bytesRead);
-
-        lock.lock();
-        buffer_.setReadingValidSize(bytesRead);
-        eof_ = eof;
+        while (canReadAhead()) {
+            readNextChunk(lock);
+        }
         readingInProgress_ = false;
         condition_.notify_all();
     }
 
-    /// @brief 保留中の読み込みタスク完了を待機する。
-    void waitForPendingTask() {
-        std::future<void> task;
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            if (!pendingReadTask_.valid()) {
-                return;
-            }
-            task = std::move(pendingReadTask_);
-        }
-        task.wait();
-    }
+    /// @brief 次のバッファへ1回分の読み込み処理を行う。
+    /// @param lock 取得済みのロック。読み込み中は解放し、戻る時には再び取得している。
+    /// @note readingInProgress_をtrueにした1つのスレッドだけが呼び出す。
+    void readNextChunk(std::unique_lock<std::mutex>& lock) {
+        const std::size_t seq = readSeq_;
+        lock.unlock();
 
-    /// @brief EOFに到達していればtrueを返す。
-    /// @param bytesRead 直前のreadで読み取れたバイト数。
-    bool isEof(std::size_t bytesRead) {
+        // バッファの先頭は前のバッファの末尾の先読み分。
+        const std::uint64_t start = pipelineTimestamp<Instrumentation>();
+        buffers_.prepare(seq);
+        const std::size_t requested = buffers_.readSize(seq);
+        stream_.read(buffers_.data(seq) + buffers_.readOffset(seq),
+            static_cast<std::streamsize>(requested));
+        const std::size_t bytesRead = static_cast<std::size_t>(stream_.gcount());
         // 読み取れたサイズが指定サイズ未満ならEOF到達。eof()はエラーの場合。
-        return bytesRead < buffer_.maxConsumeSize() || stream_.eof();
+        const bool eof = bytesRead < requested || stream_.eof();
+        buffers_.commit(seq, bytesRead, eof);
+        const std::uint64_t elapsed = pipelineTimestamp<Instrumentation>() - start;
+
+        lock.lock();
+        // 読み込むスレッドは入れ替わるが、記録はロック内で行うため競合しない。
+        instrumentation_.addRead(bytesRead, elapsed);
+        eof_ = eof;
+        ++readSeq_;
+        condition_.notify_all();
     }
 
-    ReadingAheadDoubleBuffer<char> buffer_;  ///< 二重バッファ。
+    ReadingAheadBufferRing<char> buffers_;  ///< 環状のバッファ。
     std::istream& stream_;  ///< 入力ストリーム。
-    bool eof_;  ///< EOF到達フラグ。
 
-    // スレッド制御用メンバー
-    bool readingInProgress_;  ///< 読み込み実行中フラグ。
+    // 消費側だけが扱うメンバー
+    const char* current_ = nullptr;   ///< 消費中のバッファの先頭。
+    std::size_t consumingPos_ = 0;    ///< 消費中のバッファ内の現在位置。
+    std::size_t consumableSize_ = 0;  ///< 消費中のバッファで消費できる要素数。
+    bool final_ = false;              ///< 消費中のバッファが入力の末尾を含むフラグ。
+    std::size_t position_ = 0;        ///< 入力全体での読み取り位置。
+
+    // スレッド制御用メンバー（mutex_で保護）
+    std::size_t consumingSeq_ = 0;  ///< 消費中のバッファの通し番号。
+    std::size_t readSeq_ = 0;       ///< 次に読み込むバッファの通し番号（読み込み済みの数）。
+    bool eof_ = false;              ///< EOF到達フラグ。
+    bool readPending_ = false;      ///< 読み込みを要求済みで、まだ誰も始めていないフラグ。
+    bool readingInProgress_ = false;  ///< 読み込み実行中フラグ。
+    bool stopping_ = false;         ///< 破棄中フラグ。以降の先読みを行わない。
     mutable std::mutex mutex_;  ///< 並列アクセス保護用ミューテックス。
     mutable std::condition_variable condition_;  ///< スレッド間同期用条件変数。
-    rai::common::ThreadPool& threadPool_;  ///< 共有ThreadPoolへの参照。
-    std::future<void> pendingReadTask_;  ///< 実行中または待機中の読み込みタスク。
+    rai::common::Executor& executor_;  ///< 先読みタスクを実行する実行器。
+    std::vector<std::future<void>> pendingReadTasks_;  ///< 完了を確認していない読み込みタスク。
+    [[no_unique_address]] Instrumentation instrumentation_;  ///< 計測フック。
 };
 
+/// @brief 計測しない並列入力ソース。
+using ParallelInputStreamSource = ParallelInputStreamSourceBase<>;
+
 }  // namespace rai::serialization
@@ -0,0 +1,176 @@
+// @file PipelineInstrumentation.cppm
+// @brief 読み込みパイプラインの各段（入力・トークン化・トークン受け渡し・パース）の計測フック。
+
+module;
+#include <array>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+export module rai.serialization.pipeline_instrumentation;
+
+export namespace rai::serialization {
+
+/// @brief readJsonFileが選んだ読み込み方法。
+enum class JsonReadMethod : std::uint8_t {
+    None,        ///< まだ読み込んでいない
+    Sequential,  ///< 一括読み込み後にトークン化する逐次版
+    Parallel,    ///< バッファを先読みする並列版
+    Mapped       ///< メモリマップ版
+};
+
+/// @brief 読み込みパイプラインの各段で集計した値。
+/// @note 各メンバーは1つの段だけが更新する。段の間の受け渡しはロックまたは完了待ちを通すため、
+///       読み込み関数から戻った後に読めば全ての段の値が揃っている。
+/// @note 時間は全てナノ秒（std::chrono::steady_clock）。
+struct JsonPipelineCounters {
+    /// @brief トークン種別の数（JsonTokenTypeの要素数）。
+    static constexpr std::size_t tokenTypeCount = 11;
+
+    JsonReadMethod method = JsonReadMethod::None;  ///< readJsonFileが選んだ読み込み方法。
+    std::uint64_t fileSize = 0;                 ///< 入力ファイルのサイズ（byte）。
+
+    // 入力段
+    std::uint64_t bytesRead = 0;                ///< 入力元から読み込んだbyte数。
+    std::uint64_t readCalls = 0;                ///< 入力元からの読み込み回数。
+    std::uint64_t readNanoseconds = 0;          ///< 入力元からの読み込みに掛かった時間の合計。
+    std::uint64_t readStalls = 0;               ///< トークナイザーが次のバッファを待った回数。
+    std::uint64_t readStallNanoseconds = 0;     ///< トークナイザーが次のバッファを待った時間の合計。
+
+    // トークン化段
+    std::array<std::uint64_t, tokenTypeCount> tokenCounts{};  ///< トークン種別毎の生成数。
+    std::uint64_t arenaChunks = 0;              ///< 文字列アリーナが確保したチャンク数。
+    std::uint64_t arenaBytes = 0;               ///< 文字列アリーナが確保したbyte数。
+    std::uint64_t tokenizeNanoseconds = 0;      ///< トークン化の経過時間。
+
+    // トークン受け渡し段
+    std::uint64_t takeWaits = 0;                ///< パーサーがトークンの到着を待った回数。
+    std::uint64_t takeWaitNanoseconds = 0;      ///< パーサーがトークンの到着を待った時間の合計。
+
+    // パース段と全体
+    std::uint64_t parseNanoseconds = 0;         ///< パースの経過時間（トークン待ちを含む）。
+    std::uint64_t totalNanoseconds = 0;         ///< 読み込み関数全体の経過時間。
+
+    /// @brief 生成したトークンの総数を返す。
+    std::uint64_t totalTokens() const {
+        std::uint64_t total = 0;
+        for (std::uint64_t count : tokenCounts) {
+            total += count;
+        }
+        return total;
+    }
+};
+
+/// @brief 計測フックのインターフェース。
+/// @note enabledがfalseの型では、計測側は時刻を読まない。フックは空の関数でよく、呼び出しは最適化で消える。
+template <typename T>
+concept PipelineInstrumentation = requires(T& t, std::uint64_t value, std::size_t index,
+    JsonReadMethod method) {
+    { T::enabled } -> std::convertible_to<bool>;
+    { t.beginRead(method, value) } -> std::same_as<void>;
+    { t.addRead(value, value) } -> std::same_as<void>;
+    { t.addReadStall(value) } -> std::same_as<void>;
+    { t.countToken(index) } -> std::same_as<void>;
+    { t.addArenaAllocations(value, value) } -> std::same_as<void>;
+    { t.addTokenize(value) } -> std::same_as<void>;
+    { t.addTakeWait(value) } -> std::same_as<void>;
+    { t.addParse(value) } -> std::same_as<void>;
+};
+
+/// @brief 何も計測しない既定のフック。
+struct NoPipelineInstrumentation {
+    static constexpr bool enabled = false;
+
+    void beginRead(JsonReadMethod, std::uint64_t) {}
+    void addRead(std::uint64_t, std::uint64_t) {}
+    void addReadStall(std::uint64_t) {}
+    void countToken(std::size_t) {}
+    void addArenaAllocations(std::uint64_t, std::uint64_t) {}
+    void addTokenize(std::uint64_t) {}
+    void addTakeWait(std::uint64_t) {}
+    void addParse(std::uint64_t) {}
+};
+
+/// @brief JsonPipelineCountersへ集計するフック。
+/// @note 集計先への参照だけを持つため、パイプラインの各段へ値渡しでよい。
+class CountingPipelineInstrumentation {
+public:
+    static constexpr bool enabled = true;
+
+    /// @brief 集計先を指定して構築する。
+    /// @param counters 集計先。パイプラインの各段が使い終わるまで有効であること。
+    explicit CountingPipelineInstrumentation(JsonPipelineCounters& counters) : counters_(&counters) {}
+
+    /// @brief 読み込み方法と入力のサイズを記録する。
+    /// @param method 選んだ読み込み方法。
+    /// @param fileSize 入力ファイルのサイズ（byte）。
+    void beginRead(JsonReadMethod method, std::uint64_t fileSize) {
+        counters_->method = method;
+        counters_->fileSize = fileSize;
+    }
+
+    /// @brief 入力元からの1回の読み込みを記録する。
+    /// @param bytes 読み込んだbyte数。
+    /// @param nanoseconds 読み込みに掛かった時間。
+    void addRead(std::uint64_t bytes, std::uint64_t nanoseconds) {
+        counters_->bytesRead += bytes;
+        ++counters_->readCalls;
+        counters_->readNanoseconds += nanoseconds;
+    }
+
+    /// @brief トークナイザーが次のバッファを待ったことを記録する。
+    void addReadStall(std::uint64_t nanoseconds) {
+        ++counters_->readStalls;
+        counters_->readStallNanoseconds += nanoseconds;
+    }
+
+    /// @brief トークンの生成を記録する。
+    /// @param tokenType トークン種別（JsonTokenTypeの値）。
+    void countToken(std::size_t tokenType) {
+        ++counters_->tokenCounts[tokenType];
+    }
+
+    /// @brief 文字列アリーナの確保を記録する。
+    void addArenaAllocations(std::uint64_t chunks, std::uint64_t bytes) {
+        counters_->arenaChunks += chunks;
+        counters_->arenaBytes += bytes;
+    }
+
+    /// @brief トークン化の経過時間を記録する。
+    void addTokenize(std::uint64_t nanoseconds) {
+        counters_->tokenizeNanoseconds += nanoseconds;
+    }
+
+    /// @brief パーサーがトークンを待ったことを記録する。
+    void addTakeWait(std::uint64_t nanoseconds) {
+        ++counters_->takeWaits;
+        counters_->takeWaitNanoseconds += nanoseconds;
+    }
+
+    /// @brief パースの経過時間を記録する。
+    void addParse(std::uint64_t nanoseconds) {
+        counters_->parseNanoseconds += nanoseconds;
+    }
+
+    /// @brief 集計先を返す。
+    JsonPipelineCounters& counters() const { return *counters_; }
+
+private:
+    JsonPipelineCounters* counters_;  ///< 集計先。
+};
+
+/// @brief 計測が有効な場合だけ現在時刻を読む。
+/// @tparam Instrumentation 計測フックの型。
+/// @return steady_clockの現在時刻（ナノ秒）。計測しない場合は0。
+template <PipelineInstrumentation Instrumentation>
+std::uint64_t pipelineTimestamp() {
+    if constexpr (Instrumentation::enabled) {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    } else {
+        return 0;
+    }
+}
+
+}  // namespace rai::serialization
@@ -23,6 +23,7 @@ module;
 
 export module rai.serialization.polymorphic_converter;
 
+import rai.serialization.format_io;
 import rai.serialization.json_writer;
 import rai.serialization.json_parser;
 import rai.serialization.token_manager;
@@ -39,8 +40,8 @@ namespace rai::serialization {
 template <typename T>
 struct PointerElementType;
 
-template <typename T>
-struct PointerElementType<std::unique_ptr<T>> {
+template <typename T, typename Deleter>
+struct PointerElementType<std::unique_ptr<T, Deleter>> {
     using type = T;
 };
 
@@ -71,6 +72,60 @@ export template <typename Ptr>
     requires IsSmartOrRawPointer<Ptr>
 using PolymorphicTypeFactory = std::function<Ptr()>;
 
+/// @brief 生成関数と、要素を生成せずに残りのフィールドを検証する関数の組。
+/// @details makePolymorphicFactory()がPolymorphicTypeFactoryの中身として登録する。
+/// @note どうしてこの実装にしたか：フィールド集合はserializer()経由でしか得られず、
+///       検証のたびにファクトリで要素を生成すると、検証が読み取りと同じ確保をしてしまう。
+///       検証関数をファクトリの中身に持たせれば、登録表の型（std::function）を変えずに
+///       validatePolymorphicInstanceがtarget()で取り出せ、既存のラムダによる登録もそのまま使える。
+export template <typename Ptr>
+    requires IsSmartOrRawPointer<Ptr>
+struct ValidatingPolymorphicFactory {
+    std::function<Ptr()> create;
+    void (*validate)(JsonParser&) = nullptr;
+
+    Ptr operator()() const {
+        return create();
+    }
+};
+
+/// @brief Derivedを生成し、検証では要素を生成しないファクトリを作る。
+/// @tparam Derived 生成する具象型。検証のためにデフォルト構築できる必要がある。
+/// @tparam Ptr ポインタ型（unique_ptr/shared_ptr/生ポインタ）。
+/// @param create Derivedを指すポインタを返す呼び出し可能オブジェクト。
+/// @note 検証関数は型ごとに1つだけ構築した見本のserializer()を使う。
+export template <typename Derived, typename Ptr, typename F>
+    requires IsSmartOrRawPointer<Ptr> && std::is_invocable_r_v<Ptr, F&>
+PolymorphicTypeFactory<Ptr> makePolymorphicFactory(F&& create) {
+    ValidatingPolymorphicFactory<Ptr> factory{std::forward<F>(create)};
+    if constexpr (HasSerializer<Derived> && std::is_default_constructible_v<Derived>) {
+        factory.validate = [](JsonParser& parser) {
+            static const Derived prototype{};
+            prototype.serializer().validateFields(parser);
+        };
+    }
+    return factory;
+}
+
+/// @brief newでDerivedを生成するファクトリを作る（検証では要素を生成しない）。
+/// @tparam Derived 生成する具象型。
+/// @tparam Ptr ポインタ型（unique_ptr/shared_ptr/生ポインタ）。
+export template <typename Derived, typename Ptr>
+    requires IsSmartOrRawPointer<Ptr>
+PolymorphicTypeFactory<Ptr> makePolymorphicFactory() {
+    return makePolymorphicFactory<Derived, Ptr>([]() -> Ptr {
+        if constexpr (IsSharedPtr<Ptr>) {
+            return std::make_shared<Derived>();
+        }
+        else if constexpr (std::is_pointer_v<Ptr>) {
+            return new Derived();
+        }
+        else {
+            return Ptr(new Derived());
+        }
+    });
+}
+
 /// @brief ポリモーフィックオブジェクト1つ分を読み取るヘルパー関数。
 /// @tparam Ptr ポインタ型（unique_ptr/shared_ptr/生ポインタ）。
 /// @param parser JsonParserの参照。
@@ -87,15 +142,15 @@ Ptr readPolymorphicInstance(
     parser.startObject();
 
     // 最初のキーが型判別キーであることを確認
-    std::string typeKey = parser.nextKey();
+    const std::string_view typeKey = parser.nextKeyView();
     if (typeKey != jsonKey) {
         throw std::runtime_error(
             std::string("Expected '") + std::string(jsonKey) +
-            "' key for polymorphic object, got '" + typeKey + "'");
+            "' key for polymorphic object, got '" + std::string(typeKey) + "'");
     }
 
     // 型名を読み取り、対応するファクトリを検索
-    std::string typeName;
+    std::string_view typeName;
     parser.readTo(typeName);
     const auto* factory = entriesMap.findValue(typeName);
     if (!factory) {
@@ -103,7 +158,12 @@ Ptr readPolymorphicInstance(
     }
 
     // ファクトリでインスタンスを生成
-    auto instance = (*factory)();
+    // どうしてこの実装にしたか：ファクトリは引数を取らないため、確保先はスコープで渡す。
+    // ファクトリはcurrentMemoryResource()を使ってmakePmrUnique()などで構築できる。
+    auto instance = [&] {
+        MemoryResourceScope scope(parser.memoryResource());
+        return (*factory)();
+    }();
     using BaseType = typename PointerElementType<Ptr>::type;
 
     // HasSerializerを持つ型の場合、残りのフィールドを読み取る
@@ -115,8 +175,7 @@ Ptr readPolymorphicInstance(
     else {
         // serializerを持たない型の場合、全フィールドをスキップ
         while (!parser.nextIsEndObject()) {
-            std::string key = parser.nextKey();
-            parser.noteUnknownKey(key);
+            parser.noteUnknownKey(parser.nextKeyView());
             parser.skipValue();
         }
     }
@@ -125,6 +184,60 @@ Ptr readPolymorphicInstance(
     return instance;
 }
 
+/// @brief ポリモーフィックオブジェクト1つ分を、フィールドの値を構築せずに検証するヘルパー関数。
+/// @return 型名が登録済みならtrue。falseの場合、オブジェクトの残りは消費しない。
+/// @note makePolymorphicFactory()で登録した型は要素を生成しない。
+///       それ以外のファクトリは、フィールド集合を得るために要素ごとに1つ生成する（フィールドは読み込まない）。
+export template <typename Ptr>
+    requires IsSmartOrRawPointer<Ptr>
+bool validatePolymorphicInstance(
+    JsonParser& parser,
+    const collection::MapReference<std::string_view, PolymorphicTypeFactory<Ptr>>& entriesMap,
+    std::string_view jsonKey = "type") {
+    parser.startObject();
+    const std::string_view typeKey = parser.nextKeyView();
+    if (typeKey != jsonKey) {
+        throw std::runtime_error(
+            std::string("Expected '") + std::string(jsonKey) +
+            "' key for polymorphic object, got '" + std::string(typeKey) + "'");
+    }
+    std::string_view typeName;
+    parser.readTo(typeName);
+    const auto* factory = entriesMap.findValue(typeName);
+    if (!factory) {
+        return false;
+    }
+
+    using BaseType = typename PointerElementType<Ptr>::type;
+    if constexpr (HasSerializer<BaseType>) {
+        const auto* registered = factory->template target<ValidatingPolymorphicFactory<Ptr>>();
+        if (registered != nullptr && registered->validate != nullptr) {
+            registered->validate(parser);
+            parser.endObject();
+            return true;
+        }
+        auto instance = (*factory)();
+        // 生ポインタのファクトリが生成したインスタンスは、readPolymorphicInstanceでは呼び出し側のものになる。
+        // 検証では呼び出し側へ返さないため、ここで解放する。
+        std::unique_ptr<BaseType> rawOwner;
+        if constexpr (std::is_pointer_v<Ptr>) {
+            rawOwner.reset(instance);
+        }
+        if (instance == nullptr) {
+            return false;
+        }
+        instance->serializer().validateFields(parser);
+    }
+    else {
+        while (!parser.nextIsEndObject()) {
+            parser.noteUnknownKey(parser.nextKeyView());
+            parser.skipValue();
+        }
+    }
+    parser.endObject();
+    return true;
+}
+
 /// @brief ポリモーフィックオブジェクト1つ分を読み取るヘルパー関数（null許容版）。
 export template <typename Ptr>
     requires IsSmartOrRawPointer<Ptr>
@@ -172,7 +285,8 @@ struct PolymorphicConverter {
     template <typename Entries>
     constexpr explicit PolymorphicConverter(
         const Entries& entries, const char* jsonKey = "type", bool allowNull = true)
-        : entries_(entries), jsonKey_(jsonKey), allowNull_(allowNull) {}
+        : entries_(entries), jsonKey_(jsonKey),
+          preparedJsonKey_(JsonWriter::prepareKey(jsonKey)), allowNull_(allowNull) {}
 
     Ptr read(JsonParser& parser) const {
         if (allowNull_) {
@@ -181,23 +295,40 @@ struct PolymorphicConverter {
         return readPolymorphicInstance<Ptr>(parser, entries_, jsonKey_);
     }
 
-    void write(JsonWriter& writer, const Ptr& ptr) const {
+    void validate(JsonParser& parser) const {
+        if (allowNull_ && parser.nextIsNull()) {
+            parser.skipValue();
+            return;
+        }
+        const auto position = parser.nextPosition();
+        if (!validatePolymorphicInstance<Ptr>(parser, entries_, jsonKey_)) {
+            throw std::runtime_error("Unknown polymorphic type: " + std::to_string(position));
+        }
+    }
+
+    template <IsFormatWriter Writer>
+    void write(Writer& writer, const Ptr& ptr) const {
         if (!ptr) {
             writer.null();
             return;
         }
         writer.startObject();
         std::string typeName = getTypeNameFromMap(*ptr, entries_);
-        writer.key(jsonKey_);
+        if constexpr (std::same_as<Writer, JsonWriter>) {
+            writer.key(preparedJsonKey_);
+        } else {
+            writer.key(jsonKey_);
+        }
         writer.writeObject(typeName);
-        auto& fields = ptr->serializer();
-        fields.writeFields(writer, std::to_address(ptr));
+        // どうしてこの実装にしたか：実際の型は実行時に決まるため、ここだけは仮想関数で書き出す。
+        writeSerializerFields(writer, ptr->serializer(), *ptr);
         writer.endObject();
     }
 
 private:
     Map entries_{};
     const char* jsonKey_{};
+    JsonWriter::PreparedKey preparedJsonKey_{};  ///< 書き出し用に整形済みの型判別キー
     bool allowNull_{true};
 };
 
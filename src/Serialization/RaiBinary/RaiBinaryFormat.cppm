@@ -0,0 +1,122 @@
+// @file RaiBinaryFormat.cppm
+// @brief RaiBinary形式（memo/RaiBinary(Fast).md）の定数と、読み書きで共通の補助関数。
+
+module;
+#include <cstddef>
+#include <cstdint>
+
+export module rai.serialization.rai_binary_format;
+
+export namespace rai::serialization::raibinary {
+
+// ******************************************************************************** ファイルの構成
+/// @brief ファイル先頭の識別子（"RAIF"の各文字を1ビット左シフトしたもの）。
+inline constexpr unsigned char magic[4] = {0xA4, 0x82, 0x92, 0x8C};
+
+/// @brief ヘッダー（識別子とオブジェクト集合テーブルの開始位置）のbyte数。
+inline constexpr std::size_t headerSize = 12;
+
+/// @brief オブジェクト集合の先頭（ID・フィールド数・オブジェクト数）のbyte数。
+inline constexpr std::size_t objectSetHeaderSize = 12;
+
+/// @brief 1つのskipMapが扱うオブジェクト数。
+inline constexpr std::size_t skipMapGroupSize = 8;
+
+// ******************************************************************************** 型
+/// @brief 値の型を表すビット列（下位6ビット）。
+/// @note 整数・浮動小数点数・真偽値は固定長。文字列・配列・オブジェクトは下位ビットに
+///       長さや参照のbyte数（sizeCode）を持つ。Nullはmemoに無い拡張で、値を持たない。
+enum TypeCode : std::uint8_t {
+    Bool = 0x00,         ///< 真偽値（1byte）
+    Float32 = 0x01,      ///< 単精度浮動小数点数
+    Float64 = 0x02,      ///< 倍精度浮動小数点数
+    Null = 0x03,         ///< null（拡張、0byte）
+    UInt8 = 0x04,        ///< 8ビット符号なし整数
+    UInt16 = 0x05,       ///< 16ビット符号なし整数
+    UInt32 = 0x06,       ///< 32ビット符号なし整数
+    UInt64 = 0x07,       ///< 64ビット符号なし整数
+    Int8 = 0x08,         ///< 8ビット符号付き整数
+    Int16 = 0x09,        ///< 16ビット符号付き整数
+    Int32 = 0x0A,        ///< 32ビット符号付き整数
+    Int64 = 0x0B,        ///< 64ビット符号付き整数
+    String = 0x10,       ///< 文字列（下位2ビット：長さのsizeCode）
+    SingleArray = 0x14,  ///< 単一要素型配列（下位2ビット：要素数のsizeCode）
+    AnyArray = 0x18,     ///< 任意要素型配列（下位2ビット：要素数のsizeCode）
+    Object = 0x20        ///< オブジェクト参照（ビット3-2：定義IDのsizeCode、ビット1-0：オブジェクトIDのsizeCode）
+};
+
+/// @brief 型のビット列のうち、値の型を表す部分のマスク。
+inline constexpr std::uint8_t typeMask = 0x3F;
+
+/// @brief フィールドの型のビット列で、キーの長さのsizeCodeが置かれる位置。
+inline constexpr unsigned keySizeShift = 6;
+
+/// @brief 値を表すのに必要なbyte数の符号（0=1byte、1=2byte、2=4byte、3=8byte）を返す。
+/// @param value 表す値。
+/// @return sizeCode。
+constexpr std::uint8_t sizeCodeFor(std::uint64_t value) {
+    if (value <= 0xFFu) {
+        return 0;
+    }
+    if (value <= 0xFFFFu) {
+        return 1;
+    }
+    if (value <= 0xFFFFFFFFu) {
+        return 2;
+    }
+    return 3;
+}
+
+/// @brief sizeCodeのbyte数を返す。
+constexpr std::size_t bytesOf(std::uint8_t sizeCode) {
+    return std::size_t{1} << (sizeCode & 0x03);
+}
+
+/// @brief 型が文字列かを返す。
+constexpr bool isString(std::uint8_t type) { return (type & 0x3C) == String; }
+
+/// @brief 型が単一要素型配列かを返す。
+constexpr bool isSingleArray(std::uint8_t type) { return (type & 0x3C) == SingleArray; }
+
+/// @brief 型が任意要素型配列かを返す。
+constexpr bool isAnyArray(std::uint8_t type) { return (type & 0x3C) == AnyArray; }
+
+/// @brief 型がオブジェクト参照かを返す。
+constexpr bool isObject(std::uint8_t type) { return (type & 0x30) == Object; }
+
+/// @brief 固定長の型のbyte数を返す。
+/// @param type 値の型。
+/// @return byte数。可変長の型や未定義の型は0。
+constexpr std::size_t fixedSizeOf(std::uint8_t type) {
+    switch (type) {
+    case Bool: case UInt8: case Int8: return 1;
+    case UInt16: case Int16: return 2;
+    case Float32: case UInt32: case Int32: return 4;
+    case Float64: case UInt64: case Int64: return 8;
+    default: return 0;
+    }
+}
+
+/// @brief リトルエンディアンの符号なし整数を読む。
+/// @param data 読み取り位置。byte数分が有効であること。
+/// @param bytes byte数（1・2・4・8）。
+/// @return 読んだ値。
+inline std::uint64_t loadUInt(const unsigned char* data, std::size_t bytes) {
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < bytes; ++i) {
+        value |= std::uint64_t{data[i]} << (8 * i);
+    }
+    return value;
+}
+
+/// @brief 符号なし整数をリトルエンディアンで書き込む。
+/// @param out 書き込み位置。byte数分が有効であること。
+/// @param value 書き込む値。
+/// @param bytes byte数（1・2・4・8）。
+inline void storeUInt(unsigned char* out, std::uint64_t value, std::size_t bytes) {
+    for (std::size_t i = 0; i < bytes; ++i) {
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+}  // namespace rai::serialization::raibinary
@@ -0,0 +1,200 @@
+// @file RaiBinaryIO.cppm
+// @brief RaiBinary形式の入出力の統合インターフェース。JSONと同じObjectSerializerで読み書きする。
+
+module;
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+export module rai.serialization.rai_binary_io;
+
+import rai.serialization.object_converter;
+import rai.serialization.rai_binary_writer;
+import rai.serialization.rai_binary_reader;
+import rai.serialization.json_io;
+import rai.serialization.json_writer;
+import rai.serialization.json_parser;
+import rai.serialization.json_tokenizer;
+import rai.serialization.token_manager;
+import rai.serialization.reading_ahead_buffer;
+import rai.common.thread_pool;
+
+namespace rai::serialization {
+
+/// @brief トークン列を書き込みクラスへ写す。
+/// @tparam Writer startObject()/key()/writeObject()などを持つ書き込みクラス。
+/// @param source 読み出し元。
+/// @param writer 書き込み先。
+/// @note どうしてこの実装にしたか：JSONとRaiBinaryは同じトークン列で表せるため、
+///       形式の変換はトークンを1つずつ対応する書き込み呼び出しに置き換えるだけにする。
+template <typename Writer>
+void copyTokens(TokenSource& source, Writer& writer) {
+    for (;;) {
+        const JsonToken token = source.take();
+        switch (token.type) {
+        case JsonTokenType::EndOfStream:
+            return;
+        case JsonTokenType::Null:
+            writer.null();
+            break;
+        case JsonTokenType::Bool:
+            writer.writeObject(token.boolean);
+            break;
+        case JsonTokenType::Integer:
+            writer.writeObject(token.integer);
+            break;
+        case JsonTokenType::Number:
+            writer.writeObject(token.number);
+            break;
+        case JsonTokenType::String:
+            writer.writeObject(source.text(token));
+            break;
+        case JsonTokenType::Key:
+            writer.key(source.text(token));
+            break;
+        case JsonTokenType::StartObject:
+            writer.startObject();
+            break;
+        case JsonTokenType::EndObject:
+            writer.endObject();
+            break;
+        case JsonTokenType::StartArray:
+            writer.startArray();
+            break;
+        case JsonTokenType::EndArray:
+            writer.endArray();
+            break;
+        }
+    }
+}
+
+/// @brief ファイル全体を読み込む。
+/// @param filename 入力元のファイル名。
+/// @param caller エラーメッセージ用の呼び出し元の名前。
+std::string readWholeFile(const std::string& filename, const char* caller) {
+    std::ifstream ifs(filename, std::ios::binary);
+    if (!ifs.is_open()) {
+        throw std::runtime_error(std::string(caller) + ": Cannot open file " + filename);
+    }
+    std::ostringstream oss;
+    oss << ifs.rdbuf();
+    if (ifs.fail() && !ifs.eof()) {
+        throw std::runtime_error(std::string(caller) + ": Error reading file " + filename);
+    }
+    return std::move(oss).str();
+}
+
+// ******************************************************************************** 形式の変換
+/// @brief JSON文字列をRaiBinary形式に変換する。
+/// @param json JSON形式の文字列。ルートはオブジェクトであること。
+/// @return RaiBinary形式のバイト列。
+export std::string convertJsonToRaiBinary(std::string_view json) {
+    std::string buffer;
+    buffer.reserve(json.size() + 8);
+    buffer.assign(json);
+    ReadingAheadBuffer inputSource(std::move(buffer), 8);
+    TokenManager tokens;
+    StdoutMessageOutput warningOutput;
+    JsonTokenizer<ReadingAheadBuffer, TokenManager> tokenizer(inputSource, tokens, warningOutput);
+    tokenizer.tokenize();
+    RaiBinaryWriter writer;
+    copyTokens(tokens, writer);
+    return writer.finish();
+}
+
+/// @brief RaiBinary形式をJSON文字列に変換する。
+/// @param data RaiBinary形式のバイト列。
+/// @return JSON形式の文字列。識別子として無効なキーは引用符で囲む。
+export std::string convertRaiBinaryToJson(std::string_view data) {
+    RaiBinaryReader reader(data, rai::common::getInlineExecutor());
+    std::string json;
+    JsonWriterBase<true> writer(json);
+    copyTokens(reader, writer);
+    return json;
+}
+
+// ******************************************************************************** 書き込み
+/// @brief 任意の型のオブジェクトをRaiBinary形式に変換して返す。
+/// @tparam T 変換対象の型。
+/// @param obj 変換するオブジェクト。
+/// @return RaiBinary形式のバイト列。
+export template <HasSerializer T>
+std::string getRaiBinaryContent(const T& obj) {
+    RaiBinaryWriter writer;
+    writer.startObject();
+    writeSerializerFields(writer, obj.serializer(), obj);
+    writer.endObject();
+    return writer.finish();
+}
+
+/// @brief オブジェクトをRaiBinaryファイルに書き出す。
+/// @tparam T 変換対象の型。
+/// @param obj 変換するオブジェクト。
+/// @param filename 出力先のファイル名。
+export template <HasSerializer T>
+void writeRaiBinaryFile(const T& obj, const std::string& filename) {
+    const std::string content = getRaiBinaryContent(obj);
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> file(
+        std::fopen(filename.c_str(), "wb"), &std::fclose);
+    if (!file) {
+        throw std::runtime_error("writeRaiBinaryFile: Cannot open file " + filename);
+    }
+    if (std::fwrite(content.data(), 1, content.size(), file.get()) != content.size() ||
+        std::fclose(file.release()) != 0) {
+        throw std::runtime_error("writeRaiBinaryFile: Error writing to file " + filename);
+    }
+}
+
+// ******************************************************************************** 読み込み
+// 未知キーの収集先を受け取るオーバーロード（先に定義）
+export template <HasSerializer T>
+void readRaiBinary(std::string_view data, T& out, std::vector<std::string>& unknownKeysOut,
+    rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
+    RaiBinaryReader reader(data, executor);
+    JsonParser parser(reader, executor);
+    readJsonObject(parser, out);
+    if (parser.nextTokenType() != JsonTokenType::EndOfStream) {
+        throw std::runtime_error("readRaiBinary: unexpected content after root object");
+    }
+    unknownKeysOut = std::move(parser.getUnknownKeys());
+}
+
+/// @brief RaiBinary形式のバイト列からオブジェクトを読み込む。
+/// @tparam T 読み込み対象の型。
+/// @param data RaiBinary形式のバイト列。
+/// @param out 読み込み先のオブジェクト。
+/// @param executor 値の位置を求める処理と、変換器の並列処理に使う実行器。
+export template <HasSerializer T>
+void readRaiBinary(std::string_view data, T& out,
+    rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
+    std::vector<std::string> unknownKeysOut;
+    readRaiBinary(data, out, unknownKeysOut, executor);
+}
+
+// 未知キーの収集先を受け取るオーバーロード（先に定義）
+export template <HasSerializer T>
+void readRaiBinaryFile(const std::string& filename, T& out, std::vector<std::string>& unknownKeysOut,
+    rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
+    const std::string data = readWholeFile(filename, "readRaiBinaryFile");
+    readRaiBinary(data, out, unknownKeysOut, executor);
+}
+
+/// @brief RaiBinaryファイルからオブジェクトを読み込む。
+/// @tparam T 読み込み対象の型。
+/// @param filename 入力元のファイル名。
+/// @param out 読み込み先のオブジェクト。
+/// @param executor 値の位置を求める処理と、変換器の並列処理に使う実行器。
+export template <HasSerializer T>
+void readRaiBinaryFile(const std::string& filename, T& out,
+    rai::common::Executor& executor = rai::common::getDefaultExecutor()) {
+    std::vector<std::string> unknownKeysOut;
+    readRaiBinaryFile(filename, out, unknownKeysOut, executor);
+}
+
+}  // namespace rai::serialization
@@ -0,0 +1,486 @@
+// @file RaiBinaryReader.cppm
+// @brief RaiBinary形式の読み込み。オブジェクト集合の列を辿り、JsonParserが読めるトークン列として返す。
+
+module;
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <future>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+export module rai.serialization.rai_binary_reader;
+
+import rai.serialization.rai_binary_format;
+import rai.serialization.token_manager;
+import rai.common.thread_pool;
+
+export namespace rai::serialization {
+
+/// @brief RaiBinary形式のバイト列を、JSONのトークン列として読み出すトークン読み出し元。
+/// @note JsonParserに渡すことで、JSONと同じObjectSerializerでオブジェクトを読み込める。
+/// @note 構築時にヘッダーとオブジェクト集合テーブルを検証し、各フィールドの値の位置を求める。
+///       オブジェクト集合は互いに独立に並んでいるため、実行器にスレッドがあれば集合毎に並列に求める。
+/// @note 文字列は入力バッファを直接参照する。入力バッファは本オブジェクトより長く存在すること。
+class RaiBinaryReader final : public TokenSource {
+public:
+    /// @brief 入力を検証し、読み出しを準備する。
+    /// @param data RaiBinary形式のバイト列。本オブジェクトより長く存在すること。
+    /// @param executor 値の位置を求めるのに使う実行器。
+    explicit RaiBinaryReader(std::string_view data,
+        rai::common::Executor& executor = rai::common::getDefaultExecutor())
+        : data_(reinterpret_cast<const unsigned char*>(data.data())), size_(data.size()) {
+        setInputData(data.data());
+        readTable();
+        decodeSets(executor);
+        if (sets_.empty() || sets_[0].objectCount == 0) {
+            throw std::runtime_error("RaiBinary: root object is missing");
+        }
+        visit(0, 0);
+        stack_.push_back(Frame{FrameKind::Object, 0, 0, 0, 0, 0, false});
+        next_ = JsonToken::make(JsonTokenType::StartObject, sets_[0].offset);
+    }
+
+    // コピー・ムーブ禁止（トークンの文字列が本オブジェクトを介して解決されるため）
+    RaiBinaryReader(const RaiBinaryReader&) = delete;
+    RaiBinaryReader& operator=(const RaiBinaryReader&) = delete;
+    RaiBinaryReader(RaiBinaryReader&&) = delete;
+    RaiBinaryReader& operator=(RaiBinaryReader&&) = delete;
+
+    /// @brief 次のトークンを取得して消費する。
+    JsonToken takeNext() override {
+        const JsonToken token = next_;
+        if (token.type != JsonTokenType::EndOfStream) {
+            next_ = advance();
+        }
+        return token;
+    }
+
+    /// @brief 次のトークンを取得する（消費しない）。
+    const JsonToken& peekNext() const override { return next_; }
+
+    /// @brief オブジェクト集合の数を返す。
+    std::size_t objectSetCount() const { return sets_.size(); }
+
+private:
+    static constexpr std::uint64_t npos = std::numeric_limits<std::uint64_t>::max();
+    static constexpr std::size_t maxDepth = 1024;  ///< 配列の入れ子の上限。
+
+    /// @brief フィールドの定義。
+    struct Field {
+        std::uint8_t type;     ///< 値の型。
+        std::uint64_t key;     ///< キーの位置。
+        std::size_t keyLength; ///< キーのbyte数。
+    };
+
+    /// @brief オブジェクト集合。
+    struct ObjectSet {
+        std::uint64_t offset = 0;        ///< 集合の開始位置。
+        std::size_t objectCount = 0;     ///< オブジェクト数。
+        std::vector<Field> fields;       ///< フィールドの定義。
+        std::vector<std::uint64_t> values;  ///< フィールド毎・オブジェクト毎の値の位置（省略はnpos）。
+        std::size_t visitedBase = 0;     ///< visited_内の先頭位置。
+    };
+
+    /// @brief 読み出し中の階層の種類。
+    enum class FrameKind : std::uint8_t { Object, SingleArray, AnyArray };
+
+    /// @brief 読み出し中のオブジェクトまたは配列。
+    struct Frame {
+        FrameKind kind;
+        std::size_t set;          ///< オブジェクト（またはオブジェクトの配列）の集合。
+        std::uint64_t object;     ///< オブジェクトID（配列では次の要素のID）。
+        std::uint64_t position;   ///< 配列の次の要素の位置。
+        std::size_t index;        ///< オブジェクトでは次のフィールド、配列では残りの要素数。
+        std::uint8_t elementType; ///< 単一要素型配列の要素の型。
+        bool keyDone;             ///< オブジェクトで、現在のフィールドのキーを返したフラグ。
+    };
+
+    // ******************************************************************************** 構造の検証
+    /// @brief ヘッダーとオブジェクト集合テーブルを読む。
+    void readTable() {
+        if (size_ < raibinary::headerSize || std::memcmp(data_, raibinary::magic, 4) != 0) {
+            throw std::runtime_error("RaiBinary: not a RaiBinary file");
+        }
+        const std::uint64_t table = raibinary::loadUInt(data_ + 4, 8);
+        require(table, 4);
+        const std::uint64_t count = raibinary::loadUInt(data_ + table, 4);
+        if (count > (size_ - table - 4) / 8) {
+            throw std::runtime_error("RaiBinary: truncated object set table");
+        }
+        sets_.resize(count);
+        std::vector<bool> seen(count, false);
+        for (std::uint64_t i = 0; i < count; ++i) {
+            const std::uint64_t offset = raibinary::loadUInt(data_ + table + 4 + i * 8, 8);
+            require(offset, raibinary::objectSetHeaderSize);
+            const std::uint64_t id = raibinary::loadUInt(data_ + offset, 4);
+            if (id >= count || seen[id]) {
+                throw std::runtime_error("RaiBinary: invalid object set id");
+            }
+            seen[id] = true;
+            sets_[id].offset = offset;
+        }
+        // どうしてこの実装にしたか：集合の先頭は重なり得るため、集合ごとの上限だけでは
+        // 全集合のオブジェクト数（visited_）と値の位置（values）の合計が入力の大きさの2乗になり得る。
+        // 正しいファイルでは各オブジェクトは参照を、各フィールドは8オブジェクト毎にskipMapを持つため、
+        // 合計は入力のbyte数の8倍に収まる。確保の前に全集合の合計を確かめる。
+        const std::uint64_t limit = static_cast<std::uint64_t>(size_) * raibinary::skipMapGroupSize;
+        std::uint64_t totalObjects = 0;
+        std::uint64_t totalValues = 0;
+        for (const ObjectSet& set : sets_) {
+            const std::uint64_t fieldCount = raibinary::loadUInt(data_ + set.offset + 4, 4);
+            const std::uint64_t objectCount = raibinary::loadUInt(data_ + set.offset + 8, 4);
+            if (objectCount > limit - totalObjects ||
+                (fieldCount != 0 && objectCount > (limit - totalValues) / fieldCount)) {
+                throw std::runtime_error("RaiBinary: too many objects");
+            }
+            totalObjects += objectCount;
+            totalValues += fieldCount * objectCount;
+        }
+    }
+
+    /// @brief 各オブジェクト集合のフィールドの定義と値の位置を求める。
+    void decodeSets(rai::common::Executor& executor) {
+        std::vector<std::exception_ptr> errors(sets_.size());
+        auto decode = [&](std::size_t id) {
+            try {
+                decodeSet(sets_[id]);
+            } catch (...) {
+                errors[id] = std::current_exception();
+            }
+        };
+        if (executor.getThreadCount() == 0 || sets_.size() < 2) {
+            for (std::size_t id = 0; id < sets_.size(); ++id) {
+                decode(id);
+            }
+        } else {
+            std::vector<std::future<void>> futures;
+            futures.reserve(sets_.size() - 1);
+            for (std::size_t id = 1; id < sets_.size(); ++id) {
+                futures.push_back(executor.enqueue([&decode, id]() { decode(id); }));
+            }
+            // どうしてこの実装にしたか：呼び出しスレッドも待つだけにせず先頭の集合を求める。
+            decode(0);
+            for (auto& future : futures) {
+                executor.wait(future);
+            }
+        }
+        std::size_t visitedCount = 0;
+        for (std::size_t id = 0; id < sets_.size(); ++id) {
+            if (errors[id]) {
+                std::rethrow_exception(errors[id]);
+            }
+            sets_[id].visitedBase = visitedCount;
+            visitedCount += sets_[id].objectCount;
+        }
+        visited_.assign(visitedCount, false);
+    }
+
+    /// @brief オブジェクト集合1つのフィールドの定義と値の位置を求める。
+    void decodeSet(ObjectSet& set) const {
+        std::uint64_t pos = set.offset + 4;
+        const std::uint64_t fieldCount = raibinary::loadUInt(data_ + pos, 4);
+        const std::uint64_t objectCount = raibinary::loadUInt(data_ + pos + 4, 4);
+        pos += 8;
+        // 各フィールドは型とキー長の少なくとも2byteを持ち、8オブジェクト毎にskipMapを持つ。
+        // 不正な個数で巨大な領域を確保しないよう、入力の大きさで上限を確かめる。
+        if (fieldCount > (size_ - pos) / 2 || objectCount / raibinary::skipMapGroupSize > size_ ||
+            (fieldCount != 0 && objectCount / raibinary::skipMapGroupSize > (size_ - pos) / fieldCount)) {
+            throw std::runtime_error("RaiBinary: truncated object set");
+        }
+        set.objectCount = objectCount;
+        set.fields.reserve(fieldCount);
+        set.values.assign(fieldCount * objectCount, npos);
+        for (std::uint64_t f = 0; f < fieldCount; ++f) {
+            require(pos, 1);
+            const std::uint8_t typeByte = data_[pos++];
+            const std::size_t keyBytes = raibinary::bytesOf(typeByte >> raibinary::keySizeShift);
+            require(pos, keyBytes);
+            const std::uint64_t keyLength = raibinary::loadUInt(data_ + pos, keyBytes);
+            pos += keyBytes;
+            require(pos, keyLength);
+            set.fields.push_back(Field{static_cast<std::uint8_t>(typeByte & raibinary::typeMask), pos,
+                static_cast<std::size_t>(keyLength)});
+            pos += keyLength;
+            const std::uint8_t type = set.fields.back().type;
+            std::uint8_t skipMap = 0;
+            for (std::uint64_t i = 0; i < objectCount; ++i) {
+                if (i % raibinary::skipMapGroupSize == 0) {
+                    require(pos, 1);
+                    skipMap = data_[pos++];
+                }
+                if (skipMap & (1u << (i % raibinary::skipMapGroupSize))) {
+                    continue;
+                }
+                set.values[f * objectCount + i] = pos;
+                pos = skipValue(type, pos, 0);
+            }
+        }
+    }
+
+    /// @brief 値を読み飛ばし、範囲を検証する。
+    /// @param type 値の型。
+    /// @param pos 値の位置。
+    /// @param depth 配列の入れ子の深さ。
+    /// @return 値の直後の位置。
+    std::uint64_t skipValue(std::uint8_t type, std::uint64_t pos, std::size_t depth) const {
+        if (depth > maxDepth) {
+            throw std::runtime_error("RaiBinary: nesting too deep");
+        }
+        type &= raibinary::typeMask;
+        if (const std::size_t size = raibinary::fixedSizeOf(type); size != 0) {
+            require(pos, size);
+            return pos + size;
+        }
+        if (type == raibinary::Null) {
+            return pos;
+        }
+        if (raibinary::isString(type)) {
+            const std::size_t bytes = raibinary::bytesOf(type);
+            require(pos, bytes);
+            const std::uint64_t length = raibinary::loadUInt(data_ + pos, bytes);
+            require(pos + bytes, length);
+            return pos + bytes + length;
+        }
+        if (raibinary::isObject(type)) {
+            const std::size_t bytes = raibinary::bytesOf(type >> 2) + raibinary::bytesOf(type);
+            require(pos, bytes);
+            return pos + bytes;
+        }
+        if (raibinary::isSingleArray(type)) {
+            require(pos, 1);
+            const std::uint8_t elementType = data_[pos++] & raibinary::typeMask;
+            if (raibinary::isObject(elementType)) {
+                pos = skipValue(elementType, pos, depth + 1);
+                const std::size_t bytes = raibinary::bytesOf(type);
+                require(pos, bytes);
+                return pos + bytes;
+            }
+            const std::size_t bytes = raibinary::bytesOf(type);
+            require(pos, bytes);
+            const std::uint64_t count = raibinary::loadUInt(data_ + pos, bytes);
+            pos += bytes;
+            if (const std::size_t size = raibinary::fixedSizeOf(elementType); size != 0) {
+                if (count > (size_ - pos) / size) {
+                    throw std::runtime_error("RaiBinary: value out of range");
+                }
+                return pos + count * size;
+            }
+            for (std::uint64_t i = 0; i < count; ++i) {
+                pos = skipValue(elementType, pos, depth + 1);
+            }
+            return pos;
+        }
+        if (raibinary::isAnyArray(type)) {
+            const std::size_t bytes = raibinary::bytesOf(type);
+            require(pos, bytes);
+            const std::uint64_t count = raibinary::loadUInt(data_ + pos, bytes);
+            pos += bytes;
+            for (std::uint64_t i = 0; i < count; ++i) {
+                require(pos, 1);
+                const std::uint8_t elementType = data_[pos++];
+                pos = skipValue(elementType, pos, depth + 1);
+            }
+            return pos;
+        }
+        throw std::runtime_error("RaiBinary: unknown value type");
+    }
+
+    /// @brief 位置から指定byte数が入力内にあることを確かめる。
+    void require(std::uint64_t pos, std::uint64_t bytes) const {
+        if (pos > size_ || bytes > size_ - pos) {
+            throw std::runtime_error("RaiBinary: value out of range");
+        }
+    }
+
+    // ******************************************************************************** トークンの生成
+    /// @brief 次のトークンを求める。
+    JsonToken advance() {
+        if (stack_.empty()) {
+            return JsonToken::make(JsonTokenType::EndOfStream, size_);
+        }
+        Frame& frame = stack_.back();
+        switch (frame.kind) {
+        case FrameKind::Object: {
+            const ObjectSet& set = sets_[frame.set];
+            while (frame.index < set.fields.size() &&
+                   set.values[frame.index * set.objectCount + frame.object] == npos) {
+                ++frame.index;
+            }
+            if (frame.index == set.fields.size()) {
+                stack_.pop_back();
+                return JsonToken::make(JsonTokenType::EndObject, set.offset);
+            }
+            const Field& field = set.fields[frame.index];
+            if (!frame.keyDone) {
+                frame.keyDone = true;
+                return makeString(JsonTokenType::Key, field.key, field.keyLength);
+            }
+            const std::uint64_t pos = set.values[frame.index * set.objectCount + frame.object];
+            frame.keyDone = false;
+            ++frame.index;
+            return startValue(field.type, pos);
+        }
+        case FrameKind::SingleArray: {
+            if (frame.index == 0) {
+                stack_.pop_back();
+                return JsonToken::make(JsonTokenType::EndArray, frame.position);
+            }
+            --frame.index;
+            if (raibinary::isObject(frame.elementType)) {
+                const std::size_t set = frame.set;
+                const std::uint64_t object = frame.object++;
+                return startObject(set, object, frame.position);
+            }
+            const std::uint64_t pos = frame.position;
+            const std::uint8_t elementType = frame.elementType;
+            frame.position = skipValue(elementType, pos, stack_.size());
+            return startValue(elementType, pos);
+        }
+        case FrameKind::AnyArray: {
+            if (frame.index == 0) {
+                stack_.pop_back();
+                return JsonToken::make(JsonTokenType::EndArray, frame.position);
+            }
+            --frame.index;
+            const std::uint8_t elementType = data_[frame.position];
+            const std::uint64_t pos = frame.position + 1;
+            frame.position = skipValue(elementType, pos, stack_.size());
+            return startValue(elementType, pos);
+        }
+        }
+        return JsonToken::make(JsonTokenType::EndOfStream, size_);
+    }
+
+    /// @brief 値の最初のトークンを返す。配列とオブジェクトは階層を積む。
+    /// @note 範囲はdecodeSet()で検証済み。
+    JsonToken startValue(std::uint8_t type, std::uint64_t pos) {
+        type &= raibinary::typeMask;
+        if (type == raibinary::Null) {
+            return JsonToken::make(JsonTokenType::Null, pos);
+        }
+        if (type == raibinary::Bool) {
+            return JsonToken::makeBool(data_[pos] != 0, pos);
+        }
+        if (type == raibinary::Float32) {
+            const auto bits = static_cast<std::uint32_t>(raibinary::loadUInt(data_ + pos, 4));
+            float value = 0;
+            std::memcpy(&value, &bits, sizeof(value));
+            return JsonToken::makeNumber(value, pos);
+        }
+        if (type == raibinary::Float64) {
+            const std::uint64_t bits = raibinary::loadUInt(data_ + pos, 8);
+            double value = 0;
+            std::memcpy(&value, &bits, sizeof(value));
+            return JsonToken::makeNumber(value, pos);
+        }
+        if (type >= raibinary::UInt8 && type <= raibinary::UInt64) {
+            const std::uint64_t value = raibinary::loadUInt(data_ + pos, raibinary::fixedSizeOf(type));
+            if (value > static_cast<std::uint64_t>(INT64_MAX)) {
+                return JsonToken::makeNumber(static_cast<double>(value), pos);
+            }
+            return JsonToken::makeInteger(static_cast<std::int64_t>(value), pos);
+        }
+        if (type >= raibinary::Int8 && type <= raibinary::Int64) {
+            const std::size_t bytes = raibinary::fixedSizeOf(type);
+            std::uint64_t value = raibinary::loadUInt(data_ + pos, bytes);
+            if (bytes < 8 && (value >> (bytes * 8 - 1)) != 0) {
+                value |= ~std::uint64_t{0} << (bytes * 8);  // 符号拡張
+            }
+            return JsonToken::makeInteger(static_cast<std::int64_t>(value), pos);
+        }
+        if (raibinary::isString(type)) {
+            const std::size_t bytes = raibinary::bytesOf(type);
+            const std::uint64_t length = raibinary::loadUInt(data_ + pos, bytes);
+            return makeString(JsonTokenType::String, pos + bytes, length);
+        }
+        if (raibinary::isObject(type)) {
+            const std::size_t setBytes = raibinary::bytesOf(type >> 2);
+            const std::uint64_t set = raibinary::loadUInt(data_ + pos, setBytes);
+            const std::uint64_t object = raibinary::loadUInt(data_ + pos + setBytes, raibinary::bytesOf(type));
+            return startObject(set, object, pos);
+        }
+        if (stack_.size() >= maxDepth) {
+            throw std::runtime_error("RaiBinary: nesting too deep");
+        }
+        if (raibinary::isSingleArray(type)) {
+            const std::uint8_t elementType = data_[pos] & raibinary::typeMask;
+            std::uint64_t p = pos + 1;
+            Frame frame{FrameKind::SingleArray, 0, 0, 0, 0, elementType, false};
+            if (raibinary::isObject(elementType)) {
+                const std::size_t setBytes = raibinary::bytesOf(elementType >> 2);
+                const std::size_t objectBytes = raibinary::bytesOf(elementType);
+                const std::uint64_t set = raibinary::loadUInt(data_ + p, setBytes);
+                frame.object = raibinary::loadUInt(data_ + p + setBytes, objectBytes);
+                p += setBytes + objectBytes;
+                frame.index = raibinary::loadUInt(data_ + p, raibinary::bytesOf(type));
+                if (set >= sets_.size() || frame.object > sets_[set].objectCount ||
+                    frame.index > sets_[set].objectCount - frame.object) {
+                    throw std::runtime_error("RaiBinary: invalid object reference");
+                }
+                frame.set = set;
+            } else {
+                frame.index = raibinary::loadUInt(data_ + p, raibinary::bytesOf(type));
+                p += raibinary::bytesOf(type);
+            }
+            frame.position = p;
+            stack_.push_back(frame);
+            return JsonToken::make(JsonTokenType::StartArray, pos);
+        }
+        // 任意要素型配列
+        const std::size_t bytes = raibinary::bytesOf(type);
+        stack_.push_back(Frame{FrameKind::AnyArray, 0, 0, pos + bytes,
+            static_cast<std::size_t>(raibinary::loadUInt(data_ + pos, bytes)), 0, false});
+        return JsonToken::make(JsonTokenType::StartArray, pos);
+    }
+
+    /// @brief オブジェクトの読み出しを始める。
+    JsonToken startObject(std::uint64_t set, std::uint64_t object, std::uint64_t pos) {
+        if (stack_.size() >= maxDepth) {
+            throw std::runtime_error("RaiBinary: nesting too deep");
+        }
+        if (set >= sets_.size() || object >= sets_[set].objectCount) {
+            throw std::runtime_error("RaiBinary: invalid object reference");
+        }
+        visit(static_cast<std::size_t>(set), object);
+        stack_.push_back(Frame{FrameKind::Object, static_cast<std::size_t>(set), object, 0, 0, 0, false});
+        return JsonToken::make(JsonTokenType::StartObject, pos);
+    }
+
+    /// @brief オブジェクトを読み出し済みにする。
+    /// @note どうしてこの実装にしたか：参照が循環する不正な入力で無限に読み続けないよう、
+    ///       各オブジェクトは一度だけ読み出せるものとする（木構造のみを表す）。
+    void visit(std::size_t set, std::uint64_t object) {
+        const std::size_t index = sets_[set].visitedBase + static_cast<std::size_t>(object);
+        if (visited_[index]) {
+            throw std::runtime_error("RaiBinary: object referenced more than once");
+        }
+        visited_[index] = true;
+    }
+
+    /// @brief 文字列またはキーのトークンを生成する。
+    JsonToken makeString(JsonTokenType type, std::uint64_t pos, std::uint64_t length) {
+        if (pos <= UINT32_MAX && length <= UINT32_MAX) {
+            return JsonToken::makeText(type, JsonStringSlice{static_cast<std::uint32_t>(pos),
+                static_cast<std::uint32_t>(length)}, false, pos);
+        }
+        // スライスで入力内の位置を表せないため、文字列アリーナに写す。
+        JsonStringArena& strings = arena();
+        strings.begin();
+        strings.append(reinterpret_cast<const char*>(data_ + pos), static_cast<std::size_t>(length));
+        return JsonToken::makeText(type, strings.finish(), true, pos);
+    }
+
+    const unsigned char* data_;        ///< 入力の先頭。
+    std::size_t size_;                 ///< 入力のbyte数。
+    std::vector<ObjectSet> sets_;      ///< ID順のオブジェクト集合。
+    std::vector<bool> visited_;        ///< 読み出し済みのオブジェクト。
+    std::vector<Frame> stack_;         ///< 読み出し中の階層。
+    JsonToken next_{};                 ///< 次に返すトークン。
+};
+
+}  // namespace rai::serialization
@@ -0,0 +1,595 @@
+// @file RaiBinaryWriter.cppm
+// @brief RaiBinary形式の書き込み。JsonWriterと同じ順序の呼び出しから、オブジェクト集合毎の列に並べ替えて出力する。
+
+module;
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+export module rai.serialization.rai_binary_writer;
+
+import rai.serialization.rai_binary_format;
+
+export namespace rai::serialization {
+
+/// @brief RaiBinary形式の書き込みクラス。
+/// @note startObject()/key()/writeObject()/endObject()などをJsonWriterと同じ順序で呼び、
+///       最後にfinish()で出力を得る。ルートはオブジェクトであること。
+/// @note 同じキーの並びと値の種類を持つオブジェクトを1つのオブジェクト集合にまとめ、
+///       フィールド毎の列として書き出す。列の整数や長さは、列内の値が収まる最小のbyte数で表す。
+/// @note 同じオブジェクト集合のオブジェクトだけを要素に持つ配列は、要素を連番のオブジェクトに割り当て、
+///       先頭のオブジェクト参照と要素数だけで表す。
+class RaiBinaryWriter {
+public:
+    RaiBinaryWriter() = default;
+
+    // コピー・ムーブ禁止（書き込み途中の状態を持つため）
+    RaiBinaryWriter(const RaiBinaryWriter&) = delete;
+    RaiBinaryWriter& operator=(const RaiBinaryWriter&) = delete;
+    RaiBinaryWriter(RaiBinaryWriter&&) = delete;
+    RaiBinaryWriter& operator=(RaiBinaryWriter&&) = delete;
+
+    // ******************************************************************************** 構造
+    /// @brief オブジェクトの書き込みを開始する。
+    void startObject() {
+        if (depth_ == 0 && hasRoot_) {
+            throw std::runtime_error("RaiBinaryWriter: only one root object can be written");
+        }
+        pushFrame(true);
+    }
+
+    /// @brief オブジェクトの書き込みを終了する。
+    void endObject() {
+        Frame& frame = topFrame(true);
+        if (frame.keys.size() != frame.values.size()) {
+            throw std::runtime_error("RaiBinaryWriter: key without value");
+        }
+        std::string& signature = signatureBuffer_;
+        signature.clear();
+        for (std::size_t i = 0; i < frame.keys.size(); ++i) {
+            appendBytes(signature, frame.keys[i], 4);
+            signature.push_back(static_cast<char>(frame.values[i].kind));
+        }
+        auto [it, inserted] = definitionIndex_.try_emplace(signature, definitions_.size());
+        if (inserted) {
+            definitions_.push_back(Definition{frame.keys, {}, unassigned});
+        }
+        const std::size_t node = objects_.size();
+        objects_.push_back(ObjectNode{values_.size(), it->second, 0});
+        values_.insert(values_.end(), frame.values.begin(), frame.values.end());
+        --depth_;
+        if (depth_ == 0) {
+            root_ = node;
+            hasRoot_ = true;
+        } else {
+            addValue(Value::make(ValueKind::Object, node));
+        }
+    }
+
+    /// @brief 配列の書き込みを開始する。
+    void startArray() {
+        if (depth_ == 0) {
+            throw std::runtime_error("RaiBinaryWriter: root must be an object");
+        }
+        pushFrame(false);
+    }
+
+    /// @brief 配列の書き込みを終了する。
+    void endArray() {
+        Frame& frame = topFrame(false);
+        ArrayNode array{values_.size(), frame.values.size(), ValueKind::Null, true, 0};
+        if (!frame.values.empty()) {
+            // 要素が全て同じ種類（オブジェクトなら同じ定義）の場合だけ、単一要素型配列にできる。
+            const Value& first = frame.values.front();
+            array.elementKind = first.kind;
+            for (const Value& element : frame.values) {
+                if (element.kind != first.kind || element.kind == ValueKind::Array ||
+                    (element.kind == ValueKind::Object &&
+                     objects_[element.index].definition != objects_[first.index].definition)) {
+                    array.uniform = false;
+                    break;
+                }
+            }
+            if (array.uniform && first.kind == ValueKind::Object) {
+                array.definition = objects_[first.index].definition;
+            }
+        }
+        const std::size_t node = arrays_.size();
+        arrays_.push_back(array);
+        values_.insert(values_.end(), frame.values.begin(), frame.values.end());
+        --depth_;
+        addValue(Value::make(ValueKind::Array, node));
+    }
+
+    /// @brief キーを書き込む。
+    /// @param keyName キー名。
+    void key(std::string_view keyName) {
+        Frame& frame = topFrame(true);
+        if (frame.keys.size() != frame.values.size()) {
+            throw std::runtime_error("RaiBinaryWriter: key without value");
+        }
+        auto [it, inserted] = keyIndex_.try_emplace(std::string(keyName), keys_.size());
+        if (inserted) {
+            keys_.emplace_back(keyName);
+        }
+        frame.keys.push_back(static_cast<std::uint32_t>(it->second));
+    }
+
+    // ******************************************************************************** 値
+    /// @brief null値を書き込む。
+    void null() { addValue(Value::make(ValueKind::Null, 0)); }
+
+    /// @brief 真偽値を書き込む。
+    void writeObject(bool value) {
+        Value v = Value::make(ValueKind::Bool, 0);
+        v.boolean = value;
+        addValue(v);
+    }
+
+    /// @brief 1文字を文字列として書き込む（JsonWriterと同じく、文字型は1文字の文字列として扱う）。
+    void writeObject(char value) { writeObject(std::string_view(&value, 1)); }
+    void writeObject(signed char value) { writeObject(static_cast<char>(value)); }
+    void writeObject(unsigned char value) { writeObject(static_cast<char>(value)); }
+    void writeObject(char8_t value) { writeCodePoint(static_cast<char32_t>(value)); }
+    void writeObject(char16_t value) { writeCodePoint(static_cast<char32_t>(value)); }
+    void writeObject(char32_t value) { writeCodePoint(value <= 0x10FFFF ? value : U'\uFFFD'); }
+    void writeObject(wchar_t value) { writeCodePoint(static_cast<char32_t>(value)); }
+
+    /// @brief 整数値を書き込む。
+    /// @note int64_tに収まらない符号なし整数は、JSONの読み込みと同じく浮動小数点数として扱う。
+    template <typename T>
+        requires std::is_integral_v<T> && (!std::is_same_v<T, bool>)
+    void writeObject(T value) {
+        if constexpr (std::is_unsigned_v<T> && sizeof(T) >= sizeof(std::int64_t)) {
+            if (value > static_cast<T>(std::numeric_limits<std::int64_t>::max())) {
+                writeObject(static_cast<double>(value));
+                return;
+            }
+        }
+        Value v = Value::make(ValueKind::Integer, 0);
+        v.integer = static_cast<std::int64_t>(value);
+        addValue(v);
+    }
+
+    /// @brief 浮動小数点数値を書き込む。
+    template <typename T>
+        requires std::is_floating_point_v<T>
+    void writeObject(T value) {
+        Value v = Value::make(ValueKind::Float, 0);
+        v.number = static_cast<double>(value);
+        addValue(v);
+    }
+
+    /// @brief 文字列値を書き込む。
+    void writeObject(std::string_view value) {
+        const std::size_t index = strings_.size();
+        strings_.push_back(StringRef{stringBytes_.size(), value.size()});
+        stringBytes_.append(value);
+        addValue(Value::make(ValueKind::String, index));
+    }
+
+    // ******************************************************************************** 出力
+    /// @brief 書き込んだ内容をRaiBinary形式で出力する。
+    /// @return 出力したバイト列。
+    /// @note 呼び出し後は、新しいルートオブジェクトを書き込める。
+    std::string finish() {
+        if (!hasRoot_ || depth_ != 0) {
+            throw std::runtime_error("RaiBinaryWriter: root object is not complete");
+        }
+        assignObjectIds();
+        std::string out;
+        out.append(reinterpret_cast<const char*>(raibinary::magic), 4);
+        appendBytes(out, 0, 8);  // オブジェクト集合テーブルの開始位置（後で埋める）
+        std::vector<std::uint64_t> setOffsets;
+        setOffsets.reserve(definitionOrder_.size());
+        for (std::size_t id = 0; id < definitionOrder_.size(); ++id) {
+            setOffsets.push_back(out.size());
+            writeObjectSet(out, id, definitions_[definitionOrder_[id]]);
+        }
+        const std::uint64_t tableOffset = out.size();
+        appendBytes(out, setOffsets.size(), 4);
+        for (std::uint64_t offset : setOffsets) {
+            appendBytes(out, offset, 8);
+        }
+        raibinary::storeUInt(reinterpret_cast<unsigned char*>(out.data()) + 4, tableOffset, 8);
+        clear();
+        return out;
+    }
+
+private:
+    /// @brief 値の種類。オブジェクト集合の定義では、キーの並びとこの種類の並びが同じものをまとめる。
+    enum class ValueKind : std::uint8_t { Null, Bool, Integer, Float, String, Array, Object };
+
+    /// @brief 書き込まれた値。文字列・配列・オブジェクトは格納先の添字で表す。
+    struct Value {
+        ValueKind kind;
+        union {
+            bool boolean;
+            std::int64_t integer;
+            double number;
+            std::size_t index;
+        };
+
+        static Value make(ValueKind kind, std::size_t index) {
+            Value value;
+            value.kind = kind;
+            value.index = index;
+            return value;
+        }
+    };
+
+    /// @brief 文字列の格納位置。
+    struct StringRef {
+        std::size_t offset;  ///< stringBytes_内の開始位置。
+        std::size_t length;  ///< byte数。
+    };
+
+    /// @brief 書き込み済みのオブジェクト。
+    struct ObjectNode {
+        std::size_t firstValue;  ///< values_内のフィールド値の開始位置。
+        std::size_t definition;  ///< definitions_内の定義の添字。
+        std::uint64_t id;        ///< オブジェクト集合内のオブジェクトID（finish()で割り当てる）。
+    };
+
+    /// @brief 書き込み済みの配列。
+    struct ArrayNode {
+        std::size_t firstValue;  ///< values_内の要素の開始位置。
+        std::size_t count;       ///< 要素数。
+        ValueKind elementKind;   ///< 単一要素型配列の場合の要素の種類。
+        bool uniform;            ///< 単一要素型配列にできるか。
+        std::size_t definition;  ///< 要素がオブジェクトの場合の定義の添字。
+    };
+
+    /// @brief オブジェクト集合の定義。
+    struct Definition {
+        std::vector<std::uint32_t> keys;    ///< フィールドのキー（keys_の添字）。
+        std::vector<std::size_t> objects;   ///< オブジェクトID順のオブジェクト（objects_の添字）。
+        std::size_t id;                     ///< オブジェクト集合のID（finish()で割り当てる）。
+    };
+
+    /// @brief 書き込み中のオブジェクトまたは配列。
+    struct Frame {
+        bool isObject = false;
+        std::vector<std::uint32_t> keys;
+        std::vector<Value> values;
+    };
+
+    static constexpr std::size_t unassigned = std::numeric_limits<std::size_t>::max();
+
+    /// @brief 書き込み中の階層を1つ増やす。
+    void pushFrame(bool isObject) {
+        if (depth_ == frames_.size()) {
+            frames_.emplace_back();
+        }
+        Frame& frame = frames_[depth_++];
+        frame.isObject = isObject;
+        frame.keys.clear();
+        frame.values.clear();
+    }
+
+    /// @brief 書き込み中の階層を返す。
+    /// @param isObject オブジェクトを期待する場合true、配列を期待する場合false。
+    Frame& topFrame(bool isObject) {
+        if (depth_ == 0 || frames_[depth_ - 1].isObject != isObject) {
+            throw std::runtime_error(isObject ? "RaiBinaryWriter: not inside an object"
+                                              : "RaiBinaryWriter: not inside an array");
+        }
+        return frames_[depth_ - 1];
+    }
+
+    /// @brief Unicodeのコードポイント1つをUTF-8の文字列として書き込む。
+    void writeCodePoint(char32_t codePoint) {
+        char bytes[4];
+        std::size_t size = 0;
+        const auto cp = static_cast<std::uint32_t>(codePoint);
+        if (cp < 0x80) {
+            bytes[size++] = static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            bytes[size++] = static_cast<char>(0xC0 | (cp >> 6));
+            bytes[size++] = static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            bytes[size++] = static_cast<char>(0xE0 | (cp >> 12));
+            bytes[size++] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            bytes[size++] = static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+            bytes[size++] = static_cast<char>(0xF0 | (cp >> 18));
+            bytes[size++] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            bytes[size++] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            bytes[size++] = static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        writeObject(std::string_view(bytes, size));
+    }
+
+    /// @brief 書き込み中のオブジェクトまたは配列に値を追加する。
+    void addValue(const Value& value) {
+        if (depth_ == 0) {
+            throw std::runtime_error("RaiBinaryWriter: root must be an object");
+        }
+        Frame& frame = frames_[depth_ - 1];
+        if (frame.isObject && frame.keys.size() != frame.values.size() + 1) {
+            throw std::runtime_error("RaiBinaryWriter: value without key");
+        }
+        frame.values.push_back(value);
+    }
+
+    /// @brief ルートから幅優先で辿り、オブジェクト集合とオブジェクトのIDを割り当てる。
+    /// @note どうしてこの実装にしたか：単一要素型配列の要素を連番にするため、配列の要素はまとめて割り当ててから辿る。
+    ///       ルートは最初のオブジェクト集合の最初のオブジェクトになる。
+    void assignObjectIds() {
+        definitionOrder_.clear();
+        for (Definition& definition : definitions_) {
+            definition.objects.clear();
+            definition.id = unassigned;
+        }
+        std::vector<Value> queue;
+        queue.push_back(Value::make(ValueKind::Object, root_));
+        reserveObject(root_);
+        for (std::size_t head = 0; head < queue.size(); ++head) {
+            const Value current = queue[head];
+            std::size_t first = 0;
+            std::size_t count = 0;
+            if (current.kind == ValueKind::Object) {
+                const ObjectNode& object = objects_[current.index];
+                first = object.firstValue;
+                count = definitions_[object.definition].keys.size();
+            } else {
+                first = arrays_[current.index].firstValue;
+                count = arrays_[current.index].count;
+            }
+            for (std::size_t i = first; i < first + count; ++i) {
+                const Value child = values_[i];
+                if (child.kind == ValueKind::Object) {
+                    reserveObject(child.index);
+                    queue.push_back(child);
+                } else if (child.kind == ValueKind::Array) {
+                    const ArrayNode& array = arrays_[child.index];
+                    if (array.uniform && array.elementKind == ValueKind::Object) {
+                        for (std::size_t e = array.firstValue; e < array.firstValue + array.count; ++e) {
+                            reserveObject(values_[e].index);
+                            queue.push_back(values_[e]);
+                        }
+                    } else {
+                        queue.push_back(child);
+                    }
+                }
+            }
+        }
+    }
+
+    /// @brief オブジェクトに、その定義のオブジェクト集合内の次のIDを割り当てる。
+    void reserveObject(std::size_t node) {
+        ObjectNode& object = objects_[node];
+        Definition& definition = definitions_[object.definition];
+        if (definition.id == unassigned) {
+            definition.id = definitionOrder_.size();
+            definitionOrder_.push_back(object.definition);
+        }
+        object.id = definition.objects.size();
+        definition.objects.push_back(node);
+    }
+
+    /// @brief オブジェクト集合を1つ書き出す。
+    void writeObjectSet(std::string& out, std::size_t id, const Definition& definition) {
+        appendBytes(out, id, 4);
+        appendBytes(out, definition.keys.size(), 4);
+        appendBytes(out, definition.objects.size(), 4);
+        for (std::size_t field = 0; field < definition.keys.size(); ++field) {
+            const std::string& keyName = keys_[definition.keys[field]];
+            const std::uint8_t keySize = raibinary::sizeCodeFor(keyName.size());
+            const std::uint8_t type = columnType(definition, field);
+            out.push_back(static_cast<char>(type | (keySize << raibinary::keySizeShift)));
+            appendBytes(out, keyName.size(), raibinary::bytesOf(keySize));
+            out.append(keyName);
+            const std::size_t count = definition.objects.size();
+            for (std::size_t i = 0; i < count; ++i) {
+                if (i % raibinary::skipMapGroupSize == 0) {
+                    out.push_back('\0');  // 全てのオブジェクトがフィールドを持つ。
+                }
+                writeValue(out, type, values_[objects_[definition.objects[i]].firstValue + field]);
+            }
+        }
+    }
+
+    /// @brief 列（または配列の要素）に共通の型を求める。
+    /// @param values 値の並び。全て同じ種類であること。
+    template <typename ValueAt>
+    std::uint8_t commonType(ValueKind kind, std::size_t count, ValueAt&& valueAt) const {
+        switch (kind) {
+        case ValueKind::Null:
+            return raibinary::Null;
+        case ValueKind::Bool:
+            return raibinary::Bool;
+        case ValueKind::Integer: {
+            std::int64_t minValue = 0;
+            std::int64_t maxValue = 0;
+            for (std::size_t i = 0; i < count; ++i) {
+                const std::int64_t v = valueAt(i).integer;
+                minValue = i == 0 ? v : std::min(minValue, v);
+                maxValue = i == 0 ? v : std::max(maxValue, v);
+            }
+            return integerType(minValue, maxValue);
+        }
+        case ValueKind::Float: {
+            for (std::size_t i = 0; i < count; ++i) {
+                if (!fitsFloat(valueAt(i).number)) {
+                    return raibinary::Float64;
+                }
+            }
+            return raibinary::Float32;
+        }
+        case ValueKind::String: {
+            std::size_t maxLength = 0;
+            for (std::size_t i = 0; i < count; ++i) {
+                maxLength = std::max(maxLength, strings_[valueAt(i).index].length);
+            }
+            return raibinary::String | raibinary::sizeCodeFor(maxLength);
+        }
+        case ValueKind::Array: {
+            std::size_t maxCount = 0;
+            bool uniform = true;
+            for (std::size_t i = 0; i < count; ++i) {
+                const ArrayNode& array = arrays_[valueAt(i).index];
+                maxCount = std::max(maxCount, array.count);
+                uniform = uniform && array.uniform;
+            }
+            return (uniform ? raibinary::SingleArray : raibinary::AnyArray) |
+                raibinary::sizeCodeFor(maxCount);
+        }
+        case ValueKind::Object: {
+            std::uint64_t maxDefinition = 0;
+            std::uint64_t maxId = 0;
+            for (std::size_t i = 0; i < count; ++i) {
+                const ObjectNode& object = objects_[valueAt(i).index];
+                maxDefinition = std::max<std::uint64_t>(maxDefinition, definitions_[object.definition].id);
+                maxId = std::max(maxId, object.id);
+            }
+            return raibinary::Object | (raibinary::sizeCodeFor(maxDefinition) << 2) |
+                raibinary::sizeCodeFor(maxId);
+        }
+        }
+        return raibinary::Null;
+    }
+
+    /// @brief オブジェクト集合のフィールドの列の型を求める。
+    std::uint8_t columnType(const Definition& definition, std::size_t field) const {
+        const ValueKind kind = values_[objects_[definition.objects.front()].firstValue + field].kind;
+        return commonType(kind, definition.objects.size(), [&](std::size_t i) -> const Value& {
+            return values_[objects_[definition.objects[i]].firstValue + field];
+        });
+    }
+
+    /// @brief 値を単独で表す型を求める（任意要素型配列の要素用）。
+    std::uint8_t ownType(const Value& value) const {
+        return commonType(value.kind, 1, [&](std::size_t) -> const Value& { return value; });
+    }
+
+    /// @brief 値を指定した型で書き出す。
+    void writeValue(std::string& out, std::uint8_t type, const Value& value) const {
+        type &= raibinary::typeMask;
+        if (const std::size_t size = raibinary::fixedSizeOf(type); size != 0) {
+            if (type == raibinary::Bool) {
+                out.push_back(value.boolean ? '\1' : '\0');
+            } else if (type == raibinary::Float32) {
+                const float f = static_cast<float>(value.number);
+                std::uint32_t bits = 0;
+                std::memcpy(&bits, &f, sizeof(bits));
+                appendBytes(out, bits, 4);
+            } else if (type == raibinary::Float64) {
+                std::uint64_t bits = 0;
+                std::memcpy(&bits, &value.number, sizeof(bits));
+                appendBytes(out, bits, 8);
+            } else {
+                appendBytes(out, static_cast<std::uint64_t>(value.integer), size);
+            }
+        } else if (type == raibinary::Null) {
+            // 値を持たない。
+        } else if (raibinary::isString(type)) {
+            const StringRef& str = strings_[value.index];
+            appendBytes(out, str.length, raibinary::bytesOf(type));
+            out.append(stringBytes_, str.offset, str.length);
+        } else if (raibinary::isObject(type)) {
+            const ObjectNode& object = objects_[value.index];
+            appendBytes(out, definitions_[object.definition].id, raibinary::bytesOf(type >> 2));
+            appendBytes(out, object.id, raibinary::bytesOf(type));
+        } else if (raibinary::isSingleArray(type)) {
+            const ArrayNode& array = arrays_[value.index];
+            const std::uint8_t elementType = commonType(array.elementKind, array.count,
+                [&](std::size_t i) -> const Value& { return values_[array.firstValue + i]; });
+            out.push_back(static_cast<char>(elementType));
+            if (array.elementKind == ValueKind::Object) {
+                // 要素は連番のオブジェクトなので、先頭のオブジェクト参照だけを書く。
+                const ObjectNode& first = objects_[values_[array.firstValue].index];
+                appendBytes(out, definitions_[first.definition].id, raibinary::bytesOf(elementType >> 2));
+                appendBytes(out, first.id, raibinary::bytesOf(elementType));
+                appendBytes(out, array.count, raibinary::bytesOf(type));
+            } else {
+                appendBytes(out, array.count, raibinary::bytesOf(type));
+                for (std::size_t i = 0; i < array.count; ++i) {
+                    writeValue(out, elementType, values_[array.firstValue + i]);
+                }
+            }
+        } else {
+            const ArrayNode& array = arrays_[value.index];
+            appendBytes(out, array.count, raibinary::bytesOf(type));
+            for (std::size_t i = 0; i < array.count; ++i) {
+                const Value& element = values_[array.firstValue + i];
+                const std::uint8_t elementType = ownType(element);
+                out.push_back(static_cast<char>(elementType));
+                writeValue(out, elementType, element);
+            }
+        }
+    }
+
+    /// @brief 整数の範囲を表せる最小の型を返す。
+    static std::uint8_t integerType(std::int64_t minValue, std::int64_t maxValue) {
+        if (minValue >= 0) {
+            return static_cast<std::uint8_t>(raibinary::UInt8 +
+                raibinary::sizeCodeFor(static_cast<std::uint64_t>(maxValue)));
+        }
+        auto fits = [&](std::int64_t low, std::int64_t high) { return minValue >= low && maxValue <= high; };
+        if (fits(INT8_MIN, INT8_MAX)) {
+            return raibinary::Int8;
+        }
+        if (fits(INT16_MIN, INT16_MAX)) {
+            return raibinary::Int16;
+        }
+        if (fits(INT32_MIN, INT32_MAX)) {
+            return raibinary::Int32;
+        }
+        return raibinary::Int64;
+    }
+
+    /// @brief 単精度浮動小数点数で誤差なく表せるかを返す。
+    static bool fitsFloat(double value) {
+        return std::isnan(value) || static_cast<double>(static_cast<float>(value)) == value;
+    }
+
+    /// @brief 符号なし整数をリトルエンディアンで追加する。
+    static void appendBytes(std::string& out, std::uint64_t value, std::size_t bytes) {
+        unsigned char buffer[8];
+        raibinary::storeUInt(buffer, value, bytes);
+        out.append(reinterpret_cast<const char*>(buffer), bytes);
+    }
+
+    /// @brief 書き込んだ内容を破棄する（確保済みの領域は再利用する）。
+    void clear() {
+        keys_.clear();
+        keyIndex_.clear();
+        definitions_.clear();
+        definitionIndex_.clear();
+        definitionOrder_.clear();
+        objects_.clear();
+        arrays_.clear();
+        values_.clear();
+        strings_.clear();
+        stringBytes_.clear();
+        hasRoot_ = false;
+    }
+
+    std::vector<Frame> frames_;    ///< 書き込み中の階層（再利用するため縮めない）。
+    std::size_t depth_ = 0;        ///< 書き込み中の階層の深さ。
+    std::vector<std::string> keys_;  ///< キー名の一覧。
+    std::unordered_map<std::string, std::size_t> keyIndex_;  ///< キー名からkeys_の添字への対応。
+    std::vector<Definition> definitions_;  ///< オブジェクト集合の定義。
+    std::unordered_map<std::string, std::size_t> definitionIndex_;  ///< 定義の署名からdefinitions_の添字への対応。
+    std::vector<std::size_t> definitionOrder_;  ///< オブジェクト集合のID順の定義の添字。
+    std::string signatureBuffer_;  ///< 定義の署名の作業領域。
+    std::vector<ObjectNode> objects_;  ///< 書き込み済みのオブジェクト。
+    std::vector<ArrayNode> arrays_;    ///< 書き込み済みの配列。
+    std::vector<Value> values_;        ///< オブジェクトのフィールド値と配列の要素。
+    std::vector<StringRef> strings_;   ///< 文字列値の格納位置。
+    std::string stringBytes_;          ///< 文字列値の内容。
+    std::size_t root_ = 0;             ///< ルートオブジェクト（objects_の添字）。
+    bool hasRoot_ = false;             ///< ルートオブジェクトを書き終えたフラグ。
+};
+
+}  // namespace rai::serialization
@@ -35,6 +35,14 @@ class ReadingAheadBuffer {
     /// @return 読み取り位置。
     std::size_t position() const { return consumingPos_; }
 
+    /// @brief 入力全体の先頭を返す。
+    /// @return 位置0の文字へのポインタ。本オブジェクトが存在する間有効。
+    const char* data() const { return consumingBuffer_.data(); }
+
+    /// @brief 有効な入力のbyte数を返す。
+    /// @return 先読み用の番兵を除いたbyte数。
+    std::size_t size() const { return consumingValidSize_; }
+
     /// @brief 先読みした文字を取得する。
     /// @param offset 現在位置からのオフセット。
     /// @return 指定位置の文字。範囲外の場合は'\0'。
@@ -0,0 +1,184 @@
+// @file ReadingAheadBufferRing.cppm
+// @brief K個のバッファを環状に使い、複数の読み込みを消費より先行させる先読みバッファの実装。
+
+module;
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+export module rai.serialization.reading_ahead_buffer_ring;
+
+export namespace rai::serialization {
+
+/// @brief 入力バッファの構成。
+struct InputBufferOptions {
+    /// @brief 1つのバッファの容量(要素数)。1回の読み込みの単位になる。ページサイズの倍数を推奨。
+    std::size_t chunkSize = 4096;
+
+    /// @brief バッファの数（2以上）。消費中の1つを除いた数だけ、読み込みを先行させられる。
+    std::size_t bufferCount = 2;
+
+    /// @brief バッファを2MB境界に揃えて確保し、Linuxではhuge pageの利用を要求する（ヒント）。
+    bool hugePageAligned = false;
+};
+
+/// @brief K個のバッファを環状に使う先読みバッファ。
+/// @note 通し番号seqのバッファはseq % K番目の領域を使う。各バッファの先頭maxReadingAhead要素は
+///       直前のバッファの末尾と同じ内容で、消費側はバッファの境界をまたいで先読みできる。
+///       同期は行わない。読み込み中のバッファと消費中のバッファが重ならないことは呼び出し元が保証する。
+/// @tparam T バッファの要素型（トリビアルにコピー可能な型）。
+template <typename T>
+class ReadingAheadBufferRing {
+    static_assert(std::is_trivially_copyable_v<T>, "ReadingAheadBufferRing requires a trivially copyable element");
+
+public:
+    /// @brief huge page利用時の境界(byte)。
+    static constexpr std::size_t hugePageSize = 2 * 1024 * 1024;
+
+    /// @brief コンストラクタ。
+    /// @param maxReadingAhead 先読みサイズ(要素数)。
+    /// @param options バッファの容量・数・配置の設定。
+    explicit ReadingAheadBufferRing(std::size_t maxReadingAhead, const InputBufferOptions& options = {})
+        : maxReadingAhead_(maxReadingAhead), chunkSize_(options.chunkSize),
+          bufferCount_(options.bufferCount), slots_(options.bufferCount) {
+        if (chunkSize_ <= maxReadingAhead_) {
+            throw std::invalid_argument("chunkSize must be at least maxReadingAhead + 1");
+        }
+        if (bufferCount_ < 2) {
+            throw std::invalid_argument("bufferCount must be at least 2");
+        }
+        // どうしてこの実装にしたか：最後のバッファの後ろに番兵を置けるよう、各領域をmaxReadingAhead要素だけ広く取る。
+        alignment_ = options.hugePageAligned ? hugePageSize : alignof(std::max_align_t);
+        stride_ = roundUp((chunkSize_ + maxReadingAhead_) * sizeof(T), std::max<std::size_t>(alignment_, 64));
+        storage_ = static_cast<std::byte*>(
+            ::operator new(stride_ * bufferCount_, std::align_val_t{alignment_}));
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        if (options.hugePageAligned) {
+            // ヒントなので、失敗しても通常のページで動作する。
+            ::madvise(storage_, stride_ * bufferCount_, MADV_HUGEPAGE);
+        }
+#endif
+    }
+
+    ~ReadingAheadBufferRing() {
+        ::operator delete(storage_, std::align_val_t{alignment_});
+    }
+
+    // コピー・ムーブ禁止
+    ReadingAheadBufferRing(const ReadingAheadBufferRing&) = delete;
+    ReadingAheadBufferRing& operator=(const ReadingAheadBufferRing&) = delete;
+    ReadingAheadBufferRing(ReadingAheadBufferRing&&) = delete;
+    ReadingAheadBufferRing& operator=(ReadingAheadBufferRing&&) = delete;
+
+    /// @brief 先読みサイズを取得する。
+    /// @return 先読みサイズ（要素数）。
+    std::size_t maxReadingAhead() const {
+        return maxReadingAhead_;
+    }
+
+    /// @brief 1つのバッファの容量を取得する。
+    /// @return 容量（要素数）。
+    std::size_t chunkSize() const {
+        return chunkSize_;
+    }
+
+    /// @brief バッファの数を取得する。
+    /// @return バッファの数。
+    std::size_t bufferCount() const {
+        return bufferCount_;
+    }
+
+    /// @brief バッファの先頭を取得する。
+    /// @param seq バッファの通し番号。
+    /// @return バッファの先頭要素へのポインタ。
+    T* data(std::size_t seq) {
+        return reinterpret_cast<T*>(storage_ + (seq % bufferCount_) * stride_);
+    }
+
+    /// @brief バッファの先頭を取得する。
+    /// @param seq バッファの通し番号。
+    /// @return バッファの先頭要素へのポインタ。
+    const T* data(std::size_t seq) const {
+        return reinterpret_cast<const T*>(storage_ + (seq % bufferCount_) * stride_);
+    }
+
+    /// @brief 読み込み先の位置を取得する。
+    /// @param seq バッファの通し番号。
+    /// @return バッファ内の読み込み開始位置。最初のバッファは0、以降は直前の末尾を写した後ろ。
+    std::size_t readOffset(std::size_t seq) const {
+        return seq == 0 ? 0 : maxReadingAhead_;
+    }
+
+    /// @brief 1回に読み込む要素数を取得する。
+    /// @param seq バッファの通し番号。
+    /// @return 読み込む要素数。
+    std::size_t readSize(std::size_t seq) const {
+        return chunkSize_ - readOffset(seq);
+    }
+
+    /// @brief 読み込みの前に、直前のバッファの末尾を先頭に写す。
+    /// @param seq これから読み込むバッファの通し番号。直前のバッファは満杯で読み込み済みであること。
+    void prepare(std::size_t seq) {
+        if (seq > 0) {
+            std::memcpy(data(seq), data(seq - 1) + (chunkSize_ - maxReadingAhead_),
+                maxReadingAhead_ * sizeof(T));
+        }
+    }
+
+    /// @brief 読み込みの完了を記録する。
+    /// @param seq 読み込んだバッファの通し番号。
+    /// @param count 読み込んだ要素数。
+    /// @param final 入力の末尾に到達した場合はtrue。末尾の後ろに番兵（T{}）を置く。
+    void commit(std::size_t seq, std::size_t count, bool final) {
+        Slot& slot = slots_[seq % bufferCount_];
+        const std::size_t content = readOffset(seq) + count;
+        slot.final = final;
+        if (final) {
+            std::fill_n(data(seq) + content, maxReadingAhead_, T{});
+            slot.consumableSize = content;
+        } else {
+            // 末尾maxReadingAhead要素は次のバッファの先頭でも読めるため、ここでは消費しない。
+            slot.consumableSize = chunkSize_ - maxReadingAhead_;
+        }
+    }
+
+    /// @brief バッファ内で消費できる要素数を取得する（先読み用の末尾を除く）。
+    /// @param seq 読み込み済みのバッファの通し番号。
+    std::size_t consumableSize(std::size_t seq) const {
+        return slots_[seq % bufferCount_].consumableSize;
+    }
+
+    /// @brief 入力の末尾を含むバッファかを返す。
+    /// @param seq 読み込み済みのバッファの通し番号。
+    bool isFinal(std::size_t seq) const {
+        return slots_[seq % bufferCount_].final;
+    }
+
+private:
+    /// @brief 読み込み済みのバッファの状態。
+    struct Slot {
+        std::size_t consumableSize = 0;  ///< 消費できる要素数。
+        bool final = false;              ///< 入力の末尾を含むフラグ。
+    };
+
+    static std::size_t roundUp(std::size_t value, std::size_t unit) {
+        return (value + unit - 1) / unit * unit;
+    }
+
+    std::size_t maxReadingAhead_;  ///< 先読みサイズ(要素数)。
+    std::size_t chunkSize_;        ///< 1つのバッファの容量(要素数)。
+    std::size_t bufferCount_;      ///< バッファの数。
+    std::size_t alignment_ = 0;    ///< 領域の配置境界(byte)。
+    std::size_t stride_ = 0;       ///< バッファ1つ分の領域(byte)。
+    std::byte* storage_ = nullptr; ///< 全バッファの領域。
+    std::vector<Slot> slots_;      ///< バッファ毎の状態。
+};
+
+}  // namespace rai::serialization
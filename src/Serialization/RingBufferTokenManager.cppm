@@ -0,0 +1,289 @@
+// @file RingBufferTokenManager.cppm
+// @brief 単一生産者・単一消費者向けのロックフリーなリングバッファ型トークン管理クラス。
+
+module;
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+export module rai.serialization.ring_buffer_token_manager;
+
+import rai.serialization.token_manager;
+import rai.serialization.pipeline_instrumentation;
+
+export namespace rai::serialization {
+
+/// @brief 単一生産者・単一消費者向けの有界リングバッファによるトークン管理クラス。
+/// @note トークナイザー（生産者）とJsonParser（消費者）が別スレッドで動く並列読み込み用。
+///       トークンはbatchSize個ごとにまとめて公開し、待機はスピンの後に条件変数で休止する。
+/// @note 生産者が空き待ちで停止するため、生産と消費を同一スレッドで行ってはならない。
+/// @tparam Instrumentation 計測フックの型。消費者がトークンの公開を待った時間を記録する。
+template <PipelineInstrumentation Instrumentation = NoPipelineInstrumentation>
+class RingBufferTokenManagerBase final : public TokenSource {
+public:
+    /// @brief コンストラクタ。
+    /// @param capacity リングバッファの容量（トークン数）。2の冪に切り上げる。
+    /// @param batchSize 消費者へまとめて公開するトークン数。容量の半分を上限とする。
+    explicit RingBufferTokenManagerBase(std::size_t capacity = 4096, std::size_t batchSize = 64)
+        : RingBufferTokenManagerBase(Instrumentation{}, capacity, batchSize) {}
+
+    /// @brief 計測フックを指定するコンストラクタ。
+    /// @param instrumentation 計測フック。
+    /// @param capacity リングバッファの容量（トークン数）。2の冪に切り上げる。
+    /// @param batchSize 消費者へまとめて公開するトークン数。容量の半分を上限とする。
+    explicit RingBufferTokenManagerBase(Instrumentation instrumentation,
+        std::size_t capacity = 4096, std::size_t batchSize = 64)
+        : slots_(std::bit_ceil(std::max<std::size_t>(capacity, 2))),
+          mask_(slots_.size() - 1),
+          batchSize_(std::clamp<std::size_t>(batchSize, 1, slots_.size() / 2)),
+          instrumentation_(instrumentation) {}
+
+    // コピー・ムーブ禁止（スレッド間で共有するため）
+    RingBufferTokenManagerBase(const RingBufferTokenManagerBase&) = delete;
+    RingBufferTokenManagerBase& operator=(const RingBufferTokenManagerBase&) = delete;
+    RingBufferTokenManagerBase(RingBufferTokenManagerBase&&) = delete;
+    RingBufferTokenManagerBase& operator=(RingBufferTokenManagerBase&&) = delete;
+
+    // ******************************************************************************** 生産者側
+    /// @brief トークンを追加する。
+    /// @param token 追加するトークン。
+    /// @note 終端トークンまたはbatchSize個たまった時点で消費者へ公開する。
+    void pushToken(JsonToken&& token) {
+        if (isStopped()) {
+            return;
+        }
+        if (writeIndex_ - cachedReadIndex_ >= slots_.size() && !waitForSpace()) {
+            return;  // 空き待ち中にエラー通知または中断された。
+        }
+        const bool isEnd = token.type == JsonTokenType::EndOfStream;
+        slots_[writeIndex_ & mask_] = token;
+        ++writeIndex_;
+        if (isEnd || writeIndex_ - publishedLocal_ >= batchSize_) {
+            publish();
+        }
+    }
+
+    /// @brief トークナイザー側のエラーを通知する。
+    /// @param error 捕捉した例外。
+    /// @note 未消費のトークンは破棄され、以降のtake()/peek()は例外を再送出する。
+    void signalError(std::exception_ptr error) {
+        if (!error) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) {
+                error_ = std::move(error);
+                hasError_.store(true, std::memory_order_seq_cst);
+            }
+        }
+        condition_.notify_all();
+    }
+
+    // ******************************************************************************** 消費者側
+    /// @brief 次のトークンを取得して消費する。
+    /// @return 取得したトークン。
+    JsonToken takeNext() override {
+        waitForToken();
+        JsonToken token = slots_[readLocal_ & mask_];
+        ++readLocal_;
+        if (readLocal_ - releasedLocal_ >= batchSize_) {
+            releaseReadIndex();
+        }
+        if (token.flags & JsonToken::arenaStringFlag) {
+            lastArenaSlice_ = token.slice;
+            hasArenaSlice_ = true;
+        }
+        return token;
+    }
+
+    /// @brief 次のトークンを取得する（消費しない）。
+    /// @return 次のトークンへの参照。次にtake()するまで有効。
+    const JsonToken& peekNext() const override {
+        waitForToken();
+        return slots_[readLocal_ & mask_];
+    }
+
+    /// @brief 消費済みのトークンだけが参照する文字列アリーナのチャンクを解放する。
+    /// @note 取得済みの文字列トークンの内容は、本関数の呼び出し後は参照できなくなることがある。
+    ///       長い配列を要素毎に読み進める場合に、要素の読み込み後に呼んでメモリ使用量を一定に保つ。
+    void releaseConsumedStrings() override {
+        if (hasArenaSlice_) {
+            arena().releaseChunksBefore(lastArenaSlice_);
+        }
+    }
+
+    /// @brief 以降のトークンが不要になったことを生産者へ通知する。
+    /// @note 消費者がストリーム終端より前に読み取りを終えた場合に、空き待ちの生産者を解放する。
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_.store(true, std::memory_order_seq_cst);
+        }
+        condition_.notify_all();
+    }
+
+private:
+    /// @brief エラー通知または中断により、以降のトークンが不要かを判定する。
+    /// @return 不要ならtrue。
+    bool isStopped() const {
+        return hasError_.load(std::memory_order_acquire) ||
+               closed_.load(std::memory_order_acquire);
+    }
+
+    /// @brief 書き込み済みのトークンを消費者へ公開する。
+    void publish() {
+        publishedLocal_ = writeIndex_;
+        // 休止判定とのすれ違いを防ぐため、公開と休止フラグの確認はseq_cstで行う。
+        publishedIndex_.store(writeIndex_, std::memory_order_seq_cst);
+        if (consumerParked_.load(std::memory_order_seq_cst)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            condition_.notify_all();
+        }
+    }
+
+    /// @brief リングバッファに空きができるまで待機する。
+    /// @return 空きができればtrue。エラー通知または中断された場合はfalse。
+    bool waitForSpace() {
+        // 消費者が公開済みのトークンを読み切れるよう、未公開分を先に公開しておく。
+        publish();
+        // 休止フラグとのすれ違いを防ぐため、待機条件の読み取りもseq_cstで行う。
+        auto hasSpace = [this] {
+            cachedReadIndex_ = readIndex_.load(std::memory_order_seq_cst);
+            return writeIndex_ - cachedReadIndex_ < slots_.size() || isStopped();
+        };
+        if (!spinUntil(hasSpace)) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            producerParked_.store(true, std::memory_order_seq_cst);
+            condition_.wait(lock, hasSpace);
+            producerParked_.store(false, std::memory_order_relaxed);
+        }
+        return !isStopped();
+    }
+
+    /// @brief 消費済み位置を生産者へ通知する。
+    void releaseReadIndex() const {
+        releasedLocal_ = readLocal_;
+        readIndex_.store(readLocal_, std::memory_order_seq_cst);
+        if (producerParked_.load(std::memory_order_seq_cst)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            condition_.notify_all();
+        }
+    }
+
+    /// @brief 読み取り可能なトークンが公開されるまで待機する。
+    /// @note エラーが通知されている場合は例外を再送出する。
+    void waitForToken() const {
+        if (hasError_.load(std::memory_order_acquire)) {
+            rethrowError();
+        }
+        if (readLocal_ != cachedPublishedIndex_) {
+            return;
+        }
+        // 生産者が空き待ちしている可能性があるため、待機前に消費済み位置を通知する。
+        releaseReadIndex();
+        const std::uint64_t start = pipelineTimestamp<Instrumentation>();
+        auto hasToken = [this] {
+            cachedPublishedIndex_ = publishedIndex_.load(std::memory_order_seq_cst);
+            return readLocal_ != cachedPublishedIndex_ ||
+                   hasError_.load(std::memory_order_acquire);
+        };
+        if (!spinUntil(hasToken)) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            consumerParked_.store(true, std::memory_order_seq_cst);
+            condition_.wait(lock, hasToken);
+            consumerParked_.store(false, std::memory_order_relaxed);
+        }
+        instrumentation_.addTakeWait(pipelineTimestamp<Instrumentation>() - start);
+        if (hasError_.load(std::memory_order_acquire)) {
+            rethrowError();
+        }
+    }
+
+    /// @brief 通知されたエラーを再送出する。
+    [[noreturn]] void rethrowError() const {
+        std::exception_ptr error;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            error = error_;
+        }
+        std::rethrow_exception(error);
+    }
+
+    /// @brief 条件が満たされるまで短時間スピンする。
+    /// @param isReady 待機条件。
+    /// @return スピン中に条件が満たされればtrue。
+    template <typename Predicate>
+    static bool spinUntil(Predicate&& isReady) {
+        for (int i = 0; i < spinCount_; ++i) {
+            if (isReady()) {
+                return true;
+            }
+            pauseCpu();
+        }
+        for (int i = 0; i < yieldCount_; ++i) {
+            if (isReady()) {
+                return true;
+            }
+            std::this_thread::yield();
+        }
+        return isReady();
+    }
+
+    /// @brief スピン待機中にCPUへ待機中であることを伝える。
+    static void pauseCpu() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+        _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+    static constexpr int spinCount_ = 256;         ///< 休止前にスピンする回数。
+    static constexpr int yieldCount_ = 16;         ///< 休止前にスレッドを譲る回数。
+    static constexpr std::size_t cacheLineSize_ = 64;  ///< 偽共有を避けるための配置境界。
+
+    std::vector<JsonToken> slots_;  ///< トークン格納領域（要素数は2の冪）。
+    const std::size_t mask_;        ///< インデックスを格納位置に変換するマスク。
+    const std::size_t batchSize_;   ///< まとめて公開・解放するトークン数。
+
+    // 生産者スレッドのみが扱うメンバー
+    alignas(cacheLineSize_) std::size_t writeIndex_ = 0;   ///< 次に書き込む位置。
+    std::size_t publishedLocal_ = 0;   ///< 最後に公開した位置。
+    std::size_t cachedReadIndex_ = 0;  ///< 最後に観測した消費済み位置。
+
+    // 消費者スレッドのみが扱うメンバー（peek()はconstのためmutable）
+    alignas(cacheLineSize_) mutable std::size_t readLocal_ = 0;  ///< 次に読み取る位置。
+    mutable std::size_t releasedLocal_ = 0;         ///< 最後に生産者へ通知した消費済み位置。
+    mutable std::size_t cachedPublishedIndex_ = 0;  ///< 最後に観測した公開済み位置。
+    JsonStringSlice lastArenaSlice_{};  ///< 最後に取得した文字列アリーナ内の文字列の位置。
+    bool hasArenaSlice_ = false;        ///< 文字列アリーナ内の文字列を取得済みフラグ。
+
+    // スレッド間で共有するメンバー
+    alignas(cacheLineSize_) std::atomic<std::size_t> publishedIndex_{0};  ///< 公開済み位置。
+    alignas(cacheLineSize_) mutable std::atomic<std::size_t> readIndex_{0};  ///< 消費済み位置。
+    alignas(cacheLineSize_) mutable std::atomic<bool> consumerParked_{false};  ///< 消費者休止中。
+    std::atomic<bool> producerParked_{false};  ///< 生産者休止中フラグ。
+    std::atomic<bool> hasError_{false};        ///< エラー通知済みフラグ。
+    std::atomic<bool> closed_{false};          ///< 消費者による中断フラグ。
+    mutable std::mutex mutex_;                 ///< 休止と例外の受け渡しを保護するミューテックス。
+    mutable std::condition_variable condition_;  ///< 休止中のスレッドを起こす条件変数。
+    std::exception_ptr error_;                 ///< トークナイザーから伝播した例外。
+    [[no_unique_address]] mutable Instrumentation instrumentation_;  ///< 計測フック（消費者側のみ使う）。
+};
+
+/// @brief 計測しないリングバッファ型トークン管理クラス。
+using RingBufferTokenManager = RingBufferTokenManagerBase<>;
+
+}  // namespace rai::serialization
@@ -0,0 +1,350 @@
+// @file SimdScanner.cppm
+// @brief トークナイザー用のSIMD走査関数。実行時にCPUに合わせて実装を選択する。
+
+module;
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define RAI_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define RAI_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+// AVX2版の関数だけをAVX2向けにコンパイルする（MSVCは指定なしでAVX2命令を使える）。
+#if defined(RAI_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define RAI_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define RAI_TARGET_AVX2
+#endif
+
+export module rai.serialization.simd_scanner;
+
+export namespace rai::serialization::simd {
+
+// ******************************************************************************** 実装の種類
+/// @brief 走査関数の実装の種類。
+enum class SimdLevel {
+    Scalar,  ///< 1byteずつ判定する実装（フォールバック）
+    Sse2,    ///< SSE2（16byte単位）
+    Avx2,    ///< AVX2（32byte単位）
+    Neon     ///< NEON（16byte単位）
+};
+
+/// @brief 走査関数の組。
+/// @note いずれの関数も[data, data + size)の範囲外は読まない。
+struct ScannerTable {
+    /// @brief 文字列本体のうち、そのまま内容になるbyteの連続数を返す。
+    /// @note 終了引用符、'\\'、0xE2（U+2028/U+2029の判定用）、制御文字(<0x20)で止まる。
+    std::size_t (*stringRun)(const char* data, std::size_t size, char quote);
+    /// @brief 先頭から続く空白（' ', '\\t', '\\n', '\\r'）のbyte数を返す。
+    std::size_t (*whitespaceRun)(const char* data, std::size_t size);
+    /// @brief 単一行コメント本体のうち、改行候補（'\\n', '\\r', 0xE2, '\\0'）までのbyte数を返す。
+    std::size_t (*lineCommentRun)(const char* data, std::size_t size);
+};
+
+SimdLevel detectSimdLevel();
+const ScannerTable& scannerFor(SimdLevel level);
+
+/// @brief 実行中のCPUで使える最も速い走査関数の組を返す。
+/// @return 走査関数の組。初回呼び出し時に選択して以降は同じものを返す。
+const ScannerTable& activeScanner() {
+    static const ScannerTable& table = scannerFor(detectSimdLevel());
+    return table;
+}
+
+}  // namespace rai::serialization::simd
+
+namespace rai::serialization::simd {
+
+// ******************************************************************************** スカラー実装
+/// @brief 文字列本体で止まるbyteかを判定する。
+constexpr bool isStringStop(unsigned char c, unsigned char quote) {
+    return c == quote || c == '\\' || c == 0xE2 || c < 0x20;
+}
+
+/// @brief 空白byteかを判定する。
+constexpr bool isWhitespace(unsigned char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/// @brief 単一行コメント本体で止まるbyteかを判定する。
+constexpr bool isLineCommentStop(unsigned char c) {
+    return c == '\n' || c == '\r' || c == 0xE2 || c == '\0';
+}
+
+std::size_t stringRunScalar(const char* data, std::size_t size, char quote) {
+    std::size_t i = 0;
+    while (i < size && !isStringStop(static_cast<unsigned char>(data[i]),
+                                     static_cast<unsigned char>(quote))) {
+        ++i;
+    }
+    return i;
+}
+
+std::size_t whitespaceRunScalar(const char* data, std::size_t size) {
+    std::size_t i = 0;
+    while (i < size && isWhitespace(static_cast<unsigned char>(data[i]))) {
+        ++i;
+    }
+    return i;
+}
+
+std::size_t lineCommentRunScalar(const char* data, std::size_t size) {
+    std::size_t i = 0;
+    while (i < size && !isLineCommentStop(static_cast<unsigned char>(data[i]))) {
+        ++i;
+    }
+    return i;
+}
+
+constexpr ScannerTable scalarTable{stringRunScalar, whitespaceRunScalar, lineCommentRunScalar};
+
+// ******************************************************************************** SSE2/AVX2実装
+#if defined(RAI_SIMD_X86)
+std::size_t stringRunSse2(const char* data, std::size_t size, char quote) {
+    const __m128i quoteBytes = _mm_set1_epi8(quote);
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i separatorLead = _mm_set1_epi8(static_cast<char>(0xE2));
+    const __m128i controlMax = _mm_set1_epi8(0x1F);
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        // 符号なし比較 v <= 0x1F は min(v, 0x1F) == v で表す。
+        const __m128i stop = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, quoteBytes), _mm_cmpeq_epi8(v, backslash)),
+            _mm_or_si128(_mm_cmpeq_epi8(v, separatorLead),
+                         _mm_cmpeq_epi8(_mm_min_epu8(v, controlMax), v)));
+        const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(stop));
+        if (mask != 0) {
+            return i + static_cast<std::size_t>(std::countr_zero(mask));
+        }
+    }
+    return i + stringRunScalar(data + i, size - i, quote);
+}
+
+std::size_t whitespaceRunSse2(const char* data, std::size_t size) {
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i lineFeed = _mm_set1_epi8('\n');
+    const __m128i carriageReturn = _mm_set1_epi8('\r');
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const __m128i white = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, space), _mm_cmpeq_epi8(v, tab)),
+            _mm_or_si128(_mm_cmpeq_epi8(v, lineFeed), _mm_cmpeq_epi8(v, carriageReturn)));
+        const unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(white)) & 0xFFFFu;
+        if (mask != 0) {
+            return i + static_cast<std::size_t>(std::countr_zero(mask));
+        }
+    }
+    return i + whitespaceRunScalar(data + i, size - i);
+}
+
+std::size_t lineCommentRunSse2(const char* data, std::size_t size) {
+    const __m128i lineFeed = _mm_set1_epi8('\n');
+    const __m128i carriageReturn = _mm_set1_epi8('\r');
+    const __m128i separatorLead = _mm_set1_epi8(static_cast<char>(0xE2));
+    const __m128i zero = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const __m128i stop = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, lineFeed), _mm_cmpeq_epi8(v, carriageReturn)),
+            _mm_or_si128(_mm_cmpeq_epi8(v, separatorLead), _mm_cmpeq_epi8(v, zero)));
+        const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(stop));
+        if (mask != 0) {
+            return i + static_cast<std::size_t>(std::countr_zero(mask));
+        }
+    }
+    return i + lineCommentRunScalar(data + i, size - i);
+}
+
+RAI_TARGET_AVX2 std::size_t stringRunAvx2(const char* data, std::size_t size, char quote) {
+    const __m256i quoteBytes = _mm256_set1_epi8(quote);
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i separatorLead = _mm256_set1_epi8(static_cast<char>(0xE2));
+    const __m256i controlMax = _mm256_set1_epi8(0x1F);
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const __m256i stop = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, quoteBytes), _mm256_cmpeq_epi8(v, backslash)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, separatorLead),
+                            _mm256_cmpeq_epi8(_mm256_min_epu8(v, controlMax), v)));
+        const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(stop));
+        if (mask != 0) {
+            return i + static_cast<std::size_t>(std::countr_zero(mask));
+        }
+    }
+    return i + stringRunSse2(data + i, size - i, quote);
+}
+
+RAI_TARGET_AVX2 std::size_t whitespaceRunAvx2(const char* data, std::size_t size) {
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i lineFeed = _mm256_set1_epi8('\n');
+    const __m256i carriageReturn = _mm256_set1_epi8('\r');
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const __m256i white = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, space), _mm256_cmpeq_epi8(v, tab)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, lineFeed),
+                            _mm256_cmpeq_epi8(v, carriageReturn)));
+        const unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(white));
+        if (mask != 0) {
+            return i + static_cast<std::size_t>(std::countr_zero(mask));
+        }
+    }
+    return i + whitespaceRunSse2(data + i, size - i);
+}
+
+RAI_TARGET_AVX2 std::size_t lineCommentRunAvx2(const char* data, std::size_t size) {
+    const __m256i lineFeed = _mm256_set1_epi8('\n');
+    const __m256i carriageReturn = _mm256_set1_epi8('\r');
+    const __m256i separatorLead = _mm256_set1_epi8(static_cast<char>(0xE2));
+    const __m256i zero = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const __m256i stop = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, lineFeed),
+                            _mm256_cmpeq_epi8(v, carriageReturn)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, separatorLead), _mm256_cmpeq_epi8(v, zero)));
+        const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(stop));
+        if (mask != 0) {
+            return i + static_cast<std::size_t>(std::countr_zero(mask));
+        }
+    }
+    return i + lineCommentRunSse2(data + i, size - i);
+}
+
+constexpr ScannerTable sse2Table{stringRunSse2, whitespaceRunSse2, lineCommentRunSse2};
+constexpr ScannerTable avx2Table{stringRunAvx2, whitespaceRunAvx2, lineCommentRunAvx2};
+
+/// @brief CPUとOSがAVX2を使えるか判定する。
+bool hasAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4] = {};
+    __cpuid(info, 1);
+    const bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+    if (!osSavesYmm) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif  // RAI_SIMD_X86
+
+// ******************************************************************************** NEON実装
+#if defined(RAI_SIMD_NEON)
+/// @brief 比較結果（各byte 0x00/0xFF）を、byte毎に4bitの64bitマスクへ縮める。
+inline std::uint64_t neonMask(uint8x16_t compared) {
+    const uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(compared), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+}
+
+std::size_t stringRunNeon(const char* data, std::size_t size, char quote) {
+    const uint8x16_t quoteBytes = vdupq_n_u8(static_cast<std::uint8_t>(quote));
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+    const uint8x16_t separatorLead = vdupq_n_u8(0xE2);
+    const uint8x16_t controlMax = vdupq_n_u8(0x1F);
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const uint8x16_t v = vld1q_u8(reinterpret_cast<const std::uint8_t*>(data + i));
+        const uint8x16_t stop = vorrq_u8(
+            vorrq_u8(vceqq_u8(v, quoteBytes), vceqq_u8(v, backslash)),
+            vorrq_u8(vceqq_u8(v, separatorLead), vcleq_u8(v, controlMax)));
+        const std::uint64_t mask = neonMask(stop);
+        if (mask != 0) {
+            return i + static_cast<std::size_t>(std::countr_zero(mask) / 4);
+        }
+    }
+    return i + stringRunScalar(data + i, size - i, quote);
+}
+
+std::size_t whitespaceRunNeon(const char* data, std::size_t size) {
+    const uint8x16_t space = vdupq_n_u8(' ');
+    const uint8x16_t tab = vdupq_n_u8('\t');
+    const uint8x16_t lineFeed = vdupq_n_u8('\n');
+    const uint8x16_t carriageReturn = vdupq_n_u8('\r');
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const uint8x16_t v = vld1q_u8(reinterpret_cast<const std::uint8_t*>(data + i));
+        const uint8x16_t white = vorrq_u8(
+            vorrq_u8(vceqq_u8(v, space), vceqq_u8(v, tab)),
+            vorrq_u8(vceqq_u8(v, lineFeed), vceqq_u8(v, carriageReturn)));
+        const std::uint64_t mask = ~neonMask(white);
+        if (mask != 0) {
+            return i + static_cast<std::size_t>(std::countr_zero(mask) / 4);
+        }
+    }
+    return i + whitespaceRunScalar(data + i, size - i);
+}
+
+std::size_t lineCommentRunNeon(const char* data, std::size_t size) {
+    const uint8x16_t lineFeed = vdupq_n_u8('\n');
+    const uint8x16_t carriageReturn = vdupq_n_u8('\r');
+    const uint8x16_t separatorLead = vdupq_n_u8(0xE2);
+    const uint8x16_t zero = vdupq_n_u8(0);
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const uint8x16_t v = vld1q_u8(reinterpret_cast<const std::uint8_t*>(data + i));
+        const uint8x16_t stop = vorrq_u8(
+            vorrq_u8(vceqq_u8(v, lineFeed), vceqq_u8(v, carriageReturn)),
+            vorrq_u8(vceqq_u8(v, separatorLead), vceqq_u8(v, zero)));
+        const std::uint64_t mask = neonMask(stop);
+        if (mask != 0) {
+            return i + static_cast<std::size_t>(std::countr_zero(mask) / 4);
+        }
+    }
+    return i + lineCommentRunScalar(data + i, size - i);
+}
+
+constexpr ScannerTable neonTable{stringRunNeon, whitespaceRunNeon, lineCommentRunNeon};
+#endif  // RAI_SIMD_NEON
+
+// ******************************************************************************** 実装の選択
+/// @brief 実行中のCPUで使える最も速い実装の種類を返す。
+/// @return 実装の種類。
+SimdLevel detectSimdLevel() {
+#if defined(RAI_SIMD_X86)
+    return hasAvx2() ? SimdLevel::Avx2 : SimdLevel::Sse2;
+#elif defined(RAI_SIMD_NEON)
+    return SimdLevel::Neon;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+/// @brief 指定した種類の走査関数の組を返す。
+/// @param level 実装の種類。実行中のCPUで使えない種類の場合はスカラー実装を返す。
+/// @return 走査関数の組。
+const ScannerTable& scannerFor(SimdLevel level) {
+    switch (level) {
+#if defined(RAI_SIMD_X86)
+    case SimdLevel::Sse2:
+        return sse2Table;
+    case SimdLevel::Avx2:
+        return hasAvx2() ? avx2Table : sse2Table;
+#endif
+#if defined(RAI_SIMD_NEON)
+    case SimdLevel::Neon:
+        return neonTable;
+#endif
+    default:
+        return scalarTable;
+    }
+}
+
+}  // namespace rai::serialization::simd
@@ -3,113 +3,631 @@
 
 module;
 #include <cstddef>
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <cstring>
 #include <deque>
-#include <string>
-#include <variant>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
 #include <mutex>
+#include <span>
 #include <condition_variable>
 #include <exception>
 #include <utility>
+#include <vector>
 
 export module rai.serialization.token_manager;
 
+import rai.serialization.pipeline_instrumentation;
+
 export namespace rai::serialization {
 
-// ******************************************************************************** トークン型定義（内部実装詳細）
-namespace json_token_detail {
+// ******************************************************************************** トークン型定義
+// @brief JSONトークンの種類を表す列挙型
+enum class JsonTokenType : std::uint8_t {
+    EndOfStream,    ///< 入力ストリーム終端
+    Null,           ///< null値
+    Bool,           ///< 真偽値
+    Integer,        ///< 整数値
+    Number,         ///< 浮動小数点数値
+    String,         ///< 文字列値
+    Key,            ///< キー名
+    StartObject,    ///< オブジェクト開始
+    EndObject,      ///< オブジェクト終了
+    StartArray,     ///< 配列開始
+    EndArray        ///< 配列終了
+};
+
+/// @brief 文字列トークンの内容の位置（入力バッファまたは文字列アリーナ内）。
+struct JsonStringSlice {
+    std::uint32_t offset;  ///< 格納先の先頭からのオフセット。
+    std::uint32_t length;  ///< バイト数。
+};
 
-// @brief 入力ストリーム終端を示すタグ
-struct EndOfStreamTag {};
+/// @brief JSONトークン（種類・値・入力位置を16byteで保持するPOD）。
+/// @note 文字列はヒープ確保せず、入力バッファまたは文字列アリーナへのスライスで表す。
+///       内容はTokenSource::text()で取得する。
+struct JsonToken {
+    /// @brief 文字列が文字列アリーナ内にあることを示すフラグ。
+    static constexpr std::uint8_t arenaStringFlag = 0x01;
+    /// @brief 入力位置として保持できる最大値（超えた位置はこの値に丸める）。
+    static constexpr std::size_t maxPosition = UINT32_MAX;
 
-// @brief null値を示すタグ
-struct NullTag {};
+    JsonTokenType type;      ///< トークンの種類
+    std::uint8_t flags;      ///< 付加情報（arenaStringFlagなど）
+    std::uint16_t reserved;  ///< 未使用（配置調整）
+    std::uint32_t position;  ///< 入力ストリーム内での開始位置
+    union {
+        bool boolean;            ///< 真偽値（type == Bool）
+        std::int64_t integer;    ///< 整数値（type == Integer）
+        double number;           ///< 浮動小数点数値（type == Number）
+        JsonStringSlice slice;   ///< 文字列の位置（type == String / Key）
+        /// @brief 対応する終了トークンまでのトークン数（type == StartObject / StartArray）。
+        /// 0は未確定（JsonSubtreeIndexerが書き込むまで、または書き込まない読み出し元）。
+        std::uint64_t subtreeSize;
+    };
 
-// @brief オブジェクト開始を示すタグ
-struct StartObjectTag {};
+    /// @brief 値を持たないトークン（構造、null、終端）を生成する。
+    /// @param type トークンの種類。
+    /// @param pos 入力位置。
+    static JsonToken make(JsonTokenType type, std::size_t pos) {
+        JsonToken token{type, 0, 0, clampPosition(pos), {}};
+        token.integer = 0;
+        return token;
+    }
 
-// @brief オブジェクト終了を示すタグ
-struct EndObjectTag {};
+    /// @brief 真偽値トークンを生成する。
+    static JsonToken makeBool(bool value, std::size_t pos) {
+        JsonToken token = make(JsonTokenType::Bool, pos);
+        token.boolean = value;
+        return token;
+    }
 
-// @brief 配列開始を示すタグ
-struct StartArrayTag {};
+    /// @brief 整数値トークンを生成する。
+    static JsonToken makeInteger(std::int64_t value, std::size_t pos) {
+        JsonToken token = make(JsonTokenType::Integer, pos);
+        token.integer = value;
+        return token;
+    }
+
+    /// @brief 浮動小数点数値トークンを生成する。
+    static JsonToken makeNumber(double value, std::size_t pos) {
+        JsonToken token = make(JsonTokenType::Number, pos);
+        token.number = value;
+        return token;
+    }
 
-// @brief 配列終了を示すタグ
-struct EndArrayTag {};
+    /// @brief 文字列またはキーのトークンを生成する。
+    /// @param type JsonTokenType::StringまたはJsonTokenType::Key。
+    /// @param slice 文字列の位置。
+    /// @param inArena 文字列アリーナ内の文字列ならtrue、入力バッファ内ならfalse。
+    static JsonToken makeText(JsonTokenType type, JsonStringSlice slice, bool inArena,
+        std::size_t pos) {
+        JsonToken token = make(type, pos);
+        token.flags = inArena ? arenaStringFlag : 0;
+        token.slice = slice;
+        return token;
+    }
 
-// @brief 真偽値を保持する型
-struct BoolVal {
-    bool v{};
+    /// @brief 入力位置を保持できる範囲に丸める。
+    static std::uint32_t clampPosition(std::size_t pos) {
+        return static_cast<std::uint32_t>(std::min(pos, maxPosition));
+    }
 };
+static_assert(sizeof(JsonToken) == 16, "JsonToken must stay 16 bytes");
+static_assert(std::is_trivially_copyable_v<JsonToken>, "JsonToken must be trivially copyable");
+
+// ******************************************************************************** 構造の索引
+/// @brief 追加されるトークンの入れ子を追い、開始トークンに対応する終了トークンまでのトークン数を書き込む。
+/// @note 中身がオブジェクト（キーと値の組の並び）・配列（値の並び）の文法に合う場合だけ書き込むため、
+///       書き込まれた範囲は中身を検証せずに読み飛ばせる（JsonParser::skipValueが使う）。
+///       文法に合わないトークンが来た場合は、開いている開始トークンに書き込まない。
+class JsonSubtreeIndexer {
+public:
+    /// @brief 追加したトークンを記録する。
+    /// @param token 追加したトークン。
+    /// @param tokenAt 追加済みのトークンの通し番号から、そのトークンへのポインタを返す関数。
+    ///        既に消費されていてたどれない場合はnullptrを返す。
+    template <typename TokenAt>
+    void onPush(const JsonToken& token, TokenAt&& tokenAt) {
+        const std::uint64_t index = pushed_++;
+        if (!open_.empty() && !accept(open_.back(), token.type)) {
+            // どうしてこの実装にしたか：文法に合わない範囲は読み飛ばさず、
+            // JsonParserのトークン毎の処理でエラーを報告させる。
+            open_.clear();
+            return;
+        }
+        switch (token.type) {
+        case JsonTokenType::StartObject:
+        case JsonTokenType::StartArray:
+            open_.push_back(Frame{index, token.type == JsonTokenType::StartObject, false});
+            return;
+        case JsonTokenType::EndObject:
+        case JsonTokenType::EndArray:
+            if (!open_.empty()) {
+                const std::uint64_t start = open_.back().start;
+                open_.pop_back();
+                if (JsonToken* startToken = tokenAt(start)) {
+                    startToken->subtreeSize = index - start;
+                }
+            }
+            return;
+        default:
+            return;
+        }
+    }
+
+    /// @brief 記録を破棄して最初の状態に戻す。
+    void clear() {
+        open_.clear();
+        pushed_ = 0;
+    }
 
-// @brief 整数値を保持する型
-struct IntVal {
-    std::int64_t v{};
+private:
+    /// @brief 開いているオブジェクト・配列。
+    struct Frame {
+        std::uint64_t start;   ///< 開始トークンの通し番号。
+        bool object;           ///< オブジェクトならtrue、配列ならfalse。
+        bool expectingValue;   ///< オブジェクトでキーの直後（次は値）ならtrue。
+    };
+
+    /// @brief 開いているオブジェクト・配列の中にトークンが来てよいかを判定し、状態を進める。
+    /// @param frame 最も内側のオブジェクト・配列。
+    /// @param type 追加したトークンの種類。
+    /// @return 文法に合えばtrue。
+    static bool accept(Frame& frame, JsonTokenType type) {
+        switch (type) {
+        case JsonTokenType::Key:
+            if (!frame.object || frame.expectingValue) {
+                return false;
+            }
+            frame.expectingValue = true;
+            return true;
+        case JsonTokenType::EndObject:
+            return frame.object && !frame.expectingValue;
+        case JsonTokenType::EndArray:
+            return !frame.object;
+        case JsonTokenType::EndOfStream:
+            return false;
+        default:  // 値（開始トークンを含む）
+            if (frame.object && !frame.expectingValue) {
+                return false;
+            }
+            frame.expectingValue = false;
+            return true;
+        }
+    }
+
+    std::vector<Frame> open_;    ///< 開いているオブジェクト・配列（外側から順）。
+    std::uint64_t pushed_ = 0;   ///< これまでに追加されたトークン数。
 };
 
-// @brief 浮動小数点数値を保持する型
-struct NumVal {
-    double v{};
+// ******************************************************************************** 文字列アリーナ
+/// @brief エスケープを含む文字列など、入力バッファを直接参照できない文字列の格納先。
+/// @note 確保済みの領域は移動しないため、取得したstring_viewはアリーナ破棄まで有効。
+///       ただしreleaseChunksBefore()で解放したチャンク内の文字列は無効になる。
+/// @note 書き込みは生産者スレッドのみが行い、読み取りはトークン公開後に行うこと。
+class JsonStringArena {
+public:
+    JsonStringArena() = default;
+
+    // コピー・ムーブ禁止（string_viewが参照するため）
+    JsonStringArena(const JsonStringArena&) = delete;
+    JsonStringArena& operator=(const JsonStringArena&) = delete;
+    JsonStringArena(JsonStringArena&&) = delete;
+    JsonStringArena& operator=(JsonStringArena&&) = delete;
+
+    /// @brief 新しい文字列の書き込みを開始する。
+    void begin() {
+        if (chunkCount_ == 0 || used_ >= maxOffsetInChunk_) {
+            // 現在のチャンクでは開始位置をスライスで表せないため、新しいチャンクに移る。
+            addChunk(0);
+        }
+        stringStart_ = used_;
+    }
+
+    /// @brief 書き込み中の文字列に1文字追加する。
+    /// @param c 追加する文字。
+    void push(char c) {
+        if (used_ == capacity_) {
+            grow(1);
+        }
+        current_[used_++] = c;
+    }
+
+    /// @brief 書き込み中の文字列にバイト列を追加する。
+    /// @param data 追加するバイト列の先頭。
+    /// @param size バイト数。
+    void append(const char* data, std::size_t size) {
+        if (capacity_ - used_ < size) {
+            grow(size);
+        }
+        std::memcpy(current_ + used_, data, size);
+        used_ += size;
+    }
+
+    /// @brief 書き込み中の文字列を確定する。
+    /// @return 確定した文字列の位置。
+    JsonStringSlice finish() {
+        const std::size_t length = used_ - stringStart_;
+        if (length > UINT32_MAX) {
+            throw std::runtime_error("JSON5: string too long");
+        }
+        const std::size_t offset = (((chunkCount_ - 1) % maxChunks_) << offsetBits_) | stringStart_;
+        return JsonStringSlice{static_cast<std::uint32_t>(offset),
+            static_cast<std::uint32_t>(length)};
+    }
+
+    /// @brief 確定した文字列を取得する。
+    /// @param slice finish()で得た文字列の位置。
+    /// @return 文字列の内容。
+    std::string_view view(JsonStringSlice slice) const {
+        const char* chunk = chunks_[slice.offset >> offsetBits_].get();
+        return std::string_view(chunk + (slice.offset & maxOffsetInChunk_), slice.length);
+    }
+
+    /// @brief これまでに確保したチャンク数を返す（clear()で戻らない累計）。
+    std::size_t allocatedChunks() const { return allocatedChunks_; }
+
+    /// @brief これまでに確保したbyte数を返す（clear()で戻らない累計）。
+    std::size_t allocatedBytes() const { return allocatedBytes_; }
+
+    /// @brief 解放済みでないチャンク数を返す。
+    std::size_t liveChunks() const {
+        return chunkCount_ - releasedChunks_.load(std::memory_order_acquire);
+    }
+
+    /// @brief チャンクの標準容量の上限を設定する（書き込み前に呼ぶ）。
+    /// @param size 上限のbyte数。スライスで表せる上限（1MiB）を超える値は上限に切り詰める。
+    /// @note 上限より長い文字列は、その文字列が収まる大きさのチャンクに書き込む。
+    void setMaxChunkSize(std::size_t size) {
+        maxChunkSize_ = std::clamp<std::size_t>(size, 1, maxOffsetInChunk_ + 1);
+    }
+
+    /// @brief 指定した文字列を含むチャンクより前のチャンクを解放する（消費者側）。
+    /// @param slice 消費済みの文字列の位置。後から確定した文字列は全て、このチャンク以降にある。
+    /// @note 解放したチャンクの位置は、書き込み側が新しいチャンクに再利用する。
+    ///       書き込み側と別スレッドから呼んでよいが、呼び出すスレッドは1つに限る。
+    void releaseChunksBefore(JsonStringSlice slice) {
+        const std::size_t index = slice.offset >> offsetBits_;
+        std::size_t released = releasedChunks_.load(std::memory_order_relaxed);
+        while (released % maxChunks_ != index) {
+            chunks_[released % maxChunks_].reset();
+            releasedChunks_.store(++released, std::memory_order_release);
+        }
+    }
+
+    /// @brief 確定した文字列を全て破棄し、最後に確保したチャンクだけを残して最初から書き込めるようにする。
+    /// @note 取得済みのstring_viewとスライスは全て無効になる。読み書きが終わってから呼ぶこと。
+    void clear() {
+        if (chunkCount_ == 0) {
+            return;
+        }
+        // どうしてこの実装にしたか：同じ大きさの入力を繰り返し読む場合に確保し直さないよう、
+        // 最も大きい（最後に確保した）チャンクを先頭の位置へ移して使い続ける。
+        std::unique_ptr<char[]> last = std::move(chunks_[(chunkCount_ - 1) % maxChunks_]);
+        for (std::size_t i = releasedChunks_.load(std::memory_order_relaxed); i + 1 < chunkCount_; ++i) {
+            chunks_[i % maxChunks_].reset();
+        }
+        chunks_[0] = std::move(last);
+        chunkCount_ = 1;
+        releasedChunks_.store(0, std::memory_order_relaxed);
+        current_ = chunks_[0].get();
+        used_ = 0;
+        stringStart_ = 0;
+    }
+
+private:
+    /// @brief 書き込み中の文字列が収まるよう、より大きなチャンクへ移す。
+    /// @param additional 追加で必要なバイト数。
+    void grow(std::size_t additional) {
+        const std::size_t length = used_ - stringStart_;
+        const char* previous = current_ + stringStart_;
+        // 長い文字列で写し直しが繰り返されないよう、書き込み中の長さの2倍以上を確保する。
+        addChunk(std::max(length + additional, length * 2));
+        // 文字列は連続領域でなければならないため、書き込み途中の分を新チャンクへ写す。
+        std::memcpy(current_, previous, length);
+        stringStart_ = 0;
+        used_ = length;
+    }
+
+    /// @brief チャンクを追加して書き込み先にする。
+    /// @param required 最低限必要な容量。
+    void addChunk(std::size_t required) {
+        // どうしてこの実装にしたか：チャンクの位置は環状に使い、解放済みの位置だけを再利用する。
+        // 解放は消費者側で行われるため、解放済みの数を獲得してから再利用する。
+        if (chunkCount_ - releasedChunks_.load(std::memory_order_acquire) >= maxChunks_) {
+            throw std::runtime_error("JSON5: string arena exhausted");
+        }
+        if (!chunks_) {
+            chunks_ = std::make_unique<std::unique_ptr<char[]>[]>(maxChunks_);
+        }
+        // どうしてこの実装にしたか：小さな入力で大きな領域を確保しないよう、
+        // チャンクは倍々に大きくし、スライスで表せる上限で頭打ちにする。
+        nextChunkSize_ = std::min(nextChunkSize_ * 2, maxChunkSize_);
+        capacity_ = std::max(nextChunkSize_, required);
+        auto& chunk = chunks_[chunkCount_ % maxChunks_];
+        chunk = std::make_unique<char[]>(capacity_);
+        current_ = chunk.get();
+        ++chunkCount_;
+        ++allocatedChunks_;
+        allocatedBytes_ += capacity_;
+        used_ = 0;
+    }
+
+    static constexpr std::size_t offsetBits_ = 20;  ///< オフセットのうちチャンク内位置のビット数。
+    static constexpr std::size_t maxOffsetInChunk_ = (std::size_t{1} << offsetBits_) - 1;
+    static constexpr std::size_t maxChunks_ = std::size_t{1} << (32 - offsetBits_);
+
+    /// @brief チャンク表。要素数はmaxChunks_で固定し、消費者の読み取り中に再配置しない。
+    std::unique_ptr<std::unique_ptr<char[]>[]> chunks_;
+    std::size_t chunkCount_ = 0;      ///< これまでに確保したチャンク数。
+    std::atomic<std::size_t> releasedChunks_{0};  ///< 先頭から解放したチャンク数（消費者側が更新）。
+    std::size_t nextChunkSize_ = 2048;  ///< 直前に確保したチャンクの標準容量。
+    std::size_t maxChunkSize_ = maxOffsetInChunk_ + 1;  ///< チャンクの標準容量の上限。
+    char* current_ = nullptr;         ///< 書き込み中のチャンク。
+    std::size_t capacity_ = 0;        ///< 書き込み中のチャンクの容量。
+    std::size_t used_ = 0;            ///< 書き込み中のチャンクの使用量。
+    std::size_t stringStart_ = 0;     ///< 書き込み中の文字列の開始位置。
+    std::size_t allocatedChunks_ = 0; ///< これまでに確保したチャンク数。
+    std::size_t allocatedBytes_ = 0;  ///< これまでに確保したbyte数。
 };
 
-// @brief キー名を保持する型
-struct KeyVal {
-    std::string v;
+// ******************************************************************************** トークン読み出し元
+/// @brief JsonParserがトークンを読み出す元の基底クラス。
+/// @note トークン管理クラスの実装（deque版、リングバッファ版など）を差し替え可能にする。
+/// @note 文字列トークンの内容（入力バッファと文字列アリーナ）もここから解決する。
+/// @note どうしてこの実装にしたか：take()/peek()はトークン毎に呼ばれるため、仮想呼び出しにすると
+///       逐次読み込みでも全トークンに間接呼び出しが掛かる。連続した配列にトークンを持つ読み出し元は
+///       読み出し可能な範囲（窓）を基底に設定し、窓の中はインラインで読み出す。
+///       窓を使い切ったときと、窓を持たない読み出し元だけがtakeNext()などの仮想関数を呼ぶ。
+class TokenSource {
+public:
+    virtual ~TokenSource() = default;
+
+    /// @brief 次のトークンを取得して消費する。
+    /// @return 取得したトークン。
+    JsonToken take() {
+        if (cursor_ != limit_) [[likely]] {
+            return *cursor_++;
+        }
+        return takeNext();
+    }
+
+    /// @brief 次のトークンを取得する（消費しない）。
+    /// @return 次のトークンへの参照。次にtake()するまで有効。
+    const JsonToken& peek() const {
+        if (cursor_ != limit_) [[likely]] {
+            return *cursor_;
+        }
+        return peekNext();
+    }
+
+    /// @brief 取得済みの開始トークンに続く、対応する終了トークンまでを消費する。
+    /// @param count 取得した開始トークンのsubtreeSize（終了トークンを含む消費数）。
+    void skipTokens(std::uint64_t count) {
+        if (count <= static_cast<std::uint64_t>(limit_ - cursor_)) {
+            cursor_ += count;
+            return;
+        }
+        skipNext(count);
+    }
+
+    /// @brief 取得済みの文字列より前の、文字列アリーナのチャンクを解放する。
+    /// @note 取得済みのトークンが参照するアリーナ内の文字列のビューは無効になる。
+    ///       パーサーは値1つの読み込みを終え、キーのビューを持たない位置でだけ呼ぶ。
+    ///       トークン毎にアリーナを使わない読み出し元では何もしない。
+    virtual void releaseConsumedStrings() {}
+
+    /// @brief 文字列トークンの内容を取得する。
+    /// @param token JsonTokenType::StringまたはJsonTokenType::Keyのトークン。
+    /// @return 文字列の内容。入力バッファと本オブジェクトが存在する間有効。
+    std::string_view text(const JsonToken& token) const {
+        if (token.flags & JsonToken::arenaStringFlag) {
+            return strings_->view(token.slice);
+        }
+        return std::string_view(inputData_ + token.slice.offset, token.slice.length);
+    }
+
+    /// @brief 別の読み出し元が読んだトークンの文字列内容を、本オブジェクトからも解決できるようにする。
+    /// @param other 入力バッファと文字列アリーナを共有する読み出し元。本オブジェクトより長く存在すること。
+    /// @note 確定済みの文字列の読み取りのみ行うため、複数スレッドから共有してよい。
+    void shareTextFrom(const TokenSource& other) {
+        inputData_ = other.inputData_;
+        strings_ = other.strings_;
+    }
+
+    /// @brief 入力バッファの先頭を設定する（トークナイザーが最初のトークン追加前に呼ぶ）。
+    /// @param data 入力バッファの先頭。位置0の文字を指すこと。
+    void setInputData(const char* data) { inputData_ = data; }
+
+    /// @brief 文字列アリーナを取得する（トークナイザー用）。
+    JsonStringArena& arena() { return arena_; }
+
+protected:
+    /// @brief 窓の外で、次のトークンを取得して消費する。
+    virtual JsonToken takeNext() = 0;
+
+    /// @brief 窓の外で、次のトークンを取得する（消費しない）。
+    virtual const JsonToken& peekNext() const = 0;
+
+    /// @brief 窓に収まらない数のトークンを消費する。
+    /// @param count 取得した開始トークンのsubtreeSize。
+    /// @note subtreeSizeを書き込む読み出し元は、一括で読み進めるよう上書きする。
+    virtual void skipNext(std::uint64_t count) {
+        for (std::uint64_t i = 0; i < count; ++i) {
+            take();
+        }
+    }
+
+    /// @brief インラインで読み出すトークンの範囲を設定する。
+    /// @param begin 次に読み出すトークン。
+    /// @param end 範囲の末尾。終端トークンは含めず、窓の外で返す。
+    /// @note 範囲のトークンは、窓を設定し直すまで移動・解放しないこと。
+    void setWindow(const JsonToken* begin, const JsonToken* end) {
+        cursor_ = begin;
+        limit_ = end;
+    }
+
+    /// @brief 窓の中で次に読み出すトークン。窓を設定していなければnullptr。
+    const JsonToken* windowCursor() const { return cursor_; }
+
+    /// @brief 窓の末尾。
+    const JsonToken* windowEnd() const { return limit_; }
+
+private:
+    const JsonToken* cursor_ = nullptr;  ///< 窓の中で次に読み出すトークン
+    const JsonToken* limit_ = nullptr;   ///< 窓の末尾
+    const char* inputData_ = nullptr;  ///< 入力バッファの先頭（スライス解決用）
+    JsonStringArena arena_;            ///< 入力バッファを参照できない文字列の格納先
+    const JsonStringArena* strings_ = &arena_;  ///< スライス解決に使う文字列アリーナ
 };
 
-// @brief 文字列値を保持する型（キーとは区別）
-using StrVal = std::string;
+// ******************************************************************************** トークン列の範囲の読み出し元
+/// @brief 集めたトークン列の一部を読み出すトークン読み出し元。
+/// @note 配列の要素を区間に分けて並列に読み込むため、区間毎にJsonParserを構築するのに使う。
+///       範囲の末尾以降は終端トークンを返す。
+class TokenRangeSource final : public TokenSource {
+public:
+    /// @brief 読み出す範囲と、文字列内容を解決する読み出し元を指定して構築する。
+    /// @param tokens 読み出すトークン列。本オブジェクトより長く存在すること。
+    /// @param textSource トークンを読んだ元の読み出し元（文字列内容の解決に使う）。
+    TokenRangeSource(std::span<const JsonToken> tokens, const TokenSource& textSource) {
+        shareTextFrom(textSource);
+        const std::size_t endPosition = tokens.empty() ? 0 : tokens.back().position;
+        endToken_ = JsonToken::make(JsonTokenType::EndOfStream, endPosition);
+        setWindow(tokens.data(), tokens.data() + tokens.size());
+    }
 
-}  // namespace json_token_detail
+    /// @brief 範囲のトークンを全て読み出したかを返す。
+    /// @return 読み出し済みならtrue。
+    bool atEnd() const {
+        return windowCursor() == windowEnd();
+    }
 
-// @brief JSONトークンの種類を表す列挙型
-enum class JsonTokenType {
-    EndOfStream,    ///< 入力ストリーム終端
-    Null,           ///< null値
-    Bool,           ///< 真偽値
-    Integer,        ///< 整数値
-    Number,         ///< 浮動小数点数値
-    String,         ///< 文字列値
-    Key,            ///< キー名
-    StartObject,    ///< オブジェクト開始
-    EndObject,      ///< オブジェクト終了
-    StartArray,     ///< 配列開始
-    EndArray        ///< 配列終了
+protected:
+    /// @brief 範囲の末尾以降は終端トークンを返す（範囲内は窓から読み出す）。
+    JsonToken takeNext() override {
+        return endToken_;
+    }
+
+    /// @brief 範囲の末尾以降は終端トークンを返す。
+    const JsonToken& peekNext() const override {
+        return endToken_;
+    }
+
+    /// @brief 範囲の末尾まで読み進める。
+    void skipNext(std::uint64_t) override {
+        setWindow(windowEnd(), windowEnd());
+    }
+
+private:
+    JsonToken endToken_{};               ///< 範囲の末尾以降に返す終端トークン
 };
 
-// @brief JSONトークンのvariant表現
-// @note 内部実装の詳細型はjson_token_detail名前空間に隠蔽されている
-using JsonTokenValue =
-    std::variant<json_token_detail::EndOfStreamTag, json_token_detail::NullTag,
-                 json_token_detail::BoolVal, json_token_detail::IntVal, json_token_detail::NumVal,
-                 json_token_detail::StrVal, json_token_detail::KeyVal,
-                 json_token_detail::StartObjectTag, json_token_detail::EndObjectTag,
-                 json_token_detail::StartArrayTag, json_token_detail::EndArrayTag>;
+// ******************************************************************************** 再利用できるトークン列
+/// @brief 全てトークン化してから読み出す、再利用できるトークン列。
+/// @note ロックせずに配列へ追加・読み出しするため、トークン化を終えてから同じスレッドで読み出すこと。
+///       clear()は確保済みの配列と文字列アリーナを残すため、小さな入力を繰り返し読む場合に確保が起きない。
+class TokenBuffer final : public TokenSource {
+public:
+    TokenBuffer() = default;
 
-// @brief JSONトークン（値と入力位置を保持）
-struct JsonToken {
-    JsonTokenValue value{};    ///< トークンの種類と値
-    std::size_t position{};    ///< 入力ストリーム内での開始位置
+    // コピー・ムーブ禁止（文字列アリーナを保持するため）
+    TokenBuffer(const TokenBuffer&) = delete;
+    TokenBuffer& operator=(const TokenBuffer&) = delete;
+    TokenBuffer(TokenBuffer&&) = delete;
+    TokenBuffer& operator=(TokenBuffer&&) = delete;
+
+    /// @brief トークンを追加する。
+    /// @param token 追加するトークン。
+    void pushToken(JsonToken&& token) {
+        if (windowCursor() != nullptr) [[unlikely]] {
+            // 追加で配列が再配置されるため、窓を閉じてから追加する。
+            next_ = position();
+            setWindow(nullptr, nullptr);
+        }
+        tokens_.push_back(token);
+        indexer_.onPush(tokens_.back(), [&](std::uint64_t index) { return &tokens_[index]; });
+    }
+
+    /// @brief トークン列と文字列アリーナを空にする（確保済みの領域は残す）。
+    void clear() {
+        tokens_.clear();
+        next_ = 0;
+        setWindow(nullptr, nullptr);
+        indexer_.clear();
+        arena().clear();
+    }
+
+protected:
+    /// @brief 次のトークンを取得して消費し、残りのトークンを窓に設定する。
+    /// @return 取得したトークン。終端トークンは読み進めず、以降も終端を返し続ける。
+    JsonToken takeNext() override {
+        std::size_t next = position();
+        const JsonToken token = tokens_[next];
+        if (token.type != JsonTokenType::EndOfStream) {
+            ++next;
+        }
+        openWindow(next);
+        return token;
+    }
 
-    JsonToken() = default;
-    JsonToken(const JsonToken&) = default;
-    JsonToken(JsonToken&&) = default;
-    JsonToken& operator=(const JsonToken&) = default;
-    JsonToken& operator=(JsonToken&&) = default;
+    /// @brief 次のトークンを取得する（消費しない）。
+    /// @return 次のトークンへの参照。
+    const JsonToken& peekNext() const override {
+        return tokens_[position()];
+    }
 
-    JsonToken(JsonTokenValue v, std::size_t pos)
-        : value(std::move(v)), position(pos) {}
+    /// @brief 取得済みの開始トークンに続く、対応する終了トークンまでを消費する。
+    /// @param count 取得した開始トークンのsubtreeSize。
+    void skipNext(std::uint64_t count) override {
+        openWindow(position() + count);
+    }
 
-    template <typename T>
-    JsonToken(T&& v, std::size_t pos)
-        : value(std::forward<T>(v)), position(pos) {}
+private:
+    /// @brief 次に読み出すトークンの位置を返す。
+    std::size_t position() const {
+        return windowCursor() != nullptr ? static_cast<std::size_t>(windowCursor() - tokens_.data()) : next_;
+    }
+
+    /// @brief 指定位置から終端トークンの手前までを窓に設定する。
+    /// @param next 次に読み出すトークンの位置。
+    void openWindow(std::size_t next) {
+        next_ = next;
+        const std::size_t end = tokens_.empty() ? 0 : tokens_.size() - 1;
+        if (next < end) {
+            setWindow(tokens_.data() + next, tokens_.data() + end);
+        } else {
+            setWindow(nullptr, nullptr);
+        }
+    }
+
+private:
+    std::vector<JsonToken> tokens_;  ///< トークン列（末尾はEndOfStream）
+    std::size_t next_ = 0;           ///< 窓を設定していないときに次に読み出すトークンの位置
+    JsonSubtreeIndexer indexer_;     ///< 開始トークンへsubtreeSizeを書き込む索引
 };
 
 // ******************************************************************************** デフォルトのトークン管理クラス
+static_assert(JsonPipelineCounters::tokenTypeCount == static_cast<std::size_t>(JsonTokenType::EndArray) + 1,
+    "JsonPipelineCounters::tokenCounts must cover every JsonTokenType");
+
 // @brief dequeを使用したトークン管理クラス
+// @tparam Instrumentation 計測フックの型。トークンの到着を待った時間を記録する。
 // @note 先頭要素のpopがO(1)で効率的
-class TokenManager {
+template <PipelineInstrumentation Instrumentation = NoPipelineInstrumentation>
+class TokenManagerBase final : public TokenSource {
 public:
+    TokenManagerBase() = default;
+
+    // @brief 計測フックを指定して構築する
+    // @param instrumentation 計測フック
+    explicit TokenManagerBase(Instrumentation instrumentation) : instrumentation_(instrumentation) {}
+
     // @brief トークンを追加
     // @param token 追加するトークン
     void pushToken(JsonToken&& token) {
@@ -119,6 +637,9 @@ public:
                 return;
             }
             tokens_.push_back(std::move(token));
+            indexer_.onPush(tokens_.back(), [&](std::uint64_t index) {
+                return index >= popped_ ? &tokens_[index - popped_] : nullptr;
+            });
         }
         condition_.notify_one();
     }
@@ -126,29 +647,54 @@ public:
     // @brief 次のトークンを取得して消費
     // @return 取得したトークン
     // @note generateAllTokens()で必ずEndOfStreamTagが追加されるため、tokens_は常に空でない
-    JsonToken take() {
+    JsonToken takeNext() override {
         std::unique_lock<std::mutex> lock(mutex_);
-        condition_.wait(lock, [&] { return !tokens_.empty() || error_; });
+        waitForToken(lock);
         if (error_ && tokens_.empty()) {
             std::rethrow_exception(error_);
         }
         JsonToken t = std::move(tokens_.front());
         tokens_.pop_front();
+        ++popped_;
+        if (t.flags & JsonToken::arenaStringFlag) {
+            lastArenaSlice_ = t.slice;
+            hasArenaSlice_ = true;
+        }
         return t;
     }
 
+    /// @brief 取得済みの開始トークンに続く、対応する終了トークンまでを一括で消費する。
+    /// @param count 取得した開始トークンのsubtreeSize。
+    /// @note subtreeSizeは終了トークンの追加時に書き込まれるため、範囲は全て追加済み。
+    void skipNext(std::uint64_t count) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (error_) {
+            return;
+        }
+        tokens_.erase(tokens_.begin(), tokens_.begin() + static_cast<std::ptrdiff_t>(count));
+        popped_ += count;
+    }
+
     // @brief 次のトークンを取得（消費しない）
     // @return 次のトークン
     // @note generateAllTokens()で必ずEndOfStreamTagが追加されるため、tokens_は常に空でない
-    const JsonToken& peek() const {
+    const JsonToken& peekNext() const override {
         std::unique_lock<std::mutex> lock(mutex_);
-        condition_.wait(lock, [&] { return !tokens_.empty() || error_; });
+        waitForToken(lock);
         if (error_ && tokens_.empty()) {
             std::rethrow_exception(error_);
         }
         return tokens_.front();
     }
 
+    /// @brief 取得済みの文字列より前の、文字列アリーナのチャンクを解放する。
+    /// @note トークナイザーと並行に読む場合、解放したチャンクの位置はトークナイザーが再利用する。
+    void releaseConsumedStrings() override {
+        if (hasArenaSlice_) {
+            arena().releaseChunksBefore(lastArenaSlice_);
+        }
+    }
+
     /// @brief トークナイザー側のエラーを通知する。
     /// @param error 捕捉した例外。
     /// @note パーサー側の待機を解除して例外を再送出させるために使用する。
@@ -167,10 +713,33 @@ public:
     }
 
 private:
+    // @brief トークンの到着またはエラーの通知を待つ
+    // @param lock 取得済みのロック
+    void waitForToken(std::unique_lock<std::mutex>& lock) const {
+        auto ready = [&] { return !tokens_.empty() || error_; };
+        if constexpr (Instrumentation::enabled) {
+            if (!ready()) {
+                const std::uint64_t start = pipelineTimestamp<Instrumentation>();
+                condition_.wait(lock, ready);
+                instrumentation_.addTakeWait(pipelineTimestamp<Instrumentation>() - start);
+                return;
+            }
+        }
+        condition_.wait(lock, ready);
+    }
+
     mutable std::mutex mutex_;  ///< トークン列を保護するミューテックス
     mutable std::condition_variable condition_;  ///< トークン到着待ち用の条件変数
     std::exception_ptr error_;  ///< トークナイザーから伝播した例外
     std::deque<JsonToken> tokens_;  ///< トークン列（dequeで先頭popをO(1)に）
+    std::uint64_t popped_ = 0;      ///< 先頭から消費したトークン数
+    JsonSubtreeIndexer indexer_;    ///< 開始トークンへsubtreeSizeを書き込む索引
+    JsonStringSlice lastArenaSlice_{};  ///< 最後に取得した文字列アリーナ内の文字列の位置（消費者側）
+    bool hasArenaSlice_ = false;        ///< 文字列アリーナ内の文字列を取得済みフラグ（消費者側）
+    [[no_unique_address]] mutable Instrumentation instrumentation_;  ///< 計測フック（peek()からも記録する）
 };
 
+/// @brief 計測しないトークン管理クラス。
+using TokenManager = TokenManagerBase<>;
+
 }  // namespace rai::serialization
@@ -0,0 +1,217 @@
+import rai.serialization.async_file_input_source;
+import rai.serialization.field_serializer;
+import rai.serialization.object_converter;
+import rai.serialization.object_serializer;
+import rai.serialization.json_io;
+import rai.common.thread_pool;
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace rai::serialization;
+
+namespace {
+
+/// @brief 位置に応じて内容が変わる入力を生成する補助関数。
+std::string makeFileContent(std::size_t size) {
+    std::string input(size, '\0');
+    for (std::size_t i = 0; i < size; ++i) {
+        input[i] = static_cast<char>('!' + (i * 7 + i / 13) % 90);
+    }
+    return input;
+}
+
+/// @brief 内容をファイルへ書き出す補助関数。
+void writeFile(const std::string& filename, const std::string& content) {
+    std::ofstream ofs(filename, std::ios::binary | std::ios::trunc);
+    ofs << content;
+}
+
+/// @brief 入力ソースを読み進め、先読みも含めて元の入力と一致することを確かめる補助関数。
+void expectSameContent(AsyncFileInputSource& source, const std::string& input) {
+    for (std::size_t i = 0; i < input.size(); ++i) {
+        ASSERT_EQ(source.position(), i);
+        for (std::size_t offset = 0; offset < AsyncFileInputSource::maxReadingAhead; ++offset) {
+            const char expected = i + offset < input.size() ? input[i + offset] : '\0';
+            ASSERT_EQ(source.peekAhead(offset), expected) << i << "+" << offset;
+        }
+        source.consume();
+    }
+    EXPECT_EQ(source.peekAhead(0), '\0');
+    source.consume(3);
+    EXPECT_EQ(source.peekAhead(7), '\0');
+}
+
+/// @brief 一括読み込みの確認に使うテスト用構造体。
+struct BatchConfig {
+    int id = 0;
+    std::string name;
+
+    const ObjectSerializer& serializer() const {
+        static const auto fields = getFieldSet(
+            getRequiredField(&BatchConfig::id, "id"),
+            getRequiredField(&BatchConfig::name, "name")
+        );
+        return fields;
+    }
+};
+
+}  // namespace
+
+// ********************************************************************************
+// テストカテゴリ：AsyncFileInputSource
+// ********************************************************************************
+
+/// @brief 読み込み方法・O_DIRECT・バッファの構成に関わらず、ファイルを同じ内容で読めることのテスト。
+TEST(AsyncFileInputSourceTest, ReadsSameContentForAnyConfiguration) {
+    const std::string filename = "test_async_input.bin";
+    for (std::size_t size : std::vector<std::size_t>{0, 1, 8, 9, 17, 4095, 4096, 4097, 20000}) {
+        const std::string input = makeFileContent(size);
+        writeFile(filename, input);
+        for (bool useIoUring : {true, false}) {
+            for (bool directIo : {false, true}) {
+                for (std::size_t chunkSize : {9u, 16u, 4096u}) {
+                    for (std::size_t queueDepth : {2u, 3u, 8u}) {
+                        AsyncFileInputSource source(filename,
+                            AsyncFileInputOptions{chunkSize, queueDepth, directIo, useIoUring});
+                        SCOPED_TRACE(std::to_string(size) + "/" + std::to_string(chunkSize) + "/" +
+                            std::to_string(queueDepth) + (directIo ? "/direct" : "") +
+                            (source.backend() == AsyncFileBackend::IoUring ? "/io_uring" : "/pread"));
+                        EXPECT_EQ(source.fileSize(), size);
+                        if (!useIoUring) {
+                            EXPECT_EQ(source.backend(), AsyncFileBackend::Pread);
+                        }
+                        expectSameContent(source, input);
+                    }
+                }
+            }
+        }
+    }
+    std::remove(filename.c_str());
+}
+
+/// @brief 途中で破棄しても発行済みの読み込みを回収でき、不正な設定や存在しないファイルは例外になることのテスト。
+TEST(AsyncFileInputSourceTest, DestroysMidStreamAndRejectsInvalidInput) {
+    const std::string filename = "test_async_input_partial.bin";
+    const std::string input = makeFileContent(100000);
+    writeFile(filename, input);
+    for (std::size_t i = 0; i < 10; ++i) {
+        AsyncFileInputSource source(filename, AsyncFileInputOptions{1024, 6, false, true});
+        source.consume(i * 4999);
+        EXPECT_EQ(source.peekAhead(0), input[i * 4999]);
+    }
+    EXPECT_THROW(AsyncFileInputSource(filename, AsyncFileInputOptions{8, 4, false, true}),
+        std::invalid_argument);
+    EXPECT_THROW(AsyncFileInputSource(filename, AsyncFileInputOptions{64, 1, false, true}),
+        std::invalid_argument);
+    EXPECT_THROW(AsyncFileInputSource("no_such_async_input.bin"), std::runtime_error);
+    std::remove(filename.c_str());
+}
+
+// ********************************************************************************
+// テストカテゴリ：readJsonFileAsync / readJsonFiles
+// ********************************************************************************
+
+/// @brief 非同期読み込み版と一括読み込みで、全てのファイルの内容を読めることのテスト。
+TEST(AsyncFileInputSourceTest, ReadsFileAsyncAndInBatch) {
+    std::vector<std::filesystem::path> paths;
+    for (int i = 0; i < 12; ++i) {
+        const std::string filename = "test_batch_" + std::to_string(i) + ".json";
+        writeFile(filename, "{id:" + std::to_string(i) + ",name:\"config" + std::to_string(i) +
+            "\",extra:" + std::string(i * 1000, ' ') + "1}");
+        paths.emplace_back(filename);
+    }
+
+    BatchConfig single;
+    std::vector<std::string> unknownKeys;
+    readJsonFileAsync(paths[11].string(), single, unknownKeys,
+        AsyncFileInputOptions{512, 4, false, true});
+    EXPECT_EQ(single.id, 11);
+    EXPECT_EQ(single.name, "config11");
+    ASSERT_EQ(unknownKeys.size(), 1u);
+    EXPECT_EQ(unknownKeys[0], "extra");
+
+    rai::common::ThreadPool pool(3);
+    for (rai::common::Executor* executor :
+        {static_cast<rai::common::Executor*>(&pool),
+         static_cast<rai::common::Executor*>(&rai::common::getInlineExecutor())}) {
+        std::vector<BatchConfig> configs(paths.size());
+        std::vector<std::vector<std::string>> unknownKeysPerFile;
+        readJsonFiles(paths, std::span(configs), unknownKeysPerFile, *executor);
+        ASSERT_EQ(unknownKeysPerFile.size(), paths.size());
+        for (std::size_t i = 0; i < configs.size(); ++i) {
+            EXPECT_EQ(configs[i].id, static_cast<int>(i));
+            EXPECT_EQ(configs[i].name, "config" + std::to_string(i));
+            EXPECT_EQ(unknownKeysPerFile[i].size(), 1u);
+        }
+    }
+
+    // 失敗したファイルがあっても、他のファイルは読み込まれてから例外が送出される。
+    std::vector<std::filesystem::path> withMissing = paths;
+    withMissing[5] = "no_such_batch.json";
+    std::vector<BatchConfig> configs(withMissing.size());
+    EXPECT_THROW(readJsonFiles(withMissing, std::span(configs), pool), std::runtime_error);
+    EXPECT_EQ(configs[4].id, 4);
+    EXPECT_EQ(configs[6].id, 6);
+    std::vector<BatchConfig> tooFew(2);
+    EXPECT_THROW(readJsonFiles(paths, std::span(tooFew)), std::invalid_argument);
+
+    for (const auto& path : paths) {
+        std::filesystem::remove(path);
+    }
+}
+
+/// @brief スレッド数と先に開く窓より多い大ファイルを、非同期読み込みで一括して読めることのテスト。
+/// @note 並列版の閾値（既定では10KB）を超えるファイルでも、タスク同士が待ち合って止まらない。
+///       区間を小さくして、1つのファイルで複数の読み込みを発行させる。
+TEST(AsyncFileInputSourceTest, ReadsLargeFilesInBatchWithFewThreads) {
+    std::vector<std::filesystem::path> paths;
+    for (int i = 0; i < 20; ++i) {
+        const std::string filename = "test_batch_large_" + std::to_string(i) + ".json";
+        std::string extra;
+        for (int j = 0; j < 5000; ++j) {
+            extra += (j == 0 ? "" : ",") + std::to_string(j);
+        }
+        writeFile(filename, "{id:" + std::to_string(i) + ",name:\"large" + std::to_string(i) +
+            "\",extra:[" + extra + "]}");
+        ASSERT_GT(std::filesystem::file_size(filename), getJsonFileReadPolicy().smallFileThreshold);
+        paths.emplace_back(filename);
+    }
+
+    rai::common::ThreadPool pool1(1);
+    rai::common::ThreadPool pool2(2);
+    for (rai::common::Executor* executor :
+        {static_cast<rai::common::Executor*>(&pool1), static_cast<rai::common::Executor*>(&pool2),
+         static_cast<rai::common::Executor*>(&rai::common::getInlineExecutor())}) {
+        for (bool useIoUring : {true, false}) {
+            SCOPED_TRACE(std::to_string(executor->getThreadCount()) + (useIoUring ? "/io_uring" : "/pread"));
+            std::vector<BatchConfig> configs(paths.size());
+            std::vector<std::vector<std::string>> unknownKeysPerFile;
+            readJsonFiles(paths, std::span(configs), unknownKeysPerFile,
+                AsyncFileInputOptions{4096, 3, false, useIoUring}, *executor);
+            for (std::size_t i = 0; i < configs.size(); ++i) {
+                EXPECT_EQ(configs[i].id, static_cast<int>(i));
+                EXPECT_EQ(configs[i].name, "large" + std::to_string(i));
+                ASSERT_EQ(unknownKeysPerFile[i].size(), 1u);
+                EXPECT_EQ(unknownKeysPerFile[i][0], "extra");
+            }
+        }
+    }
+
+    // 窓の外にある失敗したファイルも、ファイルの順で報告される。
+    std::vector<std::filesystem::path> withMissing = paths;
+    withMissing[15] = "no_such_batch_large.json";
+    std::vector<BatchConfig> configs(withMissing.size());
+    EXPECT_THROW(readJsonFiles(withMissing, std::span(configs), pool2), std::runtime_error);
+    EXPECT_EQ(configs[14].id, 14);
+    EXPECT_EQ(configs[19].id, 19);
+
+    for (const auto& path : paths) {
+        std::filesystem::remove(path);
+    }
+}
@@ -0,0 +1,88 @@
+import rai.serialization.field_serializer;
+import rai.serialization.object_converter;
+import rai.serialization.object_serializer;
+import rai.serialization.json_io;
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace rai::serialization;
+
+namespace {
+
+/// @brief フィールド探索の確認に使うテスト用構造体。
+/// @tparam OrderedProbe 宣言順のキーを先に比較する探索を使うか。
+template <bool OrderedProbe>
+struct LookupRecord {
+    int first = 0;
+    int second = 0;
+    int third = 0;
+    std::string fourth = "initial";
+
+    const ObjectSerializer& serializer() const {
+        static const auto fields = [] {
+            auto f = getFieldSet(
+                getRequiredField(&LookupRecord::first, "first"),
+                getDefaultOmittedField(&LookupRecord::second, "second", -2),
+                getRequiredField(&LookupRecord::third, "third"),
+                getInitialOmittedField(&LookupRecord::fourth, "fourth")
+            );
+            f.setOrderedProbe(OrderedProbe);
+            return f;
+        }();
+        return fields;
+    }
+};
+
+/// @brief 両方の探索方法で同じ結果になることを確かめる補助関数。
+/// @param json 入力JSON。
+/// @param first,second,third,fourth 期待する各フィールドの値。
+/// @param unknownKeyCount 期待する未知キーの数。
+void expectBothLookups(const std::string& json, int first, int second, int third,
+    const std::string& fourth, std::size_t unknownKeyCount = 0) {
+    std::vector<std::string> probeUnknownKeys;
+    LookupRecord<true> probe;
+    readJsonString(json, probe, probeUnknownKeys);
+    EXPECT_EQ(probe.first, first) << json;
+    EXPECT_EQ(probe.second, second) << json;
+    EXPECT_EQ(probe.third, third) << json;
+    EXPECT_EQ(probe.fourth, fourth) << json;
+    EXPECT_EQ(probeUnknownKeys.size(), unknownKeyCount) << json;
+
+    std::vector<std::string> hashUnknownKeys;
+    LookupRecord<false> hash;
+    readJsonString(json, hash, hashUnknownKeys);
+    EXPECT_EQ(hash.first, first) << json;
+    EXPECT_EQ(hash.second, second) << json;
+    EXPECT_EQ(hash.third, third) << json;
+    EXPECT_EQ(hash.fourth, fourth) << json;
+    EXPECT_EQ(hashUnknownKeys, probeUnknownKeys) << json;
+}
+
+}  // namespace
+
+// ********************************************************************************
+// テストカテゴリ：フィールド探索
+// ********************************************************************************
+
+/// @brief キーが宣言順・入れ替え・省略・未知キー混在のいずれでも同じ結果になることのテスト。
+TEST(FieldLookupTest, OrderedProbeMatchesHashLookup) {
+    expectBothLookups(R"({first:1,second:2,third:3,fourth:"4"})", 1, 2, 3, "4");
+    expectBothLookups(R"({fourth:"4",third:3,second:2,first:1})", 1, 2, 3, "4");
+    expectBothLookups(R"({second:2,first:1,fourth:"4",third:3})", 1, 2, 3, "4");
+    // 省略されたフィールドの後も宣言順の比較を続ける。
+    expectBothLookups(R"({first:1,third:3})", 1, -2, 3, "initial");
+    expectBothLookups(R"({first:1,extra:9,third:3,fourth:"4"})", 1, -2, 3, "4", 1);
+}
+
+/// @brief 宣言順の比較で一致した場合も、重複キーと必須フィールドの欠落を検出することのテスト。
+TEST(FieldLookupTest, OrderedProbeKeepsValidation) {
+    LookupRecord<true> duplicated;
+    EXPECT_THROW(readJsonString(R"({first:1,first:2,third:3})", duplicated), std::runtime_error);
+    LookupRecord<true> repeatedAfterWrap;
+    EXPECT_THROW(readJsonString(R"({first:1,second:2,third:3,first:4})", repeatedAfterWrap),
+        std::runtime_error);
+    LookupRecord<true> missingRequired;
+    EXPECT_THROW(readJsonString(R"({first:1,second:2})", missingRequired), std::runtime_error);
+}
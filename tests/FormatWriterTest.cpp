@@ -0,0 +1,198 @@
+import rai.serialization.format_io;
+import rai.serialization.field_serializer;
+import rai.serialization.object_converter;
+import rai.serialization.object_serializer;
+import rai.serialization.polymorphic_converter;
+import rai.serialization.json_io;
+import rai.serialization.json_writer;
+import rai.serialization.json_parser;
+import rai.serialization.rai_binary_io;
+import rai.collection.sorted_hash_array_map;
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace rai::serialization;
+
+namespace {
+
+/// @brief 書き込み呼び出しを簡易な文字列として記録する書き込み型。
+struct FwRecordingWriter {
+    std::string log;
+
+    void startObject() { log += '{'; }
+    void endObject() { log += '}'; }
+    void startArray() { log += '['; }
+    void endArray() { log += ']'; }
+    void key(std::string_view keyName) { log += std::string(keyName) + ':'; }
+    void null() { log += "null,"; }
+
+    /// @brief 値を記録する。
+    template <typename T>
+    void writeObject(const T& value) {
+        if constexpr (std::is_same_v<T, bool>) {
+            log += value ? "true," : "false,";
+        }
+        else if constexpr (std::is_arithmetic_v<T>) {
+            log += std::to_string(value) + ',';
+        }
+        else {
+            log += '"' + std::string(std::string_view(value)) + "\",";
+        }
+    }
+};
+
+static_assert(IsFormatWriter<FwRecordingWriter>);
+static_assert(IsFormatWriter<JsonWriter>);
+
+/// @brief serializer()が具体的なフィールド集合の型を返す型（仮想関数を介さずに書き出す）。
+struct FwStaticPoint {
+    int x = 0;
+    std::int64_t y = 0;
+
+    const auto& serializer() const {
+        static const auto fields = getFieldSet(
+            getRequiredField(&FwStaticPoint::x, "x"),
+            getRequiredField(&FwStaticPoint::y, "y")
+        );
+        return fields;
+    }
+};
+
+/// @brief ポリモーフィックな要素の基底クラス。
+struct FwShape {
+    virtual ~FwShape() = default;
+    virtual const ObjectSerializer& serializer() const = 0;
+};
+
+/// @brief 半径を持つポリモーフィックな要素。
+struct FwCircle : FwShape {
+    int radius = 0;
+
+    const ObjectSerializer& serializer() const override {
+        static const auto fields = getFieldSet(
+            getRequiredField(&FwCircle::radius, "radius")
+        );
+        return fields;
+    }
+};
+
+using FwShapeEntry = std::pair<std::string_view, PolymorphicTypeFactory<std::unique_ptr<FwShape>>>;
+inline const auto fwShapeEntries = rai::collection::makeSortedHashArrayMap(
+    FwShapeEntry{"Circle", [] { return std::make_unique<FwCircle>(); }}
+);
+
+/// @brief serializer()がObjectSerializer&を返す型（仮想関数で書き出す）。
+struct FwDocument {
+    std::string name;
+    bool flag = false;
+    double ratio = 0;
+    std::vector<FwStaticPoint> points;
+    std::vector<std::unique_ptr<FwShape>> shapes;
+
+    const ObjectSerializer& serializer() const {
+        static const auto pointsConverter = getContainerConverter<decltype(points)>();
+        static const auto shapesConverter =
+            getPolymorphicArrayConverter<decltype(shapes)>(fwShapeEntries, "kind");
+        static const auto fields = getFieldSet(
+            getRequiredField(&FwDocument::name, "name"),
+            getRequiredField(&FwDocument::flag, "flag"),
+            getRequiredField(&FwDocument::ratio, "ratio"),
+            getRequiredField(&FwDocument::points, "points", pointsConverter),
+            getRequiredField(&FwDocument::shapes, "shapes", shapesConverter)
+        );
+        return fields;
+    }
+};
+
+/// @brief JsonWriterへの書き出しだけを実装した利用者定義のコンバータ。
+struct FwJsonOnlyConverter {
+    using Value = int;
+    void write(JsonWriter& writer, const int& value) const { writer.writeObject(value * 10); }
+    int read(JsonParser& parser) const {
+        int value = 0;
+        parser.readTo(value);
+        return value / 10;
+    }
+};
+
+/// @brief 利用者定義のコンバータを使う型。
+struct FwJsonOnlyHolder {
+    int value = 0;
+
+    const ObjectSerializer& serializer() const {
+        static const FwJsonOnlyConverter converter;
+        static const auto fields = getFieldSet(
+            getRequiredField(&FwJsonOnlyHolder::value, "value", converter)
+        );
+        return fields;
+    }
+};
+
+/// @brief テスト用の文書を作る補助関数。
+FwDocument makeFwDocument() {
+    FwDocument document;
+    document.name = "doc";
+    document.flag = true;
+    document.ratio = 0.5;
+    document.points = {FwStaticPoint{1, 2}, FwStaticPoint{-3, 4}};
+    auto circle = std::make_unique<FwCircle>();
+    circle->radius = 7;
+    document.shapes.push_back(std::move(circle));
+    return document;
+}
+
+}  // namespace
+
+/// @brief 具体的なフィールド集合の型を返すserializer()で任意の書き込み型へ書き出せることを確認する。
+TEST(FormatWriterTest, WritesStaticSerializerToCustomWriter) {
+    const FwStaticPoint point{5, -6};
+    FwRecordingWriter writer;
+    writer.startObject();
+    writeSerializerFields(writer, point.serializer(), point);
+    writer.endObject();
+    EXPECT_EQ(writer.log, "{x:5,y:-6,}");
+
+    EXPECT_EQ(getJsonContent(point), "{x:5,y:-6}");
+    FwStaticPoint loaded;
+    readJsonString(getJsonContent(point), loaded);
+    EXPECT_EQ(loaded.x, 5);
+    EXPECT_EQ(loaded.y, -6);
+}
+
+/// @brief ObjectSerializer&を返す型とポリモーフィックな要素を任意の書き込み型へ書き出せることを確認する。
+TEST(FormatWriterTest, WritesVirtualSerializerToCustomWriter) {
+    const FwDocument document = makeFwDocument();
+    FwRecordingWriter writer;
+    getConverter<FwDocument>().write(writer, document);
+    EXPECT_EQ(writer.log,
+        "{name:\"doc\",flag:true,ratio:" + std::to_string(0.5) + ","
+        "points:[{x:1,y:2,}{x:-3,y:4,}]"
+        "shapes:[{kind:\"Circle\",radius:7,}]}");
+}
+
+/// @brief RaiBinaryへの直接の書き出しがJSONを介した変換と一致することを確認する。
+TEST(FormatWriterTest, WritesRaiBinaryDirectly) {
+    const FwDocument document = makeFwDocument();
+    EXPECT_EQ(getRaiBinaryContent(document), convertJsonToRaiBinary(getJsonContent(document)));
+
+    FwDocument loaded;
+    readRaiBinary(getRaiBinaryContent(document), loaded);
+    EXPECT_EQ(getJsonContent(loaded), getJsonContent(document));
+}
+
+/// @brief JsonWriterだけに対応するコンバータは、他の書き込み型では実行時エラーになることを確認する。
+TEST(FormatWriterTest, RejectsJsonOnlyConverterForOtherWriters) {
+    FwJsonOnlyHolder holder;
+    holder.value = 4;
+    EXPECT_EQ(getJsonContent(holder), "{value:40}");
+
+    FwRecordingWriter writer;
+    EXPECT_THROW(getConverter<FwJsonOnlyHolder>().write(writer, holder), std::runtime_error);
+}
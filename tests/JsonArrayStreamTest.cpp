@@ -0,0 +1,188 @@
+import rai.serialization.json_array_stream;
+import rai.serialization.field_serializer;
+import rai.serialization.object_converter;
+import rai.serialization.object_serializer;
+import rai.serialization.json_io;
+import rai.common.thread_pool;
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace rai::serialization;
+
+namespace {
+
+/// @brief 配列の要素として読み込むテスト用のログ1件。
+struct LogRecord {
+    int id = 0;
+    std::string message;
+
+    const ObjectSerializer& serializer() const {
+        static const auto fields = getFieldSet(
+            getRequiredField(&LogRecord::id, "id"),
+            getRequiredField(&LogRecord::message, "message")
+        );
+        return fields;
+    }
+};
+
+/// @brief i番目のログのメッセージを返す補助関数。エスケープを含むものも混ぜる。
+std::string makeLogMessage(int i) {
+    std::string message = "record " + std::to_string(i);
+    if (i % 5 == 0) {
+        message += "\n\t\"quoted\" " + std::string(static_cast<std::size_t>(i % 200), 'x');
+    }
+    return message;
+}
+
+/// @brief count件のログを含むJSON配列を書き出す補助関数。
+/// @param extraEvery この件数毎に未知キーを加える（0なら加えない）。
+std::string writeLogArray(const std::string& filename, int count, int extraEvery) {
+    std::string content = "[\n";
+    for (int i = 0; i < count; ++i) {
+        LogRecord record{i, makeLogMessage(i)};
+        std::string element = getJsonContent(record);
+        if (extraEvery != 0 && i % extraEvery == 0) {
+            element.insert(element.size() - 1, ",extra:1");
+        }
+        content += element;
+        content += i + 1 < count ? ",\n" : "\n";
+    }
+    content += "]\n";
+    std::ofstream ofs(filename, std::ios::binary | std::ios::trunc);
+    ofs << content;
+    return content;
+}
+
+}  // namespace
+
+// ********************************************************************************
+// テストカテゴリ：JsonArrayStream
+// ********************************************************************************
+
+/// @brief 実行器に関わらず、全ての要素を順に1つずつ読めることのテスト。
+TEST(JsonArrayStreamTest, IteratesAllRecordsInOrder) {
+    const std::string filename = "test_array_stream.json";
+    constexpr int count = 30000;
+    writeLogArray(filename, count, 1000);
+    rai::common::ThreadPool pool(2);
+    for (rai::common::Executor* executor :
+        {static_cast<rai::common::Executor*>(&pool),
+         static_cast<rai::common::Executor*>(&rai::common::getInlineExecutor())}) {
+        JsonArrayStream<LogRecord> stream(filename, *executor);
+        int expectedId = 0;
+        for (LogRecord& record : stream) {
+            ASSERT_EQ(record.id, expectedId);
+            ASSERT_EQ(record.message, makeLogMessage(expectedId));
+            // 未知キーは要素毎に区切られ、前の要素の分は残らない。
+            if (expectedId % 1000 == 0) {
+                ASSERT_EQ(stream.unknownKeys(), std::vector<std::string>{"extra"});
+            } else {
+                ASSERT_TRUE(stream.unknownKeys().empty());
+            }
+            ++expectedId;
+        }
+        EXPECT_EQ(expectedId, count);
+        EXPECT_EQ(stream.count(), static_cast<std::size_t>(count));
+        EXPECT_EQ(stream.unknownKeyCount(), static_cast<std::size_t>(count / 1000));
+        EXPECT_FALSE(stream.next());
+    }
+
+    // 空の配列とストリーム入力。
+    std::istringstream empty(" [ ] ");
+    JsonArrayStream<LogRecord> emptyStream(empty, pool);
+    EXPECT_FALSE(emptyStream.next());
+    EXPECT_EQ(emptyStream.count(), 0u);
+    std::remove(filename.c_str());
+}
+
+/// @brief 文字列の総量が大きな配列でも、読み終えた要素の文字列を解放しながら読み進められることのテスト。
+TEST(JsonArrayStreamTest, ReleasesStringsOfConsumedRecords) {
+    const std::string filename = "test_array_stream_large.json";
+    constexpr int count = 20000;
+    {
+        std::ofstream ofs(filename, std::ios::binary | std::ios::trunc);
+        ofs << "[";
+        for (int i = 0; i < count; ++i) {
+            ofs << (i == 0 ? "" : ",") << "{id:" << i << ",message:\"\\u0041" << std::string(400, 'a') << "\"}";
+        }
+        ofs << "]";
+    }
+    rai::common::ThreadPool pool(2);
+    JsonArrayStream<LogRecord> stream(filename, pool);
+    std::size_t total = 0;
+    while (stream.next()) {
+        ASSERT_EQ(stream.current().message.size(), 401u);
+        ASSERT_EQ(stream.current().message[0], 'A');
+        total += stream.current().message.size();
+    }
+    EXPECT_EQ(stream.count(), static_cast<std::size_t>(count));
+    EXPECT_EQ(total, static_cast<std::size_t>(count) * 401u);
+    std::remove(filename.c_str());
+}
+
+/// @brief 実行器の全てのワーカーから同じ実行器で構築しても、止まらずに読めることのテスト。
+TEST(JsonArrayStreamTest, StreamsFromEveryWorkerOfSamePool) {
+    const std::string filename = "test_array_stream_workers.json";
+    constexpr int count = 2000;
+    writeLogArray(filename, count, 0);
+    rai::common::ThreadPool pool(2);
+    std::vector<std::future<int>> tasks;
+    for (int i = 0; i < 4; ++i) {
+        tasks.push_back(pool.enqueue([&]() {
+            JsonArrayStream<LogRecord> stream(filename, pool);
+            int read = 0;
+            for (LogRecord& record : stream) {
+                if (record.id != read || record.message != makeLogMessage(read)) {
+                    return -1;
+                }
+                ++read;
+            }
+            return read;
+        }));
+    }
+    for (auto& task : tasks) {
+        pool.wait(task);
+        EXPECT_EQ(task.get(), count);
+    }
+    std::remove(filename.c_str());
+}
+
+/// @brief 不正な要素・配列以外の入力・後続の内容は例外になり、途中で破棄もできることのテスト。
+TEST(JsonArrayStreamTest, ReportsErrorsAndStopsEarly) {
+    rai::common::ThreadPool pool(2);
+    for (rai::common::Executor* executor :
+        {static_cast<rai::common::Executor*>(&pool),
+         static_cast<rai::common::Executor*>(&rai::common::getInlineExecutor())}) {
+        std::istringstream missingField("[{id:1,message:\"a\"},{id:2}]");
+        JsonArrayStream<LogRecord> stream(missingField, *executor);
+        EXPECT_TRUE(stream.next());
+        EXPECT_THROW(stream.next(), std::runtime_error);
+        EXPECT_FALSE(stream.next());
+
+        std::istringstream notArray("{id:1,message:\"a\"}");
+        EXPECT_THROW((JsonArrayStream<LogRecord>{notArray, *executor}), std::runtime_error);
+
+        std::istringstream trailing("[{id:1,message:\"a\"}] 1");
+        JsonArrayStream<LogRecord> trailingStream(trailing, *executor);
+        EXPECT_TRUE(trailingStream.next());
+        EXPECT_THROW(trailingStream.next(), std::runtime_error);
+    }
+    EXPECT_THROW(JsonArrayStream<LogRecord>("no_such_array_stream.json"), std::runtime_error);
+
+    // 途中で破棄しても、空き待ちのトークナイザーを解放して終了する。
+    const std::string filename = "test_array_stream_partial.json";
+    writeLogArray(filename, 50000, 0);
+    for (int i = 0; i < 5; ++i) {
+        JsonArrayStream<LogRecord> partial(filename, pool);
+        for (int j = 0; j < i * 100; ++j) {
+            ASSERT_TRUE(partial.next());
+        }
+    }
+    std::remove(filename.c_str());
+}
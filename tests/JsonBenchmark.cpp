@@ -25,6 +25,8 @@ import rai.collection.sorted_hash_array_map;
 #include <iostream>
 #include <cmath>
 #include <utility>
+#include <algorithm>
+#include <random>
 
 using namespace rai::serialization;
 
@@ -550,6 +552,116 @@ static void runFileIOBenchmark(
     std::cout << "\n";
 }
 
+// ********************************************************************************
+// キー探索方法の比較
+// ********************************************************************************
+
+/// @brief キー探索方法の比較に使う構造体。
+/// @tparam OrderedProbe 宣言順のキーを先に比較する探索を使うか。
+template <bool OrderedProbe>
+struct ProbeRecord {
+    int id = 0;
+    int width = 0;
+    int height = 0;
+    int depth = 0;
+    double weight = 0.0;
+    double price = 0.0;
+    bool active = false;
+    bool visible = false;
+    std::string label;
+    std::string owner;
+
+    const ObjectSerializer& serializer() const {
+        static const auto fields = [] {
+            auto f = getFieldSet(
+                getRequiredField(&ProbeRecord::id, "id"),
+                getRequiredField(&ProbeRecord::width, "width"),
+                getRequiredField(&ProbeRecord::height, "height"),
+                getRequiredField(&ProbeRecord::depth, "depth"),
+                getRequiredField(&ProbeRecord::weight, "weight"),
+                getRequiredField(&ProbeRecord::price, "price"),
+                getRequiredField(&ProbeRecord::active, "active"),
+                getRequiredField(&ProbeRecord::visible, "visible"),
+                getRequiredField(&ProbeRecord::label, "label"),
+                getRequiredField(&ProbeRecord::owner, "owner")
+            );
+            f.setOrderedProbe(OrderedProbe);
+            return f;
+        }();
+        return fields;
+    }
+};
+
+/// @brief ProbeRecordの配列を持つルート構造体。
+/// @tparam OrderedProbe 宣言順のキーを先に比較する探索を使うか。
+template <bool OrderedProbe>
+struct ProbeDocument {
+    std::vector<ProbeRecord<OrderedProbe>> records;
+
+    const ObjectSerializer& serializer() const {
+        static const auto recordsConverter = getContainerConverter<decltype(records)>();
+        static const auto fields = getFieldSet(
+            getRequiredField(&ProbeDocument::records, "records", recordsConverter)
+        );
+        return fields;
+    }
+};
+
+/// @brief ProbeRecordの配列のJSONを生成する。
+/// @param count 要素数。
+/// @param shuffled キーの並びを要素ごとに入れ替える場合はtrue。
+std::string generateProbeJsonData(int count, bool shuffled) {
+    std::vector<std::string> members = {"id", "width", "height", "depth", "weight",
+        "price", "active", "visible", "label", "owner"};
+    std::mt19937 engine(2024);
+    std::ostringstream oss;
+    oss << "{\"records\":[";
+    for (int i = 0; i < count; ++i) {
+        if (shuffled) {
+            std::shuffle(members.begin(), members.end(), engine);
+        }
+        oss << (i == 0 ? "{" : ",{");
+        for (std::size_t m = 0; m < members.size(); ++m) {
+            const std::string& name = members[m];
+            oss << (m == 0 ? "" : ",") << "\"" << name << "\":";
+            if (name == "weight" || name == "price") {
+                oss << (i * 0.25);
+            } else if (name == "active" || name == "visible") {
+                oss << (i % 2 == 0 ? "true" : "false");
+            } else if (name == "label" || name == "owner") {
+                oss << "\"" << name << "_" << i << "\"";
+            } else {
+                oss << i;
+            }
+        }
+        oss << "}";
+    }
+    oss << "]}";
+    return oss.str();
+}
+
+/// @brief 指定した探索方法でJSONを繰り返し読み込み、所要時間を計測する。
+/// @tparam OrderedProbe 宣言順のキーを先に比較する探索を使うか。
+/// @param jsonData 入力JSON。
+/// @param iterations 計測回数。
+template <bool OrderedProbe>
+Statistics measureProbeRead(const std::string& jsonData, int iterations) {
+    {
+        ProbeDocument<OrderedProbe> warmup;
+        readJsonString(jsonData, warmup);
+    }
+    std::vector<double> times;
+    times.reserve(iterations);
+    for (int i = 0; i < iterations; ++i) {
+        ProbeDocument<OrderedProbe> document;
+        HighResolutionTimer timer;
+        timer.start();
+        readJsonString(jsonData, document);
+        times.push_back(timer.elapsedMicroseconds());
+    }
+    return Statistics::compute(times);
+}
+
 // ********************************************************************************
 // ベンチマークテスト
 // ********************************************************************************
@@ -597,3 +709,20 @@ TEST(JsonBenchmark, MediumDataFileIO) {
     // 注: 各イテレーションでは異なるファイルを使用してキャッシュの影響を避けます
     runFileIOBenchmark(jsonData, "benchmark_medium_", iterations, 2);
 }
+
+/// @brief 宣言順のキー比較と探索表による探索を、キーが宣言順の入力と入れ替えた入力で比較する
+TEST(JsonBenchmark, FieldLookupOrderedProbe) {
+    const int iterations = 30;
+    const std::string inOrderJson = generateProbeJsonData(5000, false);
+    const std::string shuffledJson = generateProbeJsonData(5000, true);
+    std::cout << "\n=== Field Lookup Benchmark ===\n";
+    std::cout << "Data size: " << inOrderJson.size() << " bytes, ";
+    std::cout << "Iterations: " << iterations << "\n";
+    std::cout << "In-order keys:\n";
+    printBenchmarkResult("Ordered probe", measureProbeRead<true>(inOrderJson, iterations));
+    printBenchmarkResult("Hash lookup  ", measureProbeRead<false>(inOrderJson, iterations));
+    std::cout << "Shuffled keys:\n";
+    printBenchmarkResult("Ordered probe", measureProbeRead<true>(shuffledJson, iterations));
+    printBenchmarkResult("Hash lookup  ", measureProbeRead<false>(shuffledJson, iterations));
+    std::cout << "\n";
+}
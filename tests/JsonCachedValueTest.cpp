@@ -0,0 +1,145 @@
+import rai.serialization.field_serializer;
+import rai.serialization.object_converter;
+import rai.serialization.object_serializer;
+import rai.serialization.json_cached_value;
+import rai.serialization.json_io;
+import rai.serialization.json_parser;
+import rai.serialization.json_writer;
+import rai.serialization.rai_binary_io;
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace rai::serialization;
+
+namespace {
+
+/// @brief 書き出した回数を数えるコンバータ。
+struct CacheCountingConverter {
+    using Value = int;
+    inline static int writes = 0;
+
+    template <IsFormatWriter Writer>
+    void write(Writer& writer, const int& value) const {
+        ++writes;
+        writer.writeObject(value);
+    }
+    int read(JsonParser& parser) const {
+        int value = 0;
+        parser.readTo(value);
+        return value;
+    }
+};
+
+/// @brief 出力を再利用する要素。
+struct CacheItem {
+    int id = 0;
+    std::string name;
+
+    const ObjectSerializer& serializer() const {
+        static const CacheCountingConverter idConverter;
+        static const auto fields = getFieldSet(
+            getRequiredField(&CacheItem::id, "id", idConverter),
+            getRequiredField(&CacheItem::name, "name")
+        );
+        return fields;
+    }
+};
+
+/// @brief 要素と見出しの出力を再利用する文書。
+struct CacheDocument {
+    JsonCachedValue<CacheItem> header;
+    std::vector<JsonCachedValue<CacheItem>> items;
+    int revision = 0;
+
+    const ObjectSerializer& serializer() const {
+        static const auto itemsConverter = getContainerConverter<decltype(items)>();
+        static const auto fields = getFieldSet(
+            getRequiredField(&CacheDocument::header, "header"),
+            getRequiredField(&CacheDocument::items, "items", itemsConverter),
+            getRequiredField(&CacheDocument::revision, "revision")
+        );
+        return fields;
+    }
+};
+
+/// @brief 比較用に、同じ内容をラッパーなしで持つ文書。
+struct CachePlainDocument {
+    CacheItem header;
+    std::vector<CacheItem> items;
+    int revision = 0;
+
+    const ObjectSerializer& serializer() const {
+        static const auto itemsConverter = getContainerConverter<decltype(items)>();
+        static const auto fields = getFieldSet(
+            getRequiredField(&CachePlainDocument::header, "header"),
+            getRequiredField(&CachePlainDocument::items, "items", itemsConverter),
+            getRequiredField(&CachePlainDocument::revision, "revision")
+        );
+        return fields;
+    }
+};
+
+/// @brief テスト用の文書を作る補助関数。
+CacheDocument makeCacheDocument(int count) {
+    CacheDocument document;
+    document.header = CacheItem{0, "head"};
+    for (int i = 1; i <= count; ++i) {
+        document.items.emplace_back(CacheItem{i, "item" + std::to_string(i)});
+    }
+    return document;
+}
+
+/// @brief ラッパーなしの文書に写す補助関数。
+CachePlainDocument toCachePlainDocument(const CacheDocument& document) {
+    CachePlainDocument plain;
+    plain.header = document.header.get();
+    for (const auto& item : document.items) {
+        plain.items.push_back(*item);
+    }
+    plain.revision = document.revision;
+    return plain;
+}
+
+}  // namespace
+
+/// @brief 変更していない部分は前回の出力を再利用し、出力はラッパーなしと一致することを確認する。
+TEST(JsonCachedValueTest, ReusesUnchangedOutput) {
+    CacheDocument document = makeCacheDocument(10);
+    CacheCountingConverter::writes = 0;
+    const std::string first = getJsonContent(document);
+    EXPECT_EQ(CacheCountingConverter::writes, 11);
+    EXPECT_EQ(first, getJsonContent(toCachePlainDocument(document)));
+    EXPECT_TRUE(document.items[3].cached());
+
+    CacheCountingConverter::writes = 0;
+    document.revision = 1;
+    EXPECT_EQ(getJsonContent(document), getJsonContent(toCachePlainDocument(document)));
+    EXPECT_EQ(CacheCountingConverter::writes, 11);  // 比較用のラッパーなしの書き出しの分のみ
+
+    CacheCountingConverter::writes = 0;
+    document.items[3].modify().name = "changed";
+    EXPECT_FALSE(document.items[3].cached());
+    const std::string changed = getJsonContent(document);
+    EXPECT_EQ(CacheCountingConverter::writes, 1);
+    EXPECT_NE(changed.find("name:\"changed\""), std::string::npos);
+    EXPECT_EQ(changed, getJsonContent(toCachePlainDocument(document)));
+}
+
+/// @brief 読み込みで出力を破棄し、JsonWriter以外の書き込み型には毎回書き出すことを確認する。
+TEST(JsonCachedValueTest, ReadsAndWritesOtherFormats) {
+    CacheDocument document = makeCacheDocument(3);
+    const std::string json = getJsonContent(document);
+
+    CacheDocument loaded;
+    readJsonString(json, loaded);
+    EXPECT_FALSE(loaded.header.cached());
+    ASSERT_EQ(loaded.items.size(), 3u);
+    EXPECT_EQ(loaded.items[2]->name, "item3");
+    EXPECT_EQ(getJsonContent(loaded), json);
+
+    CacheCountingConverter::writes = 0;
+    EXPECT_EQ(getRaiBinaryContent(loaded), convertJsonToRaiBinary(json));
+    EXPECT_EQ(CacheCountingConverter::writes, 4);
+    EXPECT_EQ(estimateJsonSize(loaded), json.size());
+}
@@ -0,0 +1,187 @@
+import rai.serialization.token_manager;
+import rai.serialization.json_tokenizer;
+import rai.serialization.json_chunked_tokenizer;
+import rai.serialization.reading_ahead_buffer;
+import rai.serialization.field_serializer;
+import rai.serialization.object_converter;
+import rai.serialization.object_serializer;
+import rai.serialization.json_io;
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace rai::serialization;
+
+namespace {
+
+/// @brief トークンを比較用の文字列に変換する補助関数。
+/// @param source トークンの読み出し元（文字列内容の解決に使う）。
+/// @param token 変換するトークン。
+std::string describeToken(const TokenSource& source, const JsonToken& token) {
+    std::string text = std::to_string(static_cast<int>(token.type)) + "@" +
+        std::to_string(token.position) + ":";
+    switch (token.type) {
+    case JsonTokenType::Bool:    return text + (token.boolean ? "true" : "false");
+    case JsonTokenType::Integer: return text + std::to_string(token.integer);
+    case JsonTokenType::Number:  return text + std::to_string(token.number);
+    case JsonTokenType::String:
+    case JsonTokenType::Key:     return text + std::string(source.text(token));
+    default:                     return text;
+    }
+}
+
+/// @brief 読み出し元のトークンを終端まで読み出す補助関数。
+std::vector<std::string> drainTokens(TokenSource& source) {
+    std::vector<std::string> result;
+    for (;;) {
+        const JsonToken token = source.take();
+        result.push_back(describeToken(source, token));
+        if (token.type == JsonTokenType::EndOfStream) {
+            return result;
+        }
+    }
+}
+
+/// @brief 逐次版のトークナイザーでトークン化した結果を返す補助関数。
+std::vector<std::string> tokenizeSequential(const std::string& json) {
+    std::string buffer = json;
+    buffer.reserve(buffer.size() + 8);
+    ReadingAheadBuffer input(std::move(buffer), 8);
+    TokenManager tokens;
+    StdoutMessageOutput warningOutput;
+    JsonTokenizer<ReadingAheadBuffer, TokenManager> tokenizer(input, tokens, warningOutput);
+    tokenizer.tokenize();
+    return drainTokens(tokens);
+}
+
+/// @brief エスケープ・コメント・各種の値を含む大きな配列のJSONを生成する補助関数。
+std::string makeLargeArray(int count) {
+    std::string json = "{records:[";
+    for (int i = 0; i < count; ++i) {
+        json += i == 0 ? "" : ",\n";
+        json += "{ // leading, comment\n id:" + std::to_string(i) + ", 'name': \"item,\\t" +
+            std::to_string(i) + "\\u00e9\", ratio: " + std::to_string(i) +
+            ".25, /* note, here */ ok: " + (i % 2 == 0 ? "true" : "false") + ", tag: null}";
+    }
+    json += "\n]}";
+    return json;
+}
+
+/// @brief 区間並列トークン化の読み込み確認に使うテスト用構造体。
+struct ChunkedRecord {
+    int id = 0;
+    std::string name;
+    double ratio = 0.0;
+
+    const ObjectSerializer& serializer() const {
+        static const auto fields = getFieldSet(
+            getRequiredField(&ChunkedRecord::id, "id"),
+            getRequiredField(&ChunkedRecord::name, "name"),
+            getRequiredField(&ChunkedRecord::ratio, "ratio")
+        );
+        return fields;
+    }
+};
+
+/// @brief 区間並列トークン化の読み込み確認に使うテスト用のルート構造体。
+struct ChunkedDocument {
+    std::vector<ChunkedRecord> records;
+
+    const ObjectSerializer& serializer() const {
+        static const auto recordsConverter = getContainerConverter<decltype(records)>();
+        static const auto fields = getFieldSet(
+            getRequiredField(&ChunkedDocument::records, "records", recordsConverter)
+        );
+        return fields;
+    }
+};
+
+}  // namespace
+
+// ********************************************************************************
+// テストカテゴリ：区間並列トークン化
+// ********************************************************************************
+
+/// @brief 区間毎に並列でトークン化した結果が、逐次版と一致することのテスト。
+TEST(JsonChunkedTokenizerTest, MatchesSequentialTokens) {
+    const std::string json = makeLargeArray(500);
+    const auto expected = tokenizeSequential(json);
+    for (std::size_t chunkCount : {2u, 3u, 8u, 64u}) {
+        ChunkedTokenSource tokens;
+        StdoutMessageOutput warningOutput;
+        EXPECT_TRUE(tokens.tokenize(json, warningOutput, chunkCount)) << chunkCount;
+        EXPECT_GT(tokens.chunkCount(), 1u);
+        EXPECT_EQ(drainTokens(tokens), expected) << chunkCount;
+        // 終端の後も終端を返し続ける。
+        EXPECT_EQ(tokens.take().type, JsonTokenType::EndOfStream);
+    }
+}
+
+/// @brief 区切り位置が文字列・コメントの内側の場合は逐次処理に切り替えることのテスト。
+TEST(JsonChunkedTokenizerTest, FallsBackWhenSplitInsideStringOrComment) {
+    const std::string inString = "{text:\"" + std::string(200, 'a') + ",b,c,d,e,f\", n:[1,2]}";
+    const std::string inLineComment = "{n:[1 // " + std::string(200, 'x') + ",y,z\n, 2, 3]}";
+    const std::string inBlockComment = "{n:[1, /* " + std::string(200, 'x') + ",y,z */ 2, 3]}";
+    const std::string inSingleQuoted = "{t:'" + std::string(200, 'q') + ",\\',r,s', n:[1,2]}";
+    for (const std::string& json : {inString, inLineComment, inBlockComment, inSingleQuoted}) {
+        ChunkedTokenSource tokens;
+        StdoutMessageOutput warningOutput;
+        EXPECT_FALSE(tokens.tokenize(json, warningOutput, 2)) << json;
+        EXPECT_EQ(tokens.chunkCount(), 1u);
+        EXPECT_EQ(drainTokens(tokens), tokenizeSequential(json)) << json;
+    }
+}
+
+/// @brief 字句状態の走査が文字列・エスケープ・コメントの終わりを判定できることのテスト。
+TEST(JsonChunkedTokenizerTest, ScansLexicalState) {
+    auto scan = [](std::string_view text) { return scanLexicalState(text.data(), text.size()); };
+    EXPECT_EQ(scan("{a:1,"), LexicalState::Outside);
+    EXPECT_EQ(scan("\"a\\\",b"), LexicalState::DoubleQuoted);
+    EXPECT_EQ(scan("\"a\\\\\",b"), LexicalState::Outside);
+    EXPECT_EQ(scan("'a\"b',"), LexicalState::Outside);
+    EXPECT_EQ(scan("// c,"), LexicalState::LineComment);
+    EXPECT_EQ(scan("// c\n,"), LexicalState::Outside);
+    EXPECT_EQ(scan("/* c */,"), LexicalState::Outside);
+    EXPECT_EQ(scan("/* c *,"), LexicalState::BlockComment);
+}
+
+/// @brief 区間並列トークン化版の読み込みが逐次版と同じ結果・同じエラーになることのテスト。
+TEST(JsonChunkedTokenizerTest, ReadsSameObjectAsSequential) {
+    const std::string json = makeLargeArray(20000);
+    ASSERT_GT(json.size(), 2 * ChunkedTokenSource::minChunkSize);
+    ChunkedDocument sequential;
+    std::vector<std::string> sequentialUnknownKeys;
+    readJsonString(json, sequential, sequentialUnknownKeys);
+    ChunkedDocument chunked;
+    std::vector<std::string> chunkedUnknownKeys;
+    readJsonStringChunked(json, chunked, chunkedUnknownKeys);
+    ASSERT_EQ(chunked.records.size(), 20000u);
+    for (std::size_t i = 0; i < chunked.records.size(); ++i) {
+        EXPECT_EQ(chunked.records[i].id, sequential.records[i].id);
+        EXPECT_EQ(chunked.records[i].name, sequential.records[i].name);
+        EXPECT_EQ(chunked.records[i].ratio, sequential.records[i].ratio);
+    }
+    EXPECT_EQ(chunkedUnknownKeys, sequentialUnknownKeys);
+
+    // 途中の区間の不正な文字は、逐次版と同じ位置のエラーとして報告される。
+    std::string broken = json;
+    broken[broken.size() / 2 + broken.substr(broken.size() / 2).find("null")] = '#';
+    std::string sequentialMessage;
+    try {
+        ChunkedDocument document;
+        readJsonString(broken, document);
+    } catch (const std::runtime_error& e) {
+        sequentialMessage = e.what();
+    }
+    std::string chunkedMessage;
+    try {
+        ChunkedDocument document;
+        readJsonStringChunked(broken, document);
+    } catch (const std::runtime_error& e) {
+        chunkedMessage = e.what();
+    }
+    EXPECT_FALSE(chunkedMessage.empty());
+    EXPECT_EQ(chunkedMessage, sequentialMessage);
+}
@@ -0,0 +1,128 @@
+import rai.serialization.token_manager;
+import rai.serialization.json_tokenizer;
+import rai.serialization.reading_ahead_buffer;
+import rai.serialization.parallel_input_stream_source;
+import rai.serialization.field_serializer;
+import rai.serialization.object_converter;
+import rai.serialization.object_serializer;
+import rai.serialization.json_io;
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace rai::serialization;
+
+namespace {
+
+/// @brief 数値1つだけのJSONをトークン化し、その数値トークンを返す補助関数。
+/// @param json 入力文字列。
+JsonToken tokenizeNumber(std::string json) {
+    constexpr std::size_t aheadSize = 8;
+    json.reserve(json.size() + aheadSize);
+    ReadingAheadBuffer input(std::move(json), aheadSize);
+    TokenManager tokens;
+    StdoutMessageOutput warningOutput;
+    JsonTokenizer<ReadingAheadBuffer, TokenManager> tokenizer(input, tokens, warningOutput);
+    tokenizer.tokenize();
+    return tokens.take();
+}
+
+/// @brief 数値1つだけのJSONをストリーム入力元でトークン化し、その数値トークンを返す補助関数。
+/// @param json 入力文字列。
+JsonToken tokenizeNumberFromStream(const std::string& json) {
+    std::istringstream stream(json);
+    ParallelInputStreamSource input(stream);
+    TokenManager tokens;
+    StdoutMessageOutput warningOutput;
+    JsonTokenizer<ParallelInputStreamSource, TokenManager> tokenizer(
+        input, tokens, warningOutput);
+    tokenizer.tokenize();
+    return tokens.take();
+}
+
+/// @brief 倍精度浮動小数点数の配列を持つテスト用構造体。
+struct NumberArrays {
+    std::vector<double> values;
+    std::vector<std::int64_t> integers;
+
+    const ObjectSerializer& serializer() const {
+        static const auto valuesConverter = getContainerConverter<decltype(values)>();
+        static const auto integersConverter = getContainerConverter<decltype(integers)>();
+        static const auto fields = getFieldSet(
+            getRequiredField(&NumberArrays::values, "values", valuesConverter),
+            getRequiredField(&NumberArrays::integers, "integers", integersConverter)
+        );
+        return fields;
+    }
+};
+
+}  // namespace
+
+// ********************************************************************************
+// テストカテゴリ：数値の解析と書式化
+// ********************************************************************************
+
+/// @brief 10進数をstd::strtodと同じく正しく丸めて解析することのテスト。
+TEST(JsonNumberTest, ParsesCorrectlyRounded) {
+    const std::vector<std::string> inputs = {
+        "0.1", "0.3", "1.5", "-2.75", "123456.789", ".5", "5.", "1e10", "1E-5", "2.5e+3",
+        "3.141592653589793", "2.2250738585072014e-308", "1.7976931348623157e308",
+        "4.9e-324", "9007199254740993.0", "123456789012345678901234567890",
+        "0.000000000000000000000000000123456789", "1.00000000000000011102230246251565",
+        "12345678.87654321", "0.1234567890123456789", "1e-400"};
+    for (const auto& text : inputs) {
+        const double expected = std::strtod(text.c_str(), nullptr);
+        const JsonToken token = tokenizeNumber(text);
+        ASSERT_EQ(token.type, JsonTokenType::Number) << text;
+        EXPECT_EQ(token.number, expected) << text;
+        const JsonToken streamed = tokenizeNumberFromStream(text);
+        EXPECT_EQ(streamed.number, expected) << text;
+    }
+    EXPECT_TRUE(std::isinf(tokenizeNumber("1e400").number));
+    EXPECT_TRUE(std::signbit(tokenizeNumber("-0.0").number));
+}
+
+/// @brief 整数はint64_tの範囲まで整数トークンとし、範囲外は浮動小数点数にすることのテスト。
+TEST(JsonNumberTest, ParsesIntegerLimits) {
+    EXPECT_EQ(tokenizeNumber("1234567890123456789").integer, 1234567890123456789);
+    EXPECT_EQ(tokenizeNumber("9223372036854775807").integer,
+        std::numeric_limits<std::int64_t>::max());
+    EXPECT_EQ(tokenizeNumber("-9223372036854775808").integer,
+        std::numeric_limits<std::int64_t>::min());
+    EXPECT_EQ(tokenizeNumber("000123").integer, 123);
+    EXPECT_EQ(tokenizeNumberFromStream("-42").integer, -42);
+
+    const JsonToken tooLarge = tokenizeNumber("9223372036854775808");
+    ASSERT_EQ(tooLarge.type, JsonTokenType::Number);
+    EXPECT_EQ(tooLarge.number, 9223372036854775808.0);
+    EXPECT_THROW(tokenizeNumber("1e"), std::runtime_error);
+    EXPECT_THROW(tokenizeNumber("-."), std::runtime_error);
+}
+
+/// @brief 書き出した浮動小数点数が同じ値に読み戻せることのテスト。
+TEST(JsonNumberTest, WriteReadRoundTripKeepsDoubles) {
+    NumberArrays original;
+    std::mt19937_64 engine(12345);
+    std::uniform_real_distribution<double> distribution(-1e6, 1e6);
+    for (int i = 0; i < 1000; ++i) {
+        original.values.push_back(distribution(engine));
+    }
+    original.values.push_back(0.1);
+    original.values.push_back(1e300);
+    original.values.push_back(5e-324);
+    original.values.push_back(std::numeric_limits<double>::max());
+    original.integers = {0, -1, std::numeric_limits<std::int64_t>::max(),
+                         std::numeric_limits<std::int64_t>::min()};
+
+    const std::string json = getJsonContent(original);
+    EXPECT_NE(json.find("0.1,"), std::string::npos);
+    NumberArrays loaded;
+    readJsonString(json, loaded);
+    EXPECT_EQ(loaded.values, original.values);
+    EXPECT_EQ(loaded.integers, original.integers);
+}
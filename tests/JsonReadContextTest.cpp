@@ -0,0 +1,124 @@
+import rai.serialization.field_serializer;
+import rai.serialization.object_converter;
+import rai.serialization.object_serializer;
+import rai.serialization.json_io;
+import rai.serialization.json_parser;
+import rai.serialization.json_writer;
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace rai::serialization;
+
+namespace {
+
+/// @brief 繰り返し読み込むメッセージ。
+struct ContextMessage {
+    int id = 0;
+    std::string text;
+    std::vector<int> values;
+
+    const ObjectSerializer& serializer() const {
+        static const auto valuesConverter = getContainerConverter<decltype(values)>();
+        static const auto fields = getFieldSet(
+            getRequiredField(&ContextMessage::id, "id"),
+            getRequiredField(&ContextMessage::text, "text"),
+            getDefaultOmittedField(&ContextMessage::values, "values", std::vector<int>{}, valuesConverter)
+        );
+        return fields;
+    }
+};
+
+/// @brief 文字列に埋め込んだJSONを、読み込み中にreadJsonで読み込む値。
+struct ContextEmbedded {
+    ContextMessage inner;
+
+    void writeFormat(JsonWriter& writer) const { writer.writeObject(getJsonContent(inner)); }
+    void readFormat(JsonParser& parser) {
+        std::string json;
+        parser.readTo(json);
+        readJson(json, inner);
+    }
+};
+
+/// @brief 埋め込んだJSONを持つメッセージ。
+struct ContextEnvelope {
+    int id = 0;
+    ContextEmbedded payload;
+
+    const ObjectSerializer& serializer() const {
+        static const auto fields = getFieldSet(
+            getRequiredField(&ContextEnvelope::id, "id"),
+            getRequiredField(&ContextEnvelope::payload, "payload")
+        );
+        return fields;
+    }
+};
+
+}  // namespace
+
+/// @brief 同じ文脈で繰り返し読み込み、毎回正しい結果と未知キーを返すことを確認する。
+TEST(JsonReadContextTest, ReusesContextAcrossReads) {
+    JsonReadContext context;
+    for (int i = 0; i < 50; ++i) {
+        // エスケープを含む長い文字列で、文字列アリーナの再利用も確かめる。
+        const std::string text = "line\\n" + std::string(static_cast<std::size_t>(i) * 100, 'x');
+        const std::string json = "{id:" + std::to_string(i) + ",text:\"" + text + "\"" +
+            (i % 2 == 0 ? ",extra" + std::to_string(i) + ":{a:[1,2]}" : "") + ",values:[" +
+            std::to_string(i) + "]}";
+        ContextMessage message;
+        context.read(json, message);
+        EXPECT_EQ(message.id, i);
+        EXPECT_EQ(message.text, "line\n" + std::string(static_cast<std::size_t>(i) * 100, 'x'));
+        EXPECT_EQ(message.values, std::vector<int>{i});
+        if (i % 2 == 0) {
+            EXPECT_EQ(context.unknownKeys(), std::vector<std::string>{"extra" + std::to_string(i)});
+        } else {
+            EXPECT_TRUE(context.unknownKeys().empty());
+        }
+    }
+}
+
+/// @brief 入力の範囲外を読まないことと、エラーの後も文脈を使い続けられることを確認する。
+TEST(JsonReadContextTest, ReadsViewsAndRecoversFromErrors) {
+    const std::string buffer = "{id:7,text:\"view\"}{id:8,text:\"next\"}";
+    const std::string_view first(buffer.data(), buffer.find('}') + 1);
+    JsonReadContext context;
+    ContextMessage message;
+    context.read(first, message);
+    EXPECT_EQ(message.id, 7);
+    EXPECT_EQ(message.text, "view");
+
+    ContextMessage broken;
+    EXPECT_THROW(context.read("{id:1,text:\"unterminated}", broken), std::runtime_error);
+    EXPECT_FALSE(context.inUse());
+    EXPECT_THROW(context.read("{id:1}", broken), std::runtime_error);
+
+    context.read(std::string_view(buffer).substr(first.size()), message);
+    EXPECT_EQ(message.id, 8);
+    EXPECT_EQ(message.text, "next");
+}
+
+/// @brief スレッド毎の文脈を使うreadJsonが、読み込み中に入れ子で呼ばれても正しく読むことを確認する。
+TEST(JsonReadContextTest, ReadJsonHandlesNestedCalls) {
+    ContextEnvelope envelope;
+    envelope.id = 3;
+    envelope.payload.inner = ContextMessage{4, "inner", {5, 6}};
+    const std::string json = getJsonContent(envelope);
+
+    ContextEnvelope loaded;
+    std::vector<std::string> unknownKeys;
+    readJson(json, loaded, unknownKeys);
+    EXPECT_EQ(loaded.id, 3);
+    EXPECT_EQ(loaded.payload.inner.id, 4);
+    EXPECT_EQ(loaded.payload.inner.text, "inner");
+    EXPECT_EQ(loaded.payload.inner.values, (std::vector<int>{5, 6}));
+    EXPECT_TRUE(unknownKeys.empty());
+
+    ContextMessage message;
+    readJson("{id:9,text:\"again\",note:1}", message, unknownKeys);
+    EXPECT_EQ(message.id, 9);
+    EXPECT_EQ(unknownKeys, std::vector<std::string>{"note"});
+}
@@ -0,0 +1,268 @@
+import rai.serialization.json_writer;
+import rai.serialization.field_serializer;
+import rai.serialization.object_converter;
+import rai.serialization.object_serializer;
+import rai.serialization.polymorphic_converter;
+import rai.serialization.json_io;
+import rai.serialization.json_parser;
+import rai.collection.sorted_hash_array_map;
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace rai::serialization;
+
+namespace {
+
+/// @brief ポリモーフィックな要素の基底クラス。
+struct SizeShape {
+    virtual ~SizeShape() = default;
+    virtual const ObjectSerializer& serializer() const = 0;
+};
+
+/// @brief 名前を持つポリモーフィックな要素。
+struct SizeLabel : SizeShape {
+    std::string text;
+
+    const ObjectSerializer& serializer() const override {
+        static const auto fields = getFieldSet(
+            getRequiredField(&SizeLabel::text, "text")
+        );
+        return fields;
+    }
+};
+
+using SizeShapeEntry = std::pair<std::string_view, PolymorphicTypeFactory<std::unique_ptr<SizeShape>>>;
+inline const auto sizeShapeEntries = rai::collection::makeSortedHashArrayMap(
+    SizeShapeEntry{"Label", [] { return std::make_unique<SizeLabel>(); }}
+);
+
+/// @brief 様々な値の種類を持つ計測用の文書。
+struct SizeDocument {
+    std::string escaped;
+    char letter = 0;
+    char32_t symbol = 0;
+    char16_t unit = 0;
+    std::int64_t minimum = 0;
+    std::uint64_t maximum = 0;
+    double ratio = 0;
+    double infinite = 0;
+    float small = 0;
+    bool flag = false;
+    std::vector<int> numbers;
+    std::vector<std::unique_ptr<SizeShape>> shapes;
+    std::unique_ptr<SizeLabel> empty;
+
+    const ObjectSerializer& serializer() const {
+        static const auto numbersConverter = getContainerConverter<decltype(numbers)>();
+        static const auto shapesConverter =
+            getPolymorphicArrayConverter<decltype(shapes)>(sizeShapeEntries, "kind");
+        static const auto emptyConverter = getUniquePtrConverter<decltype(empty)>();
+        static const auto fields = getFieldSet(
+            getRequiredField(&SizeDocument::escaped, "escaped"),
+            getRequiredField(&SizeDocument::letter, "letter"),
+            getRequiredField(&SizeDocument::symbol, "symbol"),
+            getRequiredField(&SizeDocument::unit, "unit"),
+            getRequiredField(&SizeDocument::minimum, "minimum"),
+            getRequiredField(&SizeDocument::maximum, "maximum"),
+            getRequiredField(&SizeDocument::ratio, "ratio"),
+            getRequiredField(&SizeDocument::infinite, "infinite"),
+            getRequiredField(&SizeDocument::small, "small"),
+            getRequiredField(&SizeDocument::flag, "flag"),
+            getRequiredField(&SizeDocument::numbers, "numbers", numbersConverter),
+            getRequiredField(&SizeDocument::shapes, "shapes", shapesConverter),
+            getRequiredField(&SizeDocument::empty, "empty", emptyConverter)
+        );
+        return fields;
+    }
+};
+
+/// @brief JsonWriterへの書き出しだけを実装した利用者定義のコンバータ。
+struct SizeJsonOnlyConverter {
+    using Value = int;
+    void write(JsonWriter& writer, const int& value) const { writer.writeObject(value * 1000); }
+    int read(JsonParser& parser) const {
+        int value = 0;
+        parser.readTo(value);
+        return value / 1000;
+    }
+};
+
+/// @brief writeFormat(FormatWriter&)だけを持つ値。
+struct SizeCustomValue {
+    std::string name;
+
+    void writeFormat(JsonWriter& writer) const {
+        writer.startObject();
+        writer.key("name");
+        writer.writeObject(name);
+        writer.endObject();
+    }
+    void readFormat(JsonParser& parser) {
+        parser.startObject();
+        parser.nextKey();
+        parser.readTo(name);
+        parser.endObject();
+    }
+};
+
+/// @brief JsonWriterだけに対応する書き出しを含む文書。
+struct SizeJsonOnlyHolder {
+    int value = 0;
+    SizeCustomValue custom;
+    std::vector<SizeCustomValue> customs;
+
+    const ObjectSerializer& serializer() const {
+        static const SizeJsonOnlyConverter converter;
+        static const auto customsConverter = getContainerConverter<decltype(customs)>();
+        static const auto fields = getFieldSet(
+            getRequiredField(&SizeJsonOnlyHolder::value, "value", converter),
+            getRequiredField(&SizeJsonOnlyHolder::custom, "custom"),
+            getRequiredField(&SizeJsonOnlyHolder::customs, "customs", customsConverter)
+        );
+        return fields;
+    }
+};
+
+/// @brief JsonWriterBaseのキーの規則毎に別のキーを書き出すコンバータ。
+struct SizeQuotedKeyConverter {
+    using Value = int;
+    void write(JsonWriter& writer, const int& value) const {
+        writer.startObject();
+        writer.key("twoWords");
+        writer.writeObject(value);
+        writer.endObject();
+    }
+    void write(JsonWriterBase<true>& writer, const int& value) const {
+        writer.startObject();
+        writer.key("two words");
+        writer.writeObject(value);
+        writer.key("plain");
+        writer.null();
+        writer.endObject();
+    }
+    int read(JsonParser& parser) const {
+        int value = 0;
+        parser.startObject();
+        parser.nextKey();
+        parser.readTo(value);
+        while (!parser.nextIsEndObject()) {
+            parser.nextKeyView();
+            parser.skipValue();
+        }
+        parser.endObject();
+        return value;
+    }
+};
+
+/// @brief 引用符付きのキーを書き出すコンバータを含む文書。
+/// @note 書き込み型毎のコンバータのオーバーロードを選ぶため、具体的なフィールド集合の型を返す。
+struct SizeQuotedKeyHolder {
+    int value = 0;
+
+    const auto& serializer() const {
+        static const SizeQuotedKeyConverter converter;
+        static const auto fields = getFieldSet(
+            getRequiredField(&SizeQuotedKeyHolder::value, "value", converter)
+        );
+        return fields;
+    }
+};
+
+}  // namespace
+
+/// @brief estimateJsonSizeが書き出したJSONの長さと一致することを確認する。
+TEST(JsonSizeCounterTest, MatchesWrittenSize) {
+    SizeDocument document;
+    document.escaped = std::string("quote\" back\\ tab\t nul") + '\0' + " ctl\x01 utf8 \xE3\x81\x82";
+    document.letter = '\n';
+    document.symbol = U'\U0001F600';
+    document.unit = u'あ';
+    document.minimum = std::numeric_limits<std::int64_t>::min();
+    document.maximum = std::numeric_limits<std::uint64_t>::max();
+    document.ratio = 0.1;
+    document.infinite = -std::numeric_limits<double>::infinity();
+    document.small = 1.5e-7f;
+    document.flag = true;
+    document.numbers = {0, -1, 22, 333};
+    auto label = std::make_unique<SizeLabel>();
+    label->text = "a\rb";
+    document.shapes.push_back(std::move(label));
+    document.shapes.push_back(nullptr);
+
+    const std::string json = getJsonContent(document);
+    EXPECT_EQ(estimateJsonSize(document), json.size());
+
+    SizeDocument empty;
+    EXPECT_EQ(estimateJsonSize(empty), getJsonContent(empty).size());
+}
+
+/// @brief 識別子として無効なキーを引用符で囲む場合もJsonWriterBaseと一致することを確認する。
+TEST(JsonSizeCounterTest, CountsQuotedKeys) {
+    std::string json;
+    JsonWriterBase<true> writer(json);
+    JsonSizeCounterBase<true> counter;
+    const auto writeBoth = [&](auto&& write) {
+        write(writer);
+        write(counter);
+    };
+    writeBoth([](auto& w) { w.startObject(); });
+    writeBoth([](auto& w) { w.key("plain"); w.writeObject(1); });
+    writeBoth([](auto& w) { w.key("with space"); w.null(); });
+    writeBoth([](auto& w) { w.key("1st\n"); w.startArray(); });
+    writeBoth([](auto& w) { w.writeObject(std::numeric_limits<double>::quiet_NaN()); });
+    writeBoth([](auto& w) { w.writeObject(char8_t{0xE9}); w.writeObject(U'\U00110000'); });
+    writeBoth([](auto& w) { w.endArray(); w.endObject(); });
+    EXPECT_EQ(counter.size(), json.size());
+}
+
+/// @brief 計測したサイズで確保した文字列へ再確保なしに書き込めることを確認する。
+TEST(JsonSizeCounterTest, PresizesBuffer) {
+    SizeDocument document;
+    document.escaped = std::string(1000, '"');
+    document.numbers.assign(500, 123456);
+    std::string json;
+    json.reserve(estimateJsonSize(document));
+    const char* const data = json.data();
+    const std::size_t capacity = json.capacity();
+    writeJsonToBuffer(document, json);
+    EXPECT_EQ(json.size(), estimateJsonSize(document));
+    EXPECT_EQ(json.data(), data);
+    EXPECT_EQ(json.capacity(), capacity);
+}
+
+/// @brief JsonWriterだけに対応するコンバータとwriteFormatも一時的なJsonWriterで計測できることを確認する。
+TEST(JsonSizeCounterTest, CountsJsonOnlyConverters) {
+    SizeJsonOnlyHolder holder;
+    holder.value = 7;
+    holder.custom.name = "x\"y";
+    holder.customs.resize(3);
+    holder.customs[1].name = "second";
+    const std::string json = getJsonContent(holder);
+    EXPECT_EQ(json, "{value:7000,custom:{name:\"x\\\"y\"},customs:[{name:\"\"},{name:\"second\"},{name:\"\"}]}");
+    EXPECT_EQ(estimateJsonSize(holder), json.size());
+}
+
+/// @brief JsonSizeCounterBase<true>の一時的な書き出しも、引用符付きのキーを同じ規則で計測することを確認する。
+TEST(JsonSizeCounterTest, CountsQuotedKeysViaJsonWriter) {
+    SizeQuotedKeyHolder holder;
+    holder.value = 42;
+    std::string json;
+    JsonWriterBase<true> writer(json);
+    writer.startObject();
+    writeSerializerFields(writer, holder.serializer(), holder);
+    writer.endObject();
+    EXPECT_EQ(json, "{value:{\"two words\":42,plain:null}}");
+
+    JsonSizeCounterBase<true> counter;
+    counter.startObject();
+    writeSerializerFields(counter, holder.serializer(), holder);
+    counter.endObject();
+    EXPECT_EQ(counter.size(), json.size());
+}
@@ -0,0 +1,637 @@
+// @file JsonThroughputBench.cpp
+// @brief 代表的な入力に対する読み書きのスループット（MB/s・objects/s）を計測し、基準値と比較するベンチマーク。
+// @note 使い方: RaiSerialization_Bench [--sizes=1K,64K,1M,16M] [--corpus=numbers,strings,...]
+//       [--min-time=0.3] [--iterations=3] [--threads=N] [--out=results.json]
+//       [--baseline=JsonThroughputBaseline.json] [--tolerance=0.15] [--fail-on-regression]
+// @note サイズは1K〜1Gを指定できる。大きなサイズでは、オブジェクトとJSON文字列を同時に保持するため、
+//       サイズの数倍のメモリを使う。MBは10^6byte。書き込みのMB/sは、出力形式に依らずJSONのサイズで割る。
+
+import rai.serialization.field_serializer;
+import rai.serialization.object_converter;
+import rai.serialization.object_serializer;
+import rai.serialization.polymorphic_converter;
+import rai.serialization.json_io;
+import rai.serialization.parallel_file_output_sink;
+import rai.serialization.rai_binary_io;
+import rai.collection.sorted_hash_array_map;
+import rai.common.thread_pool;
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace rai::serialization;
+
+namespace {
+
+// ********************************************************************************
+// 計測対象の型
+// ********************************************************************************
+
+/// @brief 数値の多い要素。
+struct NumberRecord {
+    std::int64_t id = 0;
+    double x = 0.0;
+    double y = 0.0;
+    double z = 0.0;
+    std::vector<int> samples;
+
+    const ObjectSerializer& serializer() const {
+        static const auto samplesConverter = getContainerConverter<decltype(samples)>();
+        static const auto fields = getFieldSet(
+            getRequiredField(&NumberRecord::id, "id"),
+            getRequiredField(&NumberRecord::x, "x"),
+            getRequiredField(&NumberRecord::y, "y"),
+            getRequiredField(&NumberRecord::z, "z"),
+            getRequiredField(&NumberRecord::samples, "samples", samplesConverter)
+        );
+        return fields;
+    }
+};
+
+/// @brief 文字列の多い要素。
+struct StringRecord {
+    std::string title;
+    std::string body;
+    std::vector<std::string> tags;
+
+    const ObjectSerializer& serializer() const {
+        static const auto tagsConverter = getContainerConverter<decltype(tags)>();
+        static const auto fields = getFieldSet(
+            getRequiredField(&StringRecord::title, "title"),
+            getRequiredField(&StringRecord::body, "body"),
+            getRequiredField(&StringRecord::tags, "tags", tagsConverter)
+        );
+        return fields;
+    }
+};
+
+/// @brief 多くのフィールドを持つ要素。
+struct WideRecord {
+    int w00 = 0; double w01 = 0.0; std::string w02; bool w03 = false;
+    int w04 = 0; double w05 = 0.0; std::string w06; bool w07 = false;
+    int w08 = 0; double w09 = 0.0; std::string w10; bool w11 = false;
+    int w12 = 0; double w13 = 0.0; std::string w14; bool w15 = false;
+    int w16 = 0; double w17 = 0.0; std::string w18; bool w19 = false;
+    int w20 = 0; double w21 = 0.0; std::string w22; bool w23 = false;
+
+    const ObjectSerializer& serializer() const {
+        static const auto fields = getFieldSet(
+            getRequiredField(&WideRecord::w00, "w00"), getRequiredField(&WideRecord::w01, "w01"),
+            getRequiredField(&WideRecord::w02, "w02"), getRequiredField(&WideRecord::w03, "w03"),
+            getRequiredField(&WideRecord::w04, "w04"), getRequiredField(&WideRecord::w05, "w05"),
+            getRequiredField(&WideRecord::w06, "w06"), getRequiredField(&WideRecord::w07, "w07"),
+            getRequiredField(&WideRecord::w08, "w08"), getRequiredField(&WideRecord::w09, "w09"),
+            getRequiredField(&WideRecord::w10, "w10"), getRequiredField(&WideRecord::w11, "w11"),
+            getRequiredField(&WideRecord::w12, "w12"), getRequiredField(&WideRecord::w13, "w13"),
+            getRequiredField(&WideRecord::w14, "w14"), getRequiredField(&WideRecord::w15, "w15"),
+            getRequiredField(&WideRecord::w16, "w16"), getRequiredField(&WideRecord::w17, "w17"),
+            getRequiredField(&WideRecord::w18, "w18"), getRequiredField(&WideRecord::w19, "w19"),
+            getRequiredField(&WideRecord::w20, "w20"), getRequiredField(&WideRecord::w21, "w21"),
+            getRequiredField(&WideRecord::w22, "w22"), getRequiredField(&WideRecord::w23, "w23")
+        );
+        return fields;
+    }
+};
+
+/// @brief WideRecordのJSONを、2つのフィールド以外を未知キーとして読む要素。
+struct NarrowRecord {
+    int w00 = 0;
+    std::string w22;
+
+    const ObjectSerializer& serializer() const {
+        static const auto fields = getFieldSet(
+            getRequiredField(&NarrowRecord::w00, "w00"),
+            getRequiredField(&NarrowRecord::w22, "w22")
+        );
+        return fields;
+    }
+};
+
+/// @brief ポリモーフィックな木の節の基底クラス。
+struct BenchShape {
+    std::int64_t id = 0;
+
+    virtual ~BenchShape() = default;
+
+    virtual const ObjectSerializer& serializer() const {
+        static const auto fields = getFieldSet(
+            getRequiredField(&BenchShape::id, "id")
+        );
+        return fields;
+    }
+};
+
+/// @brief 木の葉。
+struct BenchLeaf : BenchShape {
+    double weight = 0.0;
+    std::string label;
+
+    const ObjectSerializer& serializer() const override {
+        static const auto fields = getFieldSet(
+            getRequiredField(&BenchShape::id, "id"),
+            getRequiredField(&BenchLeaf::weight, "weight"),
+            getRequiredField(&BenchLeaf::label, "label")
+        );
+        return fields;
+    }
+};
+
+/// @brief 子を持つ木の節。
+struct BenchGroup : BenchShape {
+    std::vector<std::unique_ptr<BenchShape>> children;
+
+    const ObjectSerializer& serializer() const override;
+};
+
+using BenchShapeEntry = std::pair<std::string_view,
+    PolymorphicTypeFactory<std::unique_ptr<BenchShape>>>;
+
+/// @brief BenchShapeの型名と生成関数の対応表を返す。
+const auto& benchShapeEntries() {
+    static const auto entries = rai::collection::makeSortedHashArrayMap(
+        BenchShapeEntry{std::string_view("Leaf"), []() { return std::make_unique<BenchLeaf>(); }},
+        BenchShapeEntry{std::string_view("Group"), []() { return std::make_unique<BenchGroup>(); }}
+    );
+    return entries;
+}
+
+// 対応表がBenchGroupを生成するため、シリアライザーは対応表の後で定義する。
+const ObjectSerializer& BenchGroup::serializer() const {
+    static const auto childrenConverter =
+        getPolymorphicArrayConverter<decltype(children)>(benchShapeEntries());
+    static const auto fields = getFieldSet(
+        getRequiredField(&BenchShape::id, "id"),
+        getRequiredField(&BenchGroup::children, "children", childrenConverter)
+    );
+    return fields;
+}
+
+/// @brief 要素の配列を1つ持つ文書。
+/// @tparam Record 要素の型。
+template <typename Record>
+struct BenchDocument {
+    std::vector<Record> records;
+
+    const ObjectSerializer& serializer() const {
+        static const auto recordsConverter = getContainerConverter<decltype(records)>();
+        static const auto fields = getFieldSet(
+            getRequiredField(&BenchDocument::records, "records", recordsConverter)
+        );
+        return fields;
+    }
+};
+
+/// @brief ポリモーフィックな木の配列を持つ文書。
+struct BenchForest {
+    std::vector<std::unique_ptr<BenchShape>> records;
+
+    const ObjectSerializer& serializer() const {
+        static const auto recordsConverter =
+            getPolymorphicArrayConverter<decltype(records)>(benchShapeEntries());
+        static const auto fields = getFieldSet(
+            getRequiredField(&BenchForest::records, "records", recordsConverter)
+        );
+        return fields;
+    }
+};
+
+// ********************************************************************************
+// 入力の生成
+// ********************************************************************************
+
+/// @brief i番目の数値の要素を作る。
+NumberRecord makeNumberRecord(std::size_t i) {
+    NumberRecord record;
+    record.id = static_cast<std::int64_t>(i) * 7919;
+    record.x = static_cast<double>(i) * 0.125;
+    record.y = -static_cast<double>(i) / 3.0;
+    record.z = 1.0e-3 * static_cast<double>(i % 1000);
+    for (int k = 0; k < 8; ++k) {
+        record.samples.push_back(static_cast<int>((i * 31 + k * 17) % 100000) - 50000);
+    }
+    return record;
+}
+
+/// @brief i番目の文字列の要素を作る。
+StringRecord makeStringRecord(std::size_t i) {
+    StringRecord record;
+    record.title = "record title " + std::to_string(i);
+    record.body = "Line one of entry " + std::to_string(i) +
+        ".\nIt has \"quotes\", a tab\tand caf\xC3\xA9 characters, repeated to make a longer body. "
+        "Lorem ipsum dolor sit amet, consectetur adipiscing elit.";
+    record.tags = {"alpha", "beta" + std::to_string(i % 10), "gamma"};
+    return record;
+}
+
+/// @brief i番目の多くのフィールドを持つ要素を作る。
+WideRecord makeWideRecord(std::size_t i) {
+    const int n = static_cast<int>(i);
+    const double d = static_cast<double>(i) * 0.5;
+    const std::string s = "v" + std::to_string(i);
+    return WideRecord{n, d, s, true, n + 1, d + 1, s + "a", false, n + 2, d + 2, s + "b", true,
+        n + 3, d + 3, s + "c", false, n + 4, d + 4, s + "d", true, n + 5, d + 5, s + "e", false};
+}
+
+/// @brief 深さdepthの二分木を作る。
+/// @param nextId 次に割り当てる節の番号。
+std::unique_ptr<BenchShape> makeBenchTree(int depth, std::int64_t& nextId) {
+    if (depth == 0) {
+        auto leaf = std::make_unique<BenchLeaf>();
+        leaf->id = nextId++;
+        leaf->weight = static_cast<double>(leaf->id) * 0.01;
+        leaf->label = "leaf" + std::to_string(leaf->id);
+        return leaf;
+    }
+    auto group = std::make_unique<BenchGroup>();
+    group->id = nextId++;
+    group->children.push_back(makeBenchTree(depth - 1, nextId));
+    group->children.push_back(makeBenchTree(depth - 1, nextId));
+    return group;
+}
+
+constexpr int benchTreeDepth = 6;  ///< 木の深さ。1本の木は127個の節を持つ。
+constexpr std::size_t benchTreeNodes = (std::size_t{1} << (benchTreeDepth + 1)) - 1;
+
+/// @brief 要素数countの文書を作る。
+template <typename Document, typename Make>
+Document makeBenchDocument(std::size_t count, Make make) {
+    Document document;
+    document.records.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        document.records.push_back(make(i));
+    }
+    return document;
+}
+
+/// @brief JSONのサイズが目標に届く要素数を、少数の要素から見積もる。
+template <typename Document, typename Make>
+std::size_t estimateRecordCount(std::size_t targetBytes, Make make) {
+    constexpr std::size_t sampleCount = 16;
+    const Document sample = makeBenchDocument<Document>(sampleCount, make);
+    const std::size_t perRecord = std::max<std::size_t>(estimateJsonSize(sample) / sampleCount, 1);
+    return std::max<std::size_t>(targetBytes / perRecord, 1);
+}
+
+// ********************************************************************************
+// 計測
+// ********************************************************************************
+
+/// @brief 計測の設定。
+struct BenchOptions {
+    std::vector<std::string> sizes{"1K", "64K", "1M", "16M"};  ///< 入力のサイズ。
+    std::vector<std::string> corpora;   ///< 計測する入力の種類（空なら全て）。
+    double minSeconds = 0.3;            ///< 1つの計測に使う最低時間（秒）。
+    int minIterations = 3;              ///< 1つの計測の最低反復回数。
+    std::size_t threads = 0;            ///< 0なら既定の実行器を使う。
+    std::string outPath;                ///< 結果の書き出し先（空なら書き出さない）。
+    std::string baselinePath;           ///< 比較する基準値（空なら比較しない）。
+    double tolerance = 0.15;            ///< 基準値から許容する低下率。
+    bool failOnRegression = false;      ///< 低下があれば終了コード1で終える。
+};
+
+/// @brief 1つの計測結果。
+struct BenchResult {
+    std::string corpus;                 ///< 入力の種類。
+    std::string size;                   ///< 指定したサイズ（"64K"など）。
+    std::string operation;              ///< 計測した操作。
+    std::int64_t bytes = 0;             ///< JSONのサイズ（byte）。
+    std::int64_t objects = 0;           ///< 要素（木の場合は節）の数。
+    std::int64_t iterations = 0;        ///< 反復回数。
+    double seconds = 0.0;               ///< 1回あたりの時間の中央値（秒）。
+    double megabytesPerSecond = 0.0;    ///< スループット（MB/s）。
+    double objectsPerSecond = 0.0;      ///< 要素のスループット（objects/s）。
+
+    const ObjectSerializer& serializer() const {
+        static const auto fields = getFieldSet(
+            getRequiredField(&BenchResult::corpus, "corpus"),
+            getRequiredField(&BenchResult::size, "size"),
+            getRequiredField(&BenchResult::operation, "operation"),
+            getRequiredField(&BenchResult::bytes, "bytes"),
+            getRequiredField(&BenchResult::objects, "objects"),
+            getRequiredField(&BenchResult::iterations, "iterations"),
+            getRequiredField(&BenchResult::seconds, "seconds"),
+            getRequiredField(&BenchResult::megabytesPerSecond, "megabytesPerSecond"),
+            getRequiredField(&BenchResult::objectsPerSecond, "objectsPerSecond")
+        );
+        return fields;
+    }
+};
+
+/// @brief 計測結果の一覧（結果と基準値のファイルの形式）。
+struct BenchReport {
+    std::vector<BenchResult> results;
+
+    const ObjectSerializer& serializer() const {
+        static const auto resultsConverter = getContainerConverter<decltype(results)>();
+        static const auto fields = getFieldSet(
+            getRequiredField(&BenchReport::results, "results", resultsConverter)
+        );
+        return fields;
+    }
+
+    /// @brief 同じ入力・サイズ・操作の結果を探す。
+    const BenchResult* find(const BenchResult& key) const {
+        for (const auto& result : results) {
+            if (result.corpus == key.corpus && result.size == key.size &&
+                result.operation == key.operation) {
+                return &result;
+            }
+        }
+        return nullptr;
+    }
+};
+
+/// @brief 計測結果をファイルに書き出す。
+/// @note 基準値の差分を読みやすくするため、結果を1行に1つずつ書く。readJsonFileでそのまま読める。
+void writeBenchReport(const BenchReport& report, const std::string& filename) {
+    std::ofstream ofs(filename, std::ios::binary);
+    ofs << "{results:[\n";
+    for (std::size_t i = 0; i < report.results.size(); ++i) {
+        ofs << "  " << getJsonContent(report.results[i]) << (i + 1 < report.results.size() ? ",\n" : "\n");
+    }
+    ofs << "]}\n";
+    if (!ofs) {
+        throw std::runtime_error("cannot write " + filename);
+    }
+}
+
+/// @brief 操作を繰り返し実行し、1回あたりの時間の中央値を返す。
+/// @param options 計測の設定。
+/// @param run 1回分の操作。戻り値は計測した時間（秒）。準備や後始末を計測から除けるよう、時間は操作側で測る。
+/// @param iterationsOut 反復回数の格納先。
+double measureMedianSeconds(const BenchOptions& options, const std::function<double()>& run,
+    std::int64_t& iterationsOut) {
+    run();  // ウォームアップ
+    std::vector<double> samples;
+    double total = 0.0;
+    while (static_cast<int>(samples.size()) < options.minIterations || total < options.minSeconds) {
+        samples.push_back(run());
+        total += samples.back();
+        if (samples.size() >= 1000) {
+            break;
+        }
+    }
+    std::sort(samples.begin(), samples.end());
+    iterationsOut = static_cast<std::int64_t>(samples.size());
+    return samples[samples.size() / 2];
+}
+
+/// @brief 関数の実行時間（秒）を返す。
+template <typename Function>
+double timeSeconds(Function&& function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/// @brief 1つの入力とサイズに対する計測を行う。
+class BenchRunner {
+public:
+    BenchRunner(const BenchOptions& options, rai::common::Executor& executor, BenchReport& report)
+        : options_(options), executor_(executor), report_(report) {}
+
+    /// @brief 読み込み（文字列・逐次・並列・mmap）と書き込み（文字列・ファイル・RaiBinary）を計測する。
+    /// @tparam Document 書き出す文書の型。
+    /// @tparam ReadDocument 読み込む文書の型（未知キーの多い入力ではDocumentと異なる）。
+    template <typename Document, typename ReadDocument = Document>
+    void run(const std::string& corpus, const std::string& size, const Document& document,
+        std::size_t objects, bool measureWriters = true) {
+        const std::string json = getJsonContent(document);
+        const auto path = std::filesystem::temp_directory_path() /
+            ("rai_bench_" + corpus + "_" + size + ".json");
+        const std::string filename = path.string();
+        writeJsonFile(document, filename);
+
+        auto record = [&](const std::string& operation, const std::function<double()>& function) {
+            BenchResult result{corpus, size, operation, static_cast<std::int64_t>(json.size()),
+                static_cast<std::int64_t>(objects)};
+            result.seconds = measureMedianSeconds(options_, function, result.iterations);
+            result.megabytesPerSecond = static_cast<double>(json.size()) / 1.0e6 / result.seconds;
+            result.objectsPerSecond = static_cast<double>(objects) / result.seconds;
+            print(result);
+            report_.results.push_back(std::move(result));
+        };
+        auto reader = [&](auto read) {
+            return [&, read]() {
+                ReadDocument loaded;
+                std::vector<std::string> unknownKeys;
+                return timeSeconds([&] { read(loaded, unknownKeys); });
+            };
+        };
+
+        record("readJsonString", reader([&](ReadDocument& out, std::vector<std::string>& keys) {
+            readJsonString(json, out, keys, executor_);
+        }));
+        record("readJson", reader([&](ReadDocument& out, std::vector<std::string>& keys) {
+            readJson(std::string_view(json), out, keys, executor_);
+        }));
+        record("readJsonFileSequential", reader([&](ReadDocument& out, std::vector<std::string>& keys) {
+            readJsonFileSequential(filename, out, keys, executor_);
+        }));
+        record("readJsonFileParallel", reader([&](ReadDocument& out, std::vector<std::string>& keys) {
+            readJsonFileParallel(filename, out, keys, executor_);
+        }));
+        record("readJsonFileMapped", reader([&](ReadDocument& out, std::vector<std::string>& keys) {
+            readJsonFileMapped(filename, out, keys, executor_);
+        }));
+        if (measureWriters) {
+            const std::string outputName = filename + ".out";
+            record("getJsonContent", [&]() {
+                std::string output;
+                return timeSeconds([&] { output = getJsonContent(document); });
+            });
+            record("writeJsonFile", [&]() {
+                return timeSeconds([&] { writeJsonFile(document, outputName, FileWriteOptions{}, executor_); });
+            });
+            record("getRaiBinaryContent", [&]() {
+                std::string output;
+                return timeSeconds([&] { output = getRaiBinaryContent(document); });
+            });
+            std::filesystem::remove(outputName);
+        }
+        std::filesystem::remove(path);
+    }
+
+    /// @brief 比較する基準値を設定する。
+    void setBaseline(const BenchReport* baseline) { baseline_ = baseline; }
+
+    /// @brief 基準値より遅くなった計測の数を返す。
+    int regressions() const { return regressions_; }
+
+private:
+    /// @brief 結果を1行で出力する。基準値があれば比較する。
+    void print(const BenchResult& result) {
+        std::cout << std::left << std::setw(12) << result.corpus << std::setw(6) << result.size
+                  << std::setw(24) << result.operation << std::right << std::setw(12)
+                  << result.bytes << " B " << std::fixed << std::setprecision(1) << std::setw(10)
+                  << result.megabytesPerSecond << " MB/s " << std::setprecision(0) << std::setw(12)
+                  << result.objectsPerSecond << " obj/s";
+        if (baseline_) {
+            if (const BenchResult* base = baseline_->find(result)) {
+                const double ratio = result.megabytesPerSecond / base->megabytesPerSecond;
+                std::cout << std::setprecision(1) << std::setw(8) << (ratio - 1.0) * 100.0 << " %";
+                if (ratio < 1.0 - options_.tolerance) {
+                    std::cout << "  REGRESSION";
+                    ++regressions_;
+                }
+            }
+        }
+        std::cout << "\n";
+    }
+
+    const BenchOptions& options_;
+    rai::common::Executor& executor_;
+    BenchReport& report_;
+    const BenchReport* baseline_ = nullptr;
+    int regressions_ = 0;
+};
+
+/// @brief "64K"などのサイズ指定をbyte数に変換する。
+std::size_t parseSize(const std::string& text) {
+    std::size_t scale = 1;
+    std::string digits = text;
+    switch (text.empty() ? '\0' : text.back()) {
+    case 'K': case 'k': scale = std::size_t{1} << 10; digits.pop_back(); break;
+    case 'M': case 'm': scale = std::size_t{1} << 20; digits.pop_back(); break;
+    case 'G': case 'g': scale = std::size_t{1} << 30; digits.pop_back(); break;
+    default: break;
+    }
+    if (digits.empty() || digits.find_first_not_of("0123456789") != std::string::npos) {
+        throw std::runtime_error("invalid size: " + text);
+    }
+    return static_cast<std::size_t>(std::stoull(digits)) * scale;
+}
+
+/// @brief カンマ区切りの文字列を分割する。
+std::vector<std::string> splitList(std::string_view text) {
+    std::vector<std::string> items;
+    while (!text.empty()) {
+        const std::size_t comma = text.find(',');
+        items.emplace_back(text.substr(0, comma));
+        text = comma == std::string_view::npos ? std::string_view{} : text.substr(comma + 1);
+    }
+    return items;
+}
+
+/// @brief コマンドライン引数を解釈する。
+BenchOptions parseOptions(int argc, char** argv) {
+    BenchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        auto value = [&](std::string_view name) -> std::optional<std::string> {
+            if (arg.starts_with(name) && arg.size() > name.size() && arg[name.size()] == '=') {
+                return std::string(arg.substr(name.size() + 1));
+            }
+            return std::nullopt;
+        };
+        if (auto v = value("--sizes")) {
+            options.sizes = splitList(*v);
+        } else if (auto v = value("--corpus")) {
+            options.corpora = splitList(*v);
+        } else if (auto v = value("--min-time")) {
+            options.minSeconds = std::stod(*v);
+        } else if (auto v = value("--iterations")) {
+            options.minIterations = std::max(std::stoi(*v), 1);
+        } else if (auto v = value("--threads")) {
+            options.threads = static_cast<std::size_t>(std::stoul(*v));
+        } else if (auto v = value("--out")) {
+            options.outPath = *v;
+        } else if (auto v = value("--baseline")) {
+            options.baselinePath = *v;
+        } else if (auto v = value("--tolerance")) {
+            options.tolerance = std::stod(*v);
+        } else if (arg == "--fail-on-regression") {
+            options.failOnRegression = true;
+        } else {
+            throw std::runtime_error("unknown option: " + std::string(arg));
+        }
+    }
+    return options;
+}
+
+/// @brief 指定した入力の種類を計測するかを返す。
+bool selected(const BenchOptions& options, std::string_view corpus) {
+    return options.corpora.empty() ||
+        std::find(options.corpora.begin(), options.corpora.end(), corpus) != options.corpora.end();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const BenchOptions options = parseOptions(argc, argv);
+        std::unique_ptr<rai::common::ThreadPool> pool;
+        if (options.threads != 0) {
+            pool = std::make_unique<rai::common::ThreadPool>(options.threads);
+        }
+        rai::common::Executor& executor = pool ? *pool : rai::common::getDefaultExecutor();
+
+        BenchReport baseline;
+        BenchReport report;
+        BenchRunner runner(options, executor, report);
+        if (!options.baselinePath.empty()) {
+            readJsonFile(options.baselinePath, baseline);
+            runner.setBaseline(&baseline);
+        }
+
+        for (const std::string& size : options.sizes) {
+            const std::size_t target = parseSize(size);
+            if (selected(options, "numbers")) {
+                using Document = BenchDocument<NumberRecord>;
+                const std::size_t count = estimateRecordCount<Document>(target, makeNumberRecord);
+                runner.run("numbers", size, makeBenchDocument<Document>(count, makeNumberRecord), count);
+            }
+            if (selected(options, "strings")) {
+                using Document = BenchDocument<StringRecord>;
+                const std::size_t count = estimateRecordCount<Document>(target, makeStringRecord);
+                runner.run("strings", size, makeBenchDocument<Document>(count, makeStringRecord), count);
+            }
+            if (selected(options, "polymorphic")) {
+                std::int64_t nextId = 0;
+                auto makeTree = [&](std::size_t) { return makeBenchTree(benchTreeDepth, nextId); };
+                const std::size_t count = estimateRecordCount<BenchForest>(target, makeTree);
+                runner.run("polymorphic", size, makeBenchDocument<BenchForest>(count, makeTree),
+                    count * benchTreeNodes);
+            }
+            if (selected(options, "wide") || selected(options, "unknown")) {
+                using Document = BenchDocument<WideRecord>;
+                const std::size_t count = estimateRecordCount<Document>(target, makeWideRecord);
+                const Document document = makeBenchDocument<Document>(count, makeWideRecord);
+                if (selected(options, "wide")) {
+                    runner.run("wide", size, document, count);
+                }
+                if (selected(options, "unknown")) {
+                    // 24個のフィールドのうち22個を未知キーとして読み飛ばす。書き込みはwideと同じため計測しない。
+                    runner.run<Document, BenchDocument<NarrowRecord>>("unknown", size, document, count, false);
+                }
+            }
+        }
+
+        if (!options.outPath.empty()) {
+            writeBenchReport(report, options.outPath);
+        }
+        if (runner.regressions() > 0) {
+            std::cout << runner.regressions() << " result(s) slower than the baseline by more than "
+                      << std::setprecision(0) << options.tolerance * 100.0 << " %\n";
+            return options.failOnRegression ? 1 : 0;
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "RaiSerialization_Bench: " << e.what() << "\n";
+        return 2;
+    }
+}
@@ -0,0 +1,147 @@
+import rai.serialization.token_manager;
+import rai.serialization.json_tokenizer;
+import rai.serialization.json_parser;
+import rai.serialization.reading_ahead_buffer;
+import rai.serialization.parallel_input_stream_source;
+#include <gtest/gtest.h>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace rai::serialization;
+
+namespace {
+
+/// @brief JSON文字列をトークン化し、トークン列を返す補助関数。
+/// @param json 入力文字列。
+/// @param tokens トークンの格納先（文字列の解決に使う）。
+/// @param inputSource 入力元の格納先（文字列の解決に使うため呼び出し元で保持する）。
+std::vector<JsonToken> tokenizeAll(const std::string& json, TokenManager& tokens,
+    std::unique_ptr<ReadingAheadBuffer>& inputSource) {
+    constexpr std::size_t aheadSize = 8;
+    std::string buffer = json;
+    buffer.reserve(buffer.size() + aheadSize);
+    inputSource = std::make_unique<ReadingAheadBuffer>(std::move(buffer), aheadSize);
+    StdoutMessageOutput warningOutput;
+    JsonTokenizer<ReadingAheadBuffer, TokenManager> tokenizer(*inputSource, tokens, warningOutput);
+    tokenizer.tokenize();
+
+    std::vector<JsonToken> result;
+    for (;;) {
+        result.push_back(tokens.take());
+        if (result.back().type == JsonTokenType::EndOfStream) {
+            return result;
+        }
+    }
+}
+
+}  // namespace
+
+// ********************************************************************************
+// テストカテゴリ：JsonToken
+// ********************************************************************************
+
+/// @brief エスケープを含まない文字列・キーは入力バッファを参照することのテスト。
+TEST(JsonTokenTest, PlainStringsReferToInput) {
+    TokenManager tokens;
+    std::unique_ptr<ReadingAheadBuffer> input;
+    auto result = tokenizeAll("{name:\"plain\",'key':'value',null:1}", tokens, input);
+
+    ASSERT_EQ(result.size(), 9u);
+    EXPECT_EQ(result[1].type, JsonTokenType::Key);
+    EXPECT_EQ(tokens.text(result[1]), "name");
+    EXPECT_EQ(result[2].type, JsonTokenType::String);
+    EXPECT_EQ(tokens.text(result[2]), "plain");
+    EXPECT_EQ(tokens.text(result[3]), "key");
+    EXPECT_EQ(tokens.text(result[4]), "value");
+    EXPECT_EQ(tokens.text(result[5]), "null");
+    for (std::size_t i = 1; i <= 5; ++i) {
+        EXPECT_EQ(result[i].flags & JsonToken::arenaStringFlag, 0) << i;
+    }
+    EXPECT_EQ(result[6].type, JsonTokenType::Integer);
+    EXPECT_EQ(result[6].integer, 1);
+}
+
+/// @brief エスケープを含む文字列・識別子は文字列アリーナに復号されることのテスト。
+TEST(JsonTokenTest, EscapedStringsUseArena) {
+    TokenManager tokens;
+    std::unique_ptr<ReadingAheadBuffer> input;
+    auto result = tokenizeAll(R"({k\u0065y:"a\tb\u00e9",plain:"x\\"})", tokens, input);
+
+    ASSERT_EQ(result.size(), 7u);
+    EXPECT_NE(result[1].flags & JsonToken::arenaStringFlag, 0);
+    EXPECT_EQ(tokens.text(result[1]), "key");
+    EXPECT_NE(result[2].flags & JsonToken::arenaStringFlag, 0);
+    EXPECT_EQ(tokens.text(result[2]), "a\tb\xC3\xA9");
+    EXPECT_EQ(result[3].flags & JsonToken::arenaStringFlag, 0);
+    EXPECT_EQ(tokens.text(result[4]), "x\\");
+}
+
+/// @brief チャンク容量を超える文字列がアリーナ内で連続領域に保たれることのテスト。
+TEST(JsonTokenTest, LongEscapedStringGrowsArena) {
+    const std::string body(3 * 1024 * 1024, 'z');
+    TokenManager tokens;
+    std::unique_ptr<ReadingAheadBuffer> input;
+    auto result = tokenizeAll("[\"\\n" + body + "\",\"\\t\"]", tokens, input);
+
+    ASSERT_EQ(result.size(), 5u);
+    const std::string_view text = tokens.text(result[1]);
+    ASSERT_EQ(text.size(), body.size() + 1);
+    EXPECT_EQ(text.front(), '\n');
+    EXPECT_EQ(text.substr(1), body);
+    EXPECT_EQ(tokens.text(result[2]), "\t");
+}
+
+/// @brief 入力バッファを参照できない入力元では、全ての文字列がアリーナに格納されることのテスト。
+TEST(JsonTokenTest, StreamInputCopiesStringsToArena) {
+    std::istringstream stream("{first:\"one\",second:\"t\\u0077o\"}");
+    ParallelInputStreamSource inputSource(stream);
+    TokenManager tokens;
+    StdoutMessageOutput warningOutput;
+    JsonTokenizer<ParallelInputStreamSource, TokenManager> tokenizer(
+        inputSource, tokens, warningOutput);
+    tokenizer.tokenize();
+
+    std::vector<std::string> texts;
+    for (auto token = tokens.take(); token.type != JsonTokenType::EndOfStream;
+         token = tokens.take()) {
+        if (token.type == JsonTokenType::Key || token.type == JsonTokenType::String) {
+            EXPECT_NE(token.flags & JsonToken::arenaStringFlag, 0);
+            texts.emplace_back(tokens.text(token));
+        }
+    }
+    EXPECT_EQ(texts, (std::vector<std::string>{"first", "one", "second", "two"}));
+}
+
+/// @brief nextKeyView()とreadTo(std::string_view&)がトークンの格納先を参照することのテスト。
+TEST(JsonTokenTest, ParserViewsBorrowTokenStorage) {
+    TokenManager tokens;
+    std::unique_ptr<ReadingAheadBuffer> input;
+    std::string json = "{plain:\"abc\",'esc\\u0061ped':\"x\\ny\"}";
+    json.reserve(json.size() + 8);
+    input = std::make_unique<ReadingAheadBuffer>(std::move(json), 8);
+    StdoutMessageOutput warningOutput;
+    JsonTokenizer<ReadingAheadBuffer, TokenManager> tokenizer(*input, tokens, warningOutput);
+    tokenizer.tokenize();
+
+    JsonParser parser(tokens);
+    parser.startObject();
+    const std::string_view firstKey = parser.nextKeyView();
+    std::string_view firstValue;
+    parser.readTo(firstValue);
+    const std::string_view secondKey = parser.nextKeyView();
+    std::string_view secondValue;
+    parser.readTo(secondValue);
+    parser.endObject();
+
+    // エスケープなしは入力バッファ内を直接参照する。
+    EXPECT_EQ(firstKey, "plain");
+    EXPECT_EQ(firstKey.data(), input->data() + 1);
+    EXPECT_EQ(firstValue, "abc");
+    // 後続トークンを読んでも、先に取得したビューは有効なまま。
+    EXPECT_EQ(secondKey, "escaped");
+    EXPECT_EQ(secondValue, "x\ny");
+    EXPECT_EQ(firstValue, "abc");
+}
@@ -0,0 +1,185 @@
+import rai.serialization.json_writer;
+import rai.serialization.field_serializer;
+import rai.serialization.object_converter;
+import rai.serialization.object_serializer;
+import rai.serialization.json_io;
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace rai::serialization;
+
+namespace {
+
+/// @brief 書き出し先の比較に使うテスト用構造体。
+struct WriterRecord {
+    int id = 0;
+    std::string text;
+
+    const ObjectSerializer& serializer() const {
+        static const auto fields = getFieldSet(
+            getRequiredField(&WriterRecord::id, "id"),
+            getRequiredField(&WriterRecord::text, "text")
+        );
+        return fields;
+    }
+};
+
+/// @brief 書き出し先の比較に使うテスト用のルート構造体。
+struct WriterDocument {
+    std::vector<WriterRecord> records;
+
+    const ObjectSerializer& serializer() const {
+        static const auto recordsConverter = getContainerConverter<decltype(records)>();
+        static const auto fields = getFieldSet(
+            getRequiredField(&WriterDocument::records, "records", recordsConverter)
+        );
+        return fields;
+    }
+};
+
+/// @brief テスト用のドキュメントを生成する補助関数。
+WriterDocument makeWriterDocument() {
+    WriterDocument document;
+    for (int i = 0; i < 200; ++i) {
+        document.records.push_back({i, "text \"" + std::to_string(i) + "\"\n"});
+    }
+    return document;
+}
+
+}  // namespace
+
+// ********************************************************************************
+// テストカテゴリ：JsonWriter
+// ********************************************************************************
+
+/// @brief 全てのbyteが表引きで正しくエスケープされることのテスト。
+TEST(JsonWriterTest, EscapesEveryByte) {
+    std::string input;
+    for (int c = 0; c < 256; ++c) {
+        input += static_cast<char>(c);
+    }
+    std::string expected = "\"";
+    for (int c = 0; c < 256; ++c) {
+        switch (c) {
+            case '"':  expected += "\\\""; break;
+            case '\\': expected += "\\\\"; break;
+            case '\b': expected += "\\b"; break;
+            case '\f': expected += "\\f"; break;
+            case '\n': expected += "\\n"; break;
+            case '\r': expected += "\\r"; break;
+            case '\t': expected += "\\t"; break;
+            case '\v': expected += "\\v"; break;
+            case '\0': expected += "\\0"; break;
+            default:
+                if (c < 0x20) {
+                    char buf[7];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    expected += buf;
+                } else {
+                    expected += static_cast<char>(c);
+                }
+                break;
+        }
+    }
+    expected += "\"";
+
+    std::string out;
+    JsonWriter writer(out);
+    writer.writeObject(std::string_view(input));
+    EXPECT_EQ(out, expected);
+}
+
+/// @brief 出力先コールバックへ分割して渡した内容が、文字列への出力と一致することのテスト。
+TEST(JsonWriterTest, SinkReceivesChunks) {
+    const WriterDocument document = makeWriterDocument();
+    const std::string expected = getJsonContent(document);
+
+    std::string joined;
+    std::size_t chunkCount = 0;
+    writeJsonToSink(document, [&](std::span<const char> data) {
+        EXPECT_FALSE(data.empty());
+        joined.append(data.data(), data.size());
+        ++chunkCount;
+    }, 256);
+    EXPECT_EQ(joined, expected);
+    EXPECT_GT(chunkCount, 1u);
+
+    // 既存の内容の後ろに追記される。
+    std::string appended = "prefix";
+    writeJsonToBuffer(document, appended);
+    EXPECT_EQ(appended, "prefix" + expected);
+}
+
+/// @brief ストリームとファイルへの出力が文字列への出力と一致することのテスト。
+TEST(JsonWriterTest, StreamAndFileMatchString) {
+    const WriterDocument document = makeWriterDocument();
+    const std::string expected = getJsonContent(document);
+
+    std::ostringstream oss;
+    writeJsonToBuffer(document, oss);
+    EXPECT_EQ(oss.str(), expected);
+
+    const std::string filename = "test_writer_output.json";
+    writeJsonFile(document, filename);
+    std::ifstream ifs(filename, std::ios::binary);
+    const std::string fileContent((std::istreambuf_iterator<char>(ifs)),
+        std::istreambuf_iterator<char>());
+    ifs.close();
+    std::remove(filename.c_str());
+    EXPECT_EQ(fileContent, expected);
+
+    EXPECT_THROW(writeJsonFile(document, "missing_dir/test_writer_output.json"),
+        std::runtime_error);
+}
+
+/// @brief ストリームを渡したJsonWriterは、flush()なしでも書き込み直後にストリームへ出力することのテスト。
+TEST(JsonWriterTest, StreamWriterWritesThrough) {
+    const WriterDocument document = makeWriterDocument();
+    const std::string expected = getJsonContent(document);
+
+    std::ostringstream oss;
+    JsonWriter writer(oss);
+    writer.startObject();
+    EXPECT_EQ(oss.str(), "{");
+    writer.key("id");
+    writer.writeObject(1);
+    EXPECT_EQ(oss.str(), "{id:1");
+    writer.endObject();
+    EXPECT_EQ(oss.str(), "{id:1}");
+
+    // 従来の使い方：書き出した直後にストリームの内容を取り出す。
+    std::ostringstream documentStream;
+    JsonWriter documentWriter(documentStream);
+    documentWriter.startObject();
+    writeSerializerFields(documentWriter, document.serializer(), document);
+    documentWriter.endObject();
+    EXPECT_EQ(documentStream.str(), expected);
+}
+
+/// @brief 整形済みキーが先頭要素ではカンマなし、以降はカンマ付きで書き出されることのテスト。
+TEST(JsonWriterTest, PreparedKeysEmitCommaAndQuotes) {
+    const auto first = JsonWriter::prepareKey("first");
+    const auto second = JsonWriter::prepareKey("second");
+    std::string out;
+    {
+        JsonWriter writer(out);
+        writer.startObject();
+        writer.key(first);
+        writer.writeObject(1);
+        writer.key(second);
+        writer.writeObject(2);
+        writer.endObject();
+    }
+    EXPECT_EQ(out, "{first:1,second:2}");
+
+    // 識別子として無効なキーは、整形時にエスケープ付きで引用符に囲まれる。
+    const auto quoted = JsonWriterBase<true>::prepareKey("a \"b\"");
+    EXPECT_EQ(quoted.withComma(), ",\"a \\\"b\\\"\":");
+    EXPECT_EQ(quoted.withoutComma(), "\"a \\\"b\\\"\":");
+}
@@ -0,0 +1,128 @@
+import rai.serialization.mmap_input_source;
+import rai.serialization.field_serializer;
+import rai.serialization.object_converter;
+import rai.serialization.object_serializer;
+import rai.serialization.json_io;
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace rai::serialization;
+
+namespace {
+
+/// @brief テスト用のファイルを書き出す補助関数。
+/// @param filename 出力先のファイル名。
+/// @param content 書き出す内容。
+void writeTextFile(const std::string& filename, const std::string& content) {
+    std::ofstream ofs(filename, std::ios::binary | std::ios::trunc);
+    ofs << content;
+}
+
+}  // namespace
+
+// ********************************************************************************
+// テストカテゴリ：MmapInputSource
+// ********************************************************************************
+
+/// @brief ファイル全体を順に読み、末尾以降は'\0'が返ることのテスト。
+TEST(MmapInputSourceTest, ReadsWholeFileAndSentinel) {
+    const std::string filename = "test_mmap_input.json";
+    std::string content;
+    for (int i = 0; i < 1000; ++i) {
+        content += static_cast<char>('a' + i % 26);
+    }
+    writeTextFile(filename, content);
+    {
+        constexpr std::size_t aheadSize = 8;
+        MmapInputSource input(filename, aheadSize);
+        ASSERT_EQ(input.size(), content.size());
+        for (std::size_t i = 0; i < content.size(); ++i) {
+            ASSERT_EQ(input.position(), i);
+            for (std::size_t offset = 0; offset < aheadSize; ++offset) {
+                const char expected = i + offset < content.size() ? content[i + offset] : '\0';
+                ASSERT_EQ(input.peekAhead(offset), expected) << i << "+" << offset;
+            }
+            input.consume();
+        }
+        EXPECT_EQ(input.peekAhead(0), '\0');
+        EXPECT_EQ(std::string(input.data(), input.size()), content);
+    }
+    std::remove(filename.c_str());
+}
+
+/// @brief 先読みbyte数以下の小さなファイルと空ファイルを扱えることのテスト。
+TEST(MmapInputSourceTest, HandlesTinyAndEmptyFiles) {
+    const std::string filename = "test_mmap_tiny.json";
+    writeTextFile(filename, "[1]");
+    {
+        MmapInputSource input(filename, 8);
+        EXPECT_EQ(input.peekAhead(0), '[');
+        EXPECT_EQ(input.peekAhead(2), ']');
+        EXPECT_EQ(input.peekAhead(3), '\0');
+        input.consume(3);
+        EXPECT_EQ(input.peekAhead(0), '\0');
+    }
+    writeTextFile(filename, "");
+    {
+        MmapInputSource input(filename, 8);
+        EXPECT_EQ(input.size(), 0u);
+        EXPECT_EQ(input.peekAhead(0), '\0');
+    }
+    std::remove(filename.c_str());
+}
+
+/// @brief 存在しないファイルで例外が発生することのテスト。
+TEST(MmapInputSourceTest, MissingFileThrows) {
+    EXPECT_THROW(MmapInputSource("test_mmap_missing.json", 8), std::runtime_error);
+}
+
+/// @brief メモリマップ版読み込みのテスト用構造体。
+struct MappedRecord {
+    int id = 0;
+    std::string name;
+
+    const ObjectSerializer& serializer() const {
+        static const auto fields = getFieldSet(
+            getRequiredField(&MappedRecord::id, "id"),
+            getRequiredField(&MappedRecord::name, "name")
+        );
+        return fields;
+    }
+};
+
+/// @brief メモリマップ版読み込みのテスト用ルート構造体。
+struct MappedDocument {
+    std::vector<MappedRecord> records;
+
+    const ObjectSerializer& serializer() const {
+        static const auto recordsConverter = getContainerConverter<decltype(records)>();
+        static const auto fields = getFieldSet(
+            getRequiredField(&MappedDocument::records, "records", recordsConverter)
+        );
+        return fields;
+    }
+};
+
+/// @brief readJsonFileMappedで書き出した内容を読み戻せることのテスト。
+TEST(MmapInputSourceTest, ReadJsonFileMappedRoundTrip) {
+    MappedDocument original;
+    for (int i = 0; i < 2000; ++i) {
+        original.records.push_back({i, "line\n" + std::to_string(i)});
+    }
+    const std::string filename = "test_mmap_round_trip.json";
+    writeJsonFile(original, filename);
+
+    MappedDocument loaded;
+    std::vector<std::string> unknownKeys;
+    readJsonFileMapped(filename, loaded, unknownKeys);
+    std::remove(filename.c_str());
+
+    ASSERT_EQ(loaded.records.size(), original.records.size());
+    EXPECT_EQ(loaded.records[0].name, "line\n0");
+    EXPECT_EQ(loaded.records[1999].id, 1999);
+    EXPECT_EQ(loaded.records[1999].name, "line\n1999");
+    EXPECT_TRUE(unknownKeys.empty());
+}
@@ -0,0 +1,268 @@
+import rai.serialization.field_serializer;
+import rai.serialization.object_converter;
+import rai.serialization.object_serializer;
+import rai.serialization.json_io;
+import rai.serialization.json_parser;
+import rai.serialization.json_writer;
+import rai.serialization.parallel_file_output_sink;
+import rai.common.thread_pool;
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace rai::serialization;
+
+namespace {
+
+/// @brief 並列読み込みの確認に使う要素の構造体。
+struct ParallelItem {
+    int id = 0;
+    std::string name;
+    std::vector<int> values;
+
+    const ObjectSerializer& serializer() const {
+        // 入れ子の配列も並列版にして、区間内では逐次に読み込まれることを確かめる。
+        static const auto valuesConverter = getParallelContainerConverter<decltype(values)>(2);
+        static const auto fields = getFieldSet(
+            getRequiredField(&ParallelItem::id, "id"),
+            getRequiredField(&ParallelItem::name, "name"),
+            getRequiredField(&ParallelItem::values, "values", valuesConverter)
+        );
+        return fields;
+    }
+
+    bool operator==(const ParallelItem&) const = default;
+};
+
+/// @brief 要素を並列に読み込むドキュメント。
+struct ParallelDocument {
+    std::vector<ParallelItem> items;
+    std::vector<std::string> names;
+
+    const ObjectSerializer& serializer() const {
+        static const auto itemsConverter = getParallelContainerConverter<decltype(items)>(16);
+        static const auto namesConverter = getParallelContainerConverter<decltype(names)>(16);
+        static const auto fields = getFieldSet(
+            getRequiredField(&ParallelDocument::items, "items", itemsConverter),
+            getRequiredField(&ParallelDocument::names, "names", namesConverter)
+        );
+        return fields;
+    }
+};
+
+/// @brief 要素を逐次に読み込む比較用のドキュメント。
+struct SequentialDocument {
+    std::vector<ParallelItem> items;
+    std::vector<std::string> names;
+
+    const ObjectSerializer& serializer() const {
+        static const auto itemsConverter = getContainerConverter<decltype(items)>();
+        static const auto namesConverter = getContainerConverter<decltype(names)>();
+        static const auto fields = getFieldSet(
+            getRequiredField(&SequentialDocument::items, "items", itemsConverter),
+            getRequiredField(&SequentialDocument::names, "names", namesConverter)
+        );
+        return fields;
+    }
+};
+
+/// @brief 未知キーを含む要素の配列のJSONを生成する補助関数。
+std::string makeItemsJson(int count) {
+    std::string json = "{items:[";
+    for (int i = 0; i < count; ++i) {
+        json += i == 0 ? "" : ",";
+        json += "{id:" + std::to_string(i) + ",name:\"n\\\"" + std::to_string(i) +
+            "\",values:[" + std::to_string(i) + "," + std::to_string(i * 2) + "]";
+        if (i % 97 == 0) {
+            json += ",extra" + std::to_string(i) + ":{deep:[1,{x:2}]}";
+        }
+        json += "}";
+    }
+    json += "],names:[";
+    for (int i = 0; i < count; ++i) {
+        json += (i == 0 ? "'" : ",'") + std::to_string(i) + "'";
+    }
+    json += "]}";
+    return json;
+}
+
+/// @brief 指定した値の書き出しで例外を送出する、テスト用の整数コンバータ。
+struct FailingIntConverter {
+    using Value = int;
+    int failOn;
+
+    void write(JsonWriter& writer, const int& value) const {
+        if (value == failOn) {
+            throw std::runtime_error("cannot write " + std::to_string(value));
+        }
+        writer.writeObject(value);
+    }
+
+    int read(JsonParser& parser) const {
+        int value = 0;
+        parser.readTo(value);
+        return value;
+    }
+};
+
+}  // namespace
+
+// ********************************************************************************
+// テストカテゴリ：ParallelContainerConverter
+// ********************************************************************************
+
+/// @brief 並列に読み込んだ要素と未知キーの順序が逐次版と一致することのテスト。
+TEST(ParallelContainerConverterTest, MatchesSequentialRead) {
+    for (int count : {0, 1, 15, 16, 1000}) {
+        const std::string json = makeItemsJson(count);
+        SequentialDocument expected;
+        std::vector<std::string> expectedUnknownKeys;
+        readJsonString(json, expected, expectedUnknownKeys);
+        ParallelDocument actual;
+        std::vector<std::string> actualUnknownKeys;
+        readJsonString(json, actual, actualUnknownKeys);
+        EXPECT_EQ(actual.items, expected.items) << count;
+        EXPECT_EQ(actual.names, expected.names) << count;
+        EXPECT_EQ(actualUnknownKeys, expectedUnknownKeys) << count;
+    }
+}
+
+/// @brief 書き出しは逐次版と同じで、往復しても内容が変わらないことのテスト。
+TEST(ParallelContainerConverterTest, WritesSameAsSequential) {
+    SequentialDocument sequential;
+    readJsonString(makeItemsJson(100), sequential);
+    ParallelDocument parallel;
+    parallel.items = sequential.items;
+    parallel.names = sequential.names;
+    EXPECT_EQ(getJsonContent(parallel), getJsonContent(sequential));
+}
+
+/// @brief いずれかの区間で起きたエラーが逐次版と同じ内容で送出されることのテスト。
+TEST(ParallelContainerConverterTest, PropagatesFirstError) {
+    std::string json = makeItemsJson(1000);
+    // 後半の区間に型の誤りを、さらに後ろに必須フィールドの欠落を入れる。
+    json.replace(json.find("{id:700,"), 8, "{id:\"x\",");
+    json.replace(json.find("{id:900,"), 8, "{");
+    std::string sequentialMessage;
+    try {
+        SequentialDocument document;
+        readJsonString(json, document);
+    } catch (const std::runtime_error& e) {
+        sequentialMessage = e.what();
+    }
+    std::string parallelMessage;
+    try {
+        ParallelDocument document;
+        readJsonString(json, document);
+    } catch (const std::runtime_error& e) {
+        parallelMessage = e.what();
+    }
+    EXPECT_FALSE(parallelMessage.empty());
+    EXPECT_EQ(parallelMessage, sequentialMessage);
+
+    ParallelDocument unterminated;
+    EXPECT_THROW(readJsonString("{items:[{id:1,name:'a',values:[]}", unterminated),
+        std::runtime_error);
+}
+
+/// @brief 読み込みAPIに渡した実行器で要素を読み込み、結果が逐次版と一致することのテスト。
+TEST(ParallelContainerConverterTest, UsesInjectedExecutor) {
+    const std::string json = makeItemsJson(1000);
+    SequentialDocument expected;
+    readJsonString(json, expected);
+
+    rai::common::ThreadPool singleWorker(1);
+    for (rai::common::Executor* executor :
+        {static_cast<rai::common::Executor*>(&rai::common::getInlineExecutor()),
+         static_cast<rai::common::Executor*>(&singleWorker)}) {
+        ParallelDocument fromString;
+        readJsonString(json, fromString, *executor);
+        EXPECT_EQ(fromString.items, expected.items);
+        EXPECT_EQ(fromString.names, expected.names);
+
+        // ファイルからの並列読み込み（先読みとトークン化）も同じ実行器で行う。
+        const std::string filename = "test_injected_executor.json";
+        {
+            std::ofstream ofs(filename, std::ios::binary | std::ios::trunc);
+            ofs << json;
+        }
+        ParallelDocument fromFile;
+        std::vector<std::string> unknownKeys;
+        readJsonFileParallel(filename, fromFile, unknownKeys, *executor);
+        EXPECT_EQ(fromFile.items, expected.items);
+        EXPECT_EQ(unknownKeys.size(), 11u);
+        ParallelDocument autoSelected;
+        readJsonFile(filename, autoSelected, *executor);
+        EXPECT_EQ(autoSelected.names, expected.names);
+        std::remove(filename.c_str());
+    }
+}
+
+/// @brief 区間毎に別のJsonWriterで書いて繋いだ結果が、区間数や出力先に関わらず逐次版と一致することのテスト。
+TEST(ParallelContainerConverterTest, WritesInParallelWithInjectedExecutor) {
+    rai::common::ThreadPool pool(4);
+    for (int count : {0, 1, 15, 16, 17, 1000}) {
+        SequentialDocument sequential;
+        readJsonString(makeItemsJson(count), sequential);
+        ParallelDocument parallel;
+        parallel.items = sequential.items;
+        parallel.names = sequential.names;
+        const std::string expected = getJsonContent(sequential);
+
+        std::string actual;
+        {
+            JsonWriter writer(actual);
+            writer.setExecutor(pool);
+            parallel.serializer().writeFields(writer, &parallel);
+        }
+        std::string sequentialFields;
+        {
+            JsonWriter writer(sequentialFields);
+            sequential.serializer().writeFields(writer, &sequential);
+        }
+        EXPECT_EQ(actual, sequentialFields) << count;
+
+        // バックグラウンド書き込みのファイル出力でも同じ内容になる。
+        const std::string filename = "test_parallel_write.json";
+        writeJsonFile(parallel, filename, FileWriteOptions{512, 3, false, false}, pool);
+        std::ifstream ifs(filename, std::ios::binary);
+        const std::string written((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+        ifs.close();
+        EXPECT_EQ(written, expected) << count;
+        std::remove(filename.c_str());
+    }
+}
+
+/// @brief いずれかの区間の書き出しで起きた例外が、全ての区間の終了後に送出されることのテスト。
+TEST(ParallelContainerConverterTest, WritePropagatesFirstError) {
+    rai::common::ThreadPool pool(4);
+    static const FailingIntConverter failing{700};
+    const auto converter = getParallelContainerConverter<std::vector<int>>(failing, 16);
+    std::vector<int> values(1000);
+    for (int i = 0; i < 1000; ++i) {
+        values[i] = i;
+    }
+    std::string out;
+    JsonWriter writer(out);
+    writer.setExecutor(pool);
+    try {
+        converter.write(writer, values);
+        FAIL() << "expected an exception";
+    } catch (const std::runtime_error& e) {
+        EXPECT_STREQ(e.what(), "cannot write 700");
+    }
+
+    values[700] = 0;
+    std::string written;
+    JsonWriter okWriter(written);
+    okWriter.setExecutor(pool);
+    converter.write(okWriter, values);
+    EXPECT_EQ(written.substr(0, 8), "[0,1,2,3");
+    EXPECT_EQ(written.back(), ']');
+    EXPECT_EQ(std::count(written.begin(), written.end(), ','), 999);
+}
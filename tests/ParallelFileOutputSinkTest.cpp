@@ -0,0 +1,150 @@
+import rai.serialization.parallel_file_output_sink;
+import rai.serialization.field_serializer;
+import rai.serialization.object_converter;
+import rai.serialization.object_serializer;
+import rai.serialization.json_io;
+import rai.serialization.json_writer;
+import rai.common.thread_pool;
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace rai::serialization;
+
+namespace {
+
+/// @brief ファイル全体を読み込む補助関数。
+std::string readWholeFile(const std::string& filename) {
+    std::ifstream ifs(filename, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+}
+
+/// @brief 積まれたタスクを、待つ側が呼ぶrunPendingTask()でしか実行しないテスト用の実行器。
+/// @note ワーカーが埋まっていて書き込みタスクが始まらない状況を再現する。
+class DeferredExecutor final : public rai::common::Executor {
+public:
+    void post(rai::common::Task task) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+
+    bool runPendingTask() override {
+        rai::common::Task task;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (tasks_.empty()) {
+                return false;
+            }
+            task = std::move(tasks_.front());
+            tasks_.erase(tasks_.begin());
+        }
+        task();
+        return true;
+    }
+
+    std::size_t getThreadCount() const override { return 1; }
+
+    bool isWorkerThread() const override { return false; }
+
+private:
+    std::mutex mutex_;
+    std::vector<rai::common::Task> tasks_;
+};
+
+/// @brief 書き出しの確認に使うテスト用構造体。
+struct SnapshotDocument {
+    std::vector<int> values;
+    std::vector<std::string> names;
+
+    const ObjectSerializer& serializer() const {
+        static const auto valuesConverter = getContainerConverter<decltype(values)>();
+        static const auto namesConverter = getContainerConverter<decltype(names)>();
+        static const auto fields = getFieldSet(
+            getRequiredField(&SnapshotDocument::values, "values", valuesConverter),
+            getRequiredField(&SnapshotDocument::names, "names", namesConverter)
+        );
+        return fields;
+    }
+};
+
+/// @brief 複数のバッファにまたがる大きさのテスト用オブジェクトを作る補助関数。
+SnapshotDocument makeSnapshot() {
+    SnapshotDocument document;
+    for (int i = 0; i < 20000; ++i) {
+        document.values.push_back(i * 37 - 5000);
+        document.names.push_back("name" + std::to_string(i) + (i % 7 == 0 ? "\n" : ""));
+    }
+    return document;
+}
+
+}  // namespace
+
+// ********************************************************************************
+// テストカテゴリ：ParallelFileOutputSink
+// ********************************************************************************
+
+/// @brief バッファの容量・数・実行器の組み合わせに関わらず、文字列版と同じ内容を書き出すことのテスト。
+TEST(ParallelFileOutputSinkTest, WritesSameContentForAnyBufferLayout) {
+    const SnapshotDocument document = makeSnapshot();
+    const std::string expected = getJsonContent(document);
+    const std::string filename = "test_parallel_output.json";
+    rai::common::ThreadPool pool(2);
+    DeferredExecutor deferred;
+    for (std::size_t bufferSize : {256u, 4096u, 1024u * 1024u}) {
+        for (std::size_t bufferCount : {2u, 3u, 8u}) {
+            for (rai::common::Executor* executor :
+                {static_cast<rai::common::Executor*>(&pool),
+                 static_cast<rai::common::Executor*>(&deferred),
+                 static_cast<rai::common::Executor*>(&rai::common::getInlineExecutor())}) {
+                SCOPED_TRACE(std::to_string(bufferSize) + "/" + std::to_string(bufferCount));
+                writeJsonFile(document, filename, FileWriteOptions{bufferSize, bufferCount, false, false},
+                    *executor);
+                EXPECT_EQ(readWholeFile(filename), expected);
+            }
+        }
+    }
+
+    SnapshotDocument readBack;
+    readJsonFile(filename, readBack);
+    EXPECT_EQ(readBack.values, document.values);
+    EXPECT_EQ(readBack.names, document.names);
+    std::filesystem::remove(filename);
+}
+
+/// @brief 一時ファイルへ書いてからclose()で置き換え、close()前に破棄した場合は元のファイルを残すことのテスト。
+TEST(ParallelFileOutputSinkTest, RenamesAtomicallyOnlyOnClose) {
+    const std::string filename = "test_atomic_output.json";
+    const std::string tempname = filename + ".tmp";
+    const SnapshotDocument document = makeSnapshot();
+    writeJsonFile(document, filename, FileWriteOptions{4096, 3, true, true});
+    EXPECT_EQ(readWholeFile(filename), getJsonContent(document));
+    EXPECT_FALSE(std::filesystem::exists(tempname));
+
+    {
+        // 途中で破棄された書き込みは反映しない。
+        ParallelFileOutputSink sink(filename, FileWriteOptions{256, 2, false, true});
+        JsonWriter writer(sink, sink.bufferSize());
+        writer.startObject();
+        writer.writeObject(std::string(1000, 'x'));
+        writer.flush();
+        EXPECT_TRUE(std::filesystem::exists(tempname));
+    }
+    EXPECT_FALSE(std::filesystem::exists(tempname));
+    EXPECT_EQ(readWholeFile(filename), getJsonContent(document));
+    std::filesystem::remove(filename);
+}
+
+/// @brief 不正な設定や開けないファイルは例外になることのテスト。
+TEST(ParallelFileOutputSinkTest, RejectsInvalidOptionsAndPaths) {
+    EXPECT_THROW(ParallelFileOutputSink("test_invalid_output.json", FileWriteOptions{4096, 1, false, false}),
+        std::invalid_argument);
+    EXPECT_THROW(ParallelFileOutputSink("no_such_directory/output.json"), std::runtime_error);
+    EXPECT_THROW(writeJsonFile(makeSnapshot(), "no_such_directory/output.json", FileWriteOptions{}),
+        std::runtime_error);
+}
@@ -0,0 +1,136 @@
+import rai.serialization.reading_ahead_buffer_ring;
+import rai.serialization.parallel_input_stream_source;
+import rai.serialization.field_serializer;
+import rai.serialization.object_converter;
+import rai.serialization.object_serializer;
+import rai.serialization.json_io;
+import rai.common.thread_pool;
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace rai::serialization;
+
+namespace {
+
+/// @brief 位置に応じて内容が変わる入力を生成する補助関数。
+std::string makeInput(std::size_t size) {
+    std::string input(size, '\0');
+    for (std::size_t i = 0; i < size; ++i) {
+        input[i] = static_cast<char>('!' + (i * 7 + i / 13) % 90);
+    }
+    return input;
+}
+
+/// @brief 入力ソースを1文字ずつ読み、先読みも含めて元の入力と一致することを確かめる補助関数。
+void expectSameContent(ParallelInputStreamSource& source, const std::string& input) {
+    for (std::size_t i = 0; i < input.size(); ++i) {
+        ASSERT_EQ(source.position(), i);
+        for (std::size_t offset = 0; offset < ParallelInputStreamSource::maxReadingAhead; ++offset) {
+            const char expected = i + offset < input.size() ? input[i + offset] : '\0';
+            ASSERT_EQ(source.peekAhead(offset), expected) << i << "+" << offset;
+        }
+        source.consume(i % 3 == 0 ? 1 : 0);
+        if (i % 3 != 0) {
+            source.consume();
+        }
+    }
+    EXPECT_EQ(source.peekAhead(0), '\0');
+    source.consume(5);
+    EXPECT_EQ(source.peekAhead(7), '\0');
+}
+
+/// @brief 読み込み方針の確認に使うテスト用構造体。
+struct PolicyDocument {
+    std::vector<int> values;
+
+    const ObjectSerializer& serializer() const {
+        static const auto valuesConverter = getContainerConverter<decltype(values)>();
+        static const auto fields = getFieldSet(
+            getRequiredField(&PolicyDocument::values, "values", valuesConverter)
+        );
+        return fields;
+    }
+};
+
+}  // namespace
+
+// ********************************************************************************
+// テストカテゴリ：ParallelInputStreamSource
+// ********************************************************************************
+
+/// @brief バッファの容量・数・実行器の組み合わせに関わらず、入力を同じ内容で読めることのテスト。
+TEST(ParallelInputStreamSourceTest, ReadsSameContentForAnyBufferLayout) {
+    rai::common::ThreadPool pool(2);
+    for (std::size_t chunkSize : {9u, 16u, 4096u}) {
+        for (std::size_t bufferCount : {2u, 3u, 8u}) {
+            for (std::size_t size : std::vector<std::size_t>{
+                     0, 1, 8, 9, chunkSize - 1, chunkSize, chunkSize + 1, 10000}) {
+                const std::string input = makeInput(size);
+                for (rai::common::Executor* executor :
+                    {static_cast<rai::common::Executor*>(&pool),
+                     static_cast<rai::common::Executor*>(&rai::common::getInlineExecutor())}) {
+                    std::istringstream stream(input);
+                    ParallelInputStreamSource source(stream,
+                        InputBufferOptions{chunkSize, bufferCount, false}, *executor);
+                    SCOPED_TRACE(std::to_string(chunkSize) + "/" + std::to_string(bufferCount) +
+                        "/" + std::to_string(size));
+                    expectSameContent(source, input);
+                }
+            }
+        }
+    }
+}
+
+/// @brief 途中で破棄しても先読みタスクが安全に終わり、huge page境界の指定でも読めることのテスト。
+TEST(ParallelInputStreamSourceTest, DestroysMidStreamAndSupportsHugePageHint) {
+    const std::string input = makeInput(200000);
+    for (int i = 0; i < 20; ++i) {
+        std::istringstream stream(input);
+        ParallelInputStreamSource source(stream, InputBufferOptions{1024, 4, false});
+        source.consume(static_cast<std::size_t>(i) * 997);
+        EXPECT_EQ(source.peekAhead(0), input[static_cast<std::size_t>(i) * 997]);
+    }
+    std::istringstream stream(input);
+    ParallelInputStreamSource source(stream, InputBufferOptions{64 * 1024, 3, true});
+    expectSameContent(source, input);
+
+    EXPECT_THROW(ReadingAheadBufferRing<char>(8, InputBufferOptions{8, 2, false}), std::invalid_argument);
+    EXPECT_THROW(ReadingAheadBufferRing<char>(8, InputBufferOptions{64, 1, false}), std::invalid_argument);
+}
+
+/// @brief 読み込み方針の閾値とバッファ設定を実行時に変更できることのテスト。
+TEST(ParallelInputStreamSourceTest, FileReadPolicyIsTunable) {
+    const JsonFileReadPolicy original = getJsonFileReadPolicy();
+    EXPECT_EQ(original.smallFileThreshold, 10u * 1024);
+    EXPECT_EQ(original.bufferOptions.bufferCount, 2u);
+
+    std::string json = "{values:[";
+    for (int i = 0; i < 5000; ++i) {
+        json += (i == 0 ? "" : ",") + std::to_string(i);
+    }
+    json += "]}";
+    const std::string filename = "test_read_policy.json";
+    {
+        std::ofstream ofs(filename, std::ios::binary | std::ios::trunc);
+        ofs << json;
+    }
+
+    // 全てのファイルを並列版で、小さなバッファを多数使って読む。
+    JsonFileReadPolicy policy = original;
+    policy.smallFileThreshold = 0;
+    policy.bufferOptions = InputBufferOptions{256, 6, false};
+    setJsonFileReadPolicy(policy);
+    EXPECT_EQ(getJsonFileReadPolicy().bufferOptions.chunkSize, 256u);
+    PolicyDocument document;
+    readJsonFile(filename, document);
+    setJsonFileReadPolicy(original);
+
+    ASSERT_EQ(document.values.size(), 5000u);
+    EXPECT_EQ(document.values[4999], 4999);
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,170 @@
+import rai.serialization.token_manager;
+import rai.serialization.json_tokenizer;
+import rai.serialization.reading_ahead_buffer;
+import rai.serialization.reading_ahead_buffer_ring;
+import rai.serialization.pipeline_instrumentation;
+import rai.serialization.field_serializer;
+import rai.serialization.object_converter;
+import rai.serialization.object_serializer;
+import rai.serialization.json_io;
+import rai.common.thread_pool;
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace rai::serialization;
+
+namespace {
+
+/// @brief 計測の確認に使う要素。
+struct InstrumentedRecord {
+    int id = 0;
+    std::string name;
+    double score = 0.0;
+
+    const ObjectSerializer& serializer() const {
+        static const auto fields = getFieldSet(
+            getRequiredField(&InstrumentedRecord::id, "id"),
+            getRequiredField(&InstrumentedRecord::name, "name"),
+            getRequiredField(&InstrumentedRecord::score, "score")
+        );
+        return fields;
+    }
+};
+
+/// @brief 計測の確認に使う文書。
+struct InstrumentedDocument {
+    std::vector<InstrumentedRecord> records;
+
+    const ObjectSerializer& serializer() const {
+        static const auto recordsConverter = getContainerConverter<decltype(records)>();
+        static const auto fields = getFieldSet(
+            getRequiredField(&InstrumentedDocument::records, "records", recordsConverter)
+        );
+        return fields;
+    }
+};
+
+/// @brief 指定した種別のトークン数を返す補助関数。
+std::uint64_t countOf(const JsonPipelineCounters& counters, JsonTokenType type) {
+    return counters.tokenCounts[static_cast<std::size_t>(type)];
+}
+
+/// @brief 要素数countの文書をファイルに書き出す補助関数。
+std::uintmax_t writeInstrumentedFile(const std::string& filename, int count) {
+    InstrumentedDocument document;
+    for (int i = 0; i < count; ++i) {
+        document.records.push_back({i, "r\\n" + std::to_string(i), i + 0.5});
+    }
+    writeJsonFile(document, filename);
+    return std::filesystem::file_size(filename);
+}
+
+/// @brief 要素数countの文書のトークン数を確認する補助関数。
+void expectRecordTokenCounts(const JsonPipelineCounters& counters, std::uint64_t count) {
+    EXPECT_EQ(countOf(counters, JsonTokenType::StartObject), count + 1);
+    EXPECT_EQ(countOf(counters, JsonTokenType::EndObject), count + 1);
+    EXPECT_EQ(countOf(counters, JsonTokenType::Key), count * 3 + 1);
+    EXPECT_EQ(countOf(counters, JsonTokenType::Integer), count);
+    EXPECT_EQ(countOf(counters, JsonTokenType::String), count);
+    EXPECT_EQ(countOf(counters, JsonTokenType::Number), count);
+    EXPECT_EQ(countOf(counters, JsonTokenType::StartArray), 1u);
+    EXPECT_EQ(countOf(counters, JsonTokenType::EndOfStream), 1u);
+    EXPECT_EQ(counters.totalTokens(), count * 8 + 6);
+}
+
+}  // namespace
+
+/// @brief 逐次版の読み込みで、読み込んだbyte数・トークン数・アリーナの確保・各段の時間を集計することを確認する。
+TEST(PipelineInstrumentationTest, CountsSequentialRead) {
+    const std::string filename = "test_pipeline_instrumentation_sequential.json";
+    const std::uintmax_t fileSize = writeInstrumentedFile(filename, 20);
+
+    InstrumentedDocument loaded;
+    std::vector<std::string> unknownKeys;
+    JsonPipelineCounters counters;
+    counters.readCalls = 99;  // 読み込み前に初期化されること
+    readJsonFile(filename, loaded, unknownKeys, counters);
+    std::remove(filename.c_str());
+
+    ASSERT_EQ(loaded.records.size(), 20u);
+    EXPECT_EQ(loaded.records[7].name, "r\\n7");
+    EXPECT_EQ(counters.method, JsonReadMethod::Sequential);
+    EXPECT_EQ(counters.fileSize, fileSize);
+    EXPECT_EQ(counters.bytesRead, fileSize);
+    EXPECT_EQ(counters.readCalls, 1u);
+    expectRecordTokenCounts(counters, 20);
+    // エスケープを含む文字列は文字列アリーナへ書き込む。
+    EXPECT_GE(counters.arenaChunks, 1u);
+    EXPECT_GE(counters.arenaBytes, 20u);
+    EXPECT_EQ(counters.takeWaits, 0u);
+    EXPECT_LE(counters.tokenizeNanoseconds + counters.parseNanoseconds, counters.totalNanoseconds);
+}
+
+/// @brief 並列版の読み込みで、バッファ毎の読み込みと段の間の待ちを集計することを確認する。
+TEST(PipelineInstrumentationTest, CountsParallelRead) {
+    const std::string filename = "test_pipeline_instrumentation_parallel.json";
+    const std::uintmax_t fileSize = writeInstrumentedFile(filename, 2000);
+
+    const JsonFileReadPolicy original = getJsonFileReadPolicy();
+    JsonFileReadPolicy policy = original;
+    policy.smallFileThreshold = 0;
+    policy.bufferOptions = InputBufferOptions{4096, 3, false};
+    setJsonFileReadPolicy(policy);
+
+    rai::common::ThreadPool pool(2);
+    InstrumentedDocument loaded;
+    std::vector<std::string> unknownKeys;
+    JsonPipelineCounters counters;
+    readJsonFile(filename, loaded, unknownKeys, counters, pool);
+    setJsonFileReadPolicy(original);
+    std::remove(filename.c_str());
+
+    ASSERT_EQ(loaded.records.size(), 2000u);
+    EXPECT_EQ(loaded.records[1999].id, 1999);
+    EXPECT_EQ(counters.method, JsonReadMethod::Parallel);
+    EXPECT_EQ(counters.bytesRead, fileSize);
+    EXPECT_GE(counters.readCalls, fileSize / 4096);
+    EXPECT_LE(counters.readStalls, counters.readCalls);
+    expectRecordTokenCounts(counters, 2000);
+    EXPECT_LE(counters.parseNanoseconds, counters.totalNanoseconds);
+}
+
+/// @brief TokenManagerのtake()でトークンの到着を待った時間を記録し、トークナイザー単体でも集計できることを確認する。
+TEST(PipelineInstrumentationTest, RecordsTakeWaits) {
+    JsonPipelineCounters counters;
+    TokenManagerBase<CountingPipelineInstrumentation> tokens{CountingPipelineInstrumentation(counters)};
+    std::thread producer([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        tokens.pushToken(JsonToken::makeInteger(5, 0));
+        tokens.pushToken(JsonToken::make(JsonTokenType::EndOfStream, 1));
+    });
+    const JsonToken first = tokens.take();
+    producer.join();
+    EXPECT_EQ(first.type, JsonTokenType::Integer);
+    EXPECT_EQ(tokens.take().type, JsonTokenType::EndOfStream);
+    EXPECT_EQ(counters.takeWaits, 1u);
+    EXPECT_GE(counters.takeWaitNanoseconds, 1'000'000u);
+
+    // トークナイザーだけに計測フックを差し込むこともできる。
+    JsonPipelineCounters tokenizerCounters;
+    std::string json = "{a:[1,null,true]}";
+    json.reserve(json.size() + 8);
+    ReadingAheadBuffer input(std::move(json), 8);
+    TokenManager plain;
+    StdoutMessageOutput warningOutput;
+    JsonTokenizer<ReadingAheadBuffer, TokenManager, CountingPipelineInstrumentation> tokenizer(
+        input, plain, warningOutput, CountingPipelineInstrumentation(tokenizerCounters));
+    tokenizer.tokenize();
+    EXPECT_EQ(plain.take().type, JsonTokenType::StartObject);
+    EXPECT_EQ(tokenizerCounters.totalTokens(), 9u);
+    EXPECT_EQ(countOf(tokenizerCounters, JsonTokenType::Null), 1u);
+    EXPECT_EQ(countOf(tokenizerCounters, JsonTokenType::Bool), 1u);
+    EXPECT_EQ(tokenizerCounters.arenaChunks, 0u);
+}
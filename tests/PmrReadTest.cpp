@@ -0,0 +1,284 @@
+import rai.serialization.field_serializer;
+import rai.serialization.object_converter;
+import rai.serialization.object_serializer;
+import rai.serialization.polymorphic_converter;
+import rai.serialization.json_parser;
+import rai.serialization.json_io;
+import rai.collection.sorted_hash_array_map;
+import rai.common.thread_pool;
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace rai::serialization;
+
+namespace {
+
+/// @brief 確保・解放の回数を数えるmemory_resource。
+class CountingResource final : public std::pmr::memory_resource {
+public:
+    std::size_t allocations = 0;    ///< 確保した回数。
+    std::size_t deallocations = 0;  ///< 解放した回数。
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        ++deallocations;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+/// @brief 有効な間、既定のmemory_resourceを差し替える補助クラス。
+class DefaultResourceOverride {
+public:
+    explicit DefaultResourceOverride(std::pmr::memory_resource* resource)
+        : previous_(std::pmr::set_default_resource(resource)) {}
+    ~DefaultResourceOverride() { std::pmr::set_default_resource(previous_); }
+
+private:
+    std::pmr::memory_resource* previous_;
+};
+
+/// @brief std::pmrのメンバーを持ち、アロケーターを受け取れるテスト用の要素。
+struct PmrRecord {
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    std::pmr::string name;
+    std::pmr::vector<int> values;
+
+    PmrRecord() = default;
+    explicit PmrRecord(const allocator_type& alloc) : name(alloc), values(alloc) {}
+    PmrRecord(const PmrRecord& other, const allocator_type& alloc)
+        : name(other.name, alloc), values(other.values, alloc) {}
+    PmrRecord(PmrRecord&& other, const allocator_type& alloc)
+        : name(std::move(other.name), alloc), values(std::move(other.values), alloc) {}
+    PmrRecord(const PmrRecord&) = default;
+    PmrRecord(PmrRecord&&) = default;
+    PmrRecord& operator=(const PmrRecord&) = default;
+    PmrRecord& operator=(PmrRecord&&) = default;
+
+    const ObjectSerializer& serializer() const {
+        static const auto valuesConverter = getContainerConverter<decltype(values)>();
+        static const auto fields = getFieldSet(
+            getRequiredField(&PmrRecord::name, "name"),
+            getRequiredField(&PmrRecord::values, "values", valuesConverter)
+        );
+        return fields;
+    }
+};
+
+/// @brief ポリモーフィックな要素の基底クラス。
+struct PmrShape {
+    virtual ~PmrShape() = default;
+    virtual const ObjectSerializer& serializer() const = 0;
+};
+
+/// @brief 文字列メンバーを持つポリモーフィックな要素。
+struct PmrLabel : PmrShape {
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    std::pmr::string text;
+
+    PmrLabel() = default;
+    explicit PmrLabel(const allocator_type& alloc) : text(alloc) {}
+
+    const ObjectSerializer& serializer() const override {
+        static const auto fields = getFieldSet(
+            getRequiredField(&PmrLabel::text, "text")
+        );
+        return fields;
+    }
+};
+
+/// @brief 数値メンバーだけを持つポリモーフィックな要素。
+struct PmrPoint : PmrShape {
+    int x = 0;
+
+    const ObjectSerializer& serializer() const override {
+        static const auto fields = getFieldSet(
+            getRequiredField(&PmrPoint::x, "x")
+        );
+        return fields;
+    }
+};
+
+using PmrShapeEntry = std::pair<std::string_view, PolymorphicTypeFactory<PmrUniquePtr<PmrShape>>>;
+inline const auto pmrShapeEntries = rai::collection::makeSortedHashArrayMap(
+    PmrShapeEntry{"Label", [] { return makePmrUnique<PmrLabel>(currentMemoryResource()); }},
+    PmrShapeEntry{"Point", [] { return makePmrUnique<PmrPoint>(currentMemoryResource()); }}
+);
+
+/// @brief 読み込んだ文書全体をmemory_resourceに置くテスト用の文書。
+struct PmrDocument {
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    std::pmr::string title;
+    std::pmr::vector<PmrRecord> records;
+    std::pmr::vector<PmrRecord> bulk;
+    std::pmr::vector<PmrUniquePtr<PmrShape>> shapes;
+    PmrUniquePtr<PmrRecord> extra;
+
+    PmrDocument() = default;
+    explicit PmrDocument(const allocator_type& alloc)
+        : title(alloc), records(alloc), bulk(alloc), shapes(alloc) {}
+
+    const ObjectSerializer& serializer() const {
+        static const auto recordsConverter = getContainerConverter<decltype(records)>();
+        static const auto bulkConverter = getParallelContainerConverter<decltype(bulk)>(2);
+        static const auto shapesConverter =
+            getPolymorphicArrayConverter<decltype(shapes)>(pmrShapeEntries, "kind");
+        static const auto extraConverter = getUniquePtrConverter<decltype(extra)>();
+        static const auto fields = getFieldSet(
+            getRequiredField(&PmrDocument::title, "title"),
+            getRequiredField(&PmrDocument::records, "records", recordsConverter),
+            getRequiredField(&PmrDocument::bulk, "bulk", bulkConverter),
+            getRequiredField(&PmrDocument::shapes, "shapes", shapesConverter),
+            getRequiredField(&PmrDocument::extra, "extra", extraConverter)
+        );
+        return fields;
+    }
+};
+
+/// @brief テスト用の文書のJSONを作る補助関数。
+std::string makePmrDocumentJson() {
+    std::string json = "{title:\"a title that does not fit in the small string buffer\",records:[";
+    for (int i = 0; i < 50; ++i) {
+        json += (i == 0 ? "" : ",");
+        json += "{name:\"record name number " + std::to_string(i) + " with a long suffix\",values:[" +
+            std::to_string(i) + "," + std::to_string(i * 2) + "]}";
+    }
+    json += "],bulk:[";
+    for (int i = 0; i < 20; ++i) {
+        json += (i == 0 ? "" : ",");
+        json += "{name:\"bulk record " + std::to_string(i) + " with a long enough name\",values:[1,2,3]}";
+    }
+    json += "],shapes:[{kind:\"Label\",text:\"a label long enough to be heap allocated\"},"
+            "{kind:\"Point\",x:7}],extra:{name:\"extra record with a long name\",values:[9]}}";
+    return json;
+}
+
+/// @brief 読み込んだ文書の内容を確かめる補助関数。
+void expectPmrDocument(const PmrDocument& document) {
+    EXPECT_EQ(document.title, "a title that does not fit in the small string buffer");
+    ASSERT_EQ(document.records.size(), 50u);
+    EXPECT_EQ(document.records[49].name, "record name number 49 with a long suffix");
+    EXPECT_EQ(document.records[49].values[1], 98);
+    ASSERT_EQ(document.bulk.size(), 20u);
+    EXPECT_EQ(document.bulk[19].name, "bulk record 19 with a long enough name");
+    ASSERT_EQ(document.shapes.size(), 2u);
+    const auto* label = dynamic_cast<const PmrLabel*>(document.shapes[0].get());
+    ASSERT_NE(label, nullptr);
+    EXPECT_EQ(label->text, "a label long enough to be heap allocated");
+    const auto* point = dynamic_cast<const PmrPoint*>(document.shapes[1].get());
+    ASSERT_NE(point, nullptr);
+    EXPECT_EQ(point->x, 7);
+    ASSERT_NE(document.extra, nullptr);
+    EXPECT_EQ(document.extra->values[0], 9);
+}
+
+}  // namespace
+
+// ********************************************************************************
+// テストカテゴリ：memory_resourceを指定した読み込み
+// ********************************************************************************
+
+/// @brief 指定したmemory_resourceに、文字列・コンテナ・ポリモーフィックな要素を全て確保することのテスト。
+TEST(PmrReadTest, PlacesWholeDocumentInArena) {
+    const std::string json = makePmrDocumentJson();
+    CountingResource defaultCounter;
+    CountingResource arenaUpstream;
+    rai::common::ThreadPool pool(2);
+    {
+        DefaultResourceOverride override(&defaultCounter);
+        std::pmr::monotonic_buffer_resource arena(&arenaUpstream);
+        {
+            PmrDocument document(&arena);
+            {
+                MemoryResourceScope scope(&arena);
+                readJsonString(json, document, pool);
+            }
+            expectPmrDocument(document);
+            EXPECT_EQ(document.records[0].name.get_allocator().resource(), &arena);
+            EXPECT_EQ(document.bulk[0].values.get_allocator().resource(), &arena);
+            EXPECT_EQ(document.extra.get_deleter().resource, &arena);
+            EXPECT_EQ(document.shapes[0].get_deleter().resource, &arena);
+        }
+        // 既定のmemory_resourceは使われず、全てアリーナから確保される。
+        EXPECT_EQ(defaultCounter.allocations, 0u);
+        EXPECT_GT(arenaUpstream.allocations, 0u);
+        EXPECT_EQ(arenaUpstream.deallocations, 0u);
+    }
+    // アリーナの破棄でまとめて解放される。
+    EXPECT_EQ(arenaUpstream.deallocations, arenaUpstream.allocations);
+}
+
+/// @brief 一括読み込みでも、呼び出しスレッドで指定したmemory_resourceに確保することのテスト。
+TEST(PmrReadTest, PlacesBatchFileReadsInArena) {
+    const std::string json = makePmrDocumentJson();
+    std::vector<std::filesystem::path> paths;
+    for (int i = 0; i < 3; ++i) {
+        paths.emplace_back("test_pmr_batch_" + std::to_string(i) + ".json");
+        std::ofstream ofs(paths.back(), std::ios::binary | std::ios::trunc);
+        ofs << json;
+    }
+    CountingResource defaultCounter;
+    CountingResource arenaUpstream;
+    rai::common::ThreadPool pool(2);
+    {
+        DefaultResourceOverride override(&defaultCounter);
+        std::pmr::monotonic_buffer_resource arena(&arenaUpstream);
+        {
+            std::pmr::vector<PmrDocument> documents(paths.size(), &arena);
+            {
+                MemoryResourceScope scope(&arena);
+                readJsonFiles(paths, std::span(documents.data(), documents.size()), pool);
+            }
+            for (const auto& document : documents) {
+                expectPmrDocument(document);
+                EXPECT_EQ(document.records[0].name.get_allocator().resource(), &arena);
+                EXPECT_EQ(document.shapes[0].get_deleter().resource, &arena);
+            }
+        }
+        EXPECT_EQ(defaultCounter.allocations, 0u);
+        EXPECT_GT(arenaUpstream.allocations, 0u);
+    }
+    for (const auto& path : paths) {
+        std::filesystem::remove(path);
+    }
+}
+
+/// @brief memory_resourceを指定しない場合は従来どおり既定のものに確保し、書き出しも同じになることのテスト。
+TEST(PmrReadTest, UsesDefaultResourceWithoutScope) {
+    const std::string json = makePmrDocumentJson();
+    PmrDocument document;
+    readJsonString(json, document);
+    expectPmrDocument(document);
+    EXPECT_EQ(document.records[0].name.get_allocator().resource(), std::pmr::get_default_resource());
+    EXPECT_EQ(document.shapes[0].get_deleter().resource, std::pmr::get_default_resource());
+
+    std::pmr::monotonic_buffer_resource arena;
+    PmrDocument copy(&arena);
+    {
+        MemoryResourceScope scope(&arena);
+        EXPECT_EQ(&currentMemoryResource(), &arena);
+        readJsonString(getJsonContent(document), copy);
+    }
+    EXPECT_EQ(&currentMemoryResource(), std::pmr::get_default_resource());
+    EXPECT_EQ(getJsonContent(copy), getJsonContent(document));
+}
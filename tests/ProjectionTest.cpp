@@ -0,0 +1,190 @@
+import rai.serialization.field_serializer;
+import rai.serialization.object_converter;
+import rai.serialization.object_serializer;
+import rai.serialization.json_io;
+import rai.serialization.json_parser;
+import rai.common.thread_pool;
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace rai::serialization;
+
+namespace {
+
+/// @brief 射影の確認に使う見出し。
+struct ProjHeader {
+    int version = 0;
+    std::string author;
+
+    const ObjectSerializer& serializer() const {
+        static const auto fields = getFieldSet(
+            getRequiredField(&ProjHeader::version, "version"),
+            getRequiredField(&ProjHeader::author, "author")
+        );
+        return fields;
+    }
+};
+
+/// @brief 射影の確認に使う要素。
+struct ProjItem {
+    int id = 0;
+    std::string name;
+    std::vector<int> tags;
+
+    const ObjectSerializer& serializer() const {
+        static const auto tagsConverter = getContainerConverter<decltype(tags)>();
+        static const auto fields = getFieldSet(
+            getRequiredField(&ProjItem::id, "id"),
+            getRequiredField(&ProjItem::name, "name"),
+            getRequiredField(&ProjItem::tags, "tags", tagsConverter)
+        );
+        return fields;
+    }
+};
+
+/// @brief 射影の確認に使う文書。
+struct ProjDocument {
+    ProjHeader header;
+    std::vector<ProjItem> items;
+    std::vector<ProjItem> parallelItems;
+    std::unique_ptr<ProjItem> extra;
+    std::string body = "keep";
+
+    const ObjectSerializer& serializer() const {
+        static const auto itemsConverter = getContainerConverter<decltype(items)>();
+        static const auto parallelConverter =
+            getParallelContainerConverter<decltype(parallelItems)>(2);
+        static const auto extraConverter = getUniquePtrConverter<decltype(extra)>();
+        static const auto fields = getFieldSet(
+            getRequiredField(&ProjDocument::header, "header"),
+            getRequiredField(&ProjDocument::items, "items", itemsConverter),
+            getRequiredField(&ProjDocument::parallelItems, "parallelItems", parallelConverter),
+            getRequiredField(&ProjDocument::extra, "extra", extraConverter),
+            getRequiredField(&ProjDocument::body, "body")
+        );
+        return fields;
+    }
+};
+
+const std::string projDocumentJson =
+    "{header:{version:3,author:\"me\"},"
+    "items:[{id:1,name:\"a\",tags:[1,2]},{id:2,name:\"b\",tags:[]}],"
+    "parallelItems:[{id:10,name:\"p\",tags:[3]},{id:11,name:\"q\",tags:[4]},{id:12,name:\"r\",tags:[]}],"
+    "extra:{id:5,name:\"e\",tags:[9]},body:\"text\",other:{x:[1,2]}}";
+
+}  // namespace
+
+/// @brief 射影したフィールドだけを読み込み、他のフィールドを変更しないことを確認する。
+TEST(ProjectionTest, ReadsOnlyProjectedFields) {
+    const JsonProjection projection{"header.version", "items[*].id", "extra.name"};
+    ProjDocument document;
+    std::vector<std::string> unknownKeys;
+    {
+        JsonProjectionScope scope(projection);
+        readJsonString(projDocumentJson, document, unknownKeys);
+    }
+    EXPECT_EQ(document.header.version, 3);
+    EXPECT_EQ(document.header.author, "");
+    ASSERT_EQ(document.items.size(), 2u);
+    EXPECT_EQ(document.items[0].id, 1);
+    EXPECT_EQ(document.items[1].id, 2);
+    EXPECT_EQ(document.items[0].name, "");
+    EXPECT_TRUE(document.items[0].tags.empty());
+    EXPECT_TRUE(document.parallelItems.empty());
+    ASSERT_NE(document.extra, nullptr);
+    EXPECT_EQ(document.extra->id, 0);
+    EXPECT_EQ(document.extra->name, "e");
+    EXPECT_EQ(document.body, "keep");
+    // 射影に含まれないキーは未知キーとして記録しない。
+    EXPECT_TRUE(unknownKeys.empty());
+
+    // スコープを抜けると全て読み込む。
+    ProjDocument full;
+    readJsonString(projDocumentJson, full, unknownKeys);
+    EXPECT_EQ(full.header.author, "me");
+    EXPECT_EQ(full.body, "text");
+    EXPECT_EQ(unknownKeys, std::vector<std::string>{"other"});
+}
+
+/// @brief 必須フィールドの判定が射影したフィールドだけに行われることを確認する。
+TEST(ProjectionTest, RequiresOnlyProjectedFields) {
+    const JsonProjection projection{"header.version", "items.id"};
+    JsonProjectionScope scope(projection);
+
+    ProjDocument document;
+    EXPECT_NO_THROW(readJsonString("{header:{version:1},items:[{id:4}]}", document));
+    EXPECT_EQ(document.header.version, 1);
+    ASSERT_EQ(document.items.size(), 1u);
+    EXPECT_EQ(document.items[0].id, 4);
+
+    ProjDocument missingId;
+    EXPECT_THROW(readJsonString("{header:{version:1},items:[{name:\"x\"}]}", missingId),
+        std::runtime_error);
+    ProjDocument missingItems;
+    EXPECT_THROW(readJsonString("{header:{version:1}}", missingItems), std::runtime_error);
+}
+
+/// @brief パスの末尾のフィールドは中身を全て読み込み、並列読み込みの区間にも射影が適用されることを確認する。
+TEST(ProjectionTest, SelectsWholeSubtreesAndParallelRanges) {
+    JsonProjection projection{"header", "parallelItems[*].name"};
+    projection.add("header.version");
+    ProjDocument document;
+    {
+        JsonProjectionScope scope(projection);
+        readJsonString(projDocumentJson, document);
+    }
+    EXPECT_EQ(document.header.version, 3);
+    EXPECT_EQ(document.header.author, "me");
+    EXPECT_TRUE(document.items.empty());
+    ASSERT_EQ(document.parallelItems.size(), 3u);
+    for (const auto& item : document.parallelItems) {
+        EXPECT_EQ(item.id, 0);
+        EXPECT_TRUE(item.tags.empty());
+    }
+    EXPECT_EQ(document.parallelItems[1].name, "q");
+    EXPECT_EQ(document.parallelItems[2].name, "r");
+
+    EXPECT_THROW(JsonProjection({"header..version"}), std::runtime_error);
+    EXPECT_THROW(JsonProjection({"[*]"}), std::runtime_error);
+}
+
+/// @brief 一括読み込みのタスクにも、呼び出しスレッドで指定した射影が適用されることを確認する。
+TEST(ProjectionTest, AppliesToBatchFileReads) {
+    std::vector<std::filesystem::path> paths;
+    for (int i = 0; i < 4; ++i) {
+        paths.emplace_back("test_projection_batch_" + std::to_string(i) + ".json");
+        std::ofstream ofs(paths.back(), std::ios::binary | std::ios::trunc);
+        ofs << projDocumentJson;
+    }
+    const JsonProjection projection{"header.version", "items[*].id"};
+    rai::common::ThreadPool pool(2);
+    for (rai::common::Executor* executor :
+        {static_cast<rai::common::Executor*>(&pool),
+         static_cast<rai::common::Executor*>(&rai::common::getInlineExecutor())}) {
+        std::vector<ProjDocument> documents(paths.size());
+        std::vector<std::vector<std::string>> unknownKeys;
+        {
+            JsonProjectionScope scope(projection);
+            readJsonFiles(paths, std::span(documents), unknownKeys, *executor);
+        }
+        for (std::size_t i = 0; i < documents.size(); ++i) {
+            EXPECT_EQ(documents[i].header.version, 3);
+            EXPECT_EQ(documents[i].header.author, "");
+            ASSERT_EQ(documents[i].items.size(), 2u);
+            EXPECT_EQ(documents[i].items[1].id, 2);
+            EXPECT_EQ(documents[i].items[1].name, "");
+            EXPECT_EQ(documents[i].body, "keep");
+            EXPECT_TRUE(unknownKeys[i].empty());
+        }
+    }
+    // 呼び出しスレッドの指定は、読み込みの後も変わらない。
+    EXPECT_EQ(scopedProjection(), nullptr);
+    for (const auto& path : paths) {
+        std::filesystem::remove(path);
+    }
+}
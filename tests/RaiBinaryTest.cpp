@@ -0,0 +1,344 @@
+import rai.serialization.rai_binary_io;
+import rai.serialization.rai_binary_reader;
+import rai.serialization.rai_binary_format;
+import rai.serialization.field_serializer;
+import rai.serialization.object_converter;
+import rai.serialization.object_serializer;
+import rai.serialization.polymorphic_converter;
+import rai.serialization.json_io;
+import rai.serialization.token_manager;
+import rai.collection.sorted_hash_array_map;
+import rai.common.thread_pool;
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace rai::serialization;
+
+namespace {
+
+/// @brief 同じ形のオブジェクトの配列の要素。
+struct RbPoint {
+    int x = 0;
+    int y = 0;
+
+    const ObjectSerializer& serializer() const {
+        static const auto fields = getFieldSet(
+            getRequiredField(&RbPoint::x, "x"),
+            getInitialOmittedField(&RbPoint::y, "y")
+        );
+        return fields;
+    }
+};
+
+/// @brief ポリモーフィックな要素の基底クラス。
+struct RbShape {
+    virtual ~RbShape() = default;
+    virtual const ObjectSerializer& serializer() const = 0;
+};
+
+/// @brief 半径を持つポリモーフィックな要素。
+struct RbCircle : RbShape {
+    double radius = 0;
+
+    const ObjectSerializer& serializer() const override {
+        static const auto fields = getFieldSet(
+            getRequiredField(&RbCircle::radius, "radius")
+        );
+        return fields;
+    }
+};
+
+/// @brief 名前と辺を持つポリモーフィックな要素。
+struct RbSquare : RbShape {
+    std::string name;
+    std::vector<int> sides;
+
+    const ObjectSerializer& serializer() const override {
+        static const auto sidesConverter = getContainerConverter<decltype(sides)>();
+        static const auto fields = getFieldSet(
+            getRequiredField(&RbSquare::name, "name"),
+            getRequiredField(&RbSquare::sides, "sides", sidesConverter)
+        );
+        return fields;
+    }
+};
+
+using RbShapeEntry = std::pair<std::string_view, PolymorphicTypeFactory<std::unique_ptr<RbShape>>>;
+inline const auto rbShapeEntries = rai::collection::makeSortedHashArrayMap(
+    RbShapeEntry{"Circle", [] { return std::make_unique<RbCircle>(); }},
+    RbShapeEntry{"Square", [] { return std::make_unique<RbSquare>(); }}
+);
+
+/// @brief 様々な型のフィールドを持つテスト用の文書。
+struct RbDocument {
+    std::string title;
+    int negative = 0;
+    std::int64_t large = 0;
+    double ratio = 0;
+    float scale = 0;
+    bool flag = false;
+    std::vector<RbPoint> points;
+    std::vector<std::vector<int>> grid;
+    std::vector<int> empty;
+    std::vector<std::string> tags;
+    std::vector<std::unique_ptr<RbShape>> shapes;
+    std::unique_ptr<RbPoint> missing;
+    std::unique_ptr<RbPoint> present;
+
+    const ObjectSerializer& serializer() const {
+        static const auto pointsConverter = getContainerConverter<decltype(points)>();
+        static const auto rowConverter = getContainerConverter<std::vector<int>>();
+        static const auto gridConverter = getContainerConverter<decltype(grid)>(rowConverter);
+        static const auto emptyConverter = getContainerConverter<decltype(empty)>();
+        static const auto tagsConverter = getContainerConverter<decltype(tags)>();
+        static const auto shapesConverter =
+            getPolymorphicArrayConverter<decltype(shapes)>(rbShapeEntries, "kind");
+        static const auto missingConverter = getUniquePtrConverter<decltype(missing)>();
+        static const auto presentConverter = getUniquePtrConverter<decltype(present)>();
+        static const auto fields = getFieldSet(
+            getRequiredField(&RbDocument::title, "title"),
+            getRequiredField(&RbDocument::negative, "negative"),
+            getRequiredField(&RbDocument::large, "large"),
+            getRequiredField(&RbDocument::ratio, "ratio"),
+            getRequiredField(&RbDocument::scale, "scale"),
+            getRequiredField(&RbDocument::flag, "flag"),
+            getRequiredField(&RbDocument::points, "points", pointsConverter),
+            getRequiredField(&RbDocument::grid, "grid", gridConverter),
+            getRequiredField(&RbDocument::empty, "empty", emptyConverter),
+            getRequiredField(&RbDocument::tags, "tags", tagsConverter),
+            getRequiredField(&RbDocument::shapes, "shapes", shapesConverter),
+            getRequiredField(&RbDocument::missing, "missing", missingConverter),
+            getRequiredField(&RbDocument::present, "present", presentConverter)
+        );
+        return fields;
+    }
+};
+
+/// @brief 点の配列を持つテスト用の文書。
+struct RbPointList {
+    std::vector<RbPoint> list;
+
+    const ObjectSerializer& serializer() const {
+        static const auto listConverter = getContainerConverter<decltype(list)>();
+        static const auto fields = getFieldSet(
+            getRequiredField(&RbPointList::list, "list", listConverter)
+        );
+        return fields;
+    }
+};
+
+/// @brief テスト用の文書を作る補助関数。
+RbDocument makeRbDocument() {
+    RbDocument document;
+    document.title = "a title with \"quotes\" and\nnewlines";
+    document.negative = -300;
+    document.large = INT64_MIN + 1;
+    document.ratio = 0.1;
+    document.scale = 0.5f;
+    document.flag = true;
+    for (int i = 0; i < 100; ++i) {
+        document.points.push_back(RbPoint{i, 70000 * i});
+    }
+    document.grid = {{1, 2, 3}, {}, {-4}};
+    document.tags = {"one", std::string(300, 't'), ""};
+    auto circle = std::make_unique<RbCircle>();
+    circle->radius = 2.25;
+    auto square = std::make_unique<RbSquare>();
+    square->name = "square";
+    square->sides = {1, 1, 1, 1};
+    document.shapes.push_back(std::move(circle));
+    document.shapes.push_back(std::move(square));
+    document.shapes.push_back(nullptr);
+    document.present = std::make_unique<RbPoint>(RbPoint{-1, 1});
+    return document;
+}
+
+/// @brief リトルエンディアンの整数を追加する補助関数。
+void appendRbUInt(std::string& out, std::uint64_t value, std::size_t bytes) {
+    for (std::size_t i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<char>(value >> (8 * i)));
+    }
+}
+
+/// @brief 3つの点の配列を手書きしたRaiBinaryを作る補助関数。2つ目の点はyを省略する。
+std::string makeHandwrittenRbPoints() {
+    std::string out(reinterpret_cast<const char*>(raibinary::magic), 4);
+    appendRbUInt(out, 0, 8);
+    const std::size_t set0 = out.size();
+    appendRbUInt(out, 0, 4);   // ID
+    appendRbUInt(out, 1, 4);   // フィールド数
+    appendRbUInt(out, 1, 4);   // オブジェクト数
+    out += '\x14';             // 単一要素型配列（要素数1byte）、キー長1byte
+    out += '\x04';
+    out += "list";
+    out += '\0';               // skipMap
+    out += '\x20';             // 要素はオブジェクト（定義ID・オブジェクトIDとも1byte）
+    out += '\x01';             // 定義ID
+    out += '\0';               // 先頭のオブジェクトID
+    out += '\x03';             // 要素数
+    const std::size_t set1 = out.size();
+    appendRbUInt(out, 1, 4);
+    appendRbUInt(out, 2, 4);
+    appendRbUInt(out, 3, 4);
+    out += '\x04';             // UInt8
+    out += '\x01';
+    out += 'x';
+    out += '\0';
+    out += "\x0A\x0B\x0C";
+    out += '\x04';
+    out += '\x01';
+    out += 'y';
+    out += '\x02';             // 2つ目のオブジェクトはyを省略
+    out += "\x14\x16";
+    const std::size_t table = out.size();
+    appendRbUInt(out, 2, 4);
+    appendRbUInt(out, set0, 8);
+    appendRbUInt(out, set1, 8);
+    for (std::size_t i = 0; i < 8; ++i) {
+        out[4 + i] = static_cast<char>(table >> (8 * i));
+    }
+    return out;
+}
+
+}  // namespace
+
+// ********************************************************************************
+// テストカテゴリ：RaiBinary形式
+// ********************************************************************************
+
+/// @brief 様々な型・ポリモーフィックな配列・入れ子の配列・nullを書き出して読み戻せることのテスト。
+TEST(RaiBinaryTest, RoundTripsDocument) {
+    const RbDocument document = makeRbDocument();
+    const std::string binary = getRaiBinaryContent(document);
+    ASSERT_GE(binary.size(), raibinary::headerSize);
+    EXPECT_EQ(binary.compare(0, 4, reinterpret_cast<const char*>(raibinary::magic), 4), 0);
+    // 列に並べて最小の幅で表すため、JSONより小さくなる。
+    EXPECT_LT(binary.size(), getJsonContent(document).size());
+
+    rai::common::ThreadPool pool(2);
+    for (rai::common::Executor* executor :
+        {static_cast<rai::common::Executor*>(&pool),
+         static_cast<rai::common::Executor*>(&rai::common::getInlineExecutor())}) {
+        RbDocument loaded;
+        std::vector<std::string> unknownKeys;
+        readRaiBinary(binary, loaded, unknownKeys, *executor);
+        EXPECT_TRUE(unknownKeys.empty());
+        EXPECT_EQ(getJsonContent(loaded), getJsonContent(document));
+        EXPECT_EQ(loaded.large, INT64_MIN + 1);
+        EXPECT_EQ(loaded.points[99].y, 70000 * 99);
+        EXPECT_EQ(loaded.shapes[2], nullptr);
+        EXPECT_EQ(loaded.missing, nullptr);
+    }
+
+    const std::string filename = "test_rai_binary.rbin";
+    writeRaiBinaryFile(document, filename);
+    RbDocument fromFile;
+    readRaiBinaryFile(filename, fromFile);
+    EXPECT_EQ(getJsonContent(fromFile), getJsonContent(document));
+    std::remove(filename.c_str());
+    EXPECT_THROW(readRaiBinaryFile("no_such_file.rbin", fromFile), std::runtime_error);
+}
+
+/// @brief JSONとRaiBinaryを相互に変換でき、変換を繰り返しても内容が変わらないことのテスト。
+TEST(RaiBinaryTest, ConvertsBetweenJsonAndBinary) {
+    const std::string json =
+        "{\"a key\":[1,\"x\",null,true,{b:1},[2.5,[]]],c:[{d:1},{d:\"s\"},{d:2}],"
+        "e:{f:{g:-5}},h:-1e300,i:[[1,2],[3]]}";
+    const std::string binary = convertJsonToRaiBinary(json);
+    const std::string converted = convertRaiBinaryToJson(binary);
+    EXPECT_EQ(convertRaiBinaryToJson(convertJsonToRaiBinary(converted)), converted);
+    EXPECT_NE(converted.find("\"a key\":[1,\"x\",null,true,{b:1},[2.5,[]]]"), std::string::npos);
+    EXPECT_NE(converted.find("c:[{d:1},{d:\"s\"},{d:2}]"), std::string::npos);
+    EXPECT_NE(converted.find("i:[[1,2],[3]]"), std::string::npos);
+
+    // ルートがオブジェクトでない入力は変換できない。
+    EXPECT_THROW(convertJsonToRaiBinary("[1,2]"), std::runtime_error);
+}
+
+/// @brief skipMapで省略されたフィールドを読み飛ばし、連番のオブジェクトを配列の要素として読めることのテスト。
+TEST(RaiBinaryTest, ReadsHandwrittenSkipMap) {
+    const std::string binary = makeHandwrittenRbPoints();
+    RbPointList list;
+    list.list.resize(1);
+    readRaiBinary(binary, list, rai::common::getInlineExecutor());
+    ASSERT_EQ(list.list.size(), 3u);
+    EXPECT_EQ(list.list[0].x, 10);
+    EXPECT_EQ(list.list[0].y, 20);
+    EXPECT_EQ(list.list[1].x, 11);
+    EXPECT_EQ(list.list[1].y, 0);
+    EXPECT_EQ(list.list[2].y, 22);
+    EXPECT_EQ(convertRaiBinaryToJson(binary), "{list:[{x:10,y:20},{x:11},{x:12,y:22}]}");
+
+    // 配列の要素数をオブジェクト数より多くすると、不正な参照として扱う。
+    std::string overflow = binary;
+    overflow[12 + 12 + 7 + 3] = '\x04';
+    EXPECT_THROW(convertRaiBinaryToJson(overflow), std::runtime_error);
+}
+
+/// @brief 壊れた入力は範囲外を読まずに例外になることのテスト。
+TEST(RaiBinaryTest, RejectsCorruptInput) {
+    const std::string binary = getRaiBinaryContent(makeRbDocument());
+    RbDocument loaded;
+    EXPECT_THROW(readRaiBinary(std::string_view("RAIF"), loaded), std::runtime_error);
+    std::string badMagic = binary;
+    badMagic[0] = 'R';
+    EXPECT_THROW(readRaiBinary(badMagic, loaded), std::runtime_error);
+
+    // 途中で切れた入力は、テーブルが範囲外になるため全て例外になる。
+    for (std::size_t size = 0; size < binary.size(); ++size) {
+        EXPECT_THROW(RaiBinaryReader(std::string_view(binary.data(), size)), std::runtime_error);
+    }
+
+    // 1byteずつ書き換えた入力は、読めるか例外になる（範囲外を読まない）。
+    for (std::size_t i = 0; i < binary.size(); ++i) {
+        std::string corrupt = binary;
+        corrupt[i] = static_cast<char>(corrupt[i] ^ 0xA5);
+        try {
+            convertRaiBinaryToJson(corrupt);
+        } catch (const std::runtime_error&) {
+        }
+    }
+
+    // ルートのオブジェクト集合のIDを重複させると、テーブルの検証で例外になる。
+    std::string list = makeHandwrittenRbPoints();
+    list[12 + 12 + 7 + 3 + 1] = '\0';
+    EXPECT_THROW(RaiBinaryReader{list}, std::runtime_error);
+}
+
+/// @brief 多数のオブジェクト集合がそれぞれ上限近いオブジェクト数を持つ入力は、確保の前に例外になることのテスト。
+TEST(RaiBinaryTest, RejectsExcessiveTotalObjectCount) {
+    constexpr std::size_t setCount = 1000;
+    constexpr std::uint64_t objectCount = 150000;
+    std::string out(reinterpret_cast<const char*>(raibinary::magic), 4);
+    appendRbUInt(out, 0, 8);
+    std::vector<std::size_t> offsets;
+    for (std::size_t id = 0; id < setCount; ++id) {
+        offsets.push_back(out.size());
+        appendRbUInt(out, id, 4);
+        appendRbUInt(out, 0, 4);            // フィールド数
+        appendRbUInt(out, objectCount, 4);  // 各集合は入力のbyte数の8倍に収まる
+    }
+    const std::size_t table = out.size();
+    appendRbUInt(out, setCount, 4);
+    for (const std::size_t offset : offsets) {
+        appendRbUInt(out, offset, 8);
+    }
+    for (std::size_t i = 0; i < 8; ++i) {
+        out[4 + i] = static_cast<char>(table >> (8 * i));
+    }
+    ASSERT_LT(objectCount, out.size() * raibinary::skipMapGroupSize);
+
+    try {
+        RaiBinaryReader reader{out};
+        FAIL() << "expected an exception";
+    } catch (const std::runtime_error& error) {
+        EXPECT_NE(std::string(error.what()).find("too many objects"), std::string::npos) << error.what();
+    }
+}
@@ -0,0 +1,290 @@
+import rai.serialization.token_manager;
+import rai.serialization.ring_buffer_token_manager;
+import rai.serialization.json_parser;
+import rai.serialization.json_tokenizer;
+import rai.serialization.reading_ahead_buffer;
+import rai.serialization.parallel_input_stream_source;
+import rai.serialization.field_serializer;
+import rai.serialization.object_converter;
+import rai.serialization.object_serializer;
+import rai.serialization.json_io;
+import rai.serialization.async_file_input_source;
+import rai.common.thread_pool;
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace rai::serialization;
+
+// ********************************************************************************
+// テストカテゴリ：RingBufferTokenManager
+// ********************************************************************************
+
+/// @brief 同一スレッドで容量内のトークンを追加・取得できることのテスト。
+TEST(RingBufferTokenManagerTest, PushThenTakeInOrder) {
+    RingBufferTokenManager tokens(16, 4);
+    tokens.pushToken(JsonToken::make(JsonTokenType::StartArray, 0));
+    tokens.pushToken(JsonToken::makeInteger(42, 1));
+    tokens.pushToken(JsonToken::make(JsonTokenType::EndArray, 3));
+    tokens.pushToken(JsonToken::make(JsonTokenType::EndOfStream, 4));
+
+    EXPECT_EQ(tokens.peek().type, JsonTokenType::StartArray);
+    EXPECT_EQ(tokens.take().type, JsonTokenType::StartArray);
+    auto value = tokens.take();
+    ASSERT_EQ(value.type, JsonTokenType::Integer);
+    EXPECT_EQ(value.integer, 42);
+    EXPECT_EQ(value.position, 1u);
+    EXPECT_EQ(tokens.take().type, JsonTokenType::EndArray);
+    EXPECT_EQ(tokens.take().type, JsonTokenType::EndOfStream);
+}
+
+/// @brief 容量より多いトークンを別スレッドから流しても順序が保たれることのテスト。
+TEST(RingBufferTokenManagerTest, ProducerThreadWrapsAround) {
+    constexpr std::int64_t count = 100000;
+    RingBufferTokenManager tokens(16, 4);
+    std::thread producer([&] {
+        for (std::int64_t i = 0; i < count; ++i) {
+            tokens.pushToken(JsonToken::makeInteger(i, static_cast<std::size_t>(i)));
+        }
+        tokens.pushToken(JsonToken::make(JsonTokenType::EndOfStream, count));
+    });
+
+    for (std::int64_t i = 0; i < count; ++i) {
+        auto token = tokens.take();
+        ASSERT_EQ(token.integer, i);
+    }
+    EXPECT_EQ(tokens.take().type, JsonTokenType::EndOfStream);
+    producer.join();
+}
+
+/// @brief トークン待ち中の消費者にエラーが伝播することのテスト。
+TEST(RingBufferTokenManagerTest, SignalErrorWakesConsumer) {
+    RingBufferTokenManager tokens(16, 4);
+    std::thread producer([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        tokens.signalError(std::make_exception_ptr(std::runtime_error("tokenizer failed")));
+    });
+    EXPECT_THROW(tokens.take(), std::runtime_error);
+    producer.join();
+    // エラー通知後はトークンを追加しても取得できない。
+    tokens.pushToken(JsonToken::make(JsonTokenType::EndOfStream, 0));
+    EXPECT_THROW(tokens.peek(), std::runtime_error);
+}
+
+/// @brief 消費者が中断を通知すると、空き待ちの生産者が解放されることのテスト。
+TEST(RingBufferTokenManagerTest, CloseReleasesBlockedProducer) {
+    RingBufferTokenManager tokens(4, 2);
+    std::thread producer([&] {
+        for (std::int64_t i = 0; i < 1000; ++i) {
+            tokens.pushToken(JsonToken::makeInteger(i, 0));
+        }
+    });
+    EXPECT_EQ(tokens.take().integer, 0);
+    tokens.close();
+    producer.join();
+}
+
+/// @brief 別スレッドのトークナイザーからJsonParserで読み込めることのテスト。
+TEST(RingBufferTokenManagerTest, JsonParserReadsFromTokenizerThread) {
+    std::string json = "[";
+    for (int i = 0; i < 5000; ++i) {
+        json += (i == 0 ? "" : ",") + std::to_string(i);
+    }
+    json += "]";
+    constexpr std::size_t aheadSize = 8;
+    json.reserve(json.size() + aheadSize);
+
+    ReadingAheadBuffer inputSource(std::move(json), aheadSize);
+    RingBufferTokenManager tokens(64, 8);
+    StdoutMessageOutput warningOutput;
+    JsonTokenizer<ReadingAheadBuffer, RingBufferTokenManager> tokenizer(
+        inputSource, tokens, warningOutput);
+    std::thread producer([&] { tokenizer.tokenize(); });
+
+    JsonParser parser(tokens);
+    std::vector<int> values;
+    parser.startArray();
+    while (!parser.nextIsEndArray()) {
+        int value = 0;
+        parser.readTo(value);
+        values.push_back(value);
+    }
+    parser.endArray();
+    producer.join();
+
+    ASSERT_EQ(values.size(), 5000u);
+    EXPECT_EQ(values.front(), 0);
+    EXPECT_EQ(values.back(), 4999);
+}
+
+/// @brief 並列読み込み用のテスト構造体。
+struct RingBufferRecord {
+    int id = 0;
+    std::string name;
+
+    const ObjectSerializer& serializer() const {
+        static const auto fields = getFieldSet(
+            getRequiredField(&RingBufferRecord::id, "id"),
+            getRequiredField(&RingBufferRecord::name, "name")
+        );
+        return fields;
+    }
+};
+
+/// @brief 並列読み込み用のルート構造体。
+struct RingBufferDocument {
+    std::vector<RingBufferRecord> records;
+
+    const ObjectSerializer& serializer() const {
+        static const auto recordsConverter = getContainerConverter<decltype(records)>();
+        static const auto fields = getFieldSet(
+            getRequiredField(&RingBufferDocument::records, "records", recordsConverter)
+        );
+        return fields;
+    }
+};
+
+/// @brief リングバッファ容量を超える大きさのファイルを並列版で読み込めることのテスト。
+TEST(RingBufferTokenManagerTest, ParallelFileReadUsesRingBuffer) {
+    RingBufferDocument original;
+    for (int i = 0; i < 3000; ++i) {
+        original.records.push_back({i, "record" + std::to_string(i)});
+    }
+    const std::string filename = "test_ring_buffer_parallel.json";
+    writeJsonFile(original, filename);
+
+    RingBufferDocument loaded;
+    readJsonFileParallel(filename, loaded);
+    std::remove(filename.c_str());
+
+    ASSERT_EQ(loaded.records.size(), original.records.size());
+    EXPECT_EQ(loaded.records[2999].id, 2999);
+    EXPECT_EQ(loaded.records[2999].name, "record2999");
+}
+
+/// @brief 実行器のワーカー数と同じ数のタスクから同じ実行器で大ファイルを読んでも、止まらないことのテスト。
+/// @note トークナイザーはワーカー自身のキューに積まれるため、ワーカーの中でリングバッファを待つと止まる。
+TEST(RingBufferTokenManagerTest, FileReadsFromEveryWorkerOfSamePool) {
+    RingBufferDocument original;
+    for (int i = 0; i < 3000; ++i) {
+        original.records.push_back({i, "record" + std::to_string(i)});
+    }
+    const std::string filename = "test_ring_buffer_from_workers.json";
+    writeJsonFile(original, filename);
+    ASSERT_GT(std::filesystem::file_size(filename), getJsonFileReadPolicy().smallFileThreshold);
+
+    for (std::size_t threadCount : {1u, 2u, 4u}) {
+        SCOPED_TRACE(threadCount);
+        rai::common::ThreadPool pool(threadCount);
+        std::vector<RingBufferDocument> loaded(threadCount * 4);
+        std::vector<std::future<void>> tasks;
+        for (std::size_t i = 0; i < loaded.size(); ++i) {
+            tasks.push_back(pool.enqueue([&, i]() {
+                switch (i % 4) {
+                case 0: readJsonFile(filename, loaded[i], pool); break;
+                case 1: readJsonFileParallel(filename, loaded[i], pool); break;
+                case 2: readJsonFileMapped(filename, loaded[i], pool); break;
+                default: readJsonFileAsync(filename, loaded[i], AsyncFileInputOptions{}, pool); break;
+                }
+            }));
+        }
+        for (auto& task : tasks) {
+            pool.wait(task);
+            task.get();
+        }
+        for (const auto& document : loaded) {
+            ASSERT_EQ(document.records.size(), original.records.size());
+            EXPECT_EQ(document.records[2999].name, "record2999");
+        }
+    }
+    std::remove(filename.c_str());
+}
+
+/// @brief 並列版でトークナイザーのエラーが呼び出し元へ伝播することのテスト。
+TEST(RingBufferTokenManagerTest, ParallelFileReadPropagatesTokenizerError) {
+    const std::string filename = "test_ring_buffer_parallel_error.json";
+    {
+        std::ofstream ofs(filename);
+        ofs << "{records:[{id:1,name:\"a\"},{id:2,name:\"b\" @}]}";
+    }
+    RingBufferDocument loaded;
+    EXPECT_THROW(readJsonFileParallel(filename, loaded), std::runtime_error);
+    std::remove(filename.c_str());
+}
+
+/// @brief 文字列アリーナ解放のテスト用に、長い名前のレコードを並べたJSONを作る。
+static std::string makeArenaReleaseJson(int count) {
+    std::string json = "{records:[";
+    for (int i = 0; i < count; ++i) {
+        json += (i == 0 ? "{id:" : ",{id:") + std::to_string(i) + ",name:\"" +
+            std::string(120, static_cast<char>('a' + i % 26)) + "\"}";
+    }
+    json += "]}";
+    return json;
+}
+
+/// @brief アリーナのチャンク表1周分より多いチャンクを、要素毎の解放で流し切れることのテスト。
+/// @note 連続領域でない入力では全ての文字列がアリーナに入る。チャンクを小さくしてチャンク数を増やす。
+TEST(RingBufferTokenManagerTest, ReleasesArenaChunksWhileReadingRecords) {
+    constexpr int count = 6000;
+    std::istringstream stream(makeArenaReleaseJson(count));
+    ParallelInputStreamSource inputSource(stream, rai::common::getInlineExecutor());
+    RingBufferTokenManager tokens;
+    tokens.arena().setMaxChunkSize(128);
+    StdoutMessageOutput warningOutput;
+    JsonTokenizer<ParallelInputStreamSource, RingBufferTokenManager> tokenizer(
+        inputSource, tokens, warningOutput);
+    std::exception_ptr tokenizerError;
+    std::thread producer([&] {
+        try {
+            tokenizer.tokenize();
+        } catch (...) {
+            tokenizerError = std::current_exception();
+            tokens.signalError(tokenizerError);
+        }
+    });
+
+    JsonParser parser(tokens);
+    RingBufferDocument loaded;
+    try {
+        readJsonObject(parser, loaded);
+    } catch (...) {
+        tokens.close();
+        producer.join();
+        throw;
+    }
+    producer.join();
+    ASSERT_FALSE(tokenizerError);
+
+    EXPECT_GT(tokens.arena().allocatedChunks(), 4096u);
+    ASSERT_EQ(loaded.records.size(), static_cast<std::size_t>(count));
+    EXPECT_EQ(loaded.records[count - 1].id, count - 1);
+    EXPECT_EQ(loaded.records[count - 1].name, std::string(120, static_cast<char>('a' + (count - 1) % 26)));
+}
+
+/// @brief 一括でトークン化した場合も、読み込みの進行に合わせてアリーナのチャンクを解放することのテスト。
+TEST(RingBufferTokenManagerTest, TokenManagerReleasesArenaChunksAfterConsuming) {
+    constexpr int count = 2000;
+    std::istringstream stream(makeArenaReleaseJson(count));
+    ParallelInputStreamSource inputSource(stream, rai::common::getInlineExecutor());
+    TokenManager tokens;
+    tokens.arena().setMaxChunkSize(128);
+    StdoutMessageOutput warningOutput;
+    JsonTokenizer<ParallelInputStreamSource, TokenManager> tokenizer(inputSource, tokens, warningOutput);
+    tokenizer.tokenize();
+    EXPECT_GE(tokens.arena().liveChunks(), static_cast<std::size_t>(count));
+
+    JsonParser parser(tokens);
+    RingBufferDocument loaded;
+    readJsonObject(parser, loaded);
+    ASSERT_EQ(loaded.records.size(), static_cast<std::size_t>(count));
+    EXPECT_EQ(loaded.records[0].name, std::string(120, 'a'));
+    EXPECT_LE(tokens.arena().liveChunks(), 2u);
+}
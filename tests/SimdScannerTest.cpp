@@ -0,0 +1,178 @@
+import rai.serialization.simd_scanner;
+import rai.serialization.token_manager;
+import rai.serialization.json_tokenizer;
+import rai.serialization.reading_ahead_buffer;
+import rai.serialization.reading_ahead_buffer_ring;
+import rai.serialization.parallel_input_stream_source;
+import rai.common.thread_pool;
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace rai::serialization;
+
+namespace {
+
+/// @brief 比較対象とする実装の種類の一覧。
+const std::vector<simd::SimdLevel> simdLevels = {
+    simd::SimdLevel::Sse2, simd::SimdLevel::Avx2, simd::SimdLevel::Neon};
+
+/// @brief 停止byteを所々に含む乱数のbyte列を生成する補助関数。
+/// @param size 生成するbyte数。
+/// @param seed 乱数の種。
+std::string makeScanInput(std::size_t size, std::uint32_t seed) {
+    static const std::string specials = std::string("\"'\\\n\r\t \x01\xE2/", 11) +
+        std::string(1, '\0');
+    std::mt19937 engine(seed);
+    std::uniform_int_distribution<int> choice(0, 99);
+    std::uniform_int_distribution<int> anyByte(0x20, 0xFF);
+    std::string result;
+    for (std::size_t i = 0; i < size; ++i) {
+        const int kind = choice(engine);
+        if (kind < 4) {
+            result += specials[static_cast<std::size_t>(kind * 3) % specials.size()];
+        } else if (kind < 40) {
+            result += ' ';
+        } else {
+            result += static_cast<char>(anyByte(engine));
+        }
+    }
+    return result;
+}
+
+/// @brief JSON文字列をトークン化し、文字列・キーの内容を返す補助関数。
+/// @param json 入力文字列。
+std::vector<std::string> tokenizeTexts(std::string json) {
+    constexpr std::size_t aheadSize = 8;
+    json.reserve(json.size() + aheadSize);
+    ReadingAheadBuffer input(std::move(json), aheadSize);
+    TokenManager tokens;
+    StdoutMessageOutput warningOutput;
+    JsonTokenizer<ReadingAheadBuffer, TokenManager> tokenizer(input, tokens, warningOutput);
+    tokenizer.tokenize();
+
+    std::vector<std::string> texts;
+    for (auto token = tokens.take(); token.type != JsonTokenType::EndOfStream;
+         token = tokens.take()) {
+        if (token.type == JsonTokenType::Key || token.type == JsonTokenType::String) {
+            texts.emplace_back(tokens.text(token));
+        }
+    }
+    return texts;
+}
+
+/// @brief バッファ毎に読み込む入力元でトークン化し、文字列・キーの内容を返す補助関数。
+/// @param json 入力文字列。
+/// @param chunkSize 1つのバッファの容量。
+std::vector<std::string> tokenizeStreamTexts(const std::string& json, std::size_t chunkSize) {
+    std::istringstream stream(json);
+    ParallelInputStreamSource input(stream, InputBufferOptions{chunkSize, 2, false},
+        rai::common::getInlineExecutor());
+    TokenManager tokens;
+    StdoutMessageOutput warningOutput;
+    JsonTokenizer<ParallelInputStreamSource, TokenManager> tokenizer(input, tokens, warningOutput);
+    tokenizer.tokenize();
+
+    std::vector<std::string> texts;
+    for (auto token = tokens.take(); token.type != JsonTokenType::EndOfStream;
+         token = tokens.take()) {
+        if (token.type == JsonTokenType::Key || token.type == JsonTokenType::String) {
+            texts.emplace_back(tokens.text(token));
+        }
+    }
+    return texts;
+}
+
+}  // namespace
+
+// ********************************************************************************
+// テストカテゴリ：SimdScanner
+// ********************************************************************************
+
+/// @brief 各SIMD実装の走査結果がスカラー実装と一致することのテスト。
+TEST(SimdScannerTest, MatchesScalarOnRandomInput) {
+    const auto& scalar = simd::scannerFor(simd::SimdLevel::Scalar);
+    for (std::uint32_t seed = 0; seed < 50; ++seed) {
+        const std::string input = makeScanInput(200, seed);
+        for (const auto level : simdLevels) {
+            const auto& scanner = simd::scannerFor(level);
+            for (std::size_t start = 0; start < input.size(); start += 7) {
+                const char* data = input.data() + start;
+                const std::size_t size = input.size() - start;
+                ASSERT_EQ(scanner.stringRun(data, size, '"'), scalar.stringRun(data, size, '"'))
+                    << seed << ":" << start;
+                ASSERT_EQ(scanner.stringRun(data, size, '\''),
+                    scalar.stringRun(data, size, '\'')) << seed << ":" << start;
+                ASSERT_EQ(scanner.whitespaceRun(data, size), scalar.whitespaceRun(data, size))
+                    << seed << ":" << start;
+                ASSERT_EQ(scanner.lineCommentRun(data, size), scalar.lineCommentRun(data, size))
+                    << seed << ":" << start;
+            }
+        }
+    }
+}
+
+/// @brief 停止byteがない場合は指定範囲の長さを返し、範囲外を読まないことのテスト。
+TEST(SimdScannerTest, StopsAtRangeEnd) {
+    // 範囲の直後に停止byteを置き、範囲内で止まらないことを確かめる。
+    std::string input(100, 'a');
+    input += "\"";
+    for (const auto level : simdLevels) {
+        const auto& scanner = simd::scannerFor(level);
+        for (std::size_t size = 0; size <= 100; ++size) {
+            ASSERT_EQ(scanner.stringRun(input.data(), size, '"'), size) << size;
+            ASSERT_EQ(scanner.lineCommentRun(input.data(), size), size) << size;
+        }
+    }
+    const std::string spaces(100, ' ');
+    EXPECT_EQ(simd::activeScanner().whitespaceRun(spaces.data(), spaces.size()), 100u);
+}
+
+/// @brief SIMD走査を経由した文字列・コメント・空白の解析結果のテスト。
+TEST(SimdScannerTest, TokenizerHandlesLongRuns) {
+    const std::string longText(100, 'x');
+    const std::string indent(70, ' ');
+    const std::string json = "{" + indent + "a:\"" + longText + "\"," +
+        "// line comment " + longText + "\xE2\x80\xA8" + indent +
+        "b:'" + longText + "\\n" + longText + "\"'," +
+        "/* block " + longText + " * not end */" +
+        "c:\"ctl\x01" + longText + "\xE2\x82\xAC\"}";
+
+    const auto texts = tokenizeTexts(json);
+    ASSERT_EQ(texts.size(), 6u);
+    EXPECT_EQ(texts[0], "a");
+    EXPECT_EQ(texts[1], longText);
+    EXPECT_EQ(texts[2], "b");
+    EXPECT_EQ(texts[3], longText + "\n" + longText + "\"");
+    EXPECT_EQ(texts[4], "c");
+    EXPECT_EQ(texts[5], "ctl\x01" + longText + "\xE2\x82\xAC");
+}
+
+/// @brief 閉じていない文字列・コメントを終端で検出することのテスト。
+TEST(SimdScannerTest, TokenizerDetectsUnterminatedInput) {
+    const std::string longText(100, 'x');
+    EXPECT_THROW(tokenizeTexts("[\"" + longText), std::runtime_error);
+    EXPECT_EQ(tokenizeTexts("[\"a\"] // " + longText).size(), 1u);
+    EXPECT_EQ(tokenizeTexts("[\"a\"] /* " + longText).size(), 1u);
+}
+
+/// @brief バッファ毎の入力元でも、バッファの境目を跨ぐ文字列・コメント・空白を正しく走査することのテスト。
+TEST(SimdScannerTest, TokenizerScansAcrossBufferBoundaries) {
+    const std::string longText(100, 'x');
+    const std::string indent(70, ' ');
+    const std::string json = "{" + indent + "a:\"" + longText + "\"," +
+        "// line comment " + longText + "\xE2\x80\xA8" + indent +
+        "b:'" + longText + "\\n" + longText + "\"'," +
+        "/* block " + longText + " * not end */" +
+        "c:\"ctl\x01" + longText + "\xE2\x82\xAC\"}";
+    const auto expected = tokenizeTexts(json);
+    ASSERT_EQ(expected.size(), 6u);
+    for (std::size_t chunkSize : {9u, 16u, 23u, 64u, 4096u}) {
+        EXPECT_EQ(tokenizeStreamTexts(json, chunkSize), expected) << chunkSize;
+    }
+    EXPECT_THROW(tokenizeStreamTexts("[\"" + longText, 16), std::runtime_error);
+    EXPECT_EQ(tokenizeStreamTexts("[\"a\"] /* " + longText, 16).size(), 1u);
+}
@@ -0,0 +1,148 @@
+import rai.serialization.token_manager;
+import rai.serialization.json_tokenizer;
+import rai.serialization.json_chunked_tokenizer;
+import rai.serialization.json_parser;
+import rai.serialization.reading_ahead_buffer;
+import rai.serialization.field_serializer;
+import rai.serialization.object_converter;
+import rai.serialization.object_serializer;
+import rai.serialization.json_io;
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace rai::serialization;
+
+namespace {
+
+/// @brief 読み出し元の開始トークンに記録されたsubtreeSizeを、出現順に集める補助関数。
+std::vector<std::uint64_t> collectSubtreeSizes(TokenSource& source) {
+    std::vector<std::uint64_t> sizes;
+    for (;;) {
+        const JsonToken token = source.take();
+        if (token.type == JsonTokenType::EndOfStream) {
+            return sizes;
+        }
+        if (token.type == JsonTokenType::StartObject || token.type == JsonTokenType::StartArray) {
+            sizes.push_back(token.subtreeSize);
+        }
+    }
+}
+
+/// @brief TokenManagerへトークン化した結果のsubtreeSizeを返す補助関数。
+std::vector<std::uint64_t> subtreeSizesOf(const std::string& json) {
+    std::string buffer = json;
+    buffer.reserve(buffer.size() + 8);
+    ReadingAheadBuffer input(std::move(buffer), 8);
+    TokenManager tokens;
+    StdoutMessageOutput warningOutput;
+    JsonTokenizer<ReadingAheadBuffer, TokenManager> tokenizer(input, tokens, warningOutput);
+    tokenizer.tokenize();
+    return collectSubtreeSizes(tokens);
+}
+
+/// @brief 未知キーの読み飛ばしの確認に使う要素。
+struct SkipRecord {
+    int id = 0;
+    std::string name;
+
+    const ObjectSerializer& serializer() const {
+        static const auto fields = getFieldSet(
+            getRequiredField(&SkipRecord::id, "id"),
+            getRequiredField(&SkipRecord::name, "name")
+        );
+        return fields;
+    }
+
+    bool operator==(const SkipRecord&) const = default;
+};
+
+/// @brief 要素を並列に読み込む文書。
+struct SkipDocument {
+    std::vector<SkipRecord> records;
+
+    const ObjectSerializer& serializer() const {
+        static const auto recordsConverter = getParallelContainerConverter<decltype(records)>(2);
+        static const auto fields = getFieldSet(
+            getRequiredField(&SkipDocument::records, "records", recordsConverter)
+        );
+        return fields;
+    }
+};
+
+/// @brief 要素毎に大きな未知の値を持つ文書のJSONを生成する補助関数。
+std::string makeSkipDocumentJson(int count) {
+    std::string json = "{records:[";
+    for (int i = 0; i < count; ++i) {
+        json += i == 0 ? "" : ",";
+        json += "{blob:{rows:[[1,2,3],[\"a\",{k:null}],[]],note:\"n" + std::to_string(i) +
+            "\"},id:" + std::to_string(i) + ",extra:[{x:1},{y:[true,false]}],name:\"r" +
+            std::to_string(i) + "\"}";
+    }
+    json += "],trailer:{done:true}}";
+    return json;
+}
+
+}  // namespace
+
+/// @brief 開始トークンに対応する終了トークンまでのトークン数が記録されることを確認する。
+TEST(SkipValueTest, IndexesMatchingEnds) {
+    const std::string json = "{a:[1,2],b:{},c:\"x\"}";
+    EXPECT_EQ(subtreeSizesOf(json), (std::vector<std::uint64_t>{11, 3, 1}));
+
+    ChunkedTokenSource chunked;
+    StdoutMessageOutput warningOutput;
+    chunked.tokenize(json, warningOutput, 1);
+    EXPECT_EQ(collectSubtreeSizes(chunked), (std::vector<std::uint64_t>{11, 3, 1}));
+}
+
+/// @brief 文法に合わない範囲は記録せず、読み飛ばす場合もエラーになることを確認する。
+TEST(SkipValueTest, LeavesInvalidSubtreesUnindexed) {
+    EXPECT_EQ(subtreeSizesOf("{a:[k:1],b:{1}}"), (std::vector<std::uint64_t>{0, 0, 0}));
+    EXPECT_EQ(subtreeSizesOf("{a:[1}"), (std::vector<std::uint64_t>{0, 0}));
+    EXPECT_EQ(subtreeSizesOf("{a:{b:[1]"), (std::vector<std::uint64_t>{0, 0, 2}));
+
+    SkipRecord record;
+    EXPECT_THROW(readJsonString("{id:1,name:\"a\",bad:[k:1]}", record), std::runtime_error);
+    EXPECT_THROW(readJsonString("{id:1,name:\"a\",bad:{1}}", record), std::runtime_error);
+    EXPECT_THROW(readJsonString("{id:1,name:\"a\",bad:[1}}", record), std::runtime_error);
+}
+
+/// @brief 未知キーの値を一括で読み飛ばしつつ、キーを記録することを確認する。
+TEST(SkipValueTest, SkipsUnknownValuesAndCollectsKeys) {
+    SkipRecord record;
+    std::vector<std::string> unknownKeys;
+    readJsonString("{blob:{deep:[[1,2,{x:\"s\"}],{}],more:\"t\"},id:7,list:[1,2,3],"
+        "name:\"n\",tail:null}", record, unknownKeys);
+    EXPECT_EQ(record, (SkipRecord{7, "n"}));
+    EXPECT_EQ(unknownKeys, (std::vector<std::string>{"blob", "list", "tail"}));
+}
+
+/// @brief 並列読み込みの区間（TokenRangeSource）と区間並列トークン化でも結果が一致することを確認する。
+TEST(SkipValueTest, SkipsInRangesAndChunks) {
+    const std::string json = makeSkipDocumentJson(400);
+    std::vector<SkipRecord> expected;
+    for (int i = 0; i < 400; ++i) {
+        expected.push_back(SkipRecord{i, "r" + std::to_string(i)});
+    }
+
+    SkipDocument document;
+    std::vector<std::string> unknownKeys;
+    readJsonString(json, document, unknownKeys);
+    EXPECT_EQ(document.records, expected);
+    EXPECT_EQ(unknownKeys.size(), 801u);
+
+    for (std::size_t chunkCount : {1u, 4u, 16u}) {
+        ChunkedTokenSource tokens;
+        StdoutMessageOutput warningOutput;
+        tokens.tokenize(json, warningOutput, chunkCount);
+        JsonParser parser(tokens);
+        SkipDocument chunked;
+        readJsonObject(parser, chunked);
+        EXPECT_EQ(chunked.records, expected) << chunkCount;
+        EXPECT_EQ(parser.unknownKeys().size(), 801u) << chunkCount;
+    }
+}
@@ -0,0 +1,85 @@
+import rai.collection.sorted_hash_array_map;
+import rai.serialization.object_converter;
+#include <gtest/gtest.h>
+#include <array>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace rai::collection;
+
+namespace {
+
+/// @brief 指定数のキーを持つマップを生成し、全キーの探索と未登録キーの不一致を確かめる補助関数。
+/// @tparam N キー数。
+/// @param keys キー配列（呼び出し元で寿命を保証する）。
+/// @return 構築したマップの探索方法。
+template <std::size_t N>
+StringKeyLookupStrategy checkAllKeys(const std::vector<std::string>& keys) {
+    std::array<std::pair<std::string_view, int>, N> entries{};
+    for (std::size_t i = 0; i < N; ++i) {
+        entries[i] = {keys[i], static_cast<int>(i) * 10};
+    }
+    const SortedHashArrayMap<std::string_view, int, N> map(entries);
+    for (std::size_t i = 0; i < N; ++i) {
+        EXPECT_EQ(map.findIndex(keys[i]), i) << keys[i];
+        const int* value = map.findValue(std::string_view(keys[i]));
+        EXPECT_NE(value, nullptr);
+        if (value != nullptr) {
+            EXPECT_EQ(*value, static_cast<int>(i) * 10);
+        }
+        // 登録キーの末尾に1文字足したキーは見つからない。
+        std::string missing = keys[i] + "?";
+        EXPECT_FALSE(map.findIndex(missing).has_value()) << missing;
+    }
+    EXPECT_FALSE(map.findIndex(std::string_view{}).has_value());
+    // MapReference経由の探索はハッシュ順の配列を使い続ける。
+    const MapReference<std::string_view, int> reference(map);
+    EXPECT_EQ(reference.findIndex(keys[N - 1]), N - 1);
+    return map.stringLookupStrategy();
+}
+
+}  // namespace
+
+// ********************************************************************************
+// テストカテゴリ：SortedHashArrayMap
+// ********************************************************************************
+
+/// @brief キー数に応じて線形探索と完全ハッシュを選び、全キーを探索できることのテスト。
+TEST(SortedHashArrayMapTest, ChoosesLookupBySize) {
+    std::vector<std::string> keys;
+    for (int i = 0; i < 64; ++i) {
+        keys.push_back("field" + std::to_string(i));
+    }
+    keys.push_back("averyveryverylongfieldname");
+    EXPECT_EQ(checkAllKeys<3>(keys), StringKeyLookupStrategy::Linear);
+    EXPECT_EQ(checkAllKeys<8>(keys), StringKeyLookupStrategy::Linear);
+    EXPECT_EQ(checkAllKeys<9>(keys), StringKeyLookupStrategy::PerfectHash);
+    EXPECT_EQ(checkAllKeys<64>(keys), StringKeyLookupStrategy::PerfectHash);
+}
+
+/// @brief 長さ・先頭・末尾が同じキーを含む場合はキー全体のハッシュへ切り替えることのテスト。
+TEST(SortedHashArrayMapTest, FallsBackToFullKeyHash) {
+    std::vector<std::string> keys;
+    for (int i = 0; i < 20; ++i) {
+        keys.push_back("prefix__" + std::string(1, static_cast<char>('a' + i)) + "__suffix");
+    }
+    EXPECT_EQ(checkAllKeys<20>(keys), StringKeyLookupStrategy::FullKeyHash);
+}
+
+/// @brief EnumTextMapの名前探索が新しい探索表を使うことのテスト。
+TEST(SortedHashArrayMapTest, EnumTextMapUsesStringLookup) {
+    enum class Level { Trace, Debug, Info, Warn, Error, Fatal, Off, All, Custom, Verbose };
+    using rai::serialization::EnumEntry;
+    const EnumEntry<Level> entries[] = {
+        {Level::Trace, "trace"}, {Level::Debug, "debug"}, {Level::Info, "info"},
+        {Level::Warn, "warn"}, {Level::Error, "error"}, {Level::Fatal, "fatal"},
+        {Level::Off, "off"}, {Level::All, "all"}, {Level::Custom, "custom"},
+        {Level::Verbose, "verbose"}};
+    const rai::serialization::EnumTextMap<Level, 10> map{std::span<const EnumEntry<Level>>(entries)};
+    EXPECT_EQ(map.fromName("fatal"), Level::Fatal);
+    EXPECT_EQ(map.fromName("verbose"), Level::Verbose);
+    EXPECT_FALSE(map.fromName("fatal2").has_value());
+    EXPECT_EQ(map.toName(Level::Custom), "custom");
+}
@@ -0,0 +1,210 @@
+import rai.common.thread_pool;
+#include <gtest/gtest.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace rai::common;
+
+namespace {
+
+/// @brief タスクの中で子タスクを積んで待つ、入れ子の並列和を求める補助関数。
+/// @param pool 子タスクを積むスレッドプール。
+/// @param begin 範囲の先頭。
+/// @param end 範囲の末尾（含まない）。
+long long nestedSum(ThreadPool& pool, long long begin, long long end) {
+    if (end - begin <= 16) {
+        long long sum = 0;
+        for (long long i = begin; i < end; ++i) {
+            sum += i;
+        }
+        return sum;
+    }
+    const long long middle = begin + (end - begin) / 2;
+    std::future<long long> left = pool.enqueue([&pool, begin, middle] {
+        return nestedSum(pool, begin, middle);
+    });
+    const long long right = nestedSum(pool, middle, end);
+    pool.wait(left);
+    return left.get() + right;
+}
+
+}  // namespace
+
+// ********************************************************************************
+// テストカテゴリ：Task
+// ********************************************************************************
+
+/// @brief 小さい関数オブジェクトも大きい関数オブジェクトも、ムーブ後に呼び出せることのテスト。
+TEST(ThreadPoolTest, TaskHoldsMoveOnlyAndLargeCallables) {
+    int called = 0;
+    auto owned = std::make_unique<int>(3);
+    Task small([&called, owned = std::move(owned)] { called += *owned; });
+    std::array<int, 64> large{};
+    large[63] = 5;
+    Task big([&called, large] { called += large[63]; });
+
+    Task movedSmall(std::move(small));
+    Task movedBig;
+    movedBig = std::move(big);
+    EXPECT_FALSE(small);
+    EXPECT_FALSE(big);
+    ASSERT_TRUE(movedSmall);
+    ASSERT_TRUE(movedBig);
+    movedSmall();
+    movedBig();
+    EXPECT_EQ(called, 8);
+}
+
+// ********************************************************************************
+// テストカテゴリ：ThreadPool
+// ********************************************************************************
+
+/// @brief 多数のタスクの結果と例外がfutureで受け取れ、waitForCompletionで全て完了することのテスト。
+TEST(ThreadPoolTest, RunsAllTasksAndPropagatesExceptions) {
+    ThreadPool pool(4);
+    std::atomic<int> counter{0};
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 1000; ++i) {
+        futures.push_back(pool.enqueue([&counter, i] {
+            counter.fetch_add(1, std::memory_order_relaxed);
+            return i;
+        }));
+    }
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(futures[i].get(), i);
+    }
+    pool.post([&counter] { counter.fetch_add(1, std::memory_order_relaxed); });
+    pool.waitForCompletion();
+    EXPECT_EQ(counter.load(), 1001);
+
+    std::future<void> failing = pool.enqueue([] { throw std::runtime_error("failed"); });
+    EXPECT_THROW(failing.get(), std::runtime_error);
+    EXPECT_FALSE(pool.isWorkerThread());
+}
+
+/// @brief ワーカー数より深い入れ子のタスクを待っても止まらないことのテスト。
+TEST(ThreadPoolTest, NestedWaitsDoNotDeadlock) {
+    for (std::size_t threads : {1u, 2u, 4u}) {
+        ThreadPool pool(threads);
+        std::future<long long> root = pool.enqueue([&pool] { return nestedSum(pool, 0, 100000); });
+        EXPECT_EQ(root.get(), 100000LL * 99999 / 2) << threads;
+    }
+}
+
+/// @brief 1つのワーカーが積んだ多数のタスクを、他のワーカーが盗んで実行することのテスト。
+TEST(ThreadPoolTest, IdleWorkersStealLocalTasks) {
+    ThreadPool pool(4);
+    constexpr int taskCount = 20000;
+    std::vector<std::atomic<int>> runs(taskCount);
+    std::future<void> producer = pool.enqueue([&] {
+        std::vector<std::future<void>> children;
+        children.reserve(taskCount);
+        for (int i = 0; i < taskCount; ++i) {
+            children.push_back(pool.enqueue([&runs, i] { runs[i].fetch_add(1); }));
+        }
+        for (auto& child : children) {
+            pool.wait(child);
+        }
+    });
+    producer.get();
+    for (int i = 0; i < taskCount; ++i) {
+        EXPECT_EQ(runs[i].load(), 1) << i;
+    }
+}
+
+/// @brief 積んだスレッドと実行したスレッドが異なっても、使い回すノードのタスクが正しく入れ替わることのテスト。
+/// @note 外部のスレッドが積むノードはワーカー側に溜まり、束で受け渡して使い回す。終了したスレッドの分は解放する。
+TEST(ThreadPoolTest, RecyclesTaskNodesAcrossThreads) {
+    ThreadPool pool(2);
+    constexpr int taskCount = 5000;
+    std::vector<std::atomic<int>> runs(taskCount);
+    for (int round = 0; round < 3; ++round) {
+        std::thread submitter([&] {
+            for (int i = 0; i < taskCount; ++i) {
+                auto owned = std::make_unique<int>(i);
+                pool.post([&runs, owned = std::move(owned)] { runs[*owned].fetch_add(1); });
+            }
+        });
+        submitter.join();
+        std::future<void> nested = pool.enqueue([&] {
+            for (int i = 0; i < taskCount; ++i) {
+                pool.post([&runs, i] { runs[i].fetch_add(1); });
+            }
+        });
+        nested.get();
+        pool.waitForCompletion();
+    }
+    for (int i = 0; i < taskCount; ++i) {
+        EXPECT_EQ(runs[i].load(), 6) << i;
+    }
+}
+
+/// @brief ワーカー以外のスレッドでも、保留中のタスクを代わりに実行できることのテスト。
+TEST(ThreadPoolTest, CallerRunsPendingTask) {
+    ThreadPool pool(1);
+    std::promise<void> started;
+    std::promise<void> release;
+    std::future<void> blocker = pool.enqueue(
+        [&started, gate = release.get_future()]() mutable {
+            started.set_value();
+            gate.wait();
+        });
+    started.get_future().wait();
+    // 唯一のワーカーが塞がっている間に積んだタスクは、呼び出しスレッドが実行する。
+    std::future<int> queued = pool.enqueue([] { return 42; });
+    pool.wait(queued);
+    EXPECT_EQ(queued.get(), 42);
+    release.set_value();
+    blocker.get();
+}
+
+// ********************************************************************************
+// テストカテゴリ：Executor
+// ********************************************************************************
+
+/// @brief InlineExecutorはスレッドを持たず、積んだタスクをその場で実行することのテスト。
+TEST(ThreadPoolTest, InlineExecutorRunsTasksImmediately) {
+    Executor& executor = getInlineExecutor();
+    EXPECT_EQ(executor.getThreadCount(), 0u);
+    EXPECT_FALSE(executor.isWorkerThread());
+    int value = 0;
+    std::future<int> future = executor.enqueue([&value] { return ++value; });
+    EXPECT_EQ(value, 1);
+    EXPECT_EQ(future.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+    EXPECT_EQ(future.get(), 1);
+    EXPECT_FALSE(executor.runPendingTask());
+}
+
+/// @brief CPU固定を指定してもタスクが実行され、固定できた数が報告されることのテスト。
+TEST(ThreadPoolTest, AppliesCpuAffinityOption) {
+    ThreadPoolOptions options;
+    options.threadCount = 2;
+    options.cpuAffinity = {0};
+    ThreadPool pool(options);
+    EXPECT_EQ(pool.getThreadCount(), 2u);
+    std::future<int> future = pool.enqueue([] { return 7; });
+    EXPECT_EQ(future.get(), 7);
+    pool.waitForCompletion();
+    EXPECT_LE(pool.getPinnedThreadCount(), 2u);
+
+    ThreadPool unpinned(1);
+    unpinned.enqueue([] {}).get();
+    EXPECT_EQ(unpinned.getPinnedThreadCount(), 0u);
+}
+
+/// @brief 既定の実行器を差し替えられ、共有ThreadPoolの起動後は設定を変更できないことのテスト。
+TEST(ThreadPoolTest, DefaultExecutorCanBeReplaced) {
+    EXPECT_EQ(&getDefaultExecutor(), static_cast<Executor*>(&getGlobalThreadPool()));
+    EXPECT_THROW(configureGlobalThreadPool(ThreadPoolOptions{}), std::runtime_error);
+    setDefaultExecutor(getInlineExecutor());
+    EXPECT_EQ(&getDefaultExecutor(), static_cast<Executor*>(&getInlineExecutor()));
+    setDefaultExecutor(getGlobalThreadPool());
+    EXPECT_EQ(&getDefaultExecutor(), static_cast<Executor*>(&getGlobalThreadPool()));
+}
@@ -0,0 +1,252 @@
+import rai.serialization.field_serializer;
+import rai.serialization.object_converter;
+import rai.serialization.object_serializer;
+import rai.serialization.polymorphic_converter;
+import rai.serialization.json_io;
+import rai.collection.sorted_hash_array_map;
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace rai::serialization;
+
+namespace {
+
+/// @brief 検証に使う色。
+enum class ValidColor { Red, Blue };
+
+inline constexpr EnumEntry<ValidColor> validColorEntries[] = {
+    {ValidColor::Red, "Red"},
+    {ValidColor::Blue, "Blue"},
+};
+
+/// @brief ポリモーフィックな要素の基底クラス。
+struct ValidShape {
+    virtual ~ValidShape() = default;
+    virtual const ObjectSerializer& serializer() const = 0;
+};
+
+/// @brief 半径を持つポリモーフィックな要素。
+struct ValidCircle : ValidShape {
+    double radius = 0;
+
+    const ObjectSerializer& serializer() const override {
+        static const auto fields = getFieldSet(
+            getRequiredField(&ValidCircle::radius, "radius")
+        );
+        return fields;
+    }
+};
+
+using ValidShapeEntry = std::pair<std::string_view, PolymorphicTypeFactory<std::unique_ptr<ValidShape>>>;
+inline const auto validShapeEntries = rai::collection::makeSortedHashArrayMap(
+    ValidShapeEntry{"Circle", [] { return std::make_unique<ValidCircle>(); }}
+);
+
+/// @brief 構築回数を数えるポリモーフィックな要素。
+struct ValidSquare : ValidShape {
+    inline static int constructed = 0;
+    double side = 0;
+
+    ValidSquare() { ++constructed; }
+
+    const ObjectSerializer& serializer() const override {
+        static const auto fields = getFieldSet(
+            getRequiredField(&ValidSquare::side, "side")
+        );
+        return fields;
+    }
+};
+
+inline const auto validCountedShapeEntries = rai::collection::makeSortedHashArrayMap(
+    ValidShapeEntry{"Circle", [] { return std::make_unique<ValidCircle>(); }},
+    ValidShapeEntry{"Square", makePolymorphicFactory<ValidSquare, std::unique_ptr<ValidShape>>()}
+);
+
+/// @brief 検証関数を登録した要素の配列を持つ文書。
+struct ValidShapeDocument {
+    std::vector<std::unique_ptr<ValidShape>> shapes;
+
+    const ObjectSerializer& serializer() const {
+        static const auto shapesConverter =
+            getPolymorphicArrayConverter<decltype(shapes)>(validCountedShapeEntries, "kind");
+        static const auto fields = getFieldSet(
+            getRequiredField(&ValidShapeDocument::shapes, "shapes", shapesConverter)
+        );
+        return fields;
+    }
+};
+
+/// @brief 入れ子の要素。
+struct ValidItem {
+    int id = 0;
+    std::string label;
+
+    const ObjectSerializer& serializer() const {
+        static const auto fields = getFieldSet(
+            getRequiredField(&ValidItem::id, "id"),
+            getDefaultOmittedField(&ValidItem::label, "label", std::string("none"))
+        );
+        return fields;
+    }
+};
+
+/// @brief 検証の対象にする文書。
+struct ValidDocument {
+    std::string name;
+    double ratio = 0;
+    bool flag = false;
+    char grade = 'A';
+    ValidColor color = ValidColor::Red;
+    std::vector<ValidItem> items;
+    std::unique_ptr<ValidItem> extra;
+    std::vector<std::unique_ptr<ValidShape>> shapes;
+
+    const ObjectSerializer& serializer() const {
+        static const auto colorConverter = getEnumConverter(validColorEntries);
+        static const auto itemsConverter = getContainerConverter<decltype(items)>();
+        static const auto extraConverter = getUniquePtrConverter<decltype(extra)>();
+        static const auto shapesConverter =
+            getPolymorphicArrayConverter<decltype(shapes)>(validShapeEntries, "kind");
+        static const auto fields = getFieldSet(
+            getRequiredField(&ValidDocument::name, "name"),
+            getRequiredField(&ValidDocument::ratio, "ratio"),
+            getInitialOmittedField(&ValidDocument::flag, "flag"),
+            getInitialOmittedField(&ValidDocument::grade, "grade"),
+            getRequiredField(&ValidDocument::color, "color", colorConverter),
+            getRequiredField(&ValidDocument::items, "items", itemsConverter),
+            getRequiredField(&ValidDocument::extra, "extra", extraConverter),
+            getRequiredField(&ValidDocument::shapes, "shapes", shapesConverter)
+        );
+        return fields;
+    }
+};
+
+inline constexpr std::string_view validDocumentJson =
+    "{name:\"doc\",ratio:1,flag:true,grade:\"B\",color:\"Blue\","
+    "items:[{id:1,label:\"a\"},{id:2}],extra:null,"
+    "shapes:[{kind:\"Circle\",radius:2.5},null]}";
+
+/// @brief readJsonStringで読み込めるかを返す。
+bool readsValidDocument(std::string_view json) {
+    ValidDocument document;
+    try {
+        readJsonString(std::string(json), document);
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+}  // namespace
+
+/// @brief 正しい文書を受け入れ、未知キーを集めることを確認する。
+TEST(ValidateJsonTest, AcceptsValidDocument) {
+    EXPECT_TRUE(validateJson<ValidDocument>(validDocumentJson));
+
+    std::string withUnknown(validDocumentJson);
+    withUnknown.insert(1, "note:{deep:[1,2]},");
+    std::vector<std::string> unknownKeys;
+    const JsonValidationResult result = validateJson<ValidDocument>(withUnknown, unknownKeys);
+    EXPECT_TRUE(result.valid);
+    EXPECT_TRUE(result.message.empty());
+    EXPECT_EQ(unknownKeys, std::vector<std::string>{"note"});
+}
+
+/// @brief 最初のエラーの位置と内容を返すことを確認する。
+TEST(ValidateJsonTest, ReportsFirstErrorPosition) {
+    const std::string wrongType = "{name:\"doc\",ratio:\"x\"}";
+    const JsonValidationResult typeResult = validateJson<ValidDocument>(wrongType);
+    EXPECT_FALSE(typeResult);
+    EXPECT_EQ(typeResult.position, wrongType.find("\"x\""));
+    EXPECT_NE(typeResult.message.find("number"), std::string::npos);
+
+    const std::string missing = "{name:\"doc\",ratio:1,color:\"Red\",items:[],extra:null}";
+    const JsonValidationResult missingResult = validateJson<ValidDocument>(missing);
+    EXPECT_FALSE(missingResult);
+    EXPECT_NE(missingResult.message.find("shapes"), std::string::npos);
+
+    const std::string duplicate = "{name:\"a\",name:\"b\"}";
+    const JsonValidationResult duplicateResult = validateJson<ValidDocument>(duplicate);
+    EXPECT_FALSE(duplicateResult);
+    EXPECT_EQ(duplicateResult.position, duplicate.find("name", 2));
+    EXPECT_NE(duplicateResult.message.find("duplicate"), std::string::npos);
+
+    const JsonValidationResult syntaxResult = validateJson<ValidDocument>("{name:\"doc\",ratio:1.2.3}");
+    EXPECT_FALSE(syntaxResult);
+    EXPECT_NE(syntaxResult.message.find("JSON5"), std::string::npos);
+}
+
+/// @brief 検証結果がreadJsonStringで読み込めるかと一致することを確認する。
+TEST(ValidateJsonTest, AgreesWithRead) {
+    const std::string base(validDocumentJson);
+    std::vector<std::string> inputs = {
+        base,
+        "{}",
+        "[]",
+        "{name:1}",
+        "{name:\"doc\",ratio:1,color:\"Green\",items:[],extra:null,shapes:[]}",
+        "{name:\"doc\",ratio:1,color:\"Red\",items:[{label:\"x\"}],extra:null,shapes:[]}",
+        "{name:\"doc\",ratio:1,color:\"Red\",items:[],extra:{id:3},shapes:[]}",
+        "{name:\"doc\",ratio:1,color:\"Red\",items:[],extra:{id:\"3\"},shapes:[]}",
+        "{name:\"doc\",ratio:1,color:\"Red\",items:[],extra:null,shapes:[{kind:\"Square\"}]}",
+        "{name:\"doc\",ratio:1,color:\"Red\",items:[],extra:null,shapes:[{radius:1}]}",
+        "{name:\"doc\",ratio:1,color:\"Red\",items:[],extra:null,shapes:[],grade:\"AB\"}",
+        "{name:\"doc\",ratio:1,color:\"Red\",items:{},extra:null,shapes:[]}",
+    };
+    for (std::size_t cut = 1; cut < base.size(); cut += 7) {
+        inputs.push_back(base.substr(0, cut));
+    }
+    for (const auto& input : inputs) {
+        EXPECT_EQ(static_cast<bool>(validateJson<ValidDocument>(input)), readsValidDocument(input))
+            << input;
+    }
+}
+
+/// @brief 入力の範囲外を読まずに文字列をその場で検証し、読み込み文脈を使い回せることを確認する。
+TEST(ValidateJsonTest, ValidatesViewsInPlace) {
+    const std::string buffer = std::string(validDocumentJson) + "{name:\"next\"}";
+    const std::string_view first(buffer.data(), validDocumentJson.size());
+    EXPECT_TRUE(validateJson<ValidDocument>(first));
+    EXPECT_FALSE(validateJson<ValidDocument>(std::string_view(buffer).substr(first.size())));
+
+    JsonReadContext context;
+    for (int i = 0; i < 3; ++i) {
+        std::string withUnknown(validDocumentJson);
+        withUnknown.insert(1, "note" + std::to_string(i) + ":1,");
+        EXPECT_TRUE(context.validate<ValidDocument>(withUnknown));
+        EXPECT_EQ(context.unknownKeys(), std::vector<std::string>{"note" + std::to_string(i)});
+        EXPECT_FALSE(context.validate<ValidDocument>("{name:\"doc\",ratio:\"x\"}"));
+        EXPECT_FALSE(context.inUse());
+    }
+}
+
+/// @brief makePolymorphicFactoryで登録した要素は、検証のたびには構築されないことを確認する。
+TEST(ValidateJsonTest, ValidatesRegisteredPolymorphicElementsWithoutConstructing) {
+    std::string json = "{shapes:[";
+    for (int i = 0; i < 100; ++i) {
+        json += "{kind:\"Square\",side:" + std::to_string(i) + "},";
+    }
+    json += "{kind:\"Circle\",radius:1}]}";
+
+    EXPECT_TRUE(validateJson<ValidShapeDocument>(json));
+    const int afterFirst = ValidSquare::constructed;
+    EXPECT_LE(afterFirst, 1);
+    EXPECT_TRUE(validateJson<ValidShapeDocument>(json));
+    EXPECT_EQ(ValidSquare::constructed, afterFirst);
+
+    const std::string missingSide = "{shapes:[{kind:\"Square\"}]}";
+    EXPECT_FALSE(validateJson<ValidShapeDocument>(missingSide));
+    EXPECT_FALSE(validateJson<ValidShapeDocument>("{shapes:[{kind:\"Square\",side:\"x\"}]}"));
+    EXPECT_EQ(ValidSquare::constructed, afterFirst);
+
+    ValidShapeDocument document;
+    readJsonString(json, document);
+    ASSERT_EQ(document.shapes.size(), 101u);
+    EXPECT_EQ(static_cast<const ValidSquare&>(*document.shapes[99]).side, 99);
+    EXPECT_EQ(ValidSquare::constructed, afterFirst + 100);
+}